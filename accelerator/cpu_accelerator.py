@@ -282,9 +282,9 @@ class CPU_Accelerator(DeepSpeedAccelerator):
             # is op_builder from deepspeed or a 3p version? this should only succeed if it's deepspeed
             # if successful this also means we're doing a local install and not JIT compile path
             from op_builder import __deepspeed__  # noqa: F401 # type: ignore
-            from op_builder.cpu import CCLCommBuilder, FusedAdamBuilder, CPUAdamBuilder, NotImplementedBuilder
+            from op_builder.cpu import CCLCommBuilder, FusedAdamBuilder, CPUAdamBuilder, CPUMultiTensorBuilder, NativeProfilerBuilder, MetricsRingBuilder, EvoformerAttnBuilder, SpatialInferenceBuilder, TransformerBuilder, StochasticTransformerBuilder, RaggedOpsBuilder, RaggedUtilsBuilder, QuantizerBuilder, NotImplementedBuilder
         except ImportError:
-            from deepspeed.ops.op_builder.cpu import CCLCommBuilder, FusedAdamBuilder, CPUAdamBuilder, NotImplementedBuilder
+            from deepspeed.ops.op_builder.cpu import CCLCommBuilder, FusedAdamBuilder, CPUAdamBuilder, CPUMultiTensorBuilder, NativeProfilerBuilder, MetricsRingBuilder, EvoformerAttnBuilder, SpatialInferenceBuilder, TransformerBuilder, StochasticTransformerBuilder, RaggedOpsBuilder, RaggedUtilsBuilder, QuantizerBuilder, NotImplementedBuilder
 
         if class_name == "CCLCommBuilder":
             return CCLCommBuilder
@@ -292,6 +292,26 @@ class CPU_Accelerator(DeepSpeedAccelerator):
             return FusedAdamBuilder
         elif class_name == "CPUAdamBuilder":
             return CPUAdamBuilder
+        elif class_name == "CPUMultiTensorBuilder":
+            return CPUMultiTensorBuilder
+        elif class_name == "NativeProfilerBuilder":
+            return NativeProfilerBuilder
+        elif class_name == "MetricsRingBuilder":
+            return MetricsRingBuilder
+        elif class_name == "EvoformerAttnBuilder":
+            return EvoformerAttnBuilder
+        elif class_name == "SpatialInferenceBuilder":
+            return SpatialInferenceBuilder
+        elif class_name == "TransformerBuilder":
+            return TransformerBuilder
+        elif class_name == "StochasticTransformerBuilder":
+            return StochasticTransformerBuilder
+        elif class_name == "RaggedOpsBuilder":
+            return RaggedOpsBuilder
+        elif class_name == "RaggedUtilsBuilder":
+            return RaggedUtilsBuilder
+        elif class_name == "QuantizerBuilder":
+            return QuantizerBuilder
         else:
             # return a NotImplementedBuilder to avoid get NoneType[Name] in unit tests
             return NotImplementedBuilder
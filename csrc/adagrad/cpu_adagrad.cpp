@@ -9,6 +9,7 @@
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
+#include "ds_trace.h"
 #if defined(__ENABLE_CUDA__)
 #include <cuda_runtime_api.h>
 #include "cublas_v2.h"
@@ -179,6 +180,7 @@ int ds_adagrad_step(int optimizer_id,
                     torch::Tensor& grads,
                     torch::Tensor& exp_avg_sq)
 {
+    DS_TRACE_SPAN("optimizer", "adagrad_step", (int64_t)params.nbytes());
     auto params_c = params.contiguous();
     auto grads_c = grads.contiguous();
     auto exp_avg_sq_c = exp_avg_sq.contiguous();
@@ -209,6 +211,7 @@ int ds_adagrad_step_plus_copy(int optimizer_id,
                               torch::Tensor& exp_avg_sq,
                               torch::Tensor& gpu_params)
 {
+    DS_TRACE_SPAN("optimizer", "adagrad_step", (int64_t)params.nbytes());
 #if defined(__ENABLE_CUDA__) or defined(__ENABLE_CANN__)
     auto params_c = params.contiguous();
     auto gpu_params_c = gpu_params.contiguous();
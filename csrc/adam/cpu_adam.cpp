@@ -4,6 +4,7 @@
 // DeepSpeed Team
 
 #include "cpu_adam.h"
+#include "cpu_adam_nvme.h"
 
 PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
 {
@@ -13,4 +14,13 @@ PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
           "DeepSpeed CPU Adam update and param copy (C++)");
     m.def("create_adam", &create_adam_optimizer, "DeepSpeed CPU Adam (C++)");
     m.def("destroy_adam", &destroy_adam_optimizer, "DeepSpeed CPU Adam destroy (C++)");
+
+    py::class_<Adam_NVMe_Pipeline>(m, "AdamNVMePipeline")
+        .def(py::init<torch::Tensor, int64_t, int64_t>())
+        .def("step",
+             &Adam_NVMe_Pipeline::step,
+             "DeepSpeed CPU Adam update over swapped optimizer state (C++)",
+             py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("n_slots", &Adam_NVMe_Pipeline::n_slots)
+        .def_property_readonly("chunk_numel", &Adam_NVMe_Pipeline::chunk_numel);
 }
@@ -9,6 +9,7 @@
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
+#include "ds_trace.h"
 #include "cpu_adam.h"
 
 #if defined(__ENABLE_CUDA__)
@@ -227,6 +228,7 @@ int ds_adam_step(int optimizer_id,
                  torch::Tensor& exp_avg,
                  torch::Tensor& exp_avg_sq)
 {
+    DS_TRACE_SPAN("optimizer", "adam_step", (int64_t)params.nbytes());
     auto params_c = params.contiguous();
     auto grads_c = grads.contiguous();
     auto exp_avg_c = exp_avg.contiguous();
@@ -272,6 +274,7 @@ int ds_adam_step_plus_copy(int optimizer_id,
                            torch::Tensor& exp_avg_sq,
                            torch::Tensor& device_params)
 {
+    DS_TRACE_SPAN("optimizer", "adam_step", (int64_t)params.nbytes());
 #if defined(__ENABLE_CUDA__) or defined(__ENABLE_CANN__)
     auto params_c = params.contiguous();
     auto device_params_c = device_params.contiguous();
@@ -304,6 +307,13 @@ int ds_adam_step_plus_copy(int optimizer_id,
     return 0;
 }
 
+std::shared_ptr<Adam_Optimizer> get_adam_optimizer(int optimizer_id)
+{
+    auto it = s_optimizers.find(optimizer_id);
+    TORCH_CHECK(it != s_optimizers.end(), "Adam optimizer ", optimizer_id, " does not exist");
+    return std::static_pointer_cast<Adam_Optimizer>(it->second);
+}
+
 int destroy_adam_optimizer(int optimizer_id)
 {
     s_optimizers.erase(optimizer_id);
@@ -0,0 +1,263 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "cpu_adam_nvme.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "cpu_adam.h"
+#include "ds_trace.h"
+
+#ifndef O_DIRECT
+// Platforms without O_DIRECT go through the page cache.
+#define O_DIRECT 0
+#endif
+
+namespace {
+
+constexpr int64_t direct_io_alignment = 4096;
+
+// The three tensors streamed per chunk, in the order of their slots and files.
+constexpr int n_streams = 3;
+constexpr int param_stream = 0;
+
+bool is_aligned(int64_t value) { return value % direct_io_alignment == 0; }
+
+}  // namespace
+
+struct Adam_NVMe_Pipeline::IO_Batch {
+    std::mutex mutex;
+    std::condition_variable cv;
+    int64_t pending = 0;
+    int error = 0;
+};
+
+Adam_NVMe_Pipeline::Adam_NVMe_Pipeline(torch::Tensor staging,
+                                       int64_t n_io_threads,
+                                       int64_t block_bytes)
+    : staging_(staging),
+      n_slots_(staging.size(0)),
+      chunk_numel_(staging.size(2)),
+      block_bytes_(block_bytes),
+      file_bytes_(0),
+      stop_(false)
+{
+    TORCH_CHECK(staging.dim() == 3 && staging.size(1) == n_streams && staging.is_contiguous() &&
+                    staging.device().is_cpu() && staging.scalar_type() == torch::kFloat,
+                "staging must be a contiguous [n_slots, 3, chunk_numel] float host tensor");
+    TORCH_CHECK(n_slots_ >= 2, "the pipeline needs at least two staging slots");
+    TORCH_CHECK(is_aligned(chunk_numel_ * sizeof(float)),
+                "chunk_numel must be a multiple of ",
+                direct_io_alignment / sizeof(float));
+    TORCH_CHECK(block_bytes > 0 && is_aligned(block_bytes),
+                "block_bytes must be a positive multiple of ",
+                direct_io_alignment);
+    TORCH_CHECK(n_io_threads > 0, "n_io_threads must be positive");
+
+    for (int i = 0; i < n_streams; i++) fds_[i] = direct_fds_[i] = -1;
+    for (int64_t i = 0; i < n_slots_; i++) slot_io_.emplace_back(new IO_Batch());
+    for (int64_t i = 0; i < n_io_threads; i++) io_threads_.emplace_back([this] { io_worker(); });
+}
+
+Adam_NVMe_Pipeline::~Adam_NVMe_Pipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stop_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto& thread : io_threads_) thread.join();
+}
+
+void Adam_NVMe_Pipeline::io_worker()
+{
+    while (true) {
+        IO_Request request;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_ && queue_.empty()) return;
+            request = queue_.front();
+            queue_.pop_front();
+        }
+
+        const bool direct = request.direct_fd >= 0 &&
+                            is_aligned(reinterpret_cast<int64_t>(request.buffer)) &&
+                            is_aligned(request.offset) && is_aligned(request.bytes);
+        const int fd = direct ? request.direct_fd : request.fd;
+
+        int error = 0;
+        int64_t done = 0;
+        while (done < request.bytes) {
+            const ssize_t n = request.write ? pwrite(fd,
+                                                     request.buffer + done,
+                                                     request.bytes - done,
+                                                     request.offset + done)
+                                            : pread(fd,
+                                                    request.buffer + done,
+                                                    request.bytes - done,
+                                                    request.offset + done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                error = n < 0 ? errno : EIO;
+                break;
+            }
+            done += n;
+        }
+
+        IO_Batch* batch = request.batch;
+        {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (error != 0) batch->error = error;
+            batch->pending--;
+        }
+        batch->cv.notify_all();
+    }
+}
+
+void Adam_NVMe_Pipeline::submit_chunk(int64_t chunk, int64_t slot, bool write, bool read_state)
+{
+    const int64_t chunk_bytes = chunk_numel_ * sizeof(float);
+    const int64_t offset = chunk * chunk_bytes;
+    const int64_t bytes = std::min(chunk_bytes, file_bytes_ - offset);
+    char* slot_data = reinterpret_cast<char*>(staging_[slot].data_ptr<float>());
+
+    std::vector<IO_Request> requests;
+    for (int stream = 0; stream < n_streams; stream++) {
+        char* buffer = slot_data + stream * chunk_bytes;
+        if (!write && !read_state && stream != param_stream) {
+            // The optimizer state of a parameter stepped for the first time starts at zero.
+            std::memset(buffer, 0, bytes);
+            continue;
+        }
+        for (int64_t block = 0; block < bytes; block += block_bytes_) {
+            requests.push_back({fds_[stream],
+                                direct_fds_[stream],
+                                buffer + block,
+                                std::min(block_bytes_, bytes - block),
+                                offset + block,
+                                write,
+                                slot_io_[slot].get()});
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(slot_io_[slot]->mutex);
+        slot_io_[slot]->pending += requests.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_.insert(queue_.end(), requests.begin(), requests.end());
+    }
+    queue_cv_.notify_all();
+}
+
+void Adam_NVMe_Pipeline::wait(IO_Batch& batch)
+{
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.cv.wait(lock, [&batch] { return batch.pending == 0; });
+}
+
+void Adam_NVMe_Pipeline::step(int optimizer_id,
+                              size_t step,
+                              float lr,
+                              float beta1,
+                              float beta2,
+                              float epsilon,
+                              float weight_decay,
+                              bool bias_correction,
+                              torch::Tensor& grads,
+                              const std::vector<std::string>& paths,
+                              int64_t file_numel,
+                              bool state_initialized)
+{
+    DS_TRACE_SPAN("optimizer", "adam_step_nvme", (int64_t)grads.nbytes());
+    TORCH_CHECK(grads.is_contiguous() && grads.device().is_cpu() &&
+                    grads.scalar_type() == torch::kFloat,
+                "grads must be a contiguous float host tensor");
+    TORCH_CHECK(paths.size() == n_streams, "expected the param, exp_avg and exp_avg_sq files");
+    const int64_t numel = grads.numel();
+    TORCH_CHECK(file_numel >= numel, "file_numel must cover the partition");
+
+    std::shared_ptr<Adam_Optimizer> opt = get_adam_optimizer(optimizer_id);
+    opt->IncrementStep(step, beta1, beta2);
+    opt->update_state(lr, epsilon, weight_decay, bias_correction);
+
+    file_bytes_ = file_numel * sizeof(float);
+    std::string error;
+    for (int i = 0; i < n_streams; i++) {
+        const int flags = (i == param_stream || state_initialized) ? O_RDWR : O_RDWR | O_CREAT;
+        fds_[i] = open(paths[i].c_str(), flags, 0644);
+        direct_fds_[i] = open(paths[i].c_str(), O_RDWR | O_DIRECT);
+        if (fds_[i] < 0 && error.empty()) {
+            error = "failed to open " + paths[i] + ": " + std::strerror(errno);
+        }
+    }
+
+    if (error.empty()) {
+        const int64_t n_chunks = (file_numel + chunk_numel_ - 1) / chunk_numel_;
+        float* out = grads.data_ptr<float>();
+
+        // One slot is always being written back while the others are read or stepped.
+        const int64_t depth = n_slots_ - 1;
+        for (int64_t k = 0; k < std::min(depth, n_chunks); k++) {
+            submit_chunk(k, k, false, state_initialized);
+        }
+
+        for (int64_t k = 0; k < n_chunks; k++) {
+            const int64_t slot = k % n_slots_;
+            wait(*slot_io_[slot]);
+            // A failed or short read leaves stale slot data, which must not be stepped and
+            // written over the files.
+            if (slot_io_[slot]->error != 0) break;
+
+            float* data = staging_[slot].data_ptr<float>();
+            const int64_t start = k * chunk_numel_;
+            const int64_t count = std::max<int64_t>(0, std::min(chunk_numel_, numel - start));
+            if (count > 0) {
+                opt->Step_8(data + param_stream * chunk_numel_,
+                            out + start,
+                            data + chunk_numel_,
+                            data + 2 * chunk_numel_,
+                            count);
+                // The gradient of the chunk is consumed, hand back the updated parameter.
+                std::memcpy(out + start, data + param_stream * chunk_numel_, count * sizeof(float));
+            }
+            submit_chunk(k, slot, true, state_initialized);
+
+            // Refill the slot of chunk k - 1 once its write back is done.
+            const int64_t next = k + depth;
+            if (next < n_chunks) {
+                const int64_t next_slot = next % n_slots_;
+                wait(*slot_io_[next_slot]);
+                if (slot_io_[next_slot]->error != 0) break;
+                submit_chunk(next, next_slot, false, state_initialized);
+            }
+        }
+        // Drain the requests still in flight, also after an error.
+        for (auto& batch : slot_io_) wait(*batch);
+    }
+
+    int io_error = 0;
+    for (auto& batch : slot_io_) {
+        io_error = io_error != 0 ? io_error : batch->error;
+        batch->error = 0;
+    }
+    for (int i = 0; i < n_streams; i++) {
+        if (fds_[i] >= 0) close(fds_[i]);
+        if (direct_fds_[i] >= 0) close(direct_fds_[i]);
+        fds_[i] = direct_fds_[i] = -1;
+    }
+
+    if (!error.empty()) throw std::runtime_error(error);
+    if (io_error != 0) {
+        throw std::runtime_error(std::string("optimizer state I/O failed: ") +
+                                 std::strerror(io_error));
+    }
+}
@@ -31,32 +31,15 @@ Functionality for swapping optimizer tensors to/from (NVMe) storage devices.
 #include <vector>
 
 #include "deepspeed_aio_common.h"
+#include "ds_trace.h"
 
 using namespace std;
 using namespace std::chrono;
 
-#define DEBUG_DS_AIO_PERF 0
 #define DEBUG_DS_AIO_SUBMIT_PERF 0
 
 static const std::string c_library_name = "deepspeed_aio";
 
-static void _report_aio_statistics(const char* tag,
-                                   const std::vector<std::chrono::duration<double>>& latencies)
-    __attribute__((unused));
-
-static void _report_aio_statistics(const char* tag,
-                                   const std::vector<std::chrono::duration<double>>& latencies)
-{
-    std::vector<double> lat_usec;
-    for (auto& lat : latencies) { lat_usec.push_back(lat.count() * 1e6); }
-    const auto min_lat = *(std::min_element(lat_usec.begin(), lat_usec.end()));
-    const auto max_lat = *(std::max_element(lat_usec.begin(), lat_usec.end()));
-    const auto avg_lat = std::accumulate(lat_usec.begin(), lat_usec.end(), 0) / lat_usec.size();
-
-    std::cout << c_library_name << ": latency statistics(usec) " << tag
-              << " min/max/avg = " << min_lat << " " << max_lat << " " << avg_lat << std::endl;
-}
-
 static void _get_aio_latencies(std::vector<std::chrono::duration<double>>& raw_latencies,
                                struct deepspeed_aio_latency_t& summary_latencies)
 {
@@ -74,6 +57,7 @@ static void _do_io_submit_singles(const long long int n_iocbs,
                                   std::vector<std::chrono::duration<double>>& submit_times)
 {
     for (auto i = 0; i < n_iocbs; ++i) {
+        DS_TRACE_SPAN("aio", "io_submit", (int64_t)aio_ctxt->_iocbs[i]->u.c.nbytes);
         const auto st = std::chrono::high_resolution_clock::now();
         const auto submit_ret = io_submit(aio_ctxt->_io_ctxt, 1, aio_ctxt->_iocbs.data() + i);
         submit_times.push_back(std::chrono::high_resolution_clock::now() - st);
@@ -94,6 +78,7 @@ static void _do_io_submit_block(const long long int n_iocbs,
                                 std::unique_ptr<aio_context>& aio_ctxt,
                                 std::vector<std::chrono::duration<double>>& submit_times)
 {
+    DS_TRACE_SPAN("aio", "io_submit");
     const auto st = std::chrono::high_resolution_clock::now();
     const auto submit_ret = io_submit(aio_ctxt->_io_ctxt, n_iocbs, aio_ctxt->_iocbs.data());
     submit_times.push_back(std::chrono::high_resolution_clock::now() - st);
@@ -114,6 +99,7 @@ static int _do_io_complete(const long long int min_completes,
                            std::unique_ptr<aio_context>& aio_ctxt,
                            std::vector<std::chrono::duration<double>>& reap_times)
 {
+    DS_TRACE_SPAN("aio", "io_getevents");
     const auto start_time = std::chrono::high_resolution_clock::now();
     long long int n_completes = io_pgetevents(aio_ctxt->_io_ctxt,
                                               min_completes,
@@ -136,11 +122,7 @@ void do_aio_operation_sequential(const bool read_op,
 
     const auto num_io_blocks = static_cast<long long int>(
         ceil(static_cast<double>(xfer_ctxt->_num_bytes) / aio_ctxt->_block_size));
-#if DEBUG_DS_AIO_PERF
-    const auto io_op_name = std::string(read_op ? "read" : "write");
-    std::cout << c_library_name << ": start " << io_op_name << " " << xfer_ctxt->_num_bytes
-              << " bytes with " << num_io_blocks << " io blocks" << std::endl;
-#endif
+    DS_TRACE_SPAN("aio", read_op ? "aio_read" : "aio_write", xfer_ctxt->_num_bytes);
 
     std::vector<std::chrono::duration<double>> submit_times;
     std::vector<std::chrono::duration<double>> reap_times;
@@ -173,21 +155,6 @@ void do_aio_operation_sequential(const bool read_op,
         perf->_e2e_usec = elapsed.count() * 1e6;
         perf->_e2e_rate_GB = (xfer_ctxt->_num_bytes / elapsed.count() / 1e9);
     }
-
-#if DEBUG_DS_AIO_PERF
-    _report_aio_statistics("submit", submit_times);
-    _report_aio_statistics("complete", reap_times);
-#endif
-
-#if DEBUG_DS_AIO_PERF
-    std::cout << c_library_name << ": runtime(usec) " << elapsed.count() * 1e6
-              << " rate(GB/sec) = " << (xfer_ctxt->_num_bytes / elapsed.count() / 1e9) << std::endl;
-#endif
-
-#if DEBUG_DS_AIO_PERF
-    std::cout << c_library_name << ": finish " << io_op_name << " " << xfer_ctxt->_num_bytes
-              << " bytes " << std::endl;
-#endif
 }
 
 void do_aio_operation_overlap(const bool read_op,
@@ -198,11 +165,7 @@ void do_aio_operation_overlap(const bool read_op,
 {
     struct io_prep_generator io_gen(read_op, xfer_ctxt, aio_ctxt->_block_size);
 
-#if DEBUG_DS_AIO_PERF
-    const auto io_op_name = std::string(read_op ? "read" : "write");
-    std::cout << c_library_name << ": start " << io_op_name << " " << xfer_ctxt->_num_bytes
-              << " bytes with " << io_gen._num_io_blocks << " io blocks" << std::endl;
-#endif
+    DS_TRACE_SPAN("aio", read_op ? "aio_read" : "aio_write", xfer_ctxt->_num_bytes);
 
     std::vector<std::chrono::duration<double>> submit_times;
     std::vector<std::chrono::duration<double>> reap_times;
@@ -225,6 +188,7 @@ void do_aio_operation_overlap(const bool read_op,
 
         n_pending_iocbs += n_iocbs;
         assert(n_pending_iocbs <= aio_ctxt->_queue_depth);
+        DS_TRACE_COUNTER("aio", "pending_iocbs", n_pending_iocbs);
 
         if (n_pending_iocbs == 0) { break; }
 
@@ -241,21 +205,6 @@ void do_aio_operation_overlap(const bool read_op,
         perf->_e2e_usec = elapsed.count() * 1e6;
         perf->_e2e_rate_GB = (xfer_ctxt->_num_bytes / elapsed.count() / 1e9);
     }
-
-#if DEBUG_DS_AIO_PERF
-    _report_aio_statistics("submit", submit_times);
-    _report_aio_statistics("complete", reap_times);
-#endif
-
-#if DEBUG_DS_AIO_PERF
-    std::cout << c_library_name << ": runtime(usec) " << elapsed.count() * 1e6
-              << " rate(GB/sec) = " << (xfer_ctxt->_num_bytes / elapsed.count() / 1e9) << std::endl;
-#endif
-
-#if DEBUG_DS_AIO_PERF
-    std::cout << c_library_name << ": finish " << io_op_name << " " << xfer_ctxt->_num_bytes
-              << " bytes " << std::endl;
-#endif
 }
 
 void report_file_error(const char* filename, const std::string file_op, const int error_code)
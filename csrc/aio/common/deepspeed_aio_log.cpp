@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "deepspeed_aio_log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <time.h>
+
+#define DS_AIO_LOG_EXPORT __attribute__((visibility("default")))
+
+static const char* c_level_names[] = {"ERROR", "WARNING", "INFO", "DEBUG"};
+
+static int log_level_from_env()
+{
+    const char* value = getenv("DS_AIO_LOG_LEVEL");
+    if (value == nullptr || value[0] == '\0') { return DS_AIO_LOG_WARNING; }
+    if (value[0] >= '0' && value[0] <= '9') {
+        const int level = atoi(value);
+        return level > DS_AIO_LOG_DEBUG ? DS_AIO_LOG_DEBUG : level;
+    }
+    for (int level = DS_AIO_LOG_ERROR; level <= DS_AIO_LOG_DEBUG; ++level) {
+        if (strcasecmp(value, c_level_names[level]) == 0) { return level; }
+    }
+    return DS_AIO_LOG_WARNING;
+}
+
+std::atomic<int> ds_aio_log_level_value(log_level_from_env());
+
+static uint64_t log_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+bool deepspeed_aio_log_site_t::acquire(int64_t& suppressed)
+{
+    const uint64_t now = log_now_ns();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (now - _window_start_ns >= 1000000000ull) {
+        _window_start_ns = now;
+        _emitted = 0;
+    }
+    if (_emitted >= DS_AIO_LOG_BURST) {
+        ++_suppressed;
+        return false;
+    }
+    ++_emitted;
+    suppressed = _suppressed;
+    _suppressed = 0;
+    return true;
+}
+
+void ds_aio_log_write(const int level, const int64_t suppressed, const char* format, ...)
+{
+    char message[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    // One fprintf per message keeps lines from different threads intact.
+    if (suppressed > 0) {
+        fprintf(stderr,
+                "[deepspeed_aio] %s: %s (%lld similar messages suppressed)\n",
+                c_level_names[level],
+                message,
+                (long long)suppressed);
+    } else {
+        fprintf(stderr, "[deepspeed_aio] %s: %s\n", c_level_names[level], message);
+    }
+}
+
+extern "C" {
+
+DS_AIO_LOG_EXPORT int ds_aio_set_log_level(int level)
+{
+    if (level < DS_AIO_LOG_ERROR) { level = DS_AIO_LOG_ERROR; }
+    if (level > DS_AIO_LOG_DEBUG) { level = DS_AIO_LOG_DEBUG; }
+    return ds_aio_log_level_value.exchange(level, std::memory_order_relaxed);
+}
+
+DS_AIO_LOG_EXPORT int ds_aio_get_log_level() { return ds_aio_log_level_value.load(); }
+}
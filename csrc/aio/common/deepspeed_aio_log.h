@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+/*
+Leveled, rate-limited logging for the AIO ops. Messages go to stderr and are emitted only up to
+the level set by the DS_AIO_LOG_LEVEL environment variable (error, warning, info or debug, or
+0-3; warning by default). Each call site emits at most DS_AIO_LOG_BURST messages per second and
+reports how many it suppressed in between, so a failing swap loop cannot flood the terminal.
+A call site above the active level costs one relaxed atomic load.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+#define DS_AIO_LOG_ERROR 0
+#define DS_AIO_LOG_WARNING 1
+#define DS_AIO_LOG_INFO 2
+#define DS_AIO_LOG_DEBUG 3
+
+// Messages per call site and second before the site is throttled.
+#define DS_AIO_LOG_BURST 10
+
+extern std::atomic<int> ds_aio_log_level_value;
+
+inline bool ds_aio_log_enabled(const int level)
+{
+    return level <= ds_aio_log_level_value.load(std::memory_order_relaxed);
+}
+
+struct deepspeed_aio_log_site_t {
+    std::mutex _mutex;
+    uint64_t _window_start_ns = 0;
+    int _emitted = 0;
+    int64_t _suppressed = 0;
+
+    // Returns false if the site is throttled. Otherwise returns true and sets the number of
+    // messages dropped since the last emitted one.
+    bool acquire(int64_t& suppressed);
+};
+
+void ds_aio_log_write(const int level, const int64_t suppressed, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define DS_AIO_LOG(level, ...)                                                          \
+    do {                                                                                \
+        if (ds_aio_log_enabled(level)) {                                                \
+            static deepspeed_aio_log_site_t ds_aio_log_site;                            \
+            int64_t ds_aio_log_suppressed;                                              \
+            if (ds_aio_log_site.acquire(ds_aio_log_suppressed)) {                       \
+                ds_aio_log_write(level, ds_aio_log_suppressed, __VA_ARGS__);            \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+extern "C" {
+// Returns the previous level.
+int ds_aio_set_log_level(int level);
+int ds_aio_get_log_level();
+}
@@ -7,6 +7,7 @@
 Functionality for swapping optimizer tensors to/from (NVMe) storage devices.
 */
 
+#include <algorithm>
 #include <cmath>
 
 #include "deepspeed_aio_utils.h"
@@ -57,6 +58,22 @@ void deepspeed_aio_latency_t::scale(const float scaler)
     _avg_usec *= scaler;
 }
 
+deepspeed_aio_op_stats_t::deepspeed_aio_op_stats_t()
+    : _count(0), _bytes(0), _aio_usec(0), _call_usec(0), _max_call_usec(0)
+{
+}
+
+void deepspeed_aio_op_stats_t::record(const long long int num_bytes,
+                                      const double aio_usec,
+                                      const double call_usec)
+{
+    _count += 1;
+    _bytes += num_bytes;
+    _aio_usec += aio_usec;
+    _call_usec += call_usec;
+    _max_call_usec = std::max(_max_call_usec, call_usec);
+}
+
 aio_context::aio_context(const int block_size, const int queue_depth)
 {
     _block_size = block_size;
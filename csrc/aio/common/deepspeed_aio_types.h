@@ -32,6 +32,18 @@ struct deepspeed_aio_perf_t {
     double _e2e_rate_GB;
 };
 
+// Running totals of one kind of handle operation (read, write, pread, pwrite).
+struct deepspeed_aio_op_stats_t {
+    long long int _count;
+    long long int _bytes;
+    double _aio_usec;
+    double _call_usec;
+    double _max_call_usec;
+
+    deepspeed_aio_op_stats_t();
+    void record(const long long int num_bytes, const double aio_usec, const double call_usec);
+};
+
 struct deepspeed_aio_config_t {
     const int _block_size;
     const int _queue_depth;
@@ -8,6 +8,10 @@ Functionality for swapping optimizer tensors to/from (NVMe) storage devices.
 */
 
 #include "deepspeed_aio_thread.h"
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <algorithm>
 
 #if defined(__ENABLE_CANN__)
 #include "torch_npu/csrc/framework/utils/OpAdapter.h"
@@ -27,7 +31,10 @@ io_op_desc_t::io_op_desc_t(const bool read_op,
       _fd(fd),
       _filename(filename),
       _num_bytes(num_bytes),
-      _validate(validate)
+      _validate(validate),
+      _start_time(std::chrono::high_resolution_clock::now()),
+      _iov_bytes(0),
+      _file_offset(0)
 {
     _cpu_buffer = (_buffer.is_cuda() || _buffer.is_xpu()
 #if defined(__ENABLE_CANN__)
@@ -39,6 +46,31 @@ io_op_desc_t::io_op_desc_t(const bool read_op,
     _contiguous_buffer = _cpu_buffer.contiguous();
 }
 
+io_op_desc_t::io_op_desc_t(const std::vector<torch::Tensor>& buffers,
+                           const int fd,
+                           const char* filename,
+                           const long long int num_bytes,
+                           const long long int file_offset)
+    : _read_op(false),
+      _fd(fd),
+      _filename(filename),
+      _num_bytes(num_bytes),
+      _validate(false),
+      _start_time(std::chrono::high_resolution_clock::now()),
+      _iov_buffers(buffers),
+      _iov_bytes(0),
+      _file_offset(file_offset)
+{
+    for (const auto& buffer : _iov_buffers) { _iov_bytes += buffer.nbytes(); }
+}
+
+bool io_op_desc_t::is_vectored() const { return !_iov_buffers.empty(); }
+
+long long int io_op_desc_t::total_bytes(const int num_threads) const
+{
+    return is_vectored() ? _iov_bytes : num_threads * _num_bytes;
+}
+
 char* io_op_desc_t::data_ptr() const { return (char*)_contiguous_buffer.data_ptr(); }
 
 void io_op_desc_t::fini()
@@ -53,6 +85,50 @@ void io_op_desc_t::fini()
 #endif
 }
 
+void io_op_desc_t::write_vectored(const int tid)
+{
+    const auto begin = _num_bytes * tid;
+    const auto end = std::min(begin + _num_bytes, _iov_bytes);
+    if (begin >= end) { return; }
+
+    // The parts of the fragments that fall in the slice of this thread.
+    std::vector<struct iovec> iov;
+    long long int fragment_begin = 0;
+    for (const auto& buffer : _iov_buffers) {
+        const auto fragment_end = fragment_begin + static_cast<long long int>(buffer.nbytes());
+        const auto lo = std::max(begin, fragment_begin);
+        const auto hi = std::min(end, fragment_end);
+        if (lo < hi) {
+            iov.push_back({(char*)buffer.data_ptr() + (lo - fragment_begin), (size_t)(hi - lo)});
+        }
+        fragment_begin = fragment_end;
+    }
+
+    auto file_offset = _file_offset + begin;
+    size_t next = 0;
+    while (next < iov.size()) {
+        const int count = static_cast<int>(std::min(iov.size() - next, (size_t)IOV_MAX));
+        const auto written = ::pwritev(_fd, iov.data() + next, count, file_offset);
+        if (written < 0 && errno == EINTR) { continue; }
+        if (written <= 0) {
+            report_file_error(_filename.c_str(), " pwritev", written < 0 ? errno : EIO);
+            return;
+        }
+        file_offset += written;
+
+        // Skip the written entries and trim a partly written one.
+        size_t remaining = written;
+        while (next < iov.size() && remaining >= iov[next].iov_len) {
+            remaining -= iov[next].iov_len;
+            ++next;
+        }
+        if (remaining > 0) {
+            iov[next].iov_base = (char*)iov[next].iov_base + remaining;
+            iov[next].iov_len -= remaining;
+        }
+    }
+}
+
 deepspeed_aio_thread_t::deepspeed_aio_thread_t(const int tid, deepspeed_aio_config_t& aio_config)
     : _tid(tid),
       _aio_config(aio_config),
@@ -78,7 +154,9 @@ void deepspeed_aio_thread_t::run()
             }
         }
 
-        if (next_io_op) {
+        if (next_io_op && next_io_op->is_vectored()) {
+            next_io_op->write_vectored(_tid);
+        } else if (next_io_op) {
             const auto base_offset = next_io_op->_num_bytes * _tid;
 
             std::unique_ptr<io_xfer_ctxt> xfer_ctxt(new io_xfer_ctxt(
@@ -91,7 +169,9 @@ void deepspeed_aio_thread_t::run()
                 do_aio_operation_sequential(
                     next_io_op->_read_op, _aio_ctxt, xfer_ctxt, &_aio_config, nullptr);
             }
+        }
 
+        if (next_io_op) {
             {
                 std::lock_guard<std::mutex> lock(_complete_sync._mutex);
                 _complete_queue.push(next_io_op);
@@ -7,9 +7,11 @@
 Functionality for swapping optimizer tensors to/from (NVMe) storage devices.
 */
 
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <queue>
+#include <vector>
 #include "deepspeed_py_aio.h"
 
 struct io_op_desc_t {
@@ -21,6 +23,12 @@ struct io_op_desc_t {
     torch::Tensor _cpu_buffer;
     torch::Tensor _contiguous_buffer;
     const bool _validate;
+    const std::chrono::high_resolution_clock::time_point _start_time;
+    // Fragments of a vectored write, stored back to back from _file_offset. Each thread writes
+    // its _num_bytes slice of the fragment bytes.
+    std::vector<torch::Tensor> _iov_buffers;
+    long long int _iov_bytes;
+    const long long int _file_offset;
 
     io_op_desc_t(const bool read_op,
                  const torch::Tensor& buffer,
@@ -29,8 +37,17 @@ struct io_op_desc_t {
                  const long long int num_bytes,
                  const bool validate);
 
+    io_op_desc_t(const std::vector<torch::Tensor>& buffers,
+                 const int fd,
+                 const char* filename,
+                 const long long int num_bytes,
+                 const long long int file_offset);
+
+    bool is_vectored() const;
+    long long int total_bytes(const int num_threads) const;
     char* data_ptr() const;
     void fini();
+    void write_vectored(const int tid);
 };
 
 struct thread_sync_t {
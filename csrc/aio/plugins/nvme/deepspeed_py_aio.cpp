@@ -29,6 +29,7 @@ Functionality for swapping optimizer tensors to/from (NVMe) storage devices.
 #include <string>
 #include <vector>
 
+#include "deepspeed_aio_log.h"
 #include "deepspeed_py_aio.h"
 
 using namespace std;
@@ -73,9 +74,12 @@ namespace DeepSpeedAIO {
 
         const std::chrono::duration<double> fn_time =
             std::chrono::high_resolution_clock::now() - start_time;
-        std::cout << "Elapsed time(usec): "
-                  << "aio = " << aio_time.count() * 1e6 << " call = " << fn_time.count() * 1e6
-                  << std::endl;
+        DS_AIO_LOG(DS_AIO_LOG_DEBUG,
+                   "aio_write %s: %lld bytes, elapsed time(usec) aio = %.1f call = %.1f",
+                   filename,
+                   num_write_bytes,
+                   aio_time.count() * 1e6,
+                   fn_time.count() * 1e6);
         return 0;
     }
 
@@ -119,9 +123,12 @@ namespace DeepSpeedAIO {
 
         const std::chrono::duration<double> fn_time =
             std::chrono::high_resolution_clock::now() - start_time;
-        std::cout << "Elapsed time(usec): "
-                  << "aio = " << aio_time.count() * 1e6 << " call = " << fn_time.count() * 1e6
-                  << std::endl;
+        DS_AIO_LOG(DS_AIO_LOG_DEBUG,
+                   "aio_read %s: %lld bytes, elapsed time(usec) aio = %.1f call = %.1f",
+                   filename,
+                   num_file_bytes,
+                   aio_time.count() * 1e6,
+                   fn_time.count() * 1e6);
         return 0;
     }
 }
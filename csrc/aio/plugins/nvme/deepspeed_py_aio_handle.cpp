@@ -11,9 +11,15 @@ Functionality for swapping optimizer tensors to/from (NVMe) storage devices.
 */
 
 #include "deepspeed_py_aio_handle.h"
+#include <fcntl.h>
+#include "deepspeed_aio_log.h"
+#include "ds_trace.h"
 
 using namespace std;
 
+// O_DIRECT needs file offsets, addresses and lengths aligned to the logical block size.
+static const long long int direct_io_alignment = 4096;
+
 static void _start_aio_thread(std::shared_ptr<struct deepspeed_aio_thread_t> ctxt) { ctxt->run(); }
 
 deepspeed_aio_handle_t::deepspeed_aio_handle_t(const int block_size,
@@ -62,6 +68,7 @@ const int deepspeed_aio_handle_t::get_thread_count() const { return _num_threads
 
 int deepspeed_aio_handle_t::read(torch::Tensor& buffer, const char* filename, const bool validate)
 {
+    DS_TRACE_SPAN("aio", "read", (int64_t)buffer.nbytes());
     const auto start_time = std::chrono::high_resolution_clock::now();
 
     assert(_aio_ctxt);
@@ -93,9 +100,7 @@ int deepspeed_aio_handle_t::read(torch::Tensor& buffer, const char* filename, co
     if (validate) { validate_aio_operation(true, filename, read_buffer, num_file_bytes); }
     const std::chrono::duration<double> fn_time =
         std::chrono::high_resolution_clock::now() - start_time;
-    std::cout << "Elapsed time(usec): "
-              << "aio = " << aio_time.count() * 1e6 << " call = " << fn_time.count() * 1e6
-              << std::endl;
+    _record_op("read", filename, num_file_bytes, aio_time.count() * 1e6, fn_time.count() * 1e6);
     return 0;
 }
 
@@ -103,6 +108,7 @@ int deepspeed_aio_handle_t::write(const torch::Tensor& buffer,
                                   const char* filename,
                                   const bool validate)
 {
+    DS_TRACE_SPAN("aio", "write", (int64_t)buffer.nbytes());
     assert(_aio_ctxt);
 
     const auto start_time = std::chrono::high_resolution_clock::now();
@@ -128,9 +134,7 @@ int deepspeed_aio_handle_t::write(const torch::Tensor& buffer,
 
     const std::chrono::duration<double> fn_time =
         std::chrono::high_resolution_clock::now() - start_time;
-    std::cout << "Elapsed time(usec): "
-              << "aio = " << aio_time.count() * 1e6 << " call = " << fn_time.count() * 1e6
-              << std::endl;
+    _record_op("write", filename, num_write_bytes, aio_time.count() * 1e6, fn_time.count() * 1e6);
     return 0;
 }
 
@@ -144,6 +148,7 @@ void deepspeed_aio_handle_t::_schedule_aio_work(std::shared_ptr<struct io_op_des
         ctxt->_work_sync._cond_var.notify_one();
     }
     _num_pending_ops++;
+    DS_TRACE_COUNTER("aio", "pending_ops", _num_pending_ops);
 }
 
 std::shared_ptr<struct io_op_desc_t> deepspeed_aio_handle_t::_wait_for_aio_work()
@@ -173,11 +178,14 @@ void deepspeed_aio_handle_t::_stop_threads()
 
 int deepspeed_aio_handle_t::wait()
 {
+    DS_TRACE_SPAN("aio", "wait");
     assert(_num_pending_ops > 0);
     auto num_completed_ops = 0;
 
     while (_num_pending_ops > 0) {
         auto completed_op = _wait_for_aio_work();
+        const std::chrono::duration<double> aio_time =
+            std::chrono::high_resolution_clock::now() - completed_op->_start_time;
 
         completed_op->fini();
 
@@ -189,6 +197,15 @@ int deepspeed_aio_handle_t::wait()
                                    completed_op->data_ptr(),
                                    _num_threads * completed_op->_num_bytes);
         }
+        const std::chrono::duration<double> fn_time =
+            std::chrono::high_resolution_clock::now() - completed_op->_start_time;
+        const auto op = completed_op->is_vectored() ? "pwritev"
+                                                    : (completed_op->_read_op ? "pread" : "pwrite");
+        _record_op(op,
+                   completed_op->_filename.c_str(),
+                   completed_op->total_bytes(_num_threads),
+                   aio_time.count() * 1e6,
+                   fn_time.count() * 1e6);
         --_num_pending_ops;
         ++num_completed_ops;
     }
@@ -201,8 +218,11 @@ bool deepspeed_aio_handle_t::_is_valid_parallel_aio_op(const bool read_op,
 {
     const auto op_string = read_op ? "Read" : "Write";
     if (num_bytes % get_thread_count()) {
-        std::cout << "deepspeed_aio failure: parallel " << op_string << " num_bytes = " << num_bytes
-                  << " not divisible by thread count = " << get_thread_count() << std::endl;
+        DS_AIO_LOG(DS_AIO_LOG_ERROR,
+                   "parallel %s num_bytes = %lld not divisible by thread count = %d",
+                   op_string,
+                   num_bytes,
+                   get_thread_count());
         return false;
     }
 
@@ -214,6 +234,7 @@ int deepspeed_aio_handle_t::pread(const torch::Tensor& buffer,
                                   const bool validate,
                                   const bool async)
 {
+    DS_TRACE_SPAN("aio", "pread", (int64_t)buffer.nbytes());
     long long num_file_bytes;
     if (-1 == get_file_size(filename, num_file_bytes)) {
         const auto error_code = errno;
@@ -222,8 +243,11 @@ int deepspeed_aio_handle_t::pread(const torch::Tensor& buffer,
     }
     const auto buffer_bytes = static_cast<long long int>(buffer.nbytes());
     if (buffer_bytes != num_file_bytes) {
-        std::cout << filename << ": buffer nbytes != file bytes " << buffer_bytes
-                  << " != " << num_file_bytes << std::endl;
+        DS_AIO_LOG(DS_AIO_LOG_ERROR,
+                   "%s: buffer nbytes != file bytes %lld != %lld",
+                   filename,
+                   buffer_bytes,
+                   num_file_bytes);
     }
     assert(static_cast<long long int>(buffer.nbytes()) == num_file_bytes);
     assert((num_file_bytes % _num_threads) == 0);
@@ -248,6 +272,7 @@ int deepspeed_aio_handle_t::pwrite(const torch::Tensor& buffer,
                                    const bool validate,
                                    const bool async)
 {
+    DS_TRACE_SPAN("aio", "pwrite", (int64_t)buffer.nbytes());
     const auto num_write_bytes = static_cast<long long int>(buffer.nbytes());
     assert((num_write_bytes % _num_threads) == 0);
 
@@ -266,6 +291,71 @@ int deepspeed_aio_handle_t::pwrite(const torch::Tensor& buffer,
     return wait();
 }
 
+static bool _is_direct_io_aligned(const std::vector<torch::Tensor>& buffers,
+                                  const long long int file_offset)
+{
+#if defined(__ENABLE_CANN__)
+    return false;
+#else
+    if (file_offset % direct_io_alignment) { return false; }
+    for (const auto& buffer : buffers) {
+        if (reinterpret_cast<uintptr_t>(buffer.data_ptr()) % direct_io_alignment ||
+            static_cast<long long int>(buffer.nbytes()) % direct_io_alignment) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+int deepspeed_aio_handle_t::pwritev(const std::vector<torch::Tensor>& buffers,
+                                    const char* filename,
+                                    const long long int file_offset,
+                                    const bool async)
+{
+    long long int num_write_bytes = 0;
+    for (const auto& buffer : buffers) { num_write_bytes += buffer.nbytes(); }
+    DS_TRACE_SPAN("aio", "pwritev", (int64_t)num_write_bytes);
+
+    if (buffers.empty()) {
+        DS_AIO_LOG(DS_AIO_LOG_ERROR, "%s: pwritev without buffers", filename);
+        return -1;
+    }
+    for (const auto& buffer : buffers) {
+        if (!buffer.device().is_cpu() || !buffer.is_contiguous()) {
+            DS_AIO_LOG(DS_AIO_LOG_ERROR,
+                       "%s: pwritev buffers must be contiguous host tensors",
+                       filename);
+            return -1;
+        }
+    }
+
+    // O_DIRECT only when every fragment is aligned, other host tensors go through the page cache.
+    const auto direct_io = _is_direct_io_aligned(buffers, file_offset);
+    const auto flags = O_WRONLY | O_CREAT | (direct_io ? O_DIRECT : 0);
+    const auto fd = open(filename, flags, 0600);
+    if (fd == -1) {
+        const auto error_code = errno;
+        report_file_error(filename, " open for pwritev ", error_code);
+        return -1;
+    }
+
+    // Each thread writes one slice of the fragment bytes, slices stay aligned for O_DIRECT.
+    const auto slice_alignment = direct_io ? direct_io_alignment : 1;
+    const auto thread_bytes = (num_write_bytes + _num_threads - 1) / _num_threads;
+    const auto slice_bytes =
+        (thread_bytes + slice_alignment - 1) / slice_alignment * slice_alignment;
+
+    auto scheduled_op =
+        std::make_shared<io_op_desc_t>(buffers, fd, filename, slice_bytes, file_offset);
+
+    _schedule_aio_work(scheduled_op);
+
+    if (async) { return 0; }
+
+    return wait();
+}
+
 int deepspeed_aio_handle_t::sync_pread(torch::Tensor& buffer, const char* filename)
 {
     return pread(buffer, filename, false, false);
@@ -286,6 +376,63 @@ int deepspeed_aio_handle_t::async_pwrite(const torch::Tensor& buffer, const char
     return pwrite(buffer, filename, false, true);
 }
 
+int deepspeed_aio_handle_t::sync_pwritev(const std::vector<torch::Tensor>& buffers,
+                                         const char* filename,
+                                         const long long int file_offset)
+{
+    return pwritev(buffers, filename, file_offset, false);
+}
+
+int deepspeed_aio_handle_t::async_pwritev(const std::vector<torch::Tensor>& buffers,
+                                          const char* filename,
+                                          const long long int file_offset)
+{
+    return pwritev(buffers, filename, file_offset, true);
+}
+
+void deepspeed_aio_handle_t::_record_op(const char* op,
+                                        const char* filename,
+                                        const long long int num_bytes,
+                                        const double aio_usec,
+                                        const double call_usec)
+{
+    {
+        std::lock_guard<std::mutex> lock(_stats_mutex);
+        _op_stats[op].record(num_bytes, aio_usec, call_usec);
+    }
+    DS_AIO_LOG(DS_AIO_LOG_DEBUG,
+               "%s %s: %lld bytes, elapsed time(usec) aio = %.1f call = %.1f",
+               op,
+               filename,
+               num_bytes,
+               aio_usec,
+               call_usec);
+}
+
+std::vector<std::tuple<std::string, long long int, long long int, double, double, double>>
+deepspeed_aio_handle_t::get_stats()
+{
+    std::lock_guard<std::mutex> lock(_stats_mutex);
+    std::vector<std::tuple<std::string, long long int, long long int, double, double, double>>
+        result;
+    for (const auto& entry : _op_stats) {
+        const auto& stats = entry.second;
+        result.emplace_back(entry.first,
+                            stats._count,
+                            stats._bytes,
+                            stats._aio_usec,
+                            stats._call_usec,
+                            stats._max_call_usec);
+    }
+    return result;
+}
+
+void deepspeed_aio_handle_t::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(_stats_mutex);
+    _op_stats.clear();
+}
+
 at::Tensor deepspeed_aio_handle_t::new_cpu_locked_tensor(const size_t num_elem,
                                                          const torch::Tensor& example_tensor)
 {
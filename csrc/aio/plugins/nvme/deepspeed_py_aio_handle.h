@@ -8,7 +8,12 @@ Functionality for swapping optimizer tensors to/from (NVMe) storage devices.
 */
 
 #include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
 #include "deepspeed_aio_thread.h"
 #include "deepspeed_pin_tensor.h"
 
@@ -24,6 +29,9 @@ struct deepspeed_aio_handle_t {
     int _num_pending_ops;
     std::unique_ptr<struct deepspeed_pin_tensor_t> _pinned_tensor_mgr;
 
+    std::mutex _stats_mutex;
+    std::map<std::string, deepspeed_aio_op_stats_t> _op_stats;
+
     deepspeed_aio_handle_t(const int block_size,
                            const int queue_depth,
                            const bool single_submit,
@@ -60,6 +68,21 @@ struct deepspeed_aio_handle_t {
 
     int async_pwrite(const torch::Tensor& buffer, const char* filename);
 
+    // Writes the host tensors in `buffers` back to back into `filename` from `file_offset`, in
+    // place, without first gathering them into one buffer.
+    int pwritev(const std::vector<torch::Tensor>& buffers,
+                const char* filename,
+                const long long int file_offset,
+                const bool async);
+
+    int sync_pwritev(const std::vector<torch::Tensor>& buffers,
+                     const char* filename,
+                     const long long int file_offset);
+
+    int async_pwritev(const std::vector<torch::Tensor>& buffers,
+                      const char* filename,
+                      const long long int file_offset);
+
     // TODO: Make API's args to be shape and dtype.
     torch::Tensor new_cpu_locked_tensor(const size_t num_elem, const torch::Tensor& example_tensor);
 
@@ -67,6 +90,12 @@ struct deepspeed_aio_handle_t {
 
     int wait();
 
+    // (op, count, bytes, aio_usec, call_usec, max_call_usec) totals per operation kind.
+    std::vector<std::tuple<std::string, long long int, long long int, double, double, double>>
+    get_stats();
+
+    void reset_stats();
+
     void _stop_threads();
 
     void _schedule_aio_work(std::shared_ptr<struct io_op_desc_t> scheduled_op);
@@ -74,4 +103,10 @@ struct deepspeed_aio_handle_t {
     std::shared_ptr<struct io_op_desc_t> _wait_for_aio_work();
 
     bool _is_valid_parallel_aio_op(const bool read_op, const long long int num_bytes);
+
+    void _record_op(const char* op,
+                    const char* filename,
+                    const long long int num_bytes,
+                    const double aio_usec,
+                    const double call_usec);
 };
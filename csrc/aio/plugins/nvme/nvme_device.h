@@ -85,6 +85,18 @@ public:
         aio_handle->async_pwrite(buffer, filename);
     }
 
+    int pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset, const bool async) override {
+        return aio_handle->pwritev(buffers, filename, file_offset, async);
+    }
+
+    int sync_pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset) override {
+        return aio_handle->sync_pwritev(buffers, filename, file_offset);
+    }
+
+    int async_pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset) override {
+        return aio_handle->async_pwritev(buffers, filename, file_offset);
+    }
+
     void new_cpu_locked_tensor(const size_t num_elem, const torch::Tensor& example_tensor) override {
         aio_handle->new_cpu_locked_tensor(num_elem, example_tensor);
     }
@@ -97,6 +109,14 @@ public:
         aio_handle->wait();
     }
 
+    std::vector<std::tuple<std::string, long long int, long long int, double, double, double>> get_stats() override {
+        return aio_handle->get_stats();
+    }
+
+    void reset_stats() override {
+        aio_handle->reset_stats();
+    }
+
 private:
     // Handle for managing AIO operation
     std::unique_ptr<deepspeed_aio_handle_t> aio_handle; 
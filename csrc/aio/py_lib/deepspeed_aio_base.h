@@ -4,6 +4,9 @@
 #include <condition_variable>
 #include <memory>
 #include <stdlib.h>
+#include <string>
+#include <tuple>
+#include <vector>
 #include <torch/extension.h>
 
 using namespace std;
@@ -26,7 +29,14 @@ public:
     virtual void sync_pwrite(const torch::Tensor& buffer, const char* filename) = 0;
     virtual void async_pread(torch::Tensor& buffer, const char* filename) = 0;
     virtual void async_pwrite(const torch::Tensor& buffer, const char* filename) = 0;
+    // Writes the host tensors back to back into the file from file_offset, without gathering them.
+    virtual int pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset, const bool async) = 0;
+    virtual int sync_pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset) = 0;
+    virtual int async_pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset) = 0;
     virtual void new_cpu_locked_tensor(const size_t num_elem, const torch::Tensor& example_tensor) = 0;
     virtual void free_cpu_locked_tensor(torch::Tensor& tensor) = 0;
     virtual void wait() = 0;
+    // (op, count, bytes, aio_usec, call_usec, max_call_usec) totals per operation kind.
+    virtual std::vector<std::tuple<std::string, long long int, long long int, double, double, double>> get_stats() = 0;
+    virtual void reset_stats() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+/*
+Functionality for sub-allocating and caching swap buffers inside pinned slabs.
+*/
+
+#include "deepspeed_swap_buffer_manager.h"
+
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+deepspeed_swap_buffer_manager_t::deepspeed_swap_buffer_manager_t(const vector<int64_t>& slab_bytes,
+                                                                 const int64_t alignment)
+    : _alignment(alignment),
+      _free_blocks(slab_bytes.size()),
+      _next_release_seq(0),
+      _free_bytes(0),
+      _cached_bytes(0)
+{
+    if (alignment <= 0) { throw invalid_argument("alignment must be positive"); }
+    for (size_t slab = 0; slab < slab_bytes.size(); ++slab) {
+        // Trailing bytes that cannot hold an aligned buffer are left out.
+        const auto usable = slab_bytes[slab] / alignment * alignment;
+        if (usable > 0) { _give_back(slab, 0, usable); }
+    }
+}
+
+bool deepspeed_swap_buffer_manager_t::_place(const int64_t num_bytes,
+                                             int64_t& slab,
+                                             int64_t& offset)
+{
+    // Best fit: the smallest free block that holds the buffer, the lowest slab and offset first.
+    auto iter = _free_by_size.lower_bound(make_tuple(num_bytes, int64_t(-1), int64_t(-1)));
+    if (iter == _free_by_size.end()) { return false; }
+
+    const auto block_bytes = get<0>(*iter);
+    slab = get<1>(*iter);
+    offset = get<2>(*iter);
+    _free_by_size.erase(iter);
+    _free_blocks[slab].erase(offset);
+    if (block_bytes > num_bytes) {
+        _free_blocks[slab][offset + num_bytes] = block_bytes - num_bytes;
+        _free_by_size.insert(make_tuple(block_bytes - num_bytes, slab, offset + num_bytes));
+    }
+    _free_bytes -= num_bytes;
+    return true;
+}
+
+void deepspeed_swap_buffer_manager_t::_give_back(const int64_t slab,
+                                                 const int64_t offset,
+                                                 const int64_t num_bytes)
+{
+    auto& blocks = _free_blocks[slab];
+    auto begin = offset;
+    auto end = offset + num_bytes;
+
+    auto next = blocks.lower_bound(offset);
+    if (next != blocks.end() && next->first == end) {
+        end += next->second;
+        _free_by_size.erase(make_tuple(next->second, slab, next->first));
+        next = blocks.erase(next);
+    }
+    if (next != blocks.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == begin) {
+            begin = prev->first;
+            _free_by_size.erase(make_tuple(prev->second, slab, prev->first));
+            blocks.erase(prev);
+        }
+    }
+
+    blocks[begin] = end - begin;
+    _free_by_size.insert(make_tuple(end - begin, slab, begin));
+    _free_bytes += num_bytes;
+}
+
+void deepspeed_swap_buffer_manager_t::_drop(unordered_map<int64_t, entry_t>::iterator iter)
+{
+    const auto& entry = iter->second;
+    if (entry.cached) {
+        _lru.erase(entry.release_seq);
+        _cached_bytes -= entry.num_bytes;
+    }
+    _give_back(entry.slab, entry.offset, entry.num_bytes);
+    _entries.erase(iter);
+}
+
+tuple<int64_t, int64_t, vector<int64_t>> deepspeed_swap_buffer_manager_t::allocate(
+    const int64_t key,
+    const int64_t num_bytes)
+{
+    if (num_bytes <= 0) { throw invalid_argument("num_bytes must be positive"); }
+    auto existing = _entries.find(key);
+    if (existing != _entries.end()) {
+        if (!existing->second.cached) {
+            throw invalid_argument("key " + to_string(key) + " already has a buffer in use");
+        }
+        // A stale cached copy is replaced.
+        _drop(existing);
+    }
+
+    const auto aligned_bytes = (num_bytes + _alignment - 1) / _alignment * _alignment;
+    vector<int64_t> evicted;
+    int64_t slab = -1;
+    int64_t offset = -1;
+    while (!_place(aligned_bytes, slab, offset)) {
+        if (_lru.empty()) { return make_tuple(int64_t(-1), int64_t(-1), evicted); }
+        const auto victim = _lru.begin()->second;
+        _drop(_entries.find(victim));
+        evicted.push_back(victim);
+    }
+
+    _entries[key] = {slab, offset, aligned_bytes, false, 0};
+    return make_tuple(slab, offset, evicted);
+}
+
+bool deepspeed_swap_buffer_manager_t::acquire(const int64_t key)
+{
+    auto iter = _entries.find(key);
+    if (iter == _entries.end() || !iter->second.cached) { return false; }
+
+    auto& entry = iter->second;
+    _lru.erase(entry.release_seq);
+    _cached_bytes -= entry.num_bytes;
+    entry.cached = false;
+    return true;
+}
+
+void deepspeed_swap_buffer_manager_t::release(const int64_t key, const bool clean)
+{
+    auto iter = _entries.find(key);
+    if (iter == _entries.end() || iter->second.cached) {
+        throw invalid_argument("key " + to_string(key) + " has no buffer in use");
+    }
+    if (!clean) {
+        _drop(iter);
+        return;
+    }
+
+    auto& entry = iter->second;
+    entry.cached = true;
+    entry.release_seq = _next_release_seq++;
+    _lru[entry.release_seq] = key;
+    _cached_bytes += entry.num_bytes;
+}
+
+bool deepspeed_swap_buffer_manager_t::free(const int64_t key)
+{
+    auto iter = _entries.find(key);
+    if (iter == _entries.end()) { return false; }
+    _drop(iter);
+    return true;
+}
+
+vector<int64_t> deepspeed_swap_buffer_manager_t::evict_all()
+{
+    vector<int64_t> evicted;
+    while (!_lru.empty()) {
+        const auto victim = _lru.begin()->second;
+        _drop(_entries.find(victim));
+        evicted.push_back(victim);
+    }
+    return evicted;
+}
+
+int64_t deepspeed_swap_buffer_manager_t::count_fits(const vector<int64_t>& keys,
+                                                    const vector<int64_t>& num_bytes) const
+{
+    if (keys.size() != num_bytes.size()) {
+        throw invalid_argument("keys and num_bytes must have the same length");
+    }
+
+    // Replay the requests on a copy, so the evictions match those of allocate.
+    auto trial = *this;
+    int64_t count = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!trial.acquire(keys[i]) && get<0>(trial.allocate(keys[i], num_bytes[i])) < 0) {
+            break;
+        }
+        ++count;
+    }
+    return count;
+}
+
+bool deepspeed_swap_buffer_manager_t::is_cached(const int64_t key) const
+{
+    auto iter = _entries.find(key);
+    return iter != _entries.end() && iter->second.cached;
+}
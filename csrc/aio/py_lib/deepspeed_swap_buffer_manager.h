@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+/*
+Bookkeeping of the pinned swap buffers of the NVMe parameter swapper. Buffers of any size are
+carved out of a few large slabs instead of a fixed pool of equally sized buffers. A released
+buffer whose contents match its swap file stays cached until its space is needed, the least
+recently released first, so swapping the partition in again needs no read.
+
+Only offsets are managed here, the slabs themselves are pinned tensors owned by the swapper.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+struct deepspeed_swap_buffer_manager_t {
+    deepspeed_swap_buffer_manager_t(const std::vector<int64_t>& slab_bytes,
+                                    const int64_t alignment);
+
+    // Places `num_bytes` for `key`, evicting cached buffers as needed. Returns the slab and the
+    // byte offset of the buffer, slab -1 if it does not fit, and the keys of evicted buffers.
+    std::tuple<int64_t, int64_t, std::vector<int64_t>> allocate(const int64_t key,
+                                                                const int64_t num_bytes);
+
+    // Takes the cached buffer of `key` back into use, returns false if it is not cached.
+    bool acquire(const int64_t key);
+
+    // Ends the use of the buffer of `key`; a clean buffer is cached, any other is freed.
+    void release(const int64_t key, const bool clean);
+
+    // Frees the buffer of `key`, cached or not. Returns false if `key` has no buffer.
+    bool free(const int64_t key);
+
+    // Frees all cached buffers and returns their keys.
+    std::vector<int64_t> evict_all();
+
+    // Number of the leading (key, num_bytes) requests that would be placed in turn, counting
+    // cached keys as placed.
+    int64_t count_fits(const std::vector<int64_t>& keys,
+                       const std::vector<int64_t>& num_bytes) const;
+
+    bool is_cached(const int64_t key) const;
+    int64_t free_bytes() const { return _free_bytes; }
+    int64_t cached_bytes() const { return _cached_bytes; }
+    int64_t num_cached() const { return static_cast<int64_t>(_lru.size()); }
+
+private:
+    struct entry_t {
+        int64_t slab;
+        int64_t offset;
+        int64_t num_bytes;
+        bool cached;
+        uint64_t release_seq;
+    };
+
+    bool _place(const int64_t num_bytes, int64_t& slab, int64_t& offset);
+    void _give_back(const int64_t slab, const int64_t offset, const int64_t num_bytes);
+    void _drop(std::unordered_map<int64_t, entry_t>::iterator iter);
+
+    int64_t _alignment;
+    // Free blocks of every slab by offset, for coalescing, and of all slabs by size, for best fit.
+    std::vector<std::map<int64_t, int64_t>> _free_blocks;
+    std::set<std::tuple<int64_t, int64_t, int64_t>> _free_by_size;
+    std::unordered_map<int64_t, entry_t> _entries;
+    // Cached keys in release order.
+    std::map<uint64_t, int64_t> _lru;
+    uint64_t _next_release_seq;
+    int64_t _free_bytes;
+    int64_t _cached_bytes;
+};
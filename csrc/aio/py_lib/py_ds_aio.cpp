@@ -1,7 +1,9 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 #include <torch/extension.h>
 #include "trampoline.h"  // Include the header file for your Trampoline class
+#include "deepspeed_swap_buffer_manager.h"
 
 namespace py = pybind11;
 
@@ -39,9 +41,14 @@ PYBIND11_MODULE(py_ds_trampoline, m) {
         .def("sync_pwrite", &Trampoline::sync_pwrite)
         .def("async_pread", &Trampoline::async_pread)
         .def("async_pwrite", &Trampoline::async_pwrite)
+        .def("pwritev", &handle::pwritev)
+        .def("sync_pwritev", &handle::sync_pwritev)
+        .def("async_pwritev", &handle::async_pwritev)
         .def("new_cpu_locked_tensor", &Trampoline::new_cpu_locked_tensor)
         .def("free_cpu_locked_tensor", &Trampoline::free_cpu_locked_tensor)
-        .def("wait", &Trampoline::wait);
+        .def("wait", &Trampoline::wait)
+        .def("get_stats", &handle::get_stats)
+        .def("reset_stats", &handle::reset_stats);
 
     py::class_<Trampoline, std::shared_ptr<Trampoline>>(m, "Trampoline")
         .def(py::init<const std::string&>())
@@ -50,4 +57,17 @@ PYBIND11_MODULE(py_ds_trampoline, m) {
         .def("aio_read", &Trampoline::aio_read)
         .def("aio_write", &Trampoline::aio_write)
         .def("deepspeed_memcpy", &Trampoline::deepspeed_memcpy);
+
+    py::class_<deepspeed_swap_buffer_manager_t>(m, "swap_buffer_manager")
+        .def(py::init<const std::vector<int64_t>&, const int64_t>())
+        .def("allocate", &deepspeed_swap_buffer_manager_t::allocate)
+        .def("acquire", &deepspeed_swap_buffer_manager_t::acquire)
+        .def("release", &deepspeed_swap_buffer_manager_t::release)
+        .def("free", &deepspeed_swap_buffer_manager_t::free)
+        .def("evict_all", &deepspeed_swap_buffer_manager_t::evict_all)
+        .def("count_fits", &deepspeed_swap_buffer_manager_t::count_fits)
+        .def("is_cached", &deepspeed_swap_buffer_manager_t::is_cached)
+        .def("free_bytes", &deepspeed_swap_buffer_manager_t::free_bytes)
+        .def("cached_bytes", &deepspeed_swap_buffer_manager_t::cached_bytes)
+        .def("num_cached", &deepspeed_swap_buffer_manager_t::num_cached);
 }
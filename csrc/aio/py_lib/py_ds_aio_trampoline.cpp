@@ -110,6 +110,35 @@ void handle::async_pwrite(const torch::Tensor& buffer, const char* filename)
         std::cerr << "No device loaded for async_pwrite\n";
 }
 
+int handle::pwritev(const std::vector<torch::Tensor>& buffers,
+                    const char* filename,
+                    const long long int file_offset,
+                    const bool async)
+{
+    if (device)
+        return device->pwritev(buffers, filename, file_offset, async);
+    std::cerr << "No device loaded for pwritev\n";
+    return -1;
+}
+int handle::sync_pwritev(const std::vector<torch::Tensor>& buffers,
+                         const char* filename,
+                         const long long int file_offset)
+{
+    if (device)
+        return device->sync_pwritev(buffers, filename, file_offset);
+    std::cerr << "No device loaded for sync_pwritev\n";
+    return -1;
+}
+int handle::async_pwritev(const std::vector<torch::Tensor>& buffers,
+                          const char* filename,
+                          const long long int file_offset)
+{
+    if (device)
+        return device->async_pwritev(buffers, filename, file_offset);
+    std::cerr << "No device loaded for async_pwritev\n";
+    return -1;
+}
+
 void handle::new_cpu_locked_tensor(const size_t num_elem, const torch::Tensor& example_tensor)
 {
     if (device)
@@ -133,6 +162,21 @@ void handle::wait()
         std::cerr << "No device loaded for wait\n";
 }
 
+std::vector<std::tuple<std::string, long long int, long long int, double, double, double>> handle::get_stats()
+{
+    if (device)
+        return device->get_stats();
+    std::cerr << "No device loaded for get_stats\n";
+    return {};
+}
+void handle::reset_stats()
+{
+    if (device)
+        device->reset_stats();
+    else
+        std::cerr << "No device loaded for reset_stats\n";
+}
+
 
 Trampoline::Trampoline(const std::string& device_type) : device(nullptr), handle_(nullptr) {
     load_device(device_type);
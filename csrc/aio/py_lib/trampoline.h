@@ -28,11 +28,18 @@ public:
     void async_pread(torch::Tensor& buffer, const char* filename);
     void async_pwrite(const torch::Tensor& buffer, const char* filename);
 
+    int pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset, const bool async);
+    int sync_pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset);
+    int async_pwritev(const std::vector<torch::Tensor>& buffers, const char* filename, const long long int file_offset);
+
     void new_cpu_locked_tensor(const size_t num_elem, const torch::Tensor& example_tensor);
     void free_cpu_locked_tensor(torch::Tensor& tensor);
 
     void wait();
 
+    std::vector<std::tuple<std::string, long long int, long long int, double, double, double>> get_stats();
+    void reset_stats();
+
 private:
     std::shared_ptr<Trampoline> trampoline_;
 };
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "ds_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define DS_TRACE_EXPORT __attribute__((visibility("default")))
+
+struct Trace_Event {
+    const char* category;
+    const char* name;
+    char phase;
+    uint64_t ts_ns;
+    uint64_t dur_ns;
+    int64_t value;
+};
+
+// Only the owning thread appends, so its mutex is uncontended except while collecting.
+struct Trace_Thread_Buffer {
+    std::mutex mutex;
+    uint32_t tid;
+    std::vector<Trace_Event> events;
+};
+
+static bool trace_enabled_from_env()
+{
+    const char* value = getenv("DS_NATIVE_TRACE");
+    return value != nullptr && value[0] != '\0' && value[0] != '0';
+}
+
+std::atomic<bool> ds_trace_enabled_flag(trace_enabled_from_env());
+
+static std::atomic<int64_t> dropped_events(0);
+static std::mutex buffer_registry_mutex;
+static std::vector<std::unique_ptr<Trace_Thread_Buffer>> buffer_registry;
+static thread_local Trace_Thread_Buffer* thread_buffer = nullptr;
+static std::string collected_json;
+
+static Trace_Thread_Buffer* get_thread_buffer()
+{
+    if (thread_buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(buffer_registry_mutex);
+        buffer_registry.emplace_back(new Trace_Thread_Buffer());
+        thread_buffer = buffer_registry.back().get();
+        thread_buffer->tid = (uint32_t)syscall(SYS_gettid);
+    }
+    return thread_buffer;
+}
+
+static void append_event(const Trace_Event& event)
+{
+    Trace_Thread_Buffer* buffer = get_thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->events.size() >= DS_TRACE_MAX_THREAD_EVENTS) {
+        dropped_events.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events.push_back(event);
+}
+
+uint64_t ds_trace_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void ds_trace_complete(const char* category,
+                       const char* name,
+                       uint64_t start_ns,
+                       uint64_t end_ns,
+                       int64_t bytes)
+{
+    append_event({category, name, 'X', start_ns, end_ns - start_ns, bytes});
+}
+
+void ds_trace_counter(const char* category, const char* name, int64_t value)
+{
+    append_event({category, name, 'C', ds_trace_now_ns(), 0, value});
+}
+
+static void format_event(std::string& out, const Trace_Event& event, int pid, uint32_t tid)
+{
+    char line[512];
+    int len;
+    if (event.phase == 'X') {
+        len = snprintf(line,
+                       sizeof(line),
+                       "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                       "\"pid\":%d,\"tid\":%u",
+                       event.name,
+                       event.category,
+                       event.ts_ns / 1e3,
+                       event.dur_ns / 1e3,
+                       pid,
+                       tid);
+        if (event.value >= 0 && len < (int)sizeof(line)) {
+            len += snprintf(line + len,
+                            sizeof(line) - len,
+                            ",\"args\":{\"bytes\":%lld}",
+                            (long long)event.value);
+        }
+    } else {
+        len = snprintf(line,
+                       sizeof(line),
+                       "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,"
+                       "\"tid\":%u,\"args\":{\"%s\":%lld}",
+                       event.name,
+                       event.category,
+                       event.ts_ns / 1e3,
+                       pid,
+                       tid,
+                       event.name,
+                       (long long)event.value);
+    }
+    if (len >= (int)sizeof(line) - 1) return;
+    if (!out.empty()) out += ',';
+    out.append(line, len);
+    out += '}';
+}
+
+extern "C" {
+
+DS_TRACE_EXPORT int ds_trace_set_enabled(int enabled)
+{
+    return ds_trace_enabled_flag.exchange(enabled != 0, std::memory_order_relaxed);
+}
+
+DS_TRACE_EXPORT int ds_trace_is_enabled() { return ds_trace_enabled(); }
+
+DS_TRACE_EXPORT const char* ds_trace_collect_json()
+{
+    const int pid = (int)getpid();
+    std::lock_guard<std::mutex> lock(buffer_registry_mutex);
+    collected_json.clear();
+    for (auto& buffer : buffer_registry) {
+        std::vector<Trace_Event> events;
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            events.swap(buffer->events);
+        }
+        for (const auto& event : events) format_event(collected_json, event, pid, buffer->tid);
+    }
+    return collected_json.c_str();
+}
+
+DS_TRACE_EXPORT int64_t ds_trace_dropped_events() { return dropped_events.exchange(0); }
+}
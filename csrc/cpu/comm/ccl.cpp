@@ -16,6 +16,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <oneapi/ccl.hpp>
+#include "ds_trace.h"
 
 // states for collectives
 enum coll_state {
@@ -481,6 +482,7 @@ ccl::reduction get_ccl_reduce_op(py::object op, at::Tensor& input)
 
 void broadcast(torch::Tensor& data, int src, std::vector<int> group, bool async_op)
 {
+    DS_TRACE_SPAN("comm", "broadcast", (int64_t)data.nbytes());
     CCLCHECK(ccl::broadcast(data.data_ptr(),
                             data.numel(),
                             get_ccl_datatype(data.scalar_type()),
@@ -492,6 +494,7 @@ void broadcast(torch::Tensor& data, int src, std::vector<int> group, bool async_
 // TODO: implement torch's async_op behavior, document it.
 void all_reduce(torch::Tensor& data, py::object op, std::vector<int> group, bool async_op)
 {
+    DS_TRACE_SPAN("comm", "all_reduce", (int64_t)data.nbytes());
     CCLCHECK(ccl::allreduce(data.data_ptr(),
                             data.data_ptr(),
                             data.numel(),
@@ -507,6 +510,7 @@ void all_reduce_caching(torch::Tensor& data,
                         std::vector<int> group,
                         bool async_op)
 {
+    DS_TRACE_SPAN("comm", "all_reduce_caching", (int64_t)data.nbytes());
     ccl::allreduce_attr attr = ccl::default_allreduce_attr;
     auto match_str = ccl::v1::string(match_id);
     attr.template set<ccl::operation_attr_id::to_cache>(true);
@@ -539,6 +543,7 @@ static void parallel_memcpy(void* to, void* from, size_t n_bytes)
 
 void inference_all_reduce(torch::Tensor& data, py::object op, bool async_op)
 {
+    DS_TRACE_SPAN("comm", "inference_all_reduce", (int64_t)data.nbytes());
     static py::object ReduceOp = py::module_::import("deepspeed.comm").attr("ReduceOp");
     static auto ReduceOpSum = (int)py::int_(ReduceOp.attr("SUM").attr("value"));
 
@@ -612,6 +617,7 @@ void inference_all_reduce(torch::Tensor& data, py::object op, bool async_op)
 
 void barrier(std::vector<int> group, bool async_op)
 {
+    DS_TRACE_SPAN("comm", "barrier");
     CCLCHECK(ccl::barrier(_get_comm_from_group(group)).wait());
 }
 
@@ -0,0 +1,570 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+/*
+CPU implementation of the DeepSpeed training transformer layer. It mirrors ds_transformer_cuda.cpp:
+the same create/forward/backward bindings, the same saved activations in the same order and
+layout, and the same fused epilogues (bias + gelu, bias + dropout + residual, layer norm backward
+fused with the residual gradient). GEMMs go through ATen, which dispatches to the CPU BLAS, and the
+elementwise work runs in the OpenMP kernels of transformer_kernels_cpu.cpp. Only fp32 is supported.
+*/
+
+#include <torch/extension.h>
+
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "cpu_transformer_layers.h"
+
+#define CHECK_CPU(x) AT_ASSERTM(!x.is_cuda(), #x " must be a CPU tensor")
+#define CHECK_CONTIGUOUS(x) AT_ASSERTM(x.is_contiguous(), #x " must be contiguous")
+#define CHECK_INPUT(x) \
+    CHECK_CPU(x);      \
+    CHECK_CONTIGUOUS(x)
+
+// Dropout seed and element offset shared by all layers, as in TrainingContext
+static uint64_t s_dropout_seed = 42;
+static uint64_t s_dropout_offset = 0;
+
+static uint64_t next_dropout_offset(int64_t size)
+{
+    const uint64_t offset = s_dropout_offset;
+    s_dropout_offset += (uint64_t)size;
+    return offset;
+}
+
+struct BertTransformerLayerCPU {
+    unsigned layer_id;
+    unsigned hidden_size;
+    unsigned heads;
+    unsigned intermediate_size;
+    float attn_dropout_ratio;
+    float hidden_dropout_ratio;
+    float layer_norm_eps;
+    bool pre_or_postLayerNorm;
+    bool attn_dropout_checkpoint;
+    bool normalize_invertible;
+    bool gelu_checkpoint;
+};
+
+static std::unordered_map<int, std::shared_ptr<BertTransformerLayerCPU>> s_transformer_layers;
+
+static float* fptr(const torch::Tensor& t) { return (float*)t.data_ptr(); }
+static uint8_t* mptr(const torch::Tensor& t) { return (uint8_t*)t.data_ptr(); }
+
+int create_transformer_layer(unsigned layer_id,
+                             unsigned batch_size,
+                             unsigned hidden_dim,
+                             unsigned num_heads,
+                             unsigned intermediate_size,
+                             float attn_dropout_ratio,
+                             float hidden_dropout_ratio,
+                             float layer_norm_eps,
+                             int seed,
+                             bool pre_or_postLayerNorm,
+                             bool test_gemm,
+                             bool attn_dropout_checkpoint,
+                             bool normalize_invertible,
+                             bool gelu_checkpoint,
+                             bool stochastic_mode)
+{
+    TORCH_CHECK(hidden_dim % num_heads == 0, "hidden size must be divisible by the number of heads");
+    s_dropout_seed = (uint64_t)seed;
+
+    auto layer = std::make_shared<BertTransformerLayerCPU>();
+    layer->layer_id = layer_id;
+    layer->hidden_size = hidden_dim;
+    layer->heads = num_heads;
+    layer->intermediate_size = intermediate_size;
+    layer->attn_dropout_ratio = attn_dropout_ratio;
+    layer->hidden_dropout_ratio = hidden_dropout_ratio;
+    layer->layer_norm_eps = layer_norm_eps;
+    layer->pre_or_postLayerNorm = pre_or_postLayerNorm;
+    layer->attn_dropout_checkpoint = attn_dropout_checkpoint;
+    layer->normalize_invertible = normalize_invertible;
+    layer->gelu_checkpoint = gelu_checkpoint;
+
+    s_transformer_layers[layer_id] = layer;
+
+    return 0;
+}
+
+std::vector<torch::Tensor> ds_transformer_forward(unsigned layer_id,
+                                                  const torch::Tensor& input,
+                                                  const torch::Tensor& input_mask,
+                                                  const torch::Tensor& attn_qkvw,
+                                                  const torch::Tensor& attn_qkvb,
+                                                  const torch::Tensor& attn_ow,
+                                                  const torch::Tensor& attn_ob,
+                                                  const torch::Tensor& attn_nw,
+                                                  const torch::Tensor& attn_nb,
+                                                  const torch::Tensor& inter_w,
+                                                  const torch::Tensor& inter_b,
+                                                  const torch::Tensor& output_w,
+                                                  const torch::Tensor& output_b,
+                                                  const torch::Tensor& norm_w,
+                                                  const torch::Tensor& norm_b,
+                                                  bool training_mode,
+                                                  bool prelayernorm,
+                                                  bool attn_dropout_checkpoint,
+                                                  bool normalize_invertible,
+                                                  bool gelu_checkpoint)
+{
+    CHECK_INPUT(input);
+    CHECK_INPUT(input_mask);
+    CHECK_INPUT(attn_qkvw);
+    CHECK_INPUT(attn_qkvb);
+    CHECK_INPUT(attn_ow);
+    CHECK_INPUT(attn_ob);
+    CHECK_INPUT(attn_nw);
+    CHECK_INPUT(attn_nb);
+    CHECK_INPUT(inter_w);
+    CHECK_INPUT(inter_b);
+    CHECK_INPUT(output_w);
+    CHECK_INPUT(output_b);
+    CHECK_INPUT(norm_w);
+    CHECK_INPUT(norm_b);
+    TORCH_CHECK(input.scalar_type() == torch::kFloat, "the CPU transformer layer only supports fp32");
+
+    std::shared_ptr<BertTransformerLayerCPU> layer = s_transformer_layers[layer_id];
+
+    const int bsz = input.size(0);
+    const int seq_len = input.size(1);
+    const int hidden = layer->hidden_size;
+    const int heads = layer->heads;
+    const int head_size = hidden / heads;
+    const int intermediate = layer->intermediate_size;
+    const int64_t bsz_seq = (int64_t)bsz * seq_len;
+    const int64_t bsz_heads = (int64_t)bsz * heads;
+    const float eps = layer->layer_norm_eps;
+    const bool prob_dropout = training_mode && layer->attn_dropout_ratio > 0;
+    const bool hidden_dropout = training_mode && layer->hidden_dropout_ratio > 0;
+
+    auto options = torch::TensorOptions().dtype(torch::kFloat).requires_grad(true);
+    auto uint8_options = torch::TensorOptions().dtype(torch::kInt8).requires_grad(false);
+
+    auto output = torch::empty_like(input);
+    auto inp_norm = ((prelayernorm || !normalize_invertible) ? torch::empty_like(input) : output);
+    auto add_res = (normalize_invertible ? inp_norm : torch::empty_like(input));
+    auto attn_o_inp = torch::empty_like(input);
+    auto qkv_tf = torch::empty({bsz_seq, output_w.size(0) * 3}, options);
+
+    auto attn_prob_dropout_mask = torch::empty({bsz_heads * seq_len, seq_len}, uint8_options);
+    auto attn_output_dropout_mask = torch::empty({bsz_seq, hidden}, uint8_options);
+    auto layer_output_dropout_mask = torch::empty({bsz_seq, hidden}, uint8_options);
+
+    auto attn_layer_norm_var = torch::empty({bsz_seq}, options);
+    auto attn_layer_norm_mean = torch::empty({bsz_seq}, options);
+    auto layer_norm_var = torch::empty({bsz_seq}, options);
+    auto layer_norm_mean = torch::empty({bsz_seq}, options);
+
+    torch::Tensor ff2_inp = torch::empty({bsz_seq, output_w.size(1)}, options);
+    torch::Tensor gelu_inp =
+        (gelu_checkpoint ? ff2_inp : torch::empty({bsz_seq, output_w.size(1)}, options));
+    auto ff1_inp = torch::empty_like(input);
+
+    torch::Tensor soft_out = torch::empty({bsz_heads * seq_len, seq_len}, options);
+    torch::Tensor ctx_bufB =
+        (attn_dropout_checkpoint ? soft_out : torch::empty({bsz_heads * seq_len, seq_len}, options));
+
+    const auto x = input.view({bsz_seq, hidden});
+
+    torch::NoGradGuard no_grad;
+
+    if (layer->pre_or_postLayerNorm) {
+        cpu_layer_norm(fptr(inp_norm),
+                       fptr(layer_norm_var),
+                       normalize_invertible ? nullptr : fptr(layer_norm_mean),
+                       fptr(input),
+                       fptr(norm_w),
+                       fptr(norm_b),
+                       bsz_seq,
+                       hidden,
+                       eps);
+    }
+
+    // qkv projection, bias add and split into heads
+    auto qkv = torch::mm(layer->pre_or_postLayerNorm ? inp_norm.view({bsz_seq, hidden}) : x,
+                         attn_qkvw.t());
+    cpu_bias_add_transform_0213(
+        fptr(qkv_tf), fptr(qkv), fptr(attn_qkvb), bsz, seq_len, hidden, heads);
+    auto qkv_heads = qkv_tf.view({3, bsz_heads, seq_len, head_size});
+    auto q = qkv_heads[0];
+    auto k = qkv_heads[1];
+    auto v = qkv_heads[2];
+
+    // attention scores, softmax + mask
+    auto scores = soft_out.view({bsz_heads, seq_len, seq_len});
+    at::baddbmm_out(scores, scores, q, k.transpose(1, 2), 0.0, 1.0 / std::sqrt((float)head_size));
+    cpu_attn_softmax(fptr(soft_out), fptr(input_mask), bsz, heads, seq_len);
+
+    // attn prob dropout
+    torch::Tensor probs = soft_out;
+    if (prob_dropout) {
+        probs = attn_dropout_checkpoint ? torch::empty_like(soft_out) : ctx_bufB;
+        cpu_dropout(fptr(probs),
+                    fptr(soft_out),
+                    mptr(attn_prob_dropout_mask),
+                    soft_out.numel(),
+                    layer->attn_dropout_ratio,
+                    s_dropout_seed,
+                    next_dropout_offset(soft_out.numel()));
+    }
+
+    // attention context
+    auto context = torch::bmm(probs.view({bsz_heads, seq_len, seq_len}), v);
+    cpu_transform4d_0213(fptr(attn_o_inp), fptr(context), bsz, heads, seq_len, hidden, 1);
+
+    // attn output, bias + dropout + residual
+    auto attn_out = torch::mm(attn_o_inp.view({bsz_seq, hidden}), attn_ow.t());
+    torch::Tensor add_res_buf = (normalize_invertible ? torch::empty_like(input) : add_res);
+    cpu_bias_dropout_residual(fptr(add_res_buf),
+                              fptr(attn_out),
+                              fptr(input),
+                              fptr(attn_ob),
+                              hidden_dropout ? mptr(attn_output_dropout_mask) : nullptr,
+                              bsz_seq,
+                              hidden,
+                              layer->hidden_dropout_ratio,
+                              s_dropout_seed,
+                              next_dropout_offset(hidden_dropout ? bsz_seq * hidden : 0));
+
+    cpu_layer_norm(fptr(ff1_inp),
+                   fptr(attn_layer_norm_var),
+                   normalize_invertible ? nullptr : fptr(attn_layer_norm_mean),
+                   fptr(add_res_buf),
+                   fptr(attn_nw),
+                   fptr(attn_nb),
+                   bsz_seq,
+                   hidden,
+                   eps);
+
+    // ff1, bias + gelu
+    torch::Tensor pre_gelu = (gelu_checkpoint ? ff2_inp : gelu_inp);
+    torch::mm_out(pre_gelu, ff1_inp.view({bsz_seq, hidden}), inter_w.t());
+    torch::Tensor gelu_out = (gelu_checkpoint ? torch::empty_like(ff2_inp) : ff2_inp);
+    cpu_bias_gelu(fptr(gelu_out), fptr(pre_gelu), fptr(inter_b), bsz_seq, intermediate);
+
+    // ff2, bias + dropout + residual
+    auto ff2_out = torch::mm(gelu_out, output_w.t());
+    cpu_bias_dropout_residual(
+        layer->pre_or_postLayerNorm ? fptr(output) : fptr(inp_norm),
+        fptr(ff2_out),
+        layer->pre_or_postLayerNorm ? fptr(add_res_buf) : fptr(ff1_inp),
+        fptr(output_b),
+        hidden_dropout ? mptr(layer_output_dropout_mask) : nullptr,
+        bsz_seq,
+        hidden,
+        layer->hidden_dropout_ratio,
+        s_dropout_seed,
+        next_dropout_offset(hidden_dropout ? bsz_seq * hidden : 0));
+
+    if (!layer->pre_or_postLayerNorm) {
+        cpu_layer_norm(fptr(output),
+                       fptr(layer_norm_var),
+                       normalize_invertible ? nullptr : fptr(layer_norm_mean),
+                       fptr(inp_norm),
+                       fptr(norm_w),
+                       fptr(norm_b),
+                       bsz_seq,
+                       hidden,
+                       eps);
+    }
+
+    return {output,
+            inp_norm,
+            qkv_tf,
+            soft_out,
+            ctx_bufB,
+            attn_o_inp,
+            add_res,
+            ff1_inp,
+            gelu_inp,
+            ff2_inp,
+            attn_prob_dropout_mask,
+            attn_output_dropout_mask,
+            layer_output_dropout_mask,
+            attn_layer_norm_var,
+            attn_layer_norm_mean,
+            layer_norm_var,
+            layer_norm_mean};
+}
+
+std::vector<torch::Tensor> ds_transformer_backward(unsigned layer_id,
+                                                   const torch::Tensor& grad_output,
+                                                   const torch::Tensor& output,
+                                                   const torch::Tensor& inp_norm,
+                                                   const torch::Tensor& qkv_tf,
+                                                   const torch::Tensor& soft_out,
+                                                   const torch::Tensor& ctx_bufB,
+                                                   const torch::Tensor& attn_o_inp,
+                                                   const torch::Tensor& add_res,
+                                                   const torch::Tensor& ff1_inp,
+                                                   const torch::Tensor& gelu_inp,
+                                                   const torch::Tensor& ff2_inp,
+                                                   const torch::Tensor& attn_prob_dropout_mask,
+                                                   const torch::Tensor& attn_output_dropout_mask,
+                                                   const torch::Tensor& layer_output_dropout_mask,
+                                                   const torch::Tensor& attn_layer_norm_var,
+                                                   const torch::Tensor& attn_layer_norm_mean,
+                                                   const torch::Tensor& layer_norm_var,
+                                                   const torch::Tensor& layer_norm_mean,
+                                                   const torch::Tensor& input,
+                                                   const torch::Tensor& input_mask,
+                                                   const torch::Tensor& attn_qkvw,
+                                                   const torch::Tensor& attn_qkvb,
+                                                   const torch::Tensor& attn_ow,
+                                                   const torch::Tensor& attn_ob,
+                                                   const torch::Tensor& attn_nw,
+                                                   const torch::Tensor& attn_nb,
+                                                   const torch::Tensor& inter_w,
+                                                   const torch::Tensor& inter_b,
+                                                   const torch::Tensor& output_w,
+                                                   const torch::Tensor& output_b,
+                                                   const torch::Tensor& norm_w,
+                                                   const torch::Tensor& norm_b)
+{
+    auto g_output = grad_output.contiguous();
+    CHECK_INPUT(g_output);
+    CHECK_INPUT(output);
+    CHECK_INPUT(inp_norm);
+    CHECK_INPUT(qkv_tf);
+    CHECK_INPUT(add_res);
+    CHECK_INPUT(soft_out);
+    CHECK_INPUT(ctx_bufB);
+    CHECK_INPUT(attn_o_inp);
+    CHECK_INPUT(ff1_inp);
+    CHECK_INPUT(gelu_inp);
+    CHECK_INPUT(ff2_inp);
+    CHECK_INPUT(input);
+    CHECK_INPUT(input_mask);
+    CHECK_INPUT(attn_qkvw);
+    CHECK_INPUT(attn_qkvb);
+    CHECK_INPUT(attn_ow);
+    CHECK_INPUT(attn_ob);
+    CHECK_INPUT(attn_nw);
+    CHECK_INPUT(attn_nb);
+    CHECK_INPUT(inter_w);
+    CHECK_INPUT(inter_b);
+    CHECK_INPUT(output_w);
+    CHECK_INPUT(output_b);
+    CHECK_INPUT(norm_w);
+    CHECK_INPUT(norm_b);
+
+    std::shared_ptr<BertTransformerLayerCPU> layer = s_transformer_layers[layer_id];
+
+    const int bsz = g_output.size(0);
+    const int seq_len = g_output.size(1);
+    const int hidden = layer->hidden_size;
+    const int heads = layer->heads;
+    const int head_size = hidden / heads;
+    const int intermediate = layer->intermediate_size;
+    const int64_t bsz_seq = (int64_t)bsz * seq_len;
+    const int64_t bsz_heads = (int64_t)bsz * heads;
+    const float eps = layer->layer_norm_eps;
+    const float scale = 1.0 / std::sqrt((float)head_size);
+    const bool pre_ln = layer->pre_or_postLayerNorm;
+    const bool invertible = layer->normalize_invertible;
+    const bool prob_dropout = layer->attn_dropout_ratio > 0;
+    const bool hidden_dropout = layer->hidden_dropout_ratio > 0;
+
+    auto grad_input = torch::empty_like(input);
+    auto grad_attn_qkvw = torch::empty_like(attn_qkvw);
+    auto grad_attn_qkvb = torch::empty_like(attn_qkvb);
+    auto grad_attn_ow = torch::empty_like(attn_ow);
+    auto grad_attn_ob = torch::empty_like(attn_ob);
+    auto grad_attn_nw = torch::empty_like(attn_nw);
+    auto grad_attn_nb = torch::empty_like(attn_nb);
+    auto grad_inter_w = torch::empty_like(inter_w);
+    auto grad_inter_b = torch::empty_like(inter_b);
+    auto grad_output_w = torch::empty_like(output_w);
+    auto grad_output_b = torch::empty_like(output_b);
+    auto grad_norm_w = torch::empty_like(norm_w);
+    auto grad_norm_b = torch::empty_like(norm_b);
+
+    torch::NoGradGuard no_grad;
+
+    auto hidden_options = torch::TensorOptions().dtype(torch::kFloat);
+    auto buf_0 = torch::empty({bsz_seq, hidden}, hidden_options);
+    auto buf_1 = torch::empty({bsz_seq, hidden}, hidden_options);
+    auto buf_2 = torch::empty({bsz_seq, hidden}, hidden_options);
+
+    const auto g = g_output.view({bsz_seq, hidden});
+
+    // final layer norm of the post-LN layer
+    if (!pre_ln) {
+        cpu_layer_norm_backward(fptr(buf_1),
+                                fptr(grad_norm_w),
+                                fptr(grad_norm_b),
+                                fptr(g),
+                                nullptr,
+                                invertible ? fptr(output) : fptr(inp_norm),
+                                fptr(norm_w),
+                                fptr(norm_b),
+                                fptr(layer_norm_var),
+                                invertible ? nullptr : fptr(layer_norm_mean),
+                                bsz_seq,
+                                hidden,
+                                eps);
+    }
+
+    // layer output dropout
+    torch::Tensor layer_dropout_grad = (pre_ln ? g : buf_1);
+    if (hidden_dropout) {
+        cpu_dropout_apply(fptr(buf_0),
+                          fptr(layer_dropout_grad),
+                          mptr(layer_output_dropout_mask),
+                          bsz_seq * hidden,
+                          layer->hidden_dropout_ratio);
+        layer_dropout_grad = buf_0;
+    }
+
+    // ff2
+    torch::Tensor gelu_out = ff2_inp;
+    if (layer->gelu_checkpoint) {
+        gelu_out = torch::empty_like(ff2_inp);
+        cpu_bias_gelu(fptr(gelu_out), fptr(ff2_inp), fptr(inter_b), bsz_seq, intermediate);
+    }
+    torch::mm_out(grad_output_w, layer_dropout_grad.t(), gelu_out);
+    cpu_column_sum(fptr(grad_output_b), fptr(layer_dropout_grad), bsz_seq, hidden);
+    auto ff2_buf = torch::mm(layer_dropout_grad, output_w);
+
+    // bias + gelu
+    cpu_bias_gelu_backward(fptr(ff2_buf), fptr(gelu_inp), fptr(inter_b), bsz_seq, intermediate);
+
+    // ff1
+    torch::mm_out(grad_inter_w, ff2_buf.t(), ff1_inp.view({bsz_seq, hidden}));
+    cpu_column_sum(fptr(grad_inter_b), fptr(ff2_buf), bsz_seq, intermediate);
+    auto buf_3 = torch::mm(ff2_buf, inter_w);
+
+    // attention layer norm, fused with the residual gradient
+    if (!pre_ln) cpu_fused_add2(fptr(buf_2), fptr(buf_3), fptr(buf_1), bsz_seq * hidden);
+    cpu_layer_norm_backward(fptr(buf_0),
+                            fptr(grad_attn_nw),
+                            fptr(grad_attn_nb),
+                            pre_ln ? fptr(buf_3) : fptr(buf_2),
+                            pre_ln ? fptr(g) : nullptr,
+                            invertible ? fptr(ff1_inp) : fptr(add_res),
+                            fptr(attn_nw),
+                            fptr(attn_nb),
+                            fptr(attn_layer_norm_var),
+                            invertible ? nullptr : fptr(attn_layer_norm_mean),
+                            bsz_seq,
+                            hidden,
+                            eps);
+
+    // attn output dropout
+    torch::Tensor attn_dropout_grad = buf_0;
+    if (hidden_dropout) {
+        cpu_dropout_apply(fptr(buf_2),
+                          fptr(buf_0),
+                          mptr(attn_output_dropout_mask),
+                          bsz_seq * hidden,
+                          layer->hidden_dropout_ratio);
+        attn_dropout_grad = buf_2;
+    }
+
+    // attn output linear
+    torch::mm_out(grad_attn_ow, attn_dropout_grad.t(), attn_o_inp.view({bsz_seq, hidden}));
+    cpu_column_sum(fptr(grad_attn_ob), fptr(attn_dropout_grad), bsz_seq, hidden);
+    torch::mm_out(buf_1, attn_dropout_grad, attn_ow);
+
+    auto grad_context = torch::empty({bsz_heads, seq_len, head_size}, hidden_options);
+    cpu_transform_0213(fptr(grad_context), fptr(buf_1), bsz, seq_len, hidden, heads);
+
+    auto qkv_heads = qkv_tf.view({3, bsz_heads, seq_len, head_size});
+    auto q = qkv_heads[0];
+    auto k = qkv_heads[1];
+    auto v = qkv_heads[2];
+    auto grad_qkv = torch::empty({3, bsz_heads, seq_len, head_size}, hidden_options);
+
+    // attention context
+    torch::Tensor probs = soft_out;
+    if (prob_dropout) {
+        probs = ctx_bufB;
+        if (layer->attn_dropout_checkpoint) {
+            probs = torch::empty_like(soft_out);
+            cpu_dropout_apply(fptr(probs),
+                              fptr(soft_out),
+                              mptr(attn_prob_dropout_mask),
+                              soft_out.numel(),
+                              layer->attn_dropout_ratio);
+        }
+    }
+    auto grad_v = grad_qkv[2];
+    at::bmm_out(grad_v, probs.view({bsz_heads, seq_len, seq_len}).transpose(1, 2), grad_context);
+    auto grad_scores = torch::bmm(grad_context, v.transpose(1, 2));
+
+    // attn prob dropout, softmax
+    if (prob_dropout) {
+        cpu_dropout_apply(fptr(grad_scores),
+                          fptr(grad_scores),
+                          mptr(attn_prob_dropout_mask),
+                          grad_scores.numel(),
+                          layer->attn_dropout_ratio);
+    }
+    cpu_attn_softmax_backward(fptr(grad_scores), fptr(soft_out), bsz_heads * seq_len, seq_len);
+
+    // attention scores
+    auto grad_q = grad_qkv[0];
+    auto grad_k = grad_qkv[1];
+    at::baddbmm_out(grad_q, grad_q, grad_scores, k, 0.0, scale);
+    at::baddbmm_out(grad_k, grad_k, grad_scores.transpose(1, 2), q, 0.0, scale);
+
+    // qkv linear
+    auto grad_qkv_merged = torch::empty({bsz_seq, 3 * hidden}, hidden_options);
+    cpu_transform4d_0213(
+        fptr(grad_qkv_merged), fptr(grad_qkv), bsz, heads, seq_len, hidden, 3);
+    torch::mm_out(grad_attn_qkvw,
+                  grad_qkv_merged.t(),
+                  (pre_ln ? inp_norm : input).view({bsz_seq, hidden}));
+    cpu_column_sum(fptr(grad_attn_qkvb), fptr(grad_qkv_merged), bsz_seq, 3 * hidden);
+    torch::mm_out(buf_2, grad_qkv_merged, attn_qkvw);
+
+    // input layer norm of the pre-LN layer, fused with the residual gradient
+    if (pre_ln) {
+        cpu_layer_norm_backward(fptr(grad_input),
+                                fptr(grad_norm_w),
+                                fptr(grad_norm_b),
+                                fptr(buf_2),
+                                fptr(buf_0),
+                                invertible ? fptr(inp_norm) : fptr(input),
+                                fptr(norm_w),
+                                fptr(norm_b),
+                                fptr(layer_norm_var),
+                                invertible ? nullptr : fptr(layer_norm_mean),
+                                bsz_seq,
+                                hidden,
+                                eps);
+    } else {
+        cpu_fused_add2(fptr(grad_input), fptr(buf_2), fptr(buf_0), bsz_seq * hidden);
+    }
+
+    return {grad_input,
+            grad_attn_qkvw,
+            grad_attn_qkvb,
+            grad_attn_ow,
+            grad_attn_ob,
+            grad_attn_nw,
+            grad_attn_nb,
+            grad_inter_w,
+            grad_inter_b,
+            grad_output_w,
+            grad_output_b,
+            grad_norm_w,
+            grad_norm_b};
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    m.def("forward_fp32", &ds_transformer_forward, "DeepSpeed Transformer forward with fp32 (CPU)");
+    m.def("backward_fp32",
+          &ds_transformer_backward,
+          "DeepSpeed Transformer backward with fp32 (CPU)");
+    m.def("create_transformer_layer_fp32",
+          &create_transformer_layer,
+          "Create DeepSpeed Transformer Transformer Layer with fp32 (CPU)");
+}
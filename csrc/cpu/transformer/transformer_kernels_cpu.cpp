@@ -0,0 +1,344 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <math.h>
+#include <omp.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "cpu_transformer_layers.h"
+
+static inline uint32_t dropout_hash(uint64_t seed, uint64_t index)
+{
+    // splitmix64 finalizer
+    uint64_t z = seed + index * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+static inline uint32_t dropout_threshold(float ratio)
+{
+    return (uint32_t)std::min(4294967295.0, (double)ratio * 4294967296.0);
+}
+
+void cpu_bias_add_transform_0213(float* output,
+                                 const float* vals,
+                                 const float* bias,
+                                 int batch_size,
+                                 int seq_length,
+                                 int hidden_dim,
+                                 int heads)
+{
+    const int head_size = hidden_dim / heads;
+#pragma omp parallel for collapse(2)
+    for (int b = 0; b < batch_size; b++) {
+        for (int s = 0; s < seq_length; s++) {
+            const float* row = vals + ((int64_t)b * seq_length + s) * 3 * hidden_dim;
+            for (int m = 0; m < 3; m++) {
+                for (int h = 0; h < heads; h++) {
+                    const int64_t col = m * hidden_dim + h * head_size;
+                    float* dst =
+                        output +
+                        ((((int64_t)m * batch_size + b) * heads + h) * seq_length + s) * head_size;
+                    for (int d = 0; d < head_size; d++) dst[d] = row[col + d] + bias[col + d];
+                }
+            }
+        }
+    }
+}
+
+void cpu_transform4d_0213(float* out,
+                          const float* in,
+                          int batch_size,
+                          int heads,
+                          int seq_length,
+                          int hidden_dim,
+                          int trans_count)
+{
+    const int head_size = hidden_dim / heads;
+#pragma omp parallel for collapse(2)
+    for (int b = 0; b < batch_size; b++) {
+        for (int s = 0; s < seq_length; s++) {
+            float* row = out + ((int64_t)b * seq_length + s) * trans_count * hidden_dim;
+            for (int m = 0; m < trans_count; m++) {
+                for (int h = 0; h < heads; h++) {
+                    const float* src =
+                        in + ((((int64_t)m * batch_size + b) * heads + h) * seq_length + s) * head_size;
+                    memcpy(row + m * hidden_dim + h * head_size, src, head_size * sizeof(float));
+                }
+            }
+        }
+    }
+}
+
+void cpu_transform_0213(float* output,
+                        const float* vals,
+                        int batch_size,
+                        int seq_length,
+                        int hidden_dim,
+                        int heads)
+{
+    const int head_size = hidden_dim / heads;
+#pragma omp parallel for collapse(2)
+    for (int b = 0; b < batch_size; b++) {
+        for (int s = 0; s < seq_length; s++) {
+            const float* row = vals + ((int64_t)b * seq_length + s) * hidden_dim;
+            for (int h = 0; h < heads; h++) {
+                float* dst = output + (((int64_t)b * heads + h) * seq_length + s) * head_size;
+                memcpy(dst, row + h * head_size, head_size * sizeof(float));
+            }
+        }
+    }
+}
+
+void cpu_attn_softmax(float* vals, const float* attn_mask, int batch_size, int heads, int seq_length)
+{
+    const int64_t rows = (int64_t)batch_size * heads * seq_length;
+#pragma omp parallel for
+    for (int64_t r = 0; r < rows; r++) {
+        float* row = vals + r * seq_length;
+        const float* mask = attn_mask + (r / ((int64_t)heads * seq_length)) * seq_length;
+        float max_val = -INFINITY;
+        for (int j = 0; j < seq_length; j++) {
+            row[j] += mask[j];
+            max_val = std::max(max_val, row[j]);
+        }
+        float sum = 0.0f;
+        for (int j = 0; j < seq_length; j++) {
+            row[j] = expf(row[j] - max_val);
+            sum += row[j];
+        }
+        const float inv_sum = 1.0f / sum;
+        for (int j = 0; j < seq_length; j++) row[j] *= inv_sum;
+    }
+}
+
+void cpu_attn_softmax_backward(float* grad, const float* soft, int64_t rows, int seq_length)
+{
+#pragma omp parallel for
+    for (int64_t r = 0; r < rows; r++) {
+        float* g = grad + r * seq_length;
+        const float* p = soft + r * seq_length;
+        float dot = 0.0f;
+        for (int j = 0; j < seq_length; j++) dot += g[j] * p[j];
+        for (int j = 0; j < seq_length; j++) g[j] = p[j] * (g[j] - dot);
+    }
+}
+
+void cpu_dropout(float* out,
+                 const float* in,
+                 uint8_t* mask,
+                 int64_t size,
+                 float ratio,
+                 uint64_t seed,
+                 uint64_t offset)
+{
+    const uint32_t threshold = dropout_threshold(ratio);
+    const float scale = 1.0f / (1.0f - ratio);
+#pragma omp parallel for
+    for (int64_t i = 0; i < size; i++) {
+        const uint8_t keep = dropout_hash(seed, offset + i) >= threshold;
+        mask[i] = keep;
+        out[i] = keep ? in[i] * scale : 0.0f;
+    }
+}
+
+void cpu_dropout_apply(float* out, const float* in, const uint8_t* mask, int64_t size, float ratio)
+{
+    const float scale = 1.0f / (1.0f - ratio);
+#pragma omp parallel for
+    for (int64_t i = 0; i < size; i++) out[i] = mask[i] ? in[i] * scale : 0.0f;
+}
+
+void cpu_bias_dropout_residual(float* out,
+                               const float* in,
+                               const float* residual,
+                               const float* bias,
+                               uint8_t* mask,
+                               int64_t rows,
+                               int cols,
+                               float ratio,
+                               uint64_t seed,
+                               uint64_t offset)
+{
+    const uint32_t threshold = dropout_threshold(ratio);
+    const float scale = mask ? 1.0f / (1.0f - ratio) : 1.0f;
+#pragma omp parallel for
+    for (int64_t r = 0; r < rows; r++) {
+        const int64_t base = r * cols;
+        if (mask) {
+            for (int c = 0; c < cols; c++) {
+                const uint8_t keep = dropout_hash(seed, offset + base + c) >= threshold;
+                mask[base + c] = keep;
+                out[base + c] =
+                    (keep ? (in[base + c] + bias[c]) * scale : 0.0f) + residual[base + c];
+            }
+        } else {
+            for (int c = 0; c < cols; c++) {
+                out[base + c] = in[base + c] + bias[c] + residual[base + c];
+            }
+        }
+    }
+}
+
+static inline float gelu(float x)
+{
+    const float sqrt_param = 0.79788456080286535587989211986876f;
+    const float mul_param = 0.044715f;
+    return x * 0.5f * (1.0f + tanhf(sqrt_param * (x + mul_param * x * x * x)));
+}
+
+static inline float d_gelu(float x)
+{
+    const float sqrt_param = 0.79788456080286535587989211986876f;
+    const float mul_param = 0.044715f;
+    const float x2mul = x * x * mul_param;
+    const float tan_h = tanhf(sqrt_param * (x + x * x2mul));
+    const float dg1 = 0.5f * (1.0f + tan_h);
+    const float dg2 = x * 0.5f * sqrt_param * (1 - tan_h * tan_h);
+    const float dg3 = dg2 * 3 * x2mul;
+    return dg1 + dg2 + dg3;
+}
+
+void cpu_bias_gelu(float* out, const float* in, const float* bias, int64_t rows, int cols)
+{
+#pragma omp parallel for
+    for (int64_t r = 0; r < rows; r++) {
+        const int64_t base = r * cols;
+        for (int c = 0; c < cols; c++) out[base + c] = gelu(in[base + c] + bias[c]);
+    }
+}
+
+void cpu_bias_gelu_backward(float* grad, const float* input, const float* bias, int64_t rows, int cols)
+{
+#pragma omp parallel for
+    for (int64_t r = 0; r < rows; r++) {
+        const int64_t base = r * cols;
+        for (int c = 0; c < cols; c++) grad[base + c] *= d_gelu(input[base + c] + bias[c]);
+    }
+}
+
+void cpu_layer_norm(float* out,
+                    float* vars,
+                    float* means,
+                    const float* in,
+                    const float* gamma,
+                    const float* beta,
+                    int64_t rows,
+                    int cols,
+                    float epsilon)
+{
+#pragma omp parallel for
+    for (int64_t r = 0; r < rows; r++) {
+        const float* x = in + r * cols;
+        float* y = out + r * cols;
+        float mean = 0.0f;
+        for (int c = 0; c < cols; c++) mean += x[c];
+        mean /= cols;
+        float var = 0.0f;
+        for (int c = 0; c < cols; c++) var += (x[c] - mean) * (x[c] - mean);
+        var /= cols;
+        const float rstd = 1.0f / sqrtf(var + epsilon);
+        vars[r] = var;
+        if (means) means[r] = mean;
+        for (int c = 0; c < cols; c++) y[c] = (x[c] - mean) * rstd * gamma[c] + beta[c];
+    }
+}
+
+void cpu_layer_norm_backward(float* grad_in,
+                             float* gamma_grad,
+                             float* beta_grad,
+                             const float* grad_out,
+                             const float* residual_grad,
+                             const float* vals,
+                             const float* gamma,
+                             const float* beta,
+                             const float* vars,
+                             const float* means,
+                             int64_t rows,
+                             int cols,
+                             float epsilon)
+{
+    const int threads = omp_get_max_threads();
+    std::vector<float> partials(2 * (size_t)threads * cols, 0.0f);
+
+#pragma omp parallel
+    {
+        float* gamma_acc = partials.data() + 2 * (size_t)omp_get_thread_num() * cols;
+        float* beta_acc = gamma_acc + cols;
+        std::vector<float> x_hat(cols);
+
+#pragma omp for
+        for (int64_t r = 0; r < rows; r++) {
+            const float* dy = grad_out + r * cols;
+            const float* v = vals + r * cols;
+            float* dx = grad_in + r * cols;
+            const float rstd = 1.0f / sqrtf(vars[r] + epsilon);
+
+            if (means) {
+                for (int c = 0; c < cols; c++) x_hat[c] = (v[c] - means[r]) * rstd;
+            } else {
+                for (int c = 0; c < cols; c++) x_hat[c] = (v[c] - beta[c]) / gamma[c];
+            }
+
+            float sum_dxhat = 0.0f;
+            float sum_dxhat_xhat = 0.0f;
+            for (int c = 0; c < cols; c++) {
+                gamma_acc[c] += dy[c] * x_hat[c];
+                beta_acc[c] += dy[c];
+                const float dxhat = dy[c] * gamma[c];
+                sum_dxhat += dxhat;
+                sum_dxhat_xhat += dxhat * x_hat[c];
+            }
+            const float mean_dxhat = sum_dxhat / cols;
+            const float mean_dxhat_xhat = sum_dxhat_xhat / cols;
+            for (int c = 0; c < cols; c++) {
+                float g = rstd * (dy[c] * gamma[c] - mean_dxhat - x_hat[c] * mean_dxhat_xhat);
+                if (residual_grad) g += residual_grad[r * cols + c];
+                dx[c] = g;
+            }
+        }
+    }
+
+    for (int c = 0; c < cols; c++) {
+        float gamma_sum = 0.0f;
+        float beta_sum = 0.0f;
+        for (int t = 0; t < threads; t++) {
+            gamma_sum += partials[2 * (size_t)t * cols + c];
+            beta_sum += partials[(2 * (size_t)t + 1) * cols + c];
+        }
+        gamma_grad[c] = gamma_sum;
+        beta_grad[c] = beta_sum;
+    }
+}
+
+void cpu_fused_add2(float* out, const float* a, const float* b, int64_t size)
+{
+#pragma omp parallel for
+    for (int64_t i = 0; i < size; i++) out[i] = a[i] + b[i];
+}
+
+void cpu_column_sum(float* out, const float* in, int64_t rows, int cols)
+{
+    const int threads = omp_get_max_threads();
+    std::vector<float> partials((size_t)threads * cols, 0.0f);
+
+#pragma omp parallel
+    {
+        float* acc = partials.data() + (size_t)omp_get_thread_num() * cols;
+#pragma omp for
+        for (int64_t r = 0; r < rows; r++) {
+            const float* row = in + r * cols;
+            for (int c = 0; c < cols; c++) acc[c] += row[c];
+        }
+    }
+
+    for (int c = 0; c < cols; c++) {
+        float sum = 0.0f;
+        for (int t = 0; t < threads; t++) sum += partials[(size_t)t * cols + c];
+        out[c] = sum;
+    }
+}
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <torch/extension.h>
+#include "attention_cpu.h"
+
+using namespace evoformer_cpu;
+
+static Evoformer_Shape make_shape(const torch::Tensor& q, const torch::Tensor& lse)
+{
+    TORCH_CHECK(q.dim() == 5, "q must be [B, N, L, H, D]");
+    Evoformer_Shape s;
+    s.B = q.size(0);
+    s.N = q.size(1);
+    s.L = q.size(2);
+    s.H = q.size(3);
+    s.D = q.size(4);
+    s.lse_stride = lse.size(-1);
+    s.scale = 1.0f / std::sqrt((float)s.D);
+    return s;
+}
+
+static void check_inputs(const torch::Tensor& q,
+                         const torch::Tensor& k,
+                         const torch::Tensor& v,
+                         const torch::Tensor& bias1,
+                         const torch::Tensor& bias2,
+                         const torch::Tensor& lse)
+{
+    TORCH_CHECK(q.is_contiguous() && k.is_contiguous() && v.is_contiguous(),
+                "q, k and v must be contiguous");
+    TORCH_CHECK(k.sizes() == q.sizes() && v.sizes() == q.sizes(), "q, k and v shapes differ");
+    TORCH_CHECK(k.scalar_type() == q.scalar_type() && v.scalar_type() == q.scalar_type(),
+                "q, k and v dtypes differ");
+    TORCH_CHECK(lse.scalar_type() == torch::kFloat && lse.is_contiguous(), "lse must be fp32");
+    TORCH_CHECK(lse.size(-1) >= q.size(2), "lse is too small");
+    if (bias1.numel() > 0) {
+        TORCH_CHECK(bias1.is_contiguous() && bias1.scalar_type() == q.scalar_type() &&
+                        bias1.numel() == q.size(0) * q.size(1) * q.size(2),
+                    "bias1 must be a contiguous [B, N, 1, 1, L] tensor of the dtype of q");
+    }
+    if (bias2.numel() > 0) {
+        TORCH_CHECK(bias2.is_contiguous() && bias2.scalar_type() == q.scalar_type() &&
+                        bias2.numel() == q.size(0) * q.size(3) * q.size(2) * q.size(2),
+                    "bias2 must be a contiguous [B, 1, H, L, L] tensor of the dtype of q");
+    }
+}
+
+template <typename T>
+static const T* bias_ptr(const torch::Tensor& bias)
+{
+    return bias.numel() > 0 ? bias.data_ptr<T>() : nullptr;
+}
+
+void attention(torch::Tensor& q,
+               torch::Tensor& k,
+               torch::Tensor& v,
+               torch::Tensor& bias1,
+               torch::Tensor& bias2,
+               torch::Tensor& o,
+               torch::Tensor& lse)
+{
+    check_inputs(q, k, v, bias1, bias2, lse);
+    const Evoformer_Shape s = make_shape(q, lse);
+    const int64_t row_tiles = (s.L + EVOFORMER_CPU_BLOCK_M - 1) / EVOFORMER_CPU_BLOCK_M;
+    const int64_t tasks = s.B * s.N * s.H * row_tiles;
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::ScalarType::Half, at::ScalarType::BFloat16, q.scalar_type(), "evoformer_attention_cpu", [&] {
+            const scalar_t* q_ptr = q.data_ptr<scalar_t>();
+            const scalar_t* k_ptr = k.data_ptr<scalar_t>();
+            const scalar_t* v_ptr = v.data_ptr<scalar_t>();
+            const scalar_t* b1_ptr = bias_ptr<scalar_t>(bias1);
+            const scalar_t* b2_ptr = bias_ptr<scalar_t>(bias2);
+            scalar_t* o_ptr = o.data_ptr<scalar_t>();
+            float* lse_ptr = lse.data_ptr<float>();
+#pragma omp parallel
+            {
+                Forward_Scratch scratch(s.D);
+#pragma omp for schedule(static)
+                for (int64_t task = 0; task < tasks; ++task) {
+                    const int64_t tile = task % row_tiles;
+                    const int64_t h = (task / row_tiles) % s.H;
+                    const int64_t bn = task / (row_tiles * s.H);
+                    forward_tile(q_ptr, k_ptr, v_ptr, b1_ptr, b2_ptr, o_ptr, lse_ptr, bn, h,
+                                 tile * EVOFORMER_CPU_BLOCK_M, s, scratch);
+                }
+            }
+        });
+}
+
+void attention_bwd(torch::Tensor& go,
+                   torch::Tensor& q,
+                   torch::Tensor& k,
+                   torch::Tensor& v,
+                   torch::Tensor& o,
+                   torch::Tensor& lse,
+                   torch::Tensor& delta,
+                   torch::Tensor& bias1,
+                   torch::Tensor& bias2,
+                   torch::Tensor& gq,
+                   torch::Tensor& gk,
+                   torch::Tensor& gv,
+                   torch::Tensor& gb1,
+                   torch::Tensor& gb2)
+{
+    check_inputs(q, k, v, bias1, bias2, lse);
+    TORCH_CHECK(go.is_contiguous() && o.is_contiguous(), "grad_out and out must be contiguous");
+    TORCH_CHECK(delta.sizes() == lse.sizes() && delta.scalar_type() == torch::kFloat,
+                "delta must match lse");
+    const bool bias1_grad = gb1.numel() > 0;
+    const bool bias2_grad = gb2.numel() > 0;
+    TORCH_CHECK(!bias1_grad || (gb1.numel() == bias1.numel() && gb1.scalar_type() == torch::kFloat),
+                "gb1 must be an fp32 tensor shaped like bias1");
+    TORCH_CHECK(!bias2_grad || (gb2.numel() == bias2.numel() && gb2.scalar_type() == torch::kFloat),
+                "gb2 must be an fp32 tensor shaped like bias2");
+
+    const Evoformer_Shape s = make_shape(q, lse);
+    const int64_t row_tiles = (s.L + EVOFORMER_CPU_BLOCK_M - 1) / EVOFORMER_CPU_BLOCK_M;
+    const int64_t col_tiles = (s.L + EVOFORMER_CPU_BLOCK_N - 1) / EVOFORMER_CPU_BLOCK_N;
+
+    // Per-head partial sums of dB1, reduced over heads below
+    torch::Tensor db1_partial;
+    if (bias1_grad) { db1_partial = torch::zeros({s.B, s.H, s.N, s.L}, q.options().dtype(torch::kFloat)); }
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::ScalarType::Half, at::ScalarType::BFloat16, q.scalar_type(), "evoformer_attention_bwd_cpu", [&] {
+            const scalar_t* go_ptr = go.data_ptr<scalar_t>();
+            const scalar_t* q_ptr = q.data_ptr<scalar_t>();
+            const scalar_t* k_ptr = k.data_ptr<scalar_t>();
+            const scalar_t* v_ptr = v.data_ptr<scalar_t>();
+            const scalar_t* o_ptr = o.data_ptr<scalar_t>();
+            const scalar_t* b1_ptr = bias_ptr<scalar_t>(bias1);
+            const scalar_t* b2_ptr = bias_ptr<scalar_t>(bias2);
+            scalar_t* gq_ptr = gq.data_ptr<scalar_t>();
+            scalar_t* gk_ptr = gk.data_ptr<scalar_t>();
+            scalar_t* gv_ptr = gv.data_ptr<scalar_t>();
+            const float* lse_ptr = lse.data_ptr<float>();
+            float* delta_ptr = delta.data_ptr<float>();
+            float* db1_ptr = bias1_grad ? db1_partial.data_ptr<float>() : nullptr;
+            float* gb2_ptr = bias2_grad ? gb2.data_ptr<float>() : nullptr;
+
+#pragma omp parallel for collapse(2)
+            for (int64_t bn = 0; bn < s.B * s.N; ++bn) {
+                for (int64_t h = 0; h < s.H; ++h) { backward_delta(go_ptr, o_ptr, delta_ptr, bn, h, s); }
+            }
+
+#pragma omp parallel
+            {
+                Backward_Scratch scratch(s.D);
+#pragma omp for schedule(dynamic)
+                for (int64_t task = 0; task < s.B * s.H * col_tiles; ++task) {
+                    const int64_t tile = task % col_tiles;
+                    const int64_t h = (task / col_tiles) % s.H;
+                    const int64_t b = task / (col_tiles * s.H);
+                    backward_key_tile(go_ptr, q_ptr, k_ptr, v_ptr, lse_ptr, delta_ptr, b1_ptr, b2_ptr,
+                                      gk_ptr, gv_ptr, db1_ptr, gb2_ptr, b, h,
+                                      tile * EVOFORMER_CPU_BLOCK_N, s, scratch);
+                }
+#pragma omp for schedule(static)
+                for (int64_t task = 0; task < s.B * s.N * s.H * row_tiles; ++task) {
+                    const int64_t tile = task % row_tiles;
+                    const int64_t h = (task / row_tiles) % s.H;
+                    const int64_t bn = task / (row_tiles * s.H);
+                    backward_query_tile(go_ptr, q_ptr, k_ptr, v_ptr, lse_ptr, delta_ptr, b1_ptr,
+                                        b2_ptr, gq_ptr, bn, h, tile * EVOFORMER_CPU_BLOCK_M, s,
+                                        scratch);
+                }
+            }
+        });
+
+    if (bias1_grad) { gb1.copy_(db1_partial.sum(1).view(gb1.sizes())); }
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    m.def("attention", &attention, "Evoformer attention forward (CPU)");
+    m.def("attention_bwd", &attention_bwd, "Evoformer attention backward (CPU)");
+}
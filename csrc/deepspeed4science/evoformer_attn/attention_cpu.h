@@ -0,0 +1,409 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+/*
+Tiled CPU Evoformer attention, the counterpart of the CUTLASS kernels in kernel_forward.h and
+kernel_backward.h. Q, K, V and O are [B, N, L, H, D] and
+
+    S[b, n, h, i, j] = Q[b, n, i, h] . K[b, n, j, h] / sqrt(D) + bias1[b, n, j] + bias2[b, h, i, j]
+
+where bias1 is [B, N, 1, 1, L] and bias2 is [B, 1, H, L, L], either may be absent, as in
+transform/bias_broadcast.h. The forward pass walks the keys in tiles with an online softmax, so
+each task only holds a tile of scores, and stores the row logsumexp for the backward pass. The
+backward pass recomputes the probabilities tile by tile: one sweep over key tiles produces dK, dV
+and the bias gradients, another over query tiles produces dQ. All math is in fp32.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Query rows and keys per tile
+#define EVOFORMER_CPU_BLOCK_M 32
+#define EVOFORMER_CPU_BLOCK_N 64
+
+struct Evoformer_Shape {
+    int64_t B;
+    int64_t N;
+    int64_t L;
+    int64_t H;
+    int64_t D;
+    // Padded number of queries per (batch, head) in the logsumexp buffer
+    int64_t lse_stride;
+    float scale;
+
+    int64_t offset(int64_t bn, int64_t row, int64_t h) const { return ((bn * L + row) * H + h) * D; }
+};
+
+namespace evoformer_cpu {
+
+// dst[rows, D] = src rows * scale, src rows are H * D apart
+template <typename T>
+inline void load_rows(float* dst, const T* src, int64_t rows, const Evoformer_Shape& s, float scale)
+{
+    for (int64_t i = 0; i < rows; ++i) {
+        const T* row = src + i * s.H * s.D;
+        for (int64_t d = 0; d < s.D; ++d) dst[i * s.D + d] = (float)row[d] * scale;
+    }
+}
+
+// dst[D, BLOCK_N] = transpose of the src rows
+template <typename T>
+inline void load_rows_transposed(float* dst, const T* src, int64_t rows, const Evoformer_Shape& s)
+{
+    for (int64_t j = 0; j < rows; ++j) {
+        const T* row = src + j * s.H * s.D;
+        for (int64_t d = 0; d < s.D; ++d) dst[d * EVOFORMER_CPU_BLOCK_N + j] = (float)row[d];
+    }
+}
+
+// c[rows, BLOCK_N] = a[rows, D] * bt[D, BLOCK_N], the inner loop runs over contiguous columns
+inline void matmul_abt(float* c, const float* a, const float* bt, int64_t rows, int64_t cols, int64_t D)
+{
+    for (int64_t i = 0; i < rows; ++i) {
+        float* c_row = c + i * EVOFORMER_CPU_BLOCK_N;
+        std::fill(c_row, c_row + cols, 0.0f);
+        for (int64_t d = 0; d < D; ++d) {
+            const float a_id = a[i * D + d];
+            const float* bt_row = bt + d * EVOFORMER_CPU_BLOCK_N;
+            for (int64_t j = 0; j < cols; ++j) c_row[j] += a_id * bt_row[j];
+        }
+    }
+}
+
+// c[rows, D] += p[rows, BLOCK_N] * b[cols, D]
+inline void matmul_pb_acc(float* c, const float* p, const float* b, int64_t rows, int64_t cols, int64_t D)
+{
+    for (int64_t i = 0; i < rows; ++i) {
+        float* c_row = c + i * D;
+        for (int64_t j = 0; j < cols; ++j) {
+            const float p_ij = p[i * EVOFORMER_CPU_BLOCK_N + j];
+            if (p_ij == 0.0f) continue;
+            const float* b_row = b + j * D;
+            for (int64_t d = 0; d < D; ++d) c_row[d] += p_ij * b_row[d];
+        }
+    }
+}
+
+// c[cols, D] += p[rows, BLOCK_N]^T * a[rows, D]
+inline void matmul_ptb_acc(float* c, const float* p, const float* a, int64_t rows, int64_t cols, int64_t D)
+{
+    for (int64_t i = 0; i < rows; ++i) {
+        const float* a_row = a + i * D;
+        for (int64_t j = 0; j < cols; ++j) {
+            const float p_ij = p[i * EVOFORMER_CPU_BLOCK_N + j];
+            if (p_ij == 0.0f) continue;
+            float* c_row = c + j * D;
+            for (int64_t d = 0; d < D; ++d) c_row[d] += p_ij * a_row[d];
+        }
+    }
+}
+
+// Adds bias1 and bias2 to a [rows, cols] tile of scores starting at (row_start, col_start)
+template <typename T>
+inline void add_bias(float* scores,
+                     const T* bias1,
+                     const T* bias2,
+                     int64_t bn,
+                     int64_t h,
+                     int64_t row_start,
+                     int64_t rows,
+                     int64_t col_start,
+                     int64_t cols,
+                     const Evoformer_Shape& s)
+{
+    const int64_t b = bn / s.N;
+    for (int64_t i = 0; i < rows; ++i) {
+        float* row = scores + i * EVOFORMER_CPU_BLOCK_N;
+        if (bias1) {
+            const T* b1 = bias1 + bn * s.L + col_start;
+            for (int64_t j = 0; j < cols; ++j) row[j] += (float)b1[j];
+        }
+        if (bias2) {
+            const T* b2 = bias2 + ((b * s.H + h) * s.L + row_start + i) * s.L + col_start;
+            for (int64_t j = 0; j < cols; ++j) row[j] += (float)b2[j];
+        }
+    }
+}
+
+struct Forward_Scratch {
+    std::vector<float> q, kt, v, scores, acc, row_max, row_sum;
+
+    explicit Forward_Scratch(int64_t D)
+        : q(EVOFORMER_CPU_BLOCK_M * D),
+          kt(D * EVOFORMER_CPU_BLOCK_N),
+          v(EVOFORMER_CPU_BLOCK_N * D),
+          scores(EVOFORMER_CPU_BLOCK_M * EVOFORMER_CPU_BLOCK_N),
+          acc(EVOFORMER_CPU_BLOCK_M * D),
+          row_max(EVOFORMER_CPU_BLOCK_M),
+          row_sum(EVOFORMER_CPU_BLOCK_M)
+    {
+    }
+};
+
+// One tile of query rows of one (batch, head) against all keys
+template <typename T>
+void forward_tile(const T* q,
+                  const T* k,
+                  const T* v,
+                  const T* bias1,
+                  const T* bias2,
+                  T* o,
+                  float* lse,
+                  int64_t bn,
+                  int64_t h,
+                  int64_t row_start,
+                  const Evoformer_Shape& s,
+                  Forward_Scratch& w)
+{
+    const float neg_inf = -std::numeric_limits<float>::infinity();
+    const int64_t rows = std::min<int64_t>(EVOFORMER_CPU_BLOCK_M, s.L - row_start);
+    const int64_t D = s.D;
+
+    load_rows(w.q.data(), q + s.offset(bn, row_start, h), rows, s, s.scale);
+    std::fill(w.acc.begin(), w.acc.end(), 0.0f);
+    std::fill(w.row_max.begin(), w.row_max.end(), neg_inf);
+    std::fill(w.row_sum.begin(), w.row_sum.end(), 0.0f);
+
+    for (int64_t col_start = 0; col_start < s.L; col_start += EVOFORMER_CPU_BLOCK_N) {
+        const int64_t cols = std::min<int64_t>(EVOFORMER_CPU_BLOCK_N, s.L - col_start);
+        load_rows_transposed(w.kt.data(), k + s.offset(bn, col_start, h), cols, s);
+        load_rows(w.v.data(), v + s.offset(bn, col_start, h), cols, s, 1.0f);
+
+        matmul_abt(w.scores.data(), w.q.data(), w.kt.data(), rows, cols, D);
+        add_bias(w.scores.data(), bias1, bias2, bn, h, row_start, rows, col_start, cols, s);
+
+        for (int64_t i = 0; i < rows; ++i) {
+            float* row = w.scores.data() + i * EVOFORMER_CPU_BLOCK_N;
+            float tile_max = neg_inf;
+            for (int64_t j = 0; j < cols; ++j) tile_max = std::max(tile_max, row[j]);
+            const float new_max = std::max(w.row_max[i], tile_max);
+            if (new_max == neg_inf) {
+                // every key so far is masked out
+                std::fill(row, row + cols, 0.0f);
+                continue;
+            }
+            const float correction = std::exp(w.row_max[i] - new_max);
+            float tile_sum = 0.0f;
+            for (int64_t j = 0; j < cols; ++j) {
+                row[j] = std::exp(row[j] - new_max);
+                tile_sum += row[j];
+            }
+            w.row_sum[i] = w.row_sum[i] * correction + tile_sum;
+            w.row_max[i] = new_max;
+            float* acc_row = w.acc.data() + i * D;
+            for (int64_t d = 0; d < D; ++d) acc_row[d] *= correction;
+        }
+        matmul_pb_acc(w.acc.data(), w.scores.data(), w.v.data(), rows, cols, D);
+    }
+
+    for (int64_t i = 0; i < rows; ++i) {
+        const float inv_sum = w.row_sum[i] > 0.0f ? 1.0f / w.row_sum[i] : 0.0f;
+        T* o_row = o + s.offset(bn, row_start + i, h);
+        for (int64_t d = 0; d < D; ++d) o_row[d] = (T)(w.acc[i * D + d] * inv_sum);
+        if (lse) {
+            lse[(bn * s.H + h) * s.lse_stride + row_start + i] =
+                w.row_sum[i] > 0.0f ? w.row_max[i] + std::log(w.row_sum[i]) : neg_inf;
+        }
+    }
+}
+
+struct Backward_Scratch {
+    std::vector<float> q, k, kt, vt, dout, scores, dp, acc_a, acc_b;
+
+    explicit Backward_Scratch(int64_t D)
+        : q(EVOFORMER_CPU_BLOCK_M * D),
+          k(EVOFORMER_CPU_BLOCK_N * D),
+          kt(D * EVOFORMER_CPU_BLOCK_N),
+          vt(D * EVOFORMER_CPU_BLOCK_N),
+          dout(EVOFORMER_CPU_BLOCK_M * D),
+          scores(EVOFORMER_CPU_BLOCK_M * EVOFORMER_CPU_BLOCK_N),
+          dp(EVOFORMER_CPU_BLOCK_M * EVOFORMER_CPU_BLOCK_N),
+          acc_a(EVOFORMER_CPU_BLOCK_N * D),
+          acc_b(EVOFORMER_CPU_BLOCK_N * D)
+    {
+    }
+};
+
+/*
+Recomputes the probabilities P and the score gradients dS = P * (dP - delta) of a tile, where
+dP = dO V^T. Expects w.q (scaled), w.kt, w.vt and w.dout to be loaded; leaves P in w.scores and
+dS in w.dp.
+*/
+template <typename T>
+inline void backward_scores(const T* bias1,
+                            const T* bias2,
+                            const float* lse,
+                            const float* delta,
+                            int64_t bn,
+                            int64_t h,
+                            int64_t row_start,
+                            int64_t rows,
+                            int64_t col_start,
+                            int64_t cols,
+                            const Evoformer_Shape& s,
+                            Backward_Scratch& w)
+{
+    const float neg_inf = -std::numeric_limits<float>::infinity();
+    matmul_abt(w.scores.data(), w.q.data(), w.kt.data(), rows, cols, s.D);
+    add_bias(w.scores.data(), bias1, bias2, bn, h, row_start, rows, col_start, cols, s);
+    matmul_abt(w.dp.data(), w.dout.data(), w.vt.data(), rows, cols, s.D);
+
+    const int64_t stats = (bn * s.H + h) * s.lse_stride + row_start;
+    for (int64_t i = 0; i < rows; ++i) {
+        float* p = w.scores.data() + i * EVOFORMER_CPU_BLOCK_N;
+        float* ds = w.dp.data() + i * EVOFORMER_CPU_BLOCK_N;
+        const float row_lse = lse[stats + i];
+        const float row_delta = delta[stats + i];
+        if (row_lse == neg_inf) {
+            std::fill(p, p + cols, 0.0f);
+            std::fill(ds, ds + cols, 0.0f);
+            continue;
+        }
+        for (int64_t j = 0; j < cols; ++j) {
+            p[j] = std::exp(p[j] - row_lse);
+            ds[j] = p[j] * (ds[j] - row_delta);
+        }
+    }
+}
+
+/*
+dK, dV and the bias gradients for one key tile of one (batch, head), over all N and query rows.
+dB2[b, h, :, tile] is owned by the task. dB1 sums over heads, so its per-head partial sums go to
+db1_partial[b, h, n, L] and are reduced afterwards.
+*/
+template <typename T>
+void backward_key_tile(const T* grad_out,
+                       const T* q,
+                       const T* k,
+                       const T* v,
+                       const float* lse,
+                       const float* delta,
+                       const T* bias1,
+                       const T* bias2,
+                       T* grad_k,
+                       T* grad_v,
+                       float* db1_partial,
+                       float* grad_bias2,
+                       int64_t b,
+                       int64_t h,
+                       int64_t col_start,
+                       const Evoformer_Shape& s,
+                       Backward_Scratch& w)
+{
+    const int64_t cols = std::min<int64_t>(EVOFORMER_CPU_BLOCK_N, s.L - col_start);
+    const int64_t D = s.D;
+
+    for (int64_t n = 0; n < s.N; ++n) {
+        const int64_t bn = b * s.N + n;
+        load_rows_transposed(w.kt.data(), k + s.offset(bn, col_start, h), cols, s);
+        load_rows_transposed(w.vt.data(), v + s.offset(bn, col_start, h), cols, s);
+        std::fill(w.acc_a.begin(), w.acc_a.end(), 0.0f);  // dK
+        std::fill(w.acc_b.begin(), w.acc_b.end(), 0.0f);  // dV
+        float* db1_row = db1_partial ? db1_partial + ((b * s.H + h) * s.N + n) * s.L + col_start
+                                     : nullptr;
+
+        for (int64_t row_start = 0; row_start < s.L; row_start += EVOFORMER_CPU_BLOCK_M) {
+            const int64_t rows = std::min<int64_t>(EVOFORMER_CPU_BLOCK_M, s.L - row_start);
+            load_rows(w.q.data(), q + s.offset(bn, row_start, h), rows, s, s.scale);
+            load_rows(w.dout.data(), grad_out + s.offset(bn, row_start, h), rows, s, 1.0f);
+            backward_scores(
+                bias1, bias2, lse, delta, bn, h, row_start, rows, col_start, cols, s, w);
+
+            // dV += P^T dO, dK += dS^T (Q / sqrt(D))
+            matmul_ptb_acc(w.acc_b.data(), w.scores.data(), w.dout.data(), rows, cols, D);
+            matmul_ptb_acc(w.acc_a.data(), w.dp.data(), w.q.data(), rows, cols, D);
+
+            for (int64_t i = 0; i < rows; ++i) {
+                const float* ds = w.dp.data() + i * EVOFORMER_CPU_BLOCK_N;
+                if (db1_row) {
+                    for (int64_t j = 0; j < cols; ++j) db1_row[j] += ds[j];
+                }
+                if (grad_bias2) {
+                    float* db2 = grad_bias2 + ((b * s.H + h) * s.L + row_start + i) * s.L + col_start;
+                    if (n == 0) {
+                        for (int64_t j = 0; j < cols; ++j) db2[j] = ds[j];
+                    } else {
+                        for (int64_t j = 0; j < cols; ++j) db2[j] += ds[j];
+                    }
+                }
+            }
+        }
+
+        for (int64_t j = 0; j < cols; ++j) {
+            T* gk = grad_k + s.offset(bn, col_start + j, h);
+            T* gv = grad_v + s.offset(bn, col_start + j, h);
+            for (int64_t d = 0; d < D; ++d) {
+                gk[d] = (T)w.acc_a[j * D + d];
+                gv[d] = (T)w.acc_b[j * D + d];
+            }
+        }
+    }
+}
+
+// dQ for one tile of query rows of one (batch, head)
+template <typename T>
+void backward_query_tile(const T* grad_out,
+                         const T* q,
+                         const T* k,
+                         const T* v,
+                         const float* lse,
+                         const float* delta,
+                         const T* bias1,
+                         const T* bias2,
+                         T* grad_q,
+                         int64_t bn,
+                         int64_t h,
+                         int64_t row_start,
+                         const Evoformer_Shape& s,
+                         Backward_Scratch& w)
+{
+    const int64_t rows = std::min<int64_t>(EVOFORMER_CPU_BLOCK_M, s.L - row_start);
+    const int64_t D = s.D;
+
+    load_rows(w.q.data(), q + s.offset(bn, row_start, h), rows, s, s.scale);
+    load_rows(w.dout.data(), grad_out + s.offset(bn, row_start, h), rows, s, 1.0f);
+    std::fill(w.acc_a.begin(), w.acc_a.end(), 0.0f);  // dQ
+
+    for (int64_t col_start = 0; col_start < s.L; col_start += EVOFORMER_CPU_BLOCK_N) {
+        const int64_t cols = std::min<int64_t>(EVOFORMER_CPU_BLOCK_N, s.L - col_start);
+        load_rows(w.k.data(), k + s.offset(bn, col_start, h), cols, s, 1.0f);
+        load_rows_transposed(w.kt.data(), k + s.offset(bn, col_start, h), cols, s);
+        load_rows_transposed(w.vt.data(), v + s.offset(bn, col_start, h), cols, s);
+        backward_scores(bias1, bias2, lse, delta, bn, h, row_start, rows, col_start, cols, s, w);
+
+        // dQ += dS K
+        matmul_pb_acc(w.acc_a.data(), w.dp.data(), w.k.data(), rows, cols, D);
+    }
+
+    for (int64_t i = 0; i < rows; ++i) {
+        T* gq = grad_q + s.offset(bn, row_start + i, h);
+        for (int64_t d = 0; d < D; ++d) gq[d] = (T)(w.acc_a[i * D + d] * s.scale);
+    }
+}
+
+// delta[bn, h, i] = dO[bn, i, h] . O[bn, i, h]
+template <typename T>
+void backward_delta(const T* grad_out,
+                    const T* out,
+                    float* delta,
+                    int64_t bn,
+                    int64_t h,
+                    const Evoformer_Shape& s)
+{
+    for (int64_t i = 0; i < s.L; ++i) {
+        const T* go = grad_out + s.offset(bn, i, h);
+        const T* o = out + s.offset(bn, i, h);
+        float sum = 0.0f;
+        for (int64_t d = 0; d < s.D; ++d) sum += (float)go[d] * (float)o[d];
+        delta[(bn * s.H + h) * s.lse_stride + i] = sum;
+    }
+}
+
+}  // namespace evoformer_cpu
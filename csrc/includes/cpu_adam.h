@@ -325,3 +325,5 @@ int ds_adam_step_plus_copy(int optimizer_id,
                            torch::Tensor& gpu_params);
 
 int destroy_adam_optimizer(int optimizer_id);
+
+std::shared_ptr<Adam_Optimizer> get_adam_optimizer(int optimizer_id);
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <torch/extension.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Optimizer step over optimizer state that lives in swap files (ZeRO-Infinity). The fp32
+parameter, exp_avg and exp_avg_sq of a partition are streamed in chunks through a fixed ring of
+host staging slots: while chunk k is stepped with Adam_Optimizer::Step_8, chunk k+1 is being
+read and chunk k-1 written back, so the step runs at the bandwidth of the swap device instead
+of alternating between I/O and compute.
+
+Reads and writes are split into blocks and served by a pool of I/O threads with positional
+reads and writes, using O_DIRECT when the buffer, offset and length allow it.
+*/
+class Adam_NVMe_Pipeline {
+public:
+    // staging: [n_slots, 3, chunk_numel] float host tensor, ideally pinned and page aligned.
+    Adam_NVMe_Pipeline(torch::Tensor staging, int64_t n_io_threads, int64_t block_bytes);
+
+    ~Adam_NVMe_Pipeline();
+
+    /*
+    Steps one partition. `grads` holds the fp32 gradient of the partition on entry and the
+    updated fp32 parameter on return. `paths` are the swap files of the parameter, exp_avg and
+    exp_avg_sq, each `file_numel` (>= grads.numel(), the padded size) elements long. Without
+    `state_initialized` the exp_avg and exp_avg_sq files are created and start from zero.
+    */
+    void step(int optimizer_id,
+              size_t step,
+              float lr,
+              float beta1,
+              float beta2,
+              float epsilon,
+              float weight_decay,
+              bool bias_correction,
+              torch::Tensor& grads,
+              const std::vector<std::string>& paths,
+              int64_t file_numel,
+              bool state_initialized);
+
+    int64_t n_slots() const { return n_slots_; }
+
+    int64_t chunk_numel() const { return chunk_numel_; }
+
+private:
+    struct IO_Batch;
+
+    struct IO_Request {
+        int fd;
+        int direct_fd;
+        char* buffer;
+        int64_t bytes;
+        int64_t offset;
+        bool write;
+        IO_Batch* batch;
+    };
+
+    void io_worker();
+
+    // Queues the read (or write) of one chunk of the three tensors from (to) a staging slot.
+    void submit_chunk(int64_t chunk, int64_t slot, bool write, bool read_state);
+
+    void wait(IO_Batch& batch);
+
+    torch::Tensor staging_;
+    int64_t n_slots_;
+    int64_t chunk_numel_;
+    int64_t block_bytes_;
+
+    // Files of the partition being stepped, buffered and O_DIRECT (-1 if not supported).
+    int fds_[3];
+    int direct_fds_[3];
+    int64_t file_bytes_;
+
+    std::vector<std::unique_ptr<IO_Batch>> slot_io_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<IO_Request> queue_;
+    bool stop_;
+    std::vector<std::thread> io_threads_;
+};
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "simd.h"
+
+// Work is split into chunks of this many elements so that a list of many small
+// tensors and a single large tensor both spread evenly over the OpenMP threads.
+#define MULTI_TENSOR_CHUNK (64 * 1024)
+
+// Partial sums are folded into double precision every NORM_BLOCK elements, which
+// bounds the fp32 accumulation error independently of the tensor size.
+#define NORM_BLOCK 4096
+
+// Element type of 16-bit or fp32 source buffers. 16-bit values are passed as raw bits.
+enum class MultiTensorDtype { Float, Half, BFloat16 };
+
+inline float ds_bf16_to_float(uint16_t value)
+{
+    uint32_t bits = (uint32_t)value << 16;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline uint32_t ds_hash32(uint32_t key)
+{
+    key ^= key >> 16;
+    key *= 0x7feb352d;
+    key ^= key >> 15;
+    key *= 0x846ca68b;
+    key ^= key >> 16;
+    return key;
+}
+
+// Rounds to nearest even, or stochastically using the low 16 bits of ds_hash32(key).
+// NaN stays a quiet NaN instead of rounding into inf.
+inline uint16_t ds_float_to_bf16(float value, bool stochastic, uint32_t key)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) return (uint16_t)((bits >> 16) | 0x40);
+    bits += stochastic ? (ds_hash32(key) & 0xffff) : (0x7fff + ((bits >> 16) & 1));
+    return (uint16_t)(bits >> 16);
+}
+
+inline float ds_fp16_to_float(uint16_t value)
+{
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // subnormal half, renormalize into a normal float
+            exponent = 113;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    } else if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// Rounds to nearest even, overflow saturates to inf and NaN stays a quiet NaN.
+inline uint16_t ds_float_to_fp16(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const int32_t exponent = (int32_t)((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+    if (exponent >= 0x1f) return sign | 0x7c00;
+    if (exponent <= 0) {
+        // subnormal half
+        if (exponent < -10) return sign;
+        mantissa |= 0x800000;
+        const int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t rem = mantissa & ((1u << shift) - 1);
+        const uint32_t mid = 1u << (shift - 1);
+        if (rem > mid || (rem == mid && (half & 1))) half++;
+        return sign | half;
+    }
+    uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+    const uint32_t rem = mantissa & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) half++;
+    return half;
+}
+
+template <MultiTensorDtype dtype>
+inline float ds_load_as_float(const void* src, size_t index)
+{
+    if (dtype == MultiTensorDtype::Half) return ds_fp16_to_float(((const uint16_t*)src)[index]);
+    if (dtype == MultiTensorDtype::BFloat16) return ds_bf16_to_float(((const uint16_t*)src)[index]);
+    return ((const float*)src)[index];
+}
+
+#if defined(__AVX512__) or defined(__AVX256__)
+template <MultiTensorDtype dtype>
+inline AVX_Data simd_load_as_float(const void* src, size_t index)
+{
+    AVX_Data result;
+    if (dtype == MultiTensorDtype::Float) {
+        result.data = SIMD_LOAD((float*)src + index);
+        return result;
+    }
+    const uint16_t* ptr = (const uint16_t*)src + index;
+#if defined(__AVX512__)
+    __m256i raw = _mm256_loadu_si256((const __m256i*)ptr);
+    if (dtype == MultiTensorDtype::Half)
+        result.data = _mm512_cvtph_ps(raw);
+    else
+        result.data = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(raw), 16));
+#else
+    __m128i raw = _mm_loadu_si128((const __m128i*)ptr);
+    if (dtype == MultiTensorDtype::Half)
+        result.data = _mm256_cvtph_ps(raw);
+    else
+        result.data = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(raw), 16));
+#endif
+    return result;
+}
+#endif
+
+struct Multi_Tensor_Norm {
+    double sum_sq;
+    float max_abs;
+    bool inf_or_nan;
+};
+
+// Computes the squared L2 norm and the inf norm of a list of fp32 buffers in a single
+// parallel pass. inf_or_nan is set if any element is non-finite. The result does not
+// depend on the number of threads.
+Multi_Tensor_Norm ds_multi_tensor_norm(const std::vector<const float*>& buffers,
+                                       const std::vector<size_t>& sizes);
+
+// dst[t] = src[t] (accumulate == false) or dst[t] += src[t] (accumulate == true) for every
+// buffer pair, converting src to fp32 on the fly. If sum_sq is not null, the squared L2 norm of
+// each updated dst buffer is written to sum_sq[t]. Returns true if any updated value is inf/nan.
+bool ds_multi_tensor_accumulate(const std::vector<float*>& dst,
+                                const std::vector<const void*>& src,
+                                const std::vector<size_t>& sizes,
+                                MultiTensorDtype src_dtype,
+                                bool accumulate,
+                                double* sum_sq);
+
+// dst[t] = bf16(src[t]) for every buffer pair. Values are rounded to nearest even, or
+// stochastically when stochastic_rounding is set. The random bits are derived from seed, the
+// buffer index and the element index, so the result does not depend on the number of threads.
+void ds_multi_tensor_copy_to_bf16(const std::vector<uint16_t*>& dst,
+                                  const std::vector<const float*>& src,
+                                  const std::vector<size_t>& sizes,
+                                  bool stochastic_rounding,
+                                  uint64_t seed);
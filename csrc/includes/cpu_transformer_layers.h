@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+Fused fp32 CPU kernels of the training transformer layer, the counterparts of the kernels in
+custom_cuda_layers.h. Activations are row-major [rows, cols] with rows = batch * seq_len, and
+the attention tensors are laid out as in the CUDA layer: q/k/v as [3, batch, heads, seq, head
+size] and the attention probabilities as [batch * heads * seq, seq].
+
+Dropout masks are uint8 tensors with 1 for kept elements. They are drawn from a counter-based
+hash of (seed, offset + element index), so a mask does not depend on the number of threads.
+*/
+
+// [batch, seq, 3 * hidden] + bias -> [3, batch, heads, seq, hidden / heads]
+void cpu_bias_add_transform_0213(float* output,
+                                 const float* vals,
+                                 const float* bias,
+                                 int batch_size,
+                                 int seq_length,
+                                 int hidden_dim,
+                                 int heads);
+
+// [count, batch, heads, seq, hidden / heads] -> [batch, seq, count * hidden]
+void cpu_transform4d_0213(float* out,
+                          const float* in,
+                          int batch_size,
+                          int heads,
+                          int seq_length,
+                          int hidden_dim,
+                          int trans_count);
+
+// [batch, seq, hidden] -> [batch, heads, seq, hidden / heads]
+void cpu_transform_0213(float* output,
+                        const float* vals,
+                        int batch_size,
+                        int seq_length,
+                        int hidden_dim,
+                        int heads);
+
+// In place softmax over the last dim of [batch, heads, seq, seq] after adding mask[batch, seq]
+void cpu_attn_softmax(float* vals, const float* attn_mask, int batch_size, int heads, int seq_length);
+
+// In place: grad = soft * (grad - sum(grad * soft)) per row
+void cpu_attn_softmax_backward(float* grad, const float* soft, int64_t rows, int seq_length);
+
+// out = in * mask / (1 - ratio), drawing the mask
+void cpu_dropout(float* out,
+                 const float* in,
+                 uint8_t* mask,
+                 int64_t size,
+                 float ratio,
+                 uint64_t seed,
+                 uint64_t offset);
+
+// out = in * mask / (1 - ratio) with an existing mask
+void cpu_dropout_apply(float* out, const float* in, const uint8_t* mask, int64_t size, float ratio);
+
+// out = dropout(in + bias) + residual, drawing the mask if mask is not null
+void cpu_bias_dropout_residual(float* out,
+                               const float* in,
+                               const float* residual,
+                               const float* bias,
+                               uint8_t* mask,
+                               int64_t rows,
+                               int cols,
+                               float ratio,
+                               uint64_t seed,
+                               uint64_t offset);
+
+// out = gelu(in + bias), tanh approximation
+void cpu_bias_gelu(float* out, const float* in, const float* bias, int64_t rows, int cols);
+
+// In place: grad *= gelu'(input + bias)
+void cpu_bias_gelu_backward(float* grad, const float* input, const float* bias, int64_t rows, int cols);
+
+// Layer norm over rows, storing the row variance and, if means is not null, the row mean
+void cpu_layer_norm(float* out,
+                    float* vars,
+                    float* means,
+                    const float* in,
+                    const float* gamma,
+                    const float* beta,
+                    int64_t rows,
+                    int cols,
+                    float epsilon);
+
+/*
+Layer norm backward. With means, vals is the layer norm input; without, vals is its output and
+the normalized input is recovered as (vals - beta) / gamma. If residual_grad is not null it is
+added to grad_in, fusing the gradient of a residual connection around the norm.
+*/
+void cpu_layer_norm_backward(float* grad_in,
+                             float* gamma_grad,
+                             float* beta_grad,
+                             const float* grad_out,
+                             const float* residual_grad,
+                             const float* vals,
+                             const float* gamma,
+                             const float* beta,
+                             const float* vars,
+                             const float* means,
+                             int64_t rows,
+                             int cols,
+                             float epsilon);
+
+// out = a + b
+void cpu_fused_add2(float* out, const float* a, const float* b, int64_t size);
+
+// out[c] = sum over rows of in[r, c]
+void cpu_column_sum(float* out, const float* in, int64_t rows, int cols);
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct DS_Metric_Event {
+    int64_t tag;
+    int64_t step;
+    double value;
+};
+
+// Bounded multi-producer, single-consumer ring of monitor events. Each slot carries a sequence
+// number that tells producers whether it is free and the consumer whether it is published, so a
+// producer only ever does one compare-and-swap on the head and never waits on the consumer. A
+// full ring drops the new event and counts it instead of blocking the training thread.
+class DS_Metrics_Ring {
+public:
+    explicit DS_Metrics_Ring(uint64_t capacity)
+        : _head(0), _tail(0), _dropped(0), _mask(capacity - 1), _slots(new Slot[capacity])
+    {
+        for (uint64_t i = 0; i < capacity; i++) _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    uint64_t capacity() const { return _mask + 1; }
+
+    inline bool push(int64_t tag, double value, int64_t step)
+    {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = _slots[head & _mask];
+            const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq == head) {
+                if (_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    slot.event = {tag, step, value};
+                    slot.seq.store(head + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (seq < head) {
+                // The slot still holds an event from the previous lap.
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                head = _head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Appends up to max_events published events to out, in the order they were claimed. Stops
+    // early at a slot whose producer has not finished writing it. Returns the number of events
+    // dropped since the previous drain.
+    uint64_t drain(std::vector<DS_Metric_Event>& out, uint64_t max_events)
+    {
+        uint64_t tail = _tail.load(std::memory_order_relaxed);
+        for (uint64_t n = 0; n < max_events; n++, tail++) {
+            Slot& slot = _slots[tail & _mask];
+            if (slot.seq.load(std::memory_order_acquire) != tail + 1) break;
+            out.push_back(slot.event);
+            slot.seq.store(tail + _mask + 1, std::memory_order_release);
+        }
+        _tail.store(tail, std::memory_order_relaxed);
+        return _dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    // Number of claimed slots not drained yet, including the ones still being written.
+    uint64_t size() const
+    {
+        return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        DS_Metric_Event event;
+    };
+
+    // producer side
+    alignas(64) std::atomic<uint64_t> _head;
+    // consumer side
+    alignas(64) std::atomic<uint64_t> _tail;
+    std::atomic<uint64_t> _dropped;
+    uint64_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+};
@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <vector>
+
+// Events each thread can buffer between two drains. Must be a power of two.
+#define DS_PROFILE_RING_SIZE (1 << 16)
+
+// Op id of events recorded by the module hook shim.
+#define DS_PROFILE_OP_MODULE 0
+
+// Op ids of events recorded by native kernels. Kernel events carry no module, their module id is 0.
+#define DS_PROFILE_OP_MULTI_TENSOR_NORM 1
+#define DS_PROFILE_OP_MULTI_TENSOR_ACCUMULATE 2
+#define DS_PROFILE_OP_MULTI_TENSOR_COPY_TO_BF16 3
+
+struct DS_Profile_Event {
+    int64_t module_id;
+    int32_t op;
+    int64_t flops;
+    uint64_t start_ns;
+    uint64_t end_ns;
+};
+
+// Single producer, single consumer ring of events. Only the owning thread pushes and only
+// the aggregator pops, so neither side takes a lock. A full ring drops the new event and
+// counts it instead of blocking the producer.
+class DS_Profile_Ring {
+public:
+    DS_Profile_Ring() : _head(0), _cached_tail(0), _tail(0), _dropped(0), _events(DS_PROFILE_RING_SIZE)
+    {
+    }
+
+    inline void push(const DS_Profile_Event& event)
+    {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        // Only re-read the consumer's tail when the ring looks full, which keeps its cache
+        // line out of the producer's way.
+        if (head - _cached_tail == DS_PROFILE_RING_SIZE) {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            if (head - _cached_tail == DS_PROFILE_RING_SIZE) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        _events[head & (DS_PROFILE_RING_SIZE - 1)] = event;
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    // Appends all pending events to out and returns the number of events dropped since
+    // the previous drain.
+    uint64_t drain(std::vector<DS_Profile_Event>& out);
+
+private:
+    // producer side
+    alignas(64) std::atomic<uint64_t> _head;
+    uint64_t _cached_tail;
+    // consumer side
+    alignas(64) std::atomic<uint64_t> _tail;
+    std::atomic<uint64_t> _dropped;
+    std::vector<DS_Profile_Event> _events;
+};
+
+// Entry points of the recorder, owned by the profiler extension. Torch extensions are loaded
+// with RTLD_LOCAL, so an extension that records events cannot link against the profiler's
+// symbols. It gets this table as a capsule from the profiler's recorder() binding instead and
+// passes it to ds_profile_attach, after which all extensions record into the same rings.
+struct DS_Profile_Recorder {
+    const std::atomic<bool>* enabled;
+    void (*record)(int64_t module_id, int32_t op, int64_t flops, uint64_t start_ns, uint64_t end_ns);
+};
+
+#define DS_PROFILE_RECORDER_CAPSULE "ds_profile_recorder"
+
+// Recorder this extension records into, null until attached. Hidden so that every extension
+// that includes this header has its own copy, rather than whichever one was loaded first.
+__attribute__((visibility("hidden"))) inline std::atomic<const DS_Profile_Recorder*>
+    ds_profile_recorder{nullptr};
+
+inline void ds_profile_attach(const DS_Profile_Recorder* recorder)
+{
+    ds_profile_recorder.store(recorder, std::memory_order_release);
+}
+
+inline bool ds_profile_enabled()
+{
+    const DS_Profile_Recorder* recorder = ds_profile_recorder.load(std::memory_order_acquire);
+    return recorder != nullptr && recorder->enabled->load(std::memory_order_relaxed);
+}
+
+// Monotonic clock shared by all events, in nanoseconds.
+inline uint64_t ds_profile_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Records a completed event on the calling thread. A no-op until a recorder is attached.
+inline void ds_profile_record(int64_t module_id,
+                              int32_t op,
+                              int64_t flops,
+                              uint64_t start_ns,
+                              uint64_t end_ns)
+{
+    const DS_Profile_Recorder* recorder = ds_profile_recorder.load(std::memory_order_acquire);
+    if (recorder != nullptr) recorder->record(module_id, op, flops, start_ns, end_ns);
+}
+
+// Records the lifetime of the scope as one event, if recording was on when it was entered.
+class DS_Profile_Scope {
+public:
+    DS_Profile_Scope(int64_t module_id, int32_t op, int64_t flops)
+        : _enabled(ds_profile_enabled()), _module_id(module_id), _op(op), _flops(flops)
+    {
+        if (_enabled) _start_ns = ds_profile_now_ns();
+    }
+
+    ~DS_Profile_Scope()
+    {
+        if (_enabled) ds_profile_record(_module_id, _op, _flops, _start_ns, ds_profile_now_ns());
+    }
+
+private:
+    bool _enabled;
+    int64_t _module_id;
+    int32_t _op;
+    int64_t _flops;
+    uint64_t _start_ns;
+};
+
+// The functions below are only defined by the profiler extension.
+
+void ds_profile_set_enabled(bool enabled);
+
+// Hook shim entry points. begin/end calls nest per thread; end records the event of the
+// matching begin.
+void ds_profile_begin(int64_t module_id);
+void ds_profile_end(int64_t module_id, int64_t flops);
+
+// Moves the pending events of every thread into out. Returns the number of dropped events.
+uint64_t ds_profile_drain(std::vector<DS_Profile_Event>& out);
+
+// Table of the profiler extension's recorder, handed out to other extensions.
+const DS_Profile_Recorder* ds_profile_local_recorder();
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+/*
+Shared tracing for the native ops. Each op compiles csrc/common/ds_trace.cpp, records spans and
+counters into per-thread buffers, and exports them through the C entry points below, which
+deepspeed/utils/native_trace.py collects from every loaded op and writes as one Chrome/Perfetto
+JSON trace. All ops share the monotonic clock, so their events line up on one timeline.
+
+Recording is off unless the DS_NATIVE_TRACE environment variable is set or it is switched on at
+runtime. A disabled span costs one relaxed atomic load.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Upper bound of buffered events per thread between two collections.
+#define DS_TRACE_MAX_THREAD_EVENTS (1 << 20)
+
+extern std::atomic<bool> ds_trace_enabled_flag;
+
+inline bool ds_trace_enabled() { return ds_trace_enabled_flag.load(std::memory_order_relaxed); }
+
+uint64_t ds_trace_now_ns();
+
+// Category and name must outlive the trace, e.g. string literals. bytes is attached to the
+// event as an argument when it is not negative.
+void ds_trace_complete(const char* category,
+                       const char* name,
+                       uint64_t start_ns,
+                       uint64_t end_ns,
+                       int64_t bytes);
+
+void ds_trace_counter(const char* category, const char* name, int64_t value);
+
+class DS_Trace_Span {
+public:
+    DS_Trace_Span(const char* category, const char* name, int64_t bytes = -1)
+        : _enabled(ds_trace_enabled()), _category(category), _name(name), _bytes(bytes)
+    {
+        if (_enabled) _start_ns = ds_trace_now_ns();
+    }
+
+    ~DS_Trace_Span()
+    {
+        if (_enabled) ds_trace_complete(_category, _name, _start_ns, ds_trace_now_ns(), _bytes);
+    }
+
+private:
+    bool _enabled;
+    const char* _category;
+    const char* _name;
+    int64_t _bytes;
+    uint64_t _start_ns;
+};
+
+#define DS_TRACE_CONCAT_IMPL(x, y) x##y
+#define DS_TRACE_CONCAT(x, y) DS_TRACE_CONCAT_IMPL(x, y)
+
+// Records the rest of the enclosing scope as one span.
+#define DS_TRACE_SPAN(category, name, ...) \
+    DS_Trace_Span DS_TRACE_CONCAT(ds_trace_span_, __LINE__)(category, name, ##__VA_ARGS__)
+
+#define DS_TRACE_COUNTER(category, name, value)                         \
+    do {                                                                \
+        if (ds_trace_enabled()) ds_trace_counter(category, name, value); \
+    } while (0)
+
+extern "C" {
+// Returns the previous state.
+int ds_trace_set_enabled(int enabled);
+int ds_trace_is_enabled();
+// Moves all buffered events out and returns them as comma separated Chrome trace event objects.
+// The string stays valid until the next call.
+const char* ds_trace_collect_json();
+// Events dropped because a thread buffer was full, since the last collection.
+int64_t ds_trace_dropped_events();
+}
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <stdint.h>
+#include "cpu_multi_tensor.h"
+
+/*
+CPU counterparts of the ZeRO++ quantization kernels in quantization.h, producing the same format:
+groups of int8 (or two int4 per byte, the first element in the high nibble) values with one fp32
+scale per group for symmetric and a (scale, offset) pair for asymmetric quantization, where
+value = q * scale (+ offset). Each group is quantized in a single pass over its elements after
+the range is found, and groups are spread over the OpenMP threads.
+*/
+namespace quantize_cpu {
+
+enum class Type { Symmetric, Asymmetric };
+
+inline bool requires_offset(Type q_type) { return q_type == Type::Asymmetric; }
+
+// The quantizers of deepspeed/compression/utils.py.
+enum class FakeQuantType { Symmetric, Asymmetric, Ternary, Binary };
+
+}  // namespace quantize_cpu
+
+void launch_quant_cpu(int8_t* output_data,
+                      float* params,
+                      const void* input_data,
+                      MultiTensorDtype input_dtype,
+                      int64_t groups,
+                      int64_t elems_per_group,
+                      int num_bits,
+                      quantize_cpu::Type quant_type);
+
+// The output is fp32, or fp16 / bf16 raw bits.
+void launch_dequantize_cpu(void* dequant_data,
+                           MultiTensorDtype output_dtype,
+                           const int8_t* q_data,
+                           const float* q_params,
+                           quantize_cpu::Type q_type,
+                           int num_bits,
+                           int64_t elems_per_group,
+                           int64_t total_elems);
+
+/*
+Quantizes like launch_quant_cpu, but stores the groups in the order of the hierarchical
+all-to-all of the quantized gradient reduction: the groups of partition
+`node * devices_per_node + device` are moved to position `device * nodes + node`, after an
+optional slicing of every partition into `pipelining` contiguous pieces.
+*/
+void launch_swizzled_quant_cpu(int8_t* q_data,
+                               float* q_scales,
+                               const void* input_data,
+                               MultiTensorDtype input_dtype,
+                               int num_bits,
+                               quantize_cpu::Type q_type,
+                               int64_t groups,
+                               int64_t elems_per_group,
+                               int64_t pipelining,
+                               int64_t nodes,
+                               int64_t devices_per_node);
+
+/*
+Dequantizes `num_tensors` quantized tensors of `elems_per_in_tensor` bytes each, sums them and
+quantizes the sum into `out_groups` groups. Sizes are in bytes of quantized data, as in
+launch_dequant_reduce. The sum is accumulated in fp32.
+*/
+void launch_dequant_reduce_cpu(int8_t* reduced_data,
+                               float* reduced_scales,
+                               const int8_t* input_data,
+                               const float* input_scales,
+                               int64_t num_tensors,
+                               int num_bits,
+                               quantize_cpu::Type quant_type,
+                               int64_t out_groups,
+                               int64_t elems_per_out_group,
+                               int64_t elems_per_in_tensor,
+                               int64_t groups_per_in_tensor,
+                               int64_t elems_per_in_group);
+
+/*
+Quantizes and dequantizes fp32 groups in place of the torch ops of the compression quantizers:
+one pass finds the range of every group, a second writes the dequantized values (ternary
+quantization needs one more pass for its alpha). `static_range` is null, or points to the
+(min, max) of the static activation quantization of a single group. `l1_mean` holds the mean
+magnitude of every group for the ternary and binary quantizers and is null otherwise.
+*/
+void launch_fake_quantize_cpu(float* output,
+                              const float* input,
+                              int64_t groups,
+                              int64_t elems_per_group,
+                              int num_bits,
+                              quantize_cpu::FakeQuantType quant_type,
+                              const float* static_range,
+                              const float* l1_mean);
@@ -28,6 +28,9 @@
 #define SIMD_ANDNOT(x, y) _mm512_andnot_ps(x, y)
 #define SIMD_OR(x, y) _mm512_or_ps(x, y)
 #define SIMD_XOR(x, y) _mm512_xor_ps(x, y)
+#define SIMD_MAX(x, y) _mm512_max_ps(x, y)
+#define SIMD_MIN(x, y) _mm512_min_ps(x, y)
+#define SIMD_ROUND(x) _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
 #define SIMD_WIDTH 16
 
 #define SIMD_LOAD2(x, h) \
@@ -50,6 +53,9 @@
 #define SIMD_ANDNOT(x, y) _mm256_andnot_ps(x, y)
 #define SIMD_OR(x, y) _mm256_or_ps(x, y)
 #define SIMD_XOR(x, y) _mm256_xor_ps(x, y)
+#define SIMD_MAX(x, y) _mm256_max_ps(x, y)
+#define SIMD_MIN(x, y) _mm256_min_ps(x, y)
+#define SIMD_ROUND(x) _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
 #define SIMD_WIDTH 8
 
 #define SIMD_LOAD2(x, h) \
@@ -195,4 +201,11 @@ inline void simd_xor(AVX_Data* dst, AVX_Data* src_a_l, AVX_Data* src_a_r)
     for (size_t i = 0; i < span; ++i) { dst[i].data = SIMD_XOR(src_a_l[i].data, src_a_r[i].data); }
 }
 
+template <int span>
+inline void simd_max(AVX_Data* dst, AVX_Data* src_a_l, AVX_Data* src_a_r)
+{
+#pragma unroll
+    for (size_t i = 0; i < span; ++i) { dst[i].data = SIMD_MAX(src_a_l[i].data, src_a_r[i].data); }
+}
+
 #endif
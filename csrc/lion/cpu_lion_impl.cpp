@@ -10,6 +10,7 @@
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
+#include "ds_trace.h"
 #include "cpu_lion.h"
 
 #if defined(__ENABLE_CUDA__)
@@ -192,6 +193,7 @@ int ds_lion_step(int optimizer_id,
                  torch::Tensor& grads,
                  torch::Tensor& exp_avg)
 {
+    DS_TRACE_SPAN("optimizer", "lion_step", (int64_t)params.nbytes());
     auto params_c = params.contiguous();
     auto grads_c = grads.contiguous();
     auto exp_avg_c = exp_avg.contiguous();
@@ -231,6 +233,7 @@ int ds_lion_step_plus_copy(int optimizer_id,
                            torch::Tensor& exp_avg,
                            torch::Tensor& gpu_params)
 {
+    DS_TRACE_SPAN("optimizer", "lion_step", (int64_t)params.nbytes());
 #if defined(__ENABLE_CUDA__) or defined(__ENABLE_CANN__)
     auto params_c = params.contiguous();
     auto gpu_params_c = gpu_params.contiguous();
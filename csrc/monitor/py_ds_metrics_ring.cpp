@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <torch/extension.h>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include "ds_metrics_ring.h"
+
+static std::shared_ptr<DS_Metrics_Ring> make_ring(int64_t capacity)
+{
+    if (capacity <= 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("MetricsRing capacity must be a positive power of two");
+    }
+    return std::make_shared<DS_Metrics_Ring>((uint64_t)capacity);
+}
+
+/*
+Returns (events, dropped), where events is a list of (tag, value, step) tuples in the order
+they were enqueued and dropped is the number of events lost to a full ring since the previous
+drain.
+*/
+static std::tuple<std::vector<std::tuple<int64_t, double, int64_t>>, int64_t> drain(
+    DS_Metrics_Ring& ring,
+    int64_t max_events)
+{
+    std::vector<DS_Metric_Event> events;
+    uint64_t dropped;
+    {
+        py::gil_scoped_release release;
+        dropped = ring.drain(events, (uint64_t)max_events);
+    }
+
+    std::vector<std::tuple<int64_t, double, int64_t>> result;
+    result.reserve(events.size());
+    for (const auto& event : events) result.emplace_back(event.tag, event.value, event.step);
+    return std::make_tuple(std::move(result), (int64_t)dropped);
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    py::class_<DS_Metrics_Ring, std::shared_ptr<DS_Metrics_Ring>>(m, "MetricsRing")
+        .def(py::init(&make_ring), py::arg("capacity"))
+        .def_property_readonly("capacity", &DS_Metrics_Ring::capacity)
+        .def("push",
+             &DS_Metrics_Ring::push,
+             "Enqueue a (tag, value, step) event, returns False if the ring is full")
+        .def("drain", &drain, "Dequeue up to max_events events")
+        .def("size", &DS_Metrics_Ring::size, "Number of events not drained yet");
+}
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <torch/extension.h>
+#include <cmath>
+#include "cpu_multi_tensor.h"
+#include "ds_profiler.h"
+
+static void check_cpu_fp32(const torch::Tensor& tensor, const char* name)
+{
+    TORCH_CHECK(tensor.device().is_cpu(), name, " must be a CPU tensor");
+    TORCH_CHECK(tensor.scalar_type() == at::kFloat, name, " must be an fp32 tensor");
+    TORCH_CHECK(tensor.is_contiguous(), name, " must be contiguous");
+}
+
+/*
+Returns (norm, inf_or_nan) over the concatenation of all tensors. norm is the L2 norm for
+norm_type == 2 and the max absolute value for norm_type == inf.
+*/
+std::tuple<double, bool> multi_tensor_norm(std::vector<torch::Tensor>& tensors, double norm_type)
+{
+    TORCH_CHECK(norm_type == 2.0 || std::isinf(norm_type), "Only L2 and inf norms are supported");
+
+    std::vector<const float*> buffers;
+    std::vector<size_t> sizes;
+    int64_t numel = 0;
+    for (auto& tensor : tensors) {
+        check_cpu_fp32(tensor, "tensors");
+        buffers.push_back(tensor.data_ptr<float>());
+        sizes.push_back(tensor.numel());
+        numel += tensor.numel();
+    }
+
+    DS_Profile_Scope profile(0, DS_PROFILE_OP_MULTI_TENSOR_NORM, 2 * numel);
+
+    Multi_Tensor_Norm result = ds_multi_tensor_norm(buffers, sizes);
+    double norm = std::isinf(norm_type) ? (double)result.max_abs : std::sqrt(result.sum_sq);
+    return std::make_tuple(norm, result.inf_or_nan);
+}
+
+static MultiTensorDtype get_multi_tensor_dtype(const torch::Tensor& tensor)
+{
+    if (tensor.scalar_type() == at::kHalf) return MultiTensorDtype::Half;
+    if (tensor.scalar_type() == at::kBFloat16) return MultiTensorDtype::BFloat16;
+    TORCH_CHECK(tensor.scalar_type() == at::kFloat, "Unsupported dtype ", tensor.scalar_type());
+    return MultiTensorDtype::Float;
+}
+
+/*
+Copies (accumulate == false) or adds (accumulate == true) every src tensor into the matching fp32
+dst tensor in one parallel pass, converting fp16/bf16 src to fp32 on the fly. Returns the squared
+L2 norm of each updated dst tensor (empty if compute_norm is false) and whether any updated value
+is inf/nan.
+*/
+std::tuple<std::vector<double>, bool> multi_tensor_accumulate(std::vector<torch::Tensor>& dst,
+                                                              std::vector<torch::Tensor>& src,
+                                                              bool accumulate,
+                                                              bool compute_norm)
+{
+    TORCH_CHECK(dst.size() == src.size(), "dst and src must have the same number of tensors");
+
+    std::vector<float*> dst_buffers;
+    std::vector<const void*> src_buffers;
+    std::vector<size_t> sizes;
+    int64_t numel = 0;
+    MultiTensorDtype src_dtype = MultiTensorDtype::Float;
+    for (size_t t = 0; t < dst.size(); t++) {
+        check_cpu_fp32(dst[t], "dst");
+        TORCH_CHECK(src[t].device().is_cpu(), "src must be a CPU tensor");
+        TORCH_CHECK(src[t].is_contiguous(), "src must be contiguous");
+        TORCH_CHECK(src[t].numel() == dst[t].numel(), "src and dst sizes must match");
+        if (t == 0) src_dtype = get_multi_tensor_dtype(src[t]);
+        TORCH_CHECK(get_multi_tensor_dtype(src[t]) == src_dtype, "src tensors must share a dtype");
+
+        dst_buffers.push_back(dst[t].data_ptr<float>());
+        src_buffers.push_back(src[t].data_ptr());
+        sizes.push_back(dst[t].numel());
+        numel += dst[t].numel();
+    }
+
+    DS_Profile_Scope profile(0,
+                             DS_PROFILE_OP_MULTI_TENSOR_ACCUMULATE,
+                             (accumulate ? numel : 0) + (compute_norm ? 2 * numel : 0));
+    std::vector<double> sum_sq(compute_norm ? dst.size() : 0);
+    bool inf_or_nan = ds_multi_tensor_accumulate(dst_buffers,
+                                                 src_buffers,
+                                                 sizes,
+                                                 src_dtype,
+                                                 accumulate,
+                                                 compute_norm ? sum_sq.data() : nullptr);
+    return std::make_tuple(sum_sq, inf_or_nan);
+}
+
+/*
+Writes bf16(src[t]) into every bf16 dst[t] in one parallel pass, rounding to nearest even or,
+if stochastic_rounding is set, stochastically with random bits derived from seed.
+*/
+void multi_tensor_copy_to_bf16(std::vector<torch::Tensor>& dst,
+                               std::vector<torch::Tensor>& src,
+                               bool stochastic_rounding,
+                               int64_t seed)
+{
+    TORCH_CHECK(dst.size() == src.size(), "dst and src must have the same number of tensors");
+
+    std::vector<uint16_t*> dst_buffers;
+    std::vector<const float*> src_buffers;
+    std::vector<size_t> sizes;
+    for (size_t t = 0; t < dst.size(); t++) {
+        check_cpu_fp32(src[t], "src");
+        TORCH_CHECK(dst[t].device().is_cpu(), "dst must be a CPU tensor");
+        TORCH_CHECK(dst[t].scalar_type() == at::kBFloat16, "dst must be a bf16 tensor");
+        TORCH_CHECK(dst[t].is_contiguous(), "dst must be contiguous");
+        TORCH_CHECK(src[t].numel() == dst[t].numel(), "src and dst sizes must match");
+
+        dst_buffers.push_back((uint16_t*)dst[t].data_ptr());
+        src_buffers.push_back(src[t].data_ptr<float>());
+        sizes.push_back(dst[t].numel());
+    }
+
+    DS_Profile_Scope profile(0, DS_PROFILE_OP_MULTI_TENSOR_COPY_TO_BF16, 0);
+    ds_multi_tensor_copy_to_bf16(
+        dst_buffers, src_buffers, sizes, stochastic_rounding, (uint64_t)seed);
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    m.def("multi_tensor_norm",
+          &multi_tensor_norm,
+          "Global L2/inf norm and inf/nan flag over a list of CPU fp32 tensors (C++)");
+    m.def("multi_tensor_accumulate",
+          &multi_tensor_accumulate,
+          "Fused copy/accumulate of CPU gradients into fp32 tensors with per-tensor norms (C++)");
+    m.def("multi_tensor_copy_to_bf16",
+          &multi_tensor_copy_to_bf16,
+          "Fused fp32 to bf16 copy with optional stochastic rounding (C++)");
+    m.def(
+        "profile_attach",
+        [](py::capsule recorder) {
+            void* table = PyCapsule_GetPointer(recorder.ptr(), DS_PROFILE_RECORDER_CAPSULE);
+            if (table == nullptr) throw py::error_already_set();
+            ds_profile_attach((const DS_Profile_Recorder*)table);
+        },
+        "Record the kernel events into the native profiler's recorder");
+}
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <stdint.h>
+#include <algorithm>
+#include "cpu_multi_tensor.h"
+
+struct Accumulate_Chunk {
+    size_t buffer;
+    size_t offset;
+    size_t size;
+};
+
+template <MultiTensorDtype src_dtype>
+static void accumulate_chunk(float* dst,
+                             const void* src,
+                             size_t size,
+                             bool accumulate,
+                             double* sum_sq,
+                             bool* inf_or_nan)
+{
+    double total = 0.0;
+    float finite_check = 0.0f;
+    size_t rounded_size = 0;
+
+#if defined(__AVX512__) or defined(__AVX256__)
+    rounded_size = ROUND_DOWN(size, SIMD_WIDTH);
+
+    AVX_Data zero;
+    zero.data = SIMD_SET(0.0f);
+    AVX_Data check;
+    check.data = zero.data;
+
+    float lanes[SIMD_WIDTH];
+    for (size_t b = 0; b < rounded_size; b += NORM_BLOCK) {
+        size_t end = std::min(b + NORM_BLOCK, rounded_size);
+        AVX_Data acc;
+        acc.data = zero.data;
+
+        for (size_t i = b; i < end; i += SIMD_WIDTH) {
+            AVX_Data value = simd_load_as_float<src_dtype>(src, i);
+            if (accumulate) value.data = SIMD_ADD(value.data, SIMD_LOAD(dst + i));
+            SIMD_STORE(dst + i, value.data);
+            check.data = SIMD_FMA(value.data, zero.data, check.data);
+            acc.data = SIMD_FMA(value.data, value.data, acc.data);
+        }
+
+        SIMD_STORE(lanes, acc.data);
+        for (int l = 0; l < SIMD_WIDTH; l++) total += (double)lanes[l];
+    }
+
+    SIMD_STORE(lanes, check.data);
+    for (int l = 0; l < SIMD_WIDTH; l++) finite_check += lanes[l];
+#endif
+
+    for (size_t i = rounded_size; i < size; i++) {
+        float value = ds_load_as_float<src_dtype>(src, i);
+        if (accumulate) value += dst[i];
+        dst[i] = value;
+        total += (double)value * (double)value;
+        finite_check += value * 0.0f;
+    }
+
+    *sum_sq = total;
+    *inf_or_nan = !(finite_check == 0.0f);
+}
+
+template <MultiTensorDtype src_dtype>
+static bool multi_tensor_accumulate(const std::vector<float*>& dst,
+                                    const std::vector<const void*>& src,
+                                    const std::vector<size_t>& sizes,
+                                    bool accumulate,
+                                    double* sum_sq)
+{
+    const size_t elem_size = (src_dtype == MultiTensorDtype::Float) ? 4 : 2;
+
+    std::vector<Accumulate_Chunk> chunks;
+    for (size_t t = 0; t < dst.size(); t++) {
+        for (size_t offset = 0; offset < sizes[t]; offset += MULTI_TENSOR_CHUNK) {
+            chunks.push_back(
+                {t, offset, std::min((size_t)MULTI_TENSOR_CHUNK, sizes[t] - offset)});
+        }
+    }
+
+    int64_t num_chunks = chunks.size();
+    std::vector<double> chunk_sum_sq(num_chunks);
+    std::vector<char> chunk_inf_or_nan(num_chunks);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t c = 0; c < num_chunks; c++) {
+        const Accumulate_Chunk& chunk = chunks[c];
+        bool inf_or_nan;
+        accumulate_chunk<src_dtype>(
+            dst[chunk.buffer] + chunk.offset,
+            (const uint8_t*)src[chunk.buffer] + chunk.offset * elem_size,
+            chunk.size,
+            accumulate,
+            &chunk_sum_sq[c],
+            &inf_or_nan);
+        chunk_inf_or_nan[c] = inf_or_nan;
+    }
+
+    // chunks are ordered by buffer, so per-buffer norms are reduced in a fixed order
+    bool inf_or_nan = false;
+    if (sum_sq) std::fill(sum_sq, sum_sq + dst.size(), 0.0);
+    for (int64_t c = 0; c < num_chunks; c++) {
+        if (sum_sq) sum_sq[chunks[c].buffer] += chunk_sum_sq[c];
+        inf_or_nan = inf_or_nan || chunk_inf_or_nan[c];
+    }
+    return inf_or_nan;
+}
+
+bool ds_multi_tensor_accumulate(const std::vector<float*>& dst,
+                                const std::vector<const void*>& src,
+                                const std::vector<size_t>& sizes,
+                                MultiTensorDtype src_dtype,
+                                bool accumulate,
+                                double* sum_sq)
+{
+    if (src_dtype == MultiTensorDtype::Half)
+        return multi_tensor_accumulate<MultiTensorDtype::Half>(dst, src, sizes, accumulate, sum_sq);
+    if (src_dtype == MultiTensorDtype::BFloat16)
+        return multi_tensor_accumulate<MultiTensorDtype::BFloat16>(
+            dst, src, sizes, accumulate, sum_sq);
+    return multi_tensor_accumulate<MultiTensorDtype::Float>(dst, src, sizes, accumulate, sum_sq);
+}
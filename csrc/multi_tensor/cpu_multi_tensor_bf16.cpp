@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <stdint.h>
+#include <algorithm>
+#include "cpu_multi_tensor.h"
+
+struct Copy_Chunk {
+    size_t buffer;
+    size_t offset;
+    size_t size;
+};
+
+#if defined(__AVX512__)
+#define SIMD_INT __m512i
+#define SIMD_INT_SET(x) _mm512_set1_epi32(x)
+#define SIMD_INT_ADD(x, y) _mm512_add_epi32(x, y)
+#define SIMD_INT_AND(x, y) _mm512_and_si512(x, y)
+#define SIMD_INT_XOR(x, y) _mm512_xor_si512(x, y)
+#define SIMD_INT_OR(x, y) _mm512_or_si512(x, y)
+#define SIMD_INT_MUL(x, y) _mm512_mullo_epi32(x, y)
+#define SIMD_INT_SRL(x, n) _mm512_srli_epi32(x, n)
+#define SIMD_INT_IOTA _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)
+#elif defined(__AVX256__)
+#define SIMD_INT __m256i
+#define SIMD_INT_SET(x) _mm256_set1_epi32(x)
+#define SIMD_INT_ADD(x, y) _mm256_add_epi32(x, y)
+#define SIMD_INT_AND(x, y) _mm256_and_si256(x, y)
+#define SIMD_INT_XOR(x, y) _mm256_xor_si256(x, y)
+#define SIMD_INT_OR(x, y) _mm256_or_si256(x, y)
+#define SIMD_INT_MUL(x, y) _mm256_mullo_epi32(x, y)
+#define SIMD_INT_SRL(x, n) _mm256_srli_epi32(x, n)
+#define SIMD_INT_IOTA _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+#endif
+
+#if defined(__AVX512__) or defined(__AVX256__)
+// Vector form of ds_hash32, lane for lane.
+static inline SIMD_INT simd_hash32(SIMD_INT key)
+{
+    key = SIMD_INT_XOR(key, SIMD_INT_SRL(key, 16));
+    key = SIMD_INT_MUL(key, SIMD_INT_SET(0x7feb352d));
+    key = SIMD_INT_XOR(key, SIMD_INT_SRL(key, 15));
+    key = SIMD_INT_MUL(key, SIMD_INT_SET((int)0x846ca68b));
+    key = SIMD_INT_XOR(key, SIMD_INT_SRL(key, 16));
+    return key;
+}
+#endif
+
+static void copy_chunk_to_bf16(uint16_t* dst,
+                               const float* src,
+                               size_t size,
+                               bool stochastic,
+                               uint32_t key)
+{
+    size_t rounded_size = 0;
+
+#if defined(__AVX512__) or defined(__AVX256__)
+    rounded_size = ROUND_DOWN(size, SIMD_WIDTH);
+
+    const SIMD_INT one = SIMD_INT_SET(1);
+    const SIMD_INT round_bias = SIMD_INT_SET(0x7fff);
+    const SIMD_INT noise_mask = SIMD_INT_SET(0xffff);
+    const SIMD_INT quiet_bit = SIMD_INT_SET(0x40);
+    const SIMD_INT iota = SIMD_INT_IOTA;
+
+    for (size_t i = 0; i < rounded_size; i += SIMD_WIDTH) {
+        AVX_Data value;
+        value.data = SIMD_LOAD(src + i);
+#if defined(__AVX512__)
+        SIMD_INT bits = _mm512_castps_si512(value.data);
+#else
+        SIMD_INT bits = _mm256_castps_si256(value.data);
+#endif
+        SIMD_INT high = SIMD_INT_SRL(bits, 16);
+        SIMD_INT noise;
+        if (stochastic) {
+            SIMD_INT lane_key = SIMD_INT_ADD(SIMD_INT_SET((int)(key + (uint32_t)i)), iota);
+            noise = SIMD_INT_AND(simd_hash32(lane_key), noise_mask);
+        } else {
+            noise = SIMD_INT_ADD(round_bias, SIMD_INT_AND(high, one));
+        }
+        SIMD_INT rounded = SIMD_INT_SRL(SIMD_INT_ADD(bits, noise), 16);
+        SIMD_INT nan_bits = SIMD_INT_OR(high, quiet_bit);
+
+#if defined(__AVX512__)
+        __mmask16 is_nan = _mm512_cmp_ps_mask(value.data, value.data, _CMP_UNORD_Q);
+        rounded = _mm512_mask_mov_epi32(rounded, is_nan, nan_bits);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtepi32_epi16(rounded));
+#else
+        __m256i is_nan =
+            _mm256_castps_si256(_mm256_cmp_ps(value.data, value.data, _CMP_UNORD_Q));
+        rounded = _mm256_blendv_epi8(rounded, nan_bits, is_nan);
+        // every lane fits in 16 bits, so the saturating pack is exact; gather both halves
+        // into the low 128 bits
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(rounded, rounded), 0x08);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm256_castsi256_si128(packed));
+#endif
+    }
+#endif
+
+    for (size_t i = rounded_size; i < size; i++) {
+        dst[i] = ds_float_to_bf16(src[i], stochastic, key + (uint32_t)i);
+    }
+}
+
+void ds_multi_tensor_copy_to_bf16(const std::vector<uint16_t*>& dst,
+                                  const std::vector<const float*>& src,
+                                  const std::vector<size_t>& sizes,
+                                  bool stochastic_rounding,
+                                  uint64_t seed)
+{
+    std::vector<Copy_Chunk> chunks;
+    for (size_t t = 0; t < dst.size(); t++) {
+        for (size_t offset = 0; offset < sizes[t]; offset += MULTI_TENSOR_CHUNK) {
+            chunks.push_back({t, offset, std::min((size_t)MULTI_TENSOR_CHUNK, sizes[t] - offset)});
+        }
+    }
+
+    int64_t num_chunks = chunks.size();
+
+#pragma omp parallel for schedule(static)
+    for (int64_t c = 0; c < num_chunks; c++) {
+        const Copy_Chunk& chunk = chunks[c];
+        // every buffer draws from its own stream, indexed by the element offset
+        uint32_t buffer_key = ds_hash32((uint32_t)seed ^ ds_hash32((uint32_t)(seed >> 32) +
+                                                                   (uint32_t)chunk.buffer));
+        copy_chunk_to_bf16(dst[chunk.buffer] + chunk.offset,
+                           src[chunk.buffer] + chunk.offset,
+                           chunk.size,
+                           stochastic_rounding,
+                           buffer_key + (uint32_t)chunk.offset);
+    }
+}
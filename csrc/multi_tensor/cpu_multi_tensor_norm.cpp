@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include "cpu_multi_tensor.h"
+
+struct Norm_Chunk {
+    const float* data;
+    size_t size;
+};
+
+static void block_norm(const float* data,
+                       size_t size,
+                       double* sum_sq,
+                       float* max_abs,
+                       bool* inf_or_nan)
+{
+    double total = 0.0;
+    float max_val = 0.0f;
+    // x * 0 is 0 for every finite x and NaN otherwise, so a single accumulator
+    // detects both inf and nan without a compare per element.
+    float finite_check = 0.0f;
+    size_t rounded_size = 0;
+
+#if defined(__AVX512__) or defined(__AVX256__)
+    rounded_size = ROUND_DOWN(size, SIMD_WIDTH * 4);
+
+    AVX_Data zero;
+    zero.data = SIMD_SET(0.0f);
+    AVX_Data sign_mask;
+    sign_mask.data = SIMD_SET(-0.0f);
+
+    AVX_Data max_4[4];
+    AVX_Data check_4[4];
+    for (int j = 0; j < 4; j++) {
+        max_4[j].data = zero.data;
+        check_4[j].data = zero.data;
+    }
+
+    float lanes[SIMD_WIDTH];
+    for (size_t b = 0; b < rounded_size; b += NORM_BLOCK) {
+        size_t end = std::min(b + NORM_BLOCK, rounded_size);
+        AVX_Data acc_4[4];
+        for (int j = 0; j < 4; j++) acc_4[j].data = zero.data;
+
+        for (size_t i = b; i < end; i += SIMD_WIDTH * 4) {
+            AVX_Data data_4[4];
+            simd_load<4>(data_4, const_cast<float*>(data + i), false);
+            simd_fma<4>(check_4, data_4, zero, check_4);
+            simd_fma<4>(acc_4, data_4, data_4, acc_4);
+            for (int j = 0; j < 4; j++) {
+                data_4[j].data = SIMD_ANDNOT(sign_mask.data, data_4[j].data);
+            }
+            simd_max<4>(max_4, max_4, data_4);
+        }
+
+        simd_add<2>(acc_4, acc_4, acc_4 + 2);
+        acc_4[0].data = SIMD_ADD(acc_4[0].data, acc_4[1].data);
+        SIMD_STORE(lanes, acc_4[0].data);
+        for (int l = 0; l < SIMD_WIDTH; l++) total += (double)lanes[l];
+    }
+
+    simd_max<2>(max_4, max_4, max_4 + 2);
+    max_4[0].data = SIMD_MAX(max_4[0].data, max_4[1].data);
+    SIMD_STORE(lanes, max_4[0].data);
+    for (int l = 0; l < SIMD_WIDTH; l++) max_val = std::max(max_val, lanes[l]);
+
+    simd_add<2>(check_4, check_4, check_4 + 2);
+    check_4[0].data = SIMD_ADD(check_4[0].data, check_4[1].data);
+    SIMD_STORE(lanes, check_4[0].data);
+    for (int l = 0; l < SIMD_WIDTH; l++) finite_check += lanes[l];
+#endif
+
+    for (size_t i = rounded_size; i < size; i++) {
+        float val = data[i];
+        total += (double)val * (double)val;
+        max_val = std::max(max_val, fabsf(val));
+        finite_check += val * 0.0f;
+    }
+
+    *sum_sq = total;
+    *max_abs = max_val;
+    *inf_or_nan = !(finite_check == 0.0f);
+}
+
+Multi_Tensor_Norm ds_multi_tensor_norm(const std::vector<const float*>& buffers,
+                                       const std::vector<size_t>& sizes)
+{
+    std::vector<Norm_Chunk> chunks;
+    for (size_t t = 0; t < buffers.size(); t++) {
+        for (size_t offset = 0; offset < sizes[t]; offset += MULTI_TENSOR_CHUNK) {
+            size_t chunk_size = std::min((size_t)MULTI_TENSOR_CHUNK, sizes[t] - offset);
+            chunks.push_back({buffers[t] + offset, chunk_size});
+        }
+    }
+
+    int64_t num_chunks = chunks.size();
+    std::vector<double> chunk_sum_sq(num_chunks);
+    std::vector<float> chunk_max_abs(num_chunks);
+    std::vector<char> chunk_inf_or_nan(num_chunks);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t c = 0; c < num_chunks; c++) {
+        bool inf_or_nan;
+        block_norm(
+            chunks[c].data, chunks[c].size, &chunk_sum_sq[c], &chunk_max_abs[c], &inf_or_nan);
+        chunk_inf_or_nan[c] = inf_or_nan;
+    }
+
+    // Kahan summation over the chunk partials in a fixed order keeps the result
+    // reproducible across thread counts.
+    Multi_Tensor_Norm result = {0.0, 0.0f, false};
+    double compensation = 0.0;
+    for (int64_t c = 0; c < num_chunks; c++) {
+        double y = chunk_sum_sq[c] - compensation;
+        double t = result.sum_sq + y;
+        compensation = (t - result.sum_sq) - y;
+        result.sum_sq = t;
+        result.max_abs = std::max(result.max_abs, chunk_max_abs[c]);
+        result.inf_or_nan = result.inf_or_nan || chunk_inf_or_nan[c];
+    }
+    return result;
+}
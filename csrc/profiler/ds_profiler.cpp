@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "ds_profiler.h"
+#include <memory>
+#include <mutex>
+#include <utility>
+
+static std::atomic<bool> ds_profile_enabled_flag(false);
+
+// Rings outlive their threads so that events of exited threads can still be drained.
+// The mutex is only taken when a thread records its first event and while draining.
+static std::mutex ring_registry_mutex;
+static std::vector<std::unique_ptr<DS_Profile_Ring>> ring_registry;
+
+static thread_local DS_Profile_Ring* thread_ring = nullptr;
+static thread_local std::vector<std::pair<int64_t, uint64_t>> thread_module_stack;
+
+uint64_t DS_Profile_Ring::drain(std::vector<DS_Profile_Event>& out)
+{
+    uint64_t tail = _tail.load(std::memory_order_relaxed);
+    uint64_t head = _head.load(std::memory_order_acquire);
+    for (; tail < head; tail++) out.push_back(_events[tail & (DS_PROFILE_RING_SIZE - 1)]);
+    _tail.store(tail, std::memory_order_release);
+    return _dropped.exchange(0, std::memory_order_relaxed);
+}
+
+void ds_profile_set_enabled(bool enabled)
+{
+    ds_profile_enabled_flag.store(enabled, std::memory_order_relaxed);
+}
+
+static DS_Profile_Ring* get_thread_ring()
+{
+    if (thread_ring == nullptr) {
+        std::lock_guard<std::mutex> lock(ring_registry_mutex);
+        ring_registry.emplace_back(new DS_Profile_Ring());
+        thread_ring = ring_registry.back().get();
+    }
+    return thread_ring;
+}
+
+static void record_event(int64_t module_id,
+                         int32_t op,
+                         int64_t flops,
+                         uint64_t start_ns,
+                         uint64_t end_ns)
+{
+    get_thread_ring()->push({module_id, op, flops, start_ns, end_ns});
+}
+
+static const DS_Profile_Recorder local_recorder = {&ds_profile_enabled_flag, &record_event};
+
+const DS_Profile_Recorder* ds_profile_local_recorder() { return &local_recorder; }
+
+void ds_profile_begin(int64_t module_id)
+{
+    if (!ds_profile_enabled_flag.load(std::memory_order_relaxed)) return;
+    thread_module_stack.emplace_back(module_id, ds_profile_now_ns());
+}
+
+void ds_profile_end(int64_t module_id, int64_t flops)
+{
+    uint64_t end_ns = ds_profile_now_ns();
+    // A module that raised in forward never reaches end, so unwind to the matching begin.
+    while (!thread_module_stack.empty()) {
+        std::pair<int64_t, uint64_t> entry = thread_module_stack.back();
+        thread_module_stack.pop_back();
+        if (entry.first == module_id) {
+            if (ds_profile_enabled_flag.load(std::memory_order_relaxed))
+                record_event(module_id, DS_PROFILE_OP_MODULE, flops, entry.second, end_ns);
+            return;
+        }
+    }
+}
+
+uint64_t ds_profile_drain(std::vector<DS_Profile_Event>& out)
+{
+    std::lock_guard<std::mutex> lock(ring_registry_mutex);
+    uint64_t dropped = 0;
+    for (auto& ring : ring_registry) dropped += ring->drain(out);
+    return dropped;
+}
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <torch/extension.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include "ds_profiler.h"
+
+struct Profile_Stats {
+    int64_t calls;
+    int64_t flops;
+    uint64_t total_ns;
+    uint64_t max_ns;
+};
+
+// Aggregated results, keyed by (module id, op). Only touched off the critical path.
+static std::mutex stats_mutex;
+static std::map<std::pair<int64_t, int32_t>, Profile_Stats> profile_stats;
+static uint64_t dropped_events = 0;
+
+/*
+Folds the pending events of every thread into the aggregated stats. Called periodically from
+a background thread so that the per-thread rings never fill up.
+*/
+void aggregate()
+{
+    std::vector<DS_Profile_Event> events;
+    uint64_t dropped = ds_profile_drain(events);
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    dropped_events += dropped;
+    for (const auto& event : events) {
+        Profile_Stats& stats = profile_stats[std::make_pair(event.module_id, event.op)];
+        uint64_t duration = event.end_ns - event.start_ns;
+        stats.calls += 1;
+        stats.flops += event.flops;
+        stats.total_ns += duration;
+        stats.max_ns = std::max(stats.max_ns, duration);
+    }
+}
+
+/*
+Returns a list of (module_id, op, calls, flops, total_ns, max_ns) tuples.
+*/
+std::vector<std::tuple<int64_t, int32_t, int64_t, int64_t, int64_t, int64_t>> get_stats()
+{
+    aggregate();
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    std::vector<std::tuple<int64_t, int32_t, int64_t, int64_t, int64_t, int64_t>> result;
+    for (const auto& entry : profile_stats) {
+        const Profile_Stats& stats = entry.second;
+        result.emplace_back(entry.first.first,
+                            entry.first.second,
+                            stats.calls,
+                            stats.flops,
+                            (int64_t)stats.total_ns,
+                            (int64_t)stats.max_ns);
+    }
+    return result;
+}
+
+int64_t get_dropped_events()
+{
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return (int64_t)dropped_events;
+}
+
+void reset()
+{
+    aggregate();
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    profile_stats.clear();
+    dropped_events = 0;
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    // Kernels of this extension record without being attached.
+    ds_profile_attach(ds_profile_local_recorder());
+
+    m.def("set_enabled", &ds_profile_set_enabled, "Turn event recording on or off");
+    m.def("is_enabled", &ds_profile_enabled, "Whether event recording is on");
+    m.def("now_ns", &ds_profile_now_ns, "Profiler clock in nanoseconds");
+    m.def("begin", &ds_profile_begin, "Open the event of a module on the calling thread");
+    m.def("end", &ds_profile_end, "Close the event of a module on the calling thread");
+    m.def("record", &ds_profile_record, "Record a completed event on the calling thread");
+    m.def(
+        "recorder",
+        []() {
+            return py::capsule((void*)ds_profile_local_recorder(), DS_PROFILE_RECORDER_CAPSULE);
+        },
+        "Capsule of the recorder, passed to the profile_attach of extensions that record events");
+    m.def("aggregate",
+          &aggregate,
+          "Fold pending events into the aggregated stats",
+          py::call_guard<py::gil_scoped_release>());
+    m.def("get_stats",
+          &get_stats,
+          "Aggregated (module_id, op, calls, flops, total_ns, max_ns) tuples",
+          py::call_guard<py::gil_scoped_release>());
+    m.def("get_dropped_events", &get_dropped_events, "Events dropped because a ring was full");
+    m.def("reset", &reset, "Drop all pending and aggregated events");
+}
@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "quantization_cpu.h"
+
+using quantize_cpu::FakeQuantType;
+
+/*
+The formulas are the ones of SymQuantizer, AsymQuantizer, TernaryQuantizer and BinaryQuantizer in
+deepspeed/compression/utils.py, evaluated in the same fp32 operation order so the fused kernels
+give the same values as the torch ops. The L1 means of the ternary and binary quantizers come
+from the torch norm, only the masked sum of the ternary alpha is accumulated in a different order.
+*/
+
+namespace {
+
+// Groups are split in tiles so that a single large group still spreads over the threads.
+constexpr int64_t fake_quant_tile = 16 * 1024;
+
+struct Tile_Stats {
+    float max;
+    float min;
+};
+
+struct Fake_Quant_Params {
+    // Symmetric / asymmetric: value = clamp(round((x - offset) / scale)) * scale + offset.
+    float scale;
+    float offset;
+    // Ternary: +-alpha above the threshold, binary: sign(x) * alpha.
+    float threshold;
+    float alpha;
+};
+
+Tile_Stats tile_stats(const float* x, int64_t count)
+{
+    Tile_Stats stats;
+    stats.max = -std::numeric_limits<float>::infinity();
+    stats.min = std::numeric_limits<float>::infinity();
+    int64_t i = 0;
+#if defined(__AVX512__) or defined(__AVX256__)
+    AVX_Data max_vec, min_vec;
+    max_vec.data = SIMD_SET(stats.max);
+    min_vec.data = SIMD_SET(stats.min);
+    const int64_t rounded = ROUND_DOWN(count, SIMD_WIDTH);
+    for (; i < rounded; i += SIMD_WIDTH) {
+        AVX_Data value;
+        value.data = SIMD_LOAD(x + i);
+        max_vec.data = SIMD_MAX(max_vec.data, value.data);
+        min_vec.data = SIMD_MIN(min_vec.data, value.data);
+    }
+    float max_lanes[SIMD_WIDTH], min_lanes[SIMD_WIDTH];
+    SIMD_STORE(max_lanes, max_vec.data);
+    SIMD_STORE(min_lanes, min_vec.data);
+    for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+        stats.max = std::max(stats.max, max_lanes[lane]);
+        stats.min = std::min(stats.min, min_lanes[lane]);
+    }
+#endif
+    for (; i < count; i++) {
+        stats.max = std::max(stats.max, x[i]);
+        stats.min = std::min(stats.min, x[i]);
+    }
+    return stats;
+}
+
+// Sum and number of the magnitudes above the threshold, for the ternary alpha.
+void tile_masked_sum(const float* x, int64_t count, float threshold, float& sum, int64_t& n)
+{
+    float acc = 0.0f;
+    int64_t hits = 0;
+    for (int64_t i = 0; i < count; i++) {
+        const float magnitude = fabsf(x[i]);
+        const bool above = magnitude > threshold;
+        acc += above ? magnitude : 0.0f;
+        hits += above;
+    }
+    sum = acc;
+    n = hits;
+}
+
+// clamp(round((x - offset) / scale), q_min, q_max) * scale + offset
+void fake_quantize_linear(float* out,
+                          const float* x,
+                          int64_t count,
+                          const Fake_Quant_Params& params,
+                          float q_min,
+                          float q_max)
+{
+    int64_t i = 0;
+#if defined(__AVX512__) or defined(__AVX256__)
+    AVX_Data scale, neg_offset, offset, lo, hi;
+    scale.data = SIMD_SET(params.scale);
+    neg_offset.data = SIMD_SET(-params.offset);
+    offset.data = SIMD_SET(params.offset);
+    lo.data = SIMD_SET(q_min);
+    hi.data = SIMD_SET(q_max);
+    const int64_t rounded = ROUND_DOWN(count, SIMD_WIDTH);
+    for (; i < rounded; i += SIMD_WIDTH) {
+        AVX_Data value;
+        value.data = SIMD_LOAD(x + i);
+        value.data = SIMD_ROUND(SIMD_DIV(SIMD_ADD(value.data, neg_offset.data), scale.data));
+        value.data = SIMD_MIN(SIMD_MAX(value.data, lo.data), hi.data);
+        value.data = SIMD_ADD(SIMD_MUL(value.data, scale.data), offset.data);
+        SIMD_STORE(out + i, value.data);
+    }
+#endif
+    for (; i < count; i++) {
+        const float q = nearbyintf((x[i] - params.offset) / params.scale);
+        out[i] = std::min(std::max(q, q_min), q_max) * params.scale + params.offset;
+    }
+}
+
+void fake_quantize_ternary(float* out, const float* x, int64_t count, const Fake_Quant_Params& params)
+{
+    const float threshold = params.threshold;
+    const float alpha = params.alpha;
+    for (int64_t i = 0; i < count; i++) {
+        out[i] = alpha * (float)(x[i] > threshold) - alpha * (float)(x[i] < -threshold);
+    }
+}
+
+void fake_quantize_binary(float* out, const float* x, int64_t count, const Fake_Quant_Params& params)
+{
+    const float alpha = params.alpha;
+    for (int64_t i = 0; i < count; i++) { out[i] = (float)((x[i] > 0) - (x[i] < 0)) * alpha; }
+}
+
+}  // namespace
+
+void launch_fake_quantize_cpu(float* output,
+                              const float* input,
+                              int64_t groups,
+                              int64_t elems_per_group,
+                              int num_bits,
+                              FakeQuantType quant_type,
+                              const float* static_range,
+                              const float* l1_mean)
+{
+    const int64_t tiles_per_group = (elems_per_group + fake_quant_tile - 1) / fake_quant_tile;
+    const int64_t n_tiles = groups * tiles_per_group;
+    auto tile_begin = [&](int64_t t) {
+        return (t / tiles_per_group) * elems_per_group + (t % tiles_per_group) * fake_quant_tile;
+    };
+    auto tile_count = [&](int64_t t) {
+        return std::min(fake_quant_tile, elems_per_group - (t % tiles_per_group) * fake_quant_tile);
+    };
+
+    const bool linear = quant_type == FakeQuantType::Symmetric ||
+                        quant_type == FakeQuantType::Asymmetric;
+    std::vector<Tile_Stats> stats;
+    if (linear && static_range == nullptr) {
+        stats.resize(n_tiles);
+#pragma omp parallel for schedule(static)
+        for (int64_t t = 0; t < n_tiles; t++) {
+            stats[t] = tile_stats(input + tile_begin(t), tile_count(t));
+        }
+    }
+
+    const float q_range = (float)(1 << num_bits);
+    std::vector<Fake_Quant_Params> params(groups);
+    for (int64_t g = 0; g < groups; g++) {
+        Fake_Quant_Params& p = params[g];
+        p.offset = 0.0f;
+        if (!linear) {
+            p.threshold = 0.7f * l1_mean[g];
+            p.alpha = l1_mean[g];
+            continue;
+        }
+
+        float max_val, min_val;
+        if (static_range != nullptr) {
+            min_val = static_range[0];
+            max_val = static_range[1];
+        } else {
+            max_val = -std::numeric_limits<float>::infinity();
+            min_val = std::numeric_limits<float>::infinity();
+            for (int64_t t = g * tiles_per_group; t < (g + 1) * tiles_per_group; t++) {
+                max_val = std::max(max_val, stats[t].max);
+                min_val = std::min(min_val, stats[t].min);
+            }
+        }
+
+        if (quant_type == FakeQuantType::Symmetric) {
+            // amax(|x|), or max(|min|, max) for a static range.
+            const float max_input = static_range != nullptr ? std::max(fabsf(min_val), max_val)
+                                                            : std::max(max_val, -min_val);
+            p.scale = 2 * max_input / q_range;
+        } else {
+            p.scale = (max_val - min_val) / q_range;
+            p.offset = nearbyintf(min_val / p.scale) * p.scale;
+        }
+    }
+
+    if (quant_type == FakeQuantType::Ternary) {
+        std::vector<float> sums(n_tiles);
+        std::vector<int64_t> hits(n_tiles);
+#pragma omp parallel for schedule(static)
+        for (int64_t t = 0; t < n_tiles; t++) {
+            tile_masked_sum(input + tile_begin(t),
+                            tile_count(t),
+                            params[t / tiles_per_group].threshold,
+                            sums[t],
+                            hits[t]);
+        }
+        for (int64_t g = 0; g < groups; g++) {
+            float sum = 0.0f;
+            int64_t n = 0;
+            for (int64_t t = g * tiles_per_group; t < (g + 1) * tiles_per_group; t++) {
+                sum += sums[t];
+                n += hits[t];
+            }
+            params[g].alpha = sum / (float)n;
+        }
+    }
+
+    const float sym_min = -q_range / 2;
+    const float sym_max = q_range / 2 - 1;
+
+#pragma omp parallel for schedule(static)
+    for (int64_t t = 0; t < n_tiles; t++) {
+        const int64_t begin = tile_begin(t);
+        const int64_t count = tile_count(t);
+        const Fake_Quant_Params& p = params[t / tiles_per_group];
+        if (quant_type == FakeQuantType::Symmetric) {
+            fake_quantize_linear(output + begin, input + begin, count, p, sym_min, sym_max);
+        } else if (quant_type == FakeQuantType::Asymmetric) {
+            fake_quantize_linear(output + begin, input + begin, count, p, 0.0f, q_range - 1);
+        } else if (quant_type == FakeQuantType::Ternary) {
+            fake_quantize_ternary(output + begin, input + begin, count, p);
+        } else {
+            fake_quantize_binary(output + begin, input + begin, count, p);
+        }
+    }
+}
@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <torch/extension.h>
+#include <vector>
+#include "quantization_cpu.h"
+
+/*
+CPU version of the quantizer op for the ZeRO++ quantized weight allgather and gradient reduction.
+The functions take the same arguments and return the same layout as their CUDA counterparts in
+pt_binding.cpp. Inputs may be fp32, fp16 or bf16.
+fake_quantize runs the fp32 forward of the quantizers of deepspeed/compression/utils.py.
+*/
+
+static MultiTensorDtype multi_tensor_dtype(const at::Tensor& tensor)
+{
+    if (tensor.scalar_type() == at::kHalf) return MultiTensorDtype::Half;
+    if (tensor.scalar_type() == at::kBFloat16) return MultiTensorDtype::BFloat16;
+    TORCH_CHECK(tensor.scalar_type() == at::kFloat, "quantizer inputs must be fp32, fp16 or bf16");
+    return MultiTensorDtype::Float;
+}
+
+static void check_group_size(int64_t numel, int groups, int num_bits)
+{
+    TORCH_CHECK(num_bits == 8 || num_bits == 4, "only 8 and 4 bit quantization are supported");
+    TORCH_CHECK(groups > 0 && numel % groups == 0,
+                "the number of elements must be a multiple of the number of groups");
+    TORCH_CHECK(num_bits == 8 || (numel / groups) % 2 == 0,
+                "4 bit quantization requires an even number of elements per group");
+}
+
+std::vector<at::Tensor> quantize_kernel(at::Tensor& input_vals,
+                                        int groups,
+                                        int numBits,
+                                        quantize_cpu::Type quantType)
+{
+    auto input = input_vals.contiguous();
+    check_group_size(input.numel(), groups, numBits);
+
+    const int param_elems = (quantize_cpu::requires_offset(quantType)) ? 2 : 1;
+    auto params = torch::empty({groups, param_elems}, at::TensorOptions().dtype(at::kFloat));
+
+    auto output_sizes = input.sizes().vec();
+    output_sizes[output_sizes.size() - 1] /= numBits == 8 ? 1 : 2;
+    auto output = torch::empty(output_sizes, at::TensorOptions().dtype(at::kChar));
+
+    launch_quant_cpu((int8_t*)output.data_ptr(),
+                     (float*)params.data_ptr(),
+                     input.data_ptr(),
+                     multi_tensor_dtype(input),
+                     groups,
+                     input.numel() / groups,
+                     numBits,
+                     quantType);
+
+    return {output, params};
+}
+
+template <at::ScalarType dtype>
+at::Tensor dequantize(at::Tensor& quantized_data,
+                      at::Tensor& params,
+                      int groups,
+                      int num_bits,
+                      quantize_cpu::Type quant_type)
+{
+    auto data = quantized_data.contiguous();
+    auto scales = params.contiguous();
+    TORCH_CHECK(scales.scalar_type() == at::kFloat, "quantization params must be fp32");
+
+    auto output_sizes = data.sizes().vec();
+    output_sizes[output_sizes.size() - 1] *= num_bits == 8 ? 1 : 2;
+    auto output = torch::empty(output_sizes, at::TensorOptions().dtype(dtype));
+    check_group_size(output.numel(), groups, num_bits);
+
+    launch_dequantize_cpu(output.data_ptr(),
+                          multi_tensor_dtype(output),
+                          (const int8_t*)data.data_ptr(),
+                          (const float*)scales.data_ptr(),
+                          quant_type,
+                          num_bits,
+                          output.numel() / groups,
+                          output.numel());
+
+    return output;
+}
+
+std::vector<at::Tensor> ds_swizzle_quant(at::Tensor& input_vals,
+                                         int groups,
+                                         int num_bits,
+                                         quantize_cpu::Type quant_type,
+                                         int pipeline_size,
+                                         int nodes,
+                                         int devices_per_node)
+{
+    auto input = input_vals.contiguous();
+    check_group_size(input.numel(), groups, num_bits);
+    TORCH_CHECK(groups % (nodes * devices_per_node * pipeline_size) == 0,
+                "groups must split evenly over the partitions and pipeline stages");
+
+    const int scales_elems = (quantize_cpu::requires_offset(quant_type)) ? 2 : 1;
+    auto scales = torch::empty({groups, scales_elems}, at::TensorOptions().dtype(at::kFloat));
+
+    const int quantization_scalar = 8 / num_bits;
+    const int64_t compressed_vals = input.numel() / quantization_scalar;
+    auto output = torch::empty({compressed_vals}, at::TensorOptions().dtype(at::kChar));
+
+    launch_swizzled_quant_cpu((int8_t*)output.data_ptr(),
+                              (float*)scales.data_ptr(),
+                              input.data_ptr(),
+                              multi_tensor_dtype(input),
+                              num_bits,
+                              quant_type,
+                              groups,
+                              input.numel() / groups,
+                              pipeline_size,
+                              nodes,
+                              devices_per_node);
+
+    return {output, scales};
+}
+
+std::vector<at::Tensor> quantized_reduction(at::Tensor& input_vals,
+                                            at::Tensor& input_scales,
+                                            int in_groups,
+                                            int out_groups,
+                                            int num_bits,
+                                            quantize_cpu::Type quant_type,
+                                            int devices_per_node)
+{
+    auto input = input_vals.contiguous();
+    auto in_scales = input_scales.contiguous();
+    TORCH_CHECK(num_bits == 8 || num_bits == 4, "only 8 and 4 bit quantization are supported");
+    TORCH_CHECK(input.numel() % devices_per_node == 0 && in_groups % devices_per_node == 0,
+                "the input must hold one tensor per device");
+
+    const int scales_elems = (quantize_cpu::requires_offset(quant_type)) ? 2 : 1;
+    auto scales = torch::empty({out_groups, scales_elems}, at::TensorOptions().dtype(at::kFloat));
+
+    std::vector<int64_t> sz(input.sizes().begin(), input.sizes().end());
+    sz[sz.size() - 1] = sz.back() / devices_per_node;
+    const int64_t elems_per_in_tensor = input.numel() / devices_per_node;
+    auto output = torch::empty(sz, at::TensorOptions().dtype(at::kChar));
+
+    const int64_t elems_per_in_group = elems_per_in_tensor / (in_groups / devices_per_node);
+    const int64_t elems_per_out_group = elems_per_in_tensor / out_groups;
+    TORCH_CHECK(elems_per_out_group * out_groups == elems_per_in_tensor,
+                "out_groups must split the reduced tensor evenly");
+
+    launch_dequant_reduce_cpu((int8_t*)output.data_ptr(),
+                              (float*)scales.data_ptr(),
+                              (const int8_t*)input.data_ptr(),
+                              (const float*)in_scales.data_ptr(),
+                              devices_per_node,
+                              num_bits,
+                              quant_type,
+                              out_groups,
+                              elems_per_out_group,
+                              elems_per_in_tensor,
+                              in_groups / devices_per_node,
+                              elems_per_in_group);
+    return {output, scales};
+}
+
+at::Tensor fake_quantize(at::Tensor& input_vals,
+                         int num_bits,
+                         int groups,
+                         quantize_cpu::FakeQuantType quant_type,
+                         c10::optional<at::Tensor> min_value,
+                         c10::optional<at::Tensor> max_value)
+{
+    auto input = input_vals.contiguous();
+    TORCH_CHECK(input.scalar_type() == at::kFloat, "fake quantization inputs must be fp32");
+    TORCH_CHECK(groups > 0 && input.numel() % groups == 0,
+                "the number of elements must be a multiple of the number of groups");
+    TORCH_CHECK(min_value.has_value() == max_value.has_value(),
+                "a static range needs both min_value and max_value");
+
+    float static_range[2];
+    if (min_value.has_value()) {
+        TORCH_CHECK(groups == 1, "a static range applies to a single group");
+        static_range[0] = min_value->item<float>();
+        static_range[1] = max_value->item<float>();
+    }
+
+    // The L1 means use the reduction of the torch ops, so that the binary values match exactly.
+    at::Tensor l1_mean;
+    if (quant_type == quantize_cpu::FakeQuantType::Ternary ||
+        quant_type == quantize_cpu::FakeQuantType::Binary) {
+        const int64_t elems_per_group = input.numel() / groups;
+        l1_mean = input.view({groups, elems_per_group}).norm(1, {1}).div(elems_per_group);
+    }
+
+    auto output = torch::empty_like(input);
+    launch_fake_quantize_cpu((float*)output.data_ptr(),
+                             (const float*)input.data_ptr(),
+                             groups,
+                             input.numel() / groups,
+                             num_bits,
+                             quant_type,
+                             min_value.has_value() ? static_range : nullptr,
+                             l1_mean.defined() ? (const float*)l1_mean.data_ptr() : nullptr);
+    return output;
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    pybind11::enum_<quantize_cpu::Type>(m, "QuantizationType")
+        .value("Symmetric", quantize_cpu::Type::Symmetric)
+        .value("Asymmetric", quantize_cpu::Type::Asymmetric)
+        .export_values();
+    pybind11::enum_<quantize_cpu::FakeQuantType>(m, "FakeQuantizationType")
+        .value("SymmetricFakeQuant", quantize_cpu::FakeQuantType::Symmetric)
+        .value("AsymmetricFakeQuant", quantize_cpu::FakeQuantType::Asymmetric)
+        .value("TernaryFakeQuant", quantize_cpu::FakeQuantType::Ternary)
+        .value("BinaryFakeQuant", quantize_cpu::FakeQuantType::Binary)
+        .export_values();
+    m.def("quantize", &quantize_kernel);
+    m.def("dequantize", &dequantize<at::kHalf>);
+    m.def("dequantize_fp32", &dequantize<at::kFloat>);
+    m.def("dequantize_bf16", &dequantize<at::kBFloat16>);
+    m.def("swizzle_quant", &ds_swizzle_quant);
+    m.def("quantized_reduction", &quantized_reduction);
+    m.def("fake_quantize", &fake_quantize);
+}
@@ -0,0 +1,326 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "quantization_cpu.h"
+
+using quantize_cpu::Type;
+
+/*
+The quantization math follows quantization_utils.h: symmetric groups are scaled by
+2^bits / (2 * absmax), asymmetric groups by 2^bits / (max - min) around the midpoint of the
+range, and the stored scale is the inverse. Values are rounded to nearest even like
+__float2int_rn and clamped to the signed range of num_bits.
+*/
+
+namespace {
+
+struct Group_Params {
+    float scale;
+    float offset;
+};
+
+// Range of a group, the absolute maximum for symmetric quantization.
+template <MultiTensorDtype dtype>
+void group_range(const void* src, int64_t begin, int64_t count, Type q_type, float& hi, float& lo)
+{
+    const bool symmetric = q_type == Type::Symmetric;
+    float max_val = -std::numeric_limits<float>::infinity();
+    float min_val = std::numeric_limits<float>::infinity();
+    int64_t i = 0;
+#if defined(__AVX512__) or defined(__AVX256__)
+    AVX_Data sign_mask;
+    sign_mask.data = SIMD_SET(-0.0f);
+    AVX_Data max_vec, neg_min_vec;
+    max_vec.data = SIMD_SET(max_val);
+    neg_min_vec.data = SIMD_SET(max_val);
+    const int64_t rounded = ROUND_DOWN(count, SIMD_WIDTH);
+    for (; i < rounded; i += SIMD_WIDTH) {
+        AVX_Data value = simd_load_as_float<dtype>(src, begin + i);
+        if (symmetric) {
+            max_vec.data = SIMD_MAX(max_vec.data, SIMD_ANDNOT(sign_mask.data, value.data));
+        } else {
+            max_vec.data = SIMD_MAX(max_vec.data, value.data);
+            neg_min_vec.data = SIMD_MAX(neg_min_vec.data, SIMD_XOR(sign_mask.data, value.data));
+        }
+    }
+    float max_lanes[SIMD_WIDTH], neg_min_lanes[SIMD_WIDTH];
+    SIMD_STORE(max_lanes, max_vec.data);
+    SIMD_STORE(neg_min_lanes, neg_min_vec.data);
+    for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+        max_val = std::max(max_val, max_lanes[lane]);
+        min_val = std::min(min_val, -neg_min_lanes[lane]);
+    }
+#endif
+    for (; i < count; i++) {
+        const float value = ds_load_as_float<dtype>(src, begin + i);
+        if (symmetric) {
+            max_val = std::max(max_val, fabsf(value));
+        } else {
+            max_val = std::max(max_val, value);
+            min_val = std::min(min_val, value);
+        }
+    }
+    hi = max_val;
+    lo = min_val;
+}
+
+Group_Params make_params(float hi, float lo, int num_bits, Type q_type)
+{
+    Group_Params params;
+    if (q_type == Type::Symmetric) {
+        params.scale = hi == 0 ? 1.0f : (float)(1 << num_bits) / (2 * hi);
+        params.offset = 0.0f;
+    } else {
+        params.scale = hi == lo ? 1.0f : (float)(1 << num_bits) / (hi - lo);
+        params.offset = (hi + lo) / 2;
+    }
+    return params;
+}
+
+inline int8_t quantize_value(float value, const Group_Params& params, int q_min, int q_max)
+{
+    const int q = (int)nearbyintf((value - params.offset) * params.scale);
+    return (int8_t)std::min(std::max(q, q_min), q_max);
+}
+
+// Quantizes `count` elements starting at `begin` of src into out, and stores the group params.
+template <MultiTensorDtype dtype>
+void quantize_group(int8_t* out,
+                    float* params_out,
+                    const void* src,
+                    int64_t begin,
+                    int64_t count,
+                    int num_bits,
+                    Type q_type)
+{
+    float hi, lo;
+    group_range<dtype>(src, begin, count, q_type, hi, lo);
+    const Group_Params params = make_params(hi, lo, num_bits, q_type);
+
+    const int q_min = -(1 << (num_bits - 1));
+    const int q_max = (1 << (num_bits - 1)) - 1;
+    if (num_bits == 8) {
+        for (int64_t i = 0; i < count; i++) {
+            out[i] = quantize_value(ds_load_as_float<dtype>(src, begin + i), params, q_min, q_max);
+        }
+    } else {
+        for (int64_t i = 0; i < count; i += 2) {
+            const int8_t first =
+                quantize_value(ds_load_as_float<dtype>(src, begin + i), params, q_min, q_max);
+            const int8_t second =
+                quantize_value(ds_load_as_float<dtype>(src, begin + i + 1), params, q_min, q_max);
+            out[i / 2] = (int8_t)((first << 4) | (second & 0xf));
+        }
+    }
+
+    params_out[0] = 1 / params.scale;
+    if (quantize_cpu::requires_offset(q_type)) { params_out[1] = params.offset; }
+}
+
+void quantize_group(int8_t* out,
+                    float* params_out,
+                    const void* src,
+                    MultiTensorDtype src_dtype,
+                    int64_t begin,
+                    int64_t count,
+                    int num_bits,
+                    Type q_type)
+{
+    if (src_dtype == MultiTensorDtype::Half) {
+        quantize_group<MultiTensorDtype::Half>(out, params_out, src, begin, count, num_bits, q_type);
+    } else if (src_dtype == MultiTensorDtype::BFloat16) {
+        quantize_group<MultiTensorDtype::BFloat16>(
+            out, params_out, src, begin, count, num_bits, q_type);
+    } else {
+        quantize_group<MultiTensorDtype::Float>(
+            out, params_out, src, begin, count, num_bits, q_type);
+    }
+}
+
+// Calls fn(index, value) for the `count` dequantized values of a group, in order.
+template <typename Fn>
+inline void for_each_dequantized(const int8_t* data,
+                                 const float* params,
+                                 int64_t count,
+                                 int num_bits,
+                                 Type q_type,
+                                 Fn fn)
+{
+    const float scale = params[0];
+    const float offset = quantize_cpu::requires_offset(q_type) ? params[1] : 0.0f;
+    if (num_bits == 8) {
+        for (int64_t i = 0; i < count; i++) { fn(i, data[i] * scale + offset); }
+    } else {
+        for (int64_t i = 0; i < count; i += 2) {
+            const int8_t packed = data[i / 2];
+            fn(i, (packed >> 4) * scale + offset);
+            fn(i + 1, ((int8_t)(packed << 4) >> 4) * scale + offset);
+        }
+    }
+}
+
+}  // namespace
+
+void launch_quant_cpu(int8_t* output_data,
+                      float* params,
+                      const void* input_data,
+                      MultiTensorDtype input_dtype,
+                      int64_t groups,
+                      int64_t elems_per_group,
+                      int num_bits,
+                      Type quant_type)
+{
+    const int64_t params_per_group = quantize_cpu::requires_offset(quant_type) ? 2 : 1;
+    const int64_t bytes_per_group = elems_per_group * num_bits / 8;
+
+#pragma omp parallel for schedule(static)
+    for (int64_t g = 0; g < groups; g++) {
+        quantize_group(output_data + g * bytes_per_group,
+                       params + g * params_per_group,
+                       input_data,
+                       input_dtype,
+                       g * elems_per_group,
+                       elems_per_group,
+                       num_bits,
+                       quant_type);
+    }
+}
+
+void launch_dequantize_cpu(void* dequant_data,
+                           MultiTensorDtype output_dtype,
+                           const int8_t* q_data,
+                           const float* q_params,
+                           Type q_type,
+                           int num_bits,
+                           int64_t elems_per_group,
+                           int64_t total_elems)
+{
+    const int64_t params_per_group = quantize_cpu::requires_offset(q_type) ? 2 : 1;
+    const int64_t groups = (total_elems + elems_per_group - 1) / elems_per_group;
+
+#pragma omp parallel for schedule(static)
+    for (int64_t g = 0; g < groups; g++) {
+        const int64_t begin = g * elems_per_group;
+        const int64_t count = std::min(elems_per_group, total_elems - begin);
+        const int8_t* data = q_data + begin * num_bits / 8;
+        const float* params = q_params + g * params_per_group;
+
+        if (output_dtype == MultiTensorDtype::Float) {
+            float* out = (float*)dequant_data + begin;
+            for_each_dequantized(
+                data, params, count, num_bits, q_type, [out](int64_t i, float v) { out[i] = v; });
+        } else if (output_dtype == MultiTensorDtype::Half) {
+            uint16_t* out = (uint16_t*)dequant_data + begin;
+            for_each_dequantized(data, params, count, num_bits, q_type, [out](int64_t i, float v) {
+                out[i] = ds_float_to_fp16(v);
+            });
+        } else {
+            uint16_t* out = (uint16_t*)dequant_data + begin;
+            for_each_dequantized(data, params, count, num_bits, q_type, [out](int64_t i, float v) {
+                out[i] = ds_float_to_bf16(v, false, 0);
+            });
+        }
+    }
+}
+
+void launch_swizzled_quant_cpu(int8_t* q_data,
+                               float* q_scales,
+                               const void* input_data,
+                               MultiTensorDtype input_dtype,
+                               int num_bits,
+                               Type q_type,
+                               int64_t groups,
+                               int64_t elems_per_group,
+                               int64_t pipelining,
+                               int64_t nodes,
+                               int64_t devices_per_node)
+{
+    const int64_t params_per_group = quantize_cpu::requires_offset(q_type) ? 2 : 1;
+    const int64_t bytes_per_group = elems_per_group * num_bits / 8;
+    const int64_t partitions = nodes * devices_per_node;
+    const int64_t contiguous_groups = groups / partitions / pipelining;
+
+#pragma omp parallel for schedule(static)
+    for (int64_t g = 0; g < groups; g++) {
+        // Same decomposition as the (x, y, z) grid of swizzled_quant_kernel.
+        const int64_t group_in_slice = g % contiguous_groups;
+        const int64_t slice = (g / contiguous_groups) % pipelining;
+        const int64_t partition = g / (contiguous_groups * pipelining);
+
+        const int64_t output_partition = slice * partitions +
+                                         (partition % devices_per_node) * nodes +
+                                         partition / devices_per_node;
+        const int64_t out_group = output_partition * contiguous_groups + group_in_slice;
+
+        quantize_group(q_data + out_group * bytes_per_group,
+                       q_scales + out_group * params_per_group,
+                       input_data,
+                       input_dtype,
+                       g * elems_per_group,
+                       elems_per_group,
+                       num_bits,
+                       q_type);
+    }
+}
+
+void launch_dequant_reduce_cpu(int8_t* reduced_data,
+                               float* reduced_scales,
+                               const int8_t* input_data,
+                               const float* input_scales,
+                               int64_t num_tensors,
+                               int num_bits,
+                               Type quant_type,
+                               int64_t out_groups,
+                               int64_t elems_per_out_group,
+                               int64_t elems_per_in_tensor,
+                               int64_t groups_per_in_tensor,
+                               int64_t elems_per_in_group)
+{
+    const int64_t params_per_group = quantize_cpu::requires_offset(quant_type) ? 2 : 1;
+    const int64_t values_per_byte = 8 / num_bits;
+
+#pragma omp parallel
+    {
+        std::vector<float> sums(elems_per_out_group * values_per_byte);
+
+#pragma omp for schedule(static)
+        for (int64_t o = 0; o < out_groups; o++) {
+            std::fill(sums.begin(), sums.end(), 0.0f);
+            const int64_t out_begin = o * elems_per_out_group;
+            const int64_t out_end = out_begin + elems_per_out_group;
+
+            for (int64_t t = 0; t < num_tensors; t++) {
+                const int8_t* tensor = input_data + t * elems_per_in_tensor;
+                const float* scales = input_scales + t * groups_per_in_tensor * params_per_group;
+
+                // Walk the input groups overlapping the output group.
+                for (int64_t begin = out_begin; begin < out_end;) {
+                    const int64_t in_group = begin / elems_per_in_group;
+                    const int64_t end = std::min(out_end, (in_group + 1) * elems_per_in_group);
+                    float* acc = sums.data() + (begin - out_begin) * values_per_byte;
+                    for_each_dequantized(tensor + begin,
+                                         scales + in_group * params_per_group,
+                                         (end - begin) * values_per_byte,
+                                         num_bits,
+                                         quant_type,
+                                         [acc](int64_t i, float v) { acc[i] += v; });
+                    begin = end;
+                }
+            }
+
+            quantize_group<MultiTensorDtype::Float>(reduced_data + out_begin,
+                                                    reduced_scales + o * params_per_group,
+                                                    sums.data(),
+                                                    0,
+                                                    (int64_t)sums.size(),
+                                                    num_bits,
+                                                    quant_type);
+        }
+    }
+}
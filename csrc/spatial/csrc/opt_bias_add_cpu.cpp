@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "simd.h"
+#include "spatial_cpu_layers.h"
+
+/*
+Fused bias add variants. The two biases are folded into one fp32 vector up front, so every
+variant is a single pass over the activations. Rows are processed in blocks and each block walks
+the channels in chunks, keeping a chunk of the folded bias in L1 while it is applied to all rows
+of the block.
+*/
+
+namespace badd_cpu {
+constexpr int64_t rows_per_block = 16;
+constexpr int64_t channels_per_block = 256;
+}  // namespace badd_cpu
+
+static inline float bf16_to_float(uint16_t value)
+{
+    uint32_t bits = (uint32_t)value << 16;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// Round to nearest even, keeping NaNs quiet
+static inline uint16_t float_to_bf16(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) { return (uint16_t)((bits >> 16) | 0x40); }
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return (uint16_t)(bits >> 16);
+}
+
+static inline float load_value(const float* src, int64_t i) { return src[i]; }
+static inline float load_value(const uint16_t* src, int64_t i) { return bf16_to_float(src[i]); }
+static inline void store_value(float* dst, int64_t i, float value) { dst[i] = value; }
+static inline void store_value(uint16_t* dst, int64_t i, float value)
+{
+    dst[i] = float_to_bf16(value);
+}
+
+template <typename T>
+static void fold_bias(float* folded, const T* bias, const T* other_bias, int64_t channels)
+{
+    for (int64_t c = 0; c < channels; c++) {
+        folded[c] = load_value(bias, c) + (other_bias ? load_value(other_bias, c) : 0.0f);
+    }
+}
+
+static void bias_add_chunk(float* result,
+                           const float* activation,
+                           const float* bias,
+                           const float* other,
+                           int64_t size)
+{
+    int64_t rounded_size = 0;
+#if defined(__AVX512__) or defined(__AVX256__)
+    rounded_size = ROUND_DOWN(size, SIMD_WIDTH);
+    for (int64_t c = 0; c < rounded_size; c += SIMD_WIDTH) {
+        AVX_Data value;
+        value.data = SIMD_ADD(SIMD_LOAD(activation + c), SIMD_LOAD(bias + c));
+        if (other) { value.data = SIMD_ADD(value.data, SIMD_LOAD(other + c)); }
+        SIMD_STORE(result + c, value.data);
+    }
+#endif
+    for (int64_t c = rounded_size; c < size; c++) {
+        result[c] = activation[c] + bias[c] + (other ? other[c] : 0.0f);
+    }
+}
+
+static void bias_add_chunk(uint16_t* result,
+                           const uint16_t* activation,
+                           const float* bias,
+                           const uint16_t* other,
+                           int64_t size)
+{
+    // Plain shifts and adds, which the compiler vectorizes with the -march flags of the op
+    if (other) {
+        for (int64_t c = 0; c < size; c++) {
+            result[c] = float_to_bf16(bf16_to_float(activation[c]) + bias[c] +
+                                      bf16_to_float(other[c]));
+        }
+    } else {
+        for (int64_t c = 0; c < size; c++) {
+            result[c] = float_to_bf16(bf16_to_float(activation[c]) + bias[c]);
+        }
+    }
+}
+
+template <typename T>
+static void opt_bias_add(T* result,
+                         const T* activation,
+                         const T* bias,
+                         const T* other,
+                         const T* other_bias,
+                         int64_t rows,
+                         int64_t channels)
+{
+    std::vector<float> folded(channels);
+    fold_bias(folded.data(), bias, other_bias, channels);
+
+    const int64_t row_blocks = (rows + badd_cpu::rows_per_block - 1) / badd_cpu::rows_per_block;
+#pragma omp parallel for schedule(static)
+    for (int64_t block = 0; block < row_blocks; block++) {
+        const int64_t row_start = block * badd_cpu::rows_per_block;
+        const int64_t row_end = std::min(rows, row_start + badd_cpu::rows_per_block);
+        for (int64_t c = 0; c < channels; c += badd_cpu::channels_per_block) {
+            const int64_t size = std::min(badd_cpu::channels_per_block, channels - c);
+            for (int64_t row = row_start; row < row_end; row++) {
+                const int64_t offset = row * channels + c;
+                bias_add_chunk(result + offset,
+                               activation + offset,
+                               folded.data() + c,
+                               other ? other + offset : nullptr,
+                               size);
+            }
+        }
+    }
+}
+
+void launch_opt_bias_add_cpu(float* result,
+                             const float* activation,
+                             const float* bias,
+                             const float* other,
+                             const float* other_bias,
+                             int64_t batch_size,
+                             int64_t seq_len,
+                             int64_t channels)
+{
+    opt_bias_add(result, activation, bias, other, other_bias, batch_size * seq_len, channels);
+}
+
+void launch_opt_bias_add_cpu(uint16_t* result,
+                             const uint16_t* activation,
+                             const uint16_t* bias,
+                             const uint16_t* other,
+                             const uint16_t* other_bias,
+                             int64_t batch_size,
+                             int64_t seq_len,
+                             int64_t channels)
+{
+    opt_bias_add(result, activation, bias, other, other_bias, batch_size * seq_len, channels);
+}
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <torch/extension.h>
+#include <vector>
+#include "spatial_cpu_layers.h"
+
+struct {
+    int64_t batch_size;
+    int64_t seq_len;
+    int64_t channels;
+} typedef ChannelsLastProblem;
+
+ChannelsLastProblem dimension_problem(at::Tensor& input)
+{
+    ChannelsLastProblem dims;
+
+    if (input.dim() == 4) {
+        // See the note in pt_binding.cpp, a 1x1 image is ambiguous.
+        TORCH_CHECK(input.is_contiguous(at::MemoryFormat::ChannelsLast),
+                    "nhwc_bias_add expects a channels-last input");
+        dims.batch_size = input.size(0);
+        dims.seq_len = input.size(2) * input.size(3);
+        dims.channels = input.size(1);
+    } else {
+        TORCH_CHECK(input.is_contiguous(), "nhwc_bias_add expects a contiguous input");
+        dims.batch_size = input.size(0);
+        dims.seq_len = input.size(1);
+        dims.channels = input.size(2);
+    }
+
+    return dims;
+}
+
+at::Tensor bias_add_dispatch(at::Tensor& input,
+                             at::Tensor& bias,
+                             at::Tensor* other,
+                             at::Tensor* other_bias)
+{
+    ChannelsLastProblem problem = dimension_problem(input);
+    TORCH_CHECK(bias.is_contiguous() && bias.numel() == problem.channels,
+                "bias must have one value per channel");
+    TORCH_CHECK(bias.scalar_type() == input.scalar_type(), "bias dtype must match the input");
+    if (other) {
+        TORCH_CHECK(other->sizes() == input.sizes() && other->strides() == input.strides() &&
+                        other->scalar_type() == input.scalar_type(),
+                    "other must match the input in shape, layout and dtype");
+    }
+    if (other_bias) {
+        TORCH_CHECK(other_bias->is_contiguous() && other_bias->numel() == problem.channels &&
+                        other_bias->scalar_type() == input.scalar_type(),
+                    "other_bias must have one value per channel");
+    }
+
+    // empty_like keeps the channels-last layout of the input
+    auto output = at::empty_like(input);
+
+    if (input.scalar_type() == at::kFloat) {
+        launch_opt_bias_add_cpu((float*)output.data_ptr(),
+                                (const float*)input.data_ptr(),
+                                (const float*)bias.data_ptr(),
+                                other ? (const float*)other->data_ptr() : nullptr,
+                                other_bias ? (const float*)other_bias->data_ptr() : nullptr,
+                                problem.batch_size,
+                                problem.seq_len,
+                                problem.channels);
+    } else if (input.scalar_type() == at::kBFloat16) {
+        launch_opt_bias_add_cpu((uint16_t*)output.data_ptr(),
+                                (const uint16_t*)input.data_ptr(),
+                                (const uint16_t*)bias.data_ptr(),
+                                other ? (const uint16_t*)other->data_ptr() : nullptr,
+                                other_bias ? (const uint16_t*)other_bias->data_ptr() : nullptr,
+                                problem.batch_size,
+                                problem.seq_len,
+                                problem.channels);
+    } else {
+        // No native fp16 arithmetic on the CPU, fall back to the unfused form
+        std::vector<int64_t> shape(input.dim(), 1);
+        shape[input.dim() == 4 ? 1 : 2] = problem.channels;
+        output.copy_(input + bias.view(shape));
+        if (other) { output.add_(*other); }
+        if (other_bias) { output.add_(other_bias->view(shape)); }
+    }
+
+    return output;
+}
+
+at::Tensor seq_unroll_bias_add(at::Tensor& input, at::Tensor& bias)
+{
+    return bias_add_dispatch(input, bias, nullptr, nullptr);
+}
+
+at::Tensor seq_bias_add_add(at::Tensor& input, at::Tensor& bias, at::Tensor& other)
+{
+    return bias_add_dispatch(input, bias, &other, nullptr);
+}
+
+at::Tensor seq_bias_add_bias_add(at::Tensor& input,
+                                 at::Tensor& bias,
+                                 at::Tensor& other,
+                                 at::Tensor& other_bias)
+{
+    return bias_add_dispatch(input, bias, &other, &other_bias);
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    m.def("nhwc_bias_add", &seq_unroll_bias_add);
+    m.def("nhwc_bias_add_add", &seq_bias_add_add);
+    m.def("nhwc_bias_add_bias_add", &seq_bias_add_bias_add);
+}
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+CPU counterparts of launch_opt_bias_add. result = activation + bias (+ other (+ other_bias)),
+where activation, other and result are [batch_size * seq_len, channels] and the biases are
+[channels]. other and other_bias may be null. bf16 tensors are passed as their raw bits.
+*/
+void launch_opt_bias_add_cpu(float* result,
+                             const float* activation,
+                             const float* bias,
+                             const float* other,
+                             const float* other_bias,
+                             int64_t batch_size,
+                             int64_t seq_len,
+                             int64_t channels);
+
+void launch_opt_bias_add_cpu(uint16_t* result,
+                             const uint16_t* activation,
+                             const uint16_t* bias,
+                             const uint16_t* other,
+                             const uint16_t* other_bias,
+                             int64_t batch_size,
+                             int64_t seq_len,
+                             int64_t channels);
@@ -17,7 +17,7 @@ from ..runtime.zero.config import ZERO_OPTIMIZATION, ZeroStageEnum
 from ..utils import logger
 from .config import DeepSpeedAutotuningConfig
 from .constants import *
-from .scheduler import ResourceManager
+from .scheduler import ResourceManager, SimulatedResourceManager
 from .tuner import GridSearchTuner, RandomTuner, ModelBasedTuner
 from .utils import *
 from deepspeed.accelerator import get_accelerator
@@ -103,6 +103,8 @@ class Autotuner:
         self.optimal_cmd = None
         self.optimal_ds_config = None
 
+        self.cost_model = None
+
         self.mlflow_parent_id = None
 
     def print_tuning_results(self):
@@ -268,7 +270,61 @@ class Autotuner:
         else:
             return False
 
+    def cost_model_enabled(self):
+        return self.autotuning_config.cost_model[COST_MODEL_ENABLED]
+
+    def cost_model_simulate(self):
+        return self.cost_model_enabled() and self.autotuning_config.cost_model[COST_MODEL_SIMULATE]
+
+    def _init_cost_model(self):
+        """Loads (or measures) the machine profile and builds the analytical cost model. In simulate mode,
+        the resource manager is replaced so that no experiment is launched."""
+        from .microbenchmarks import load_machine_profile
+        from .performance_model import AnalyticalCostModel
+
+        config = self.autotuning_config.cost_model
+        nvme_path = config[COST_MODEL_NVME_PATH]
+        profile = load_machine_profile(config[COST_MODEL_MACHINE_PROFILE_PATH], nvme_path=nvme_path)
+        self.cost_model = AnalyticalCostModel(profile,
+                                              self.model_info,
+                                              num_gpus=self.exp_num_gpus,
+                                              num_nodes=self.exp_num_nodes,
+                                              mp_size=self.mp_size(),
+                                              seq_length=config[COST_MODEL_SEQ_LENGTH])
+        if self.cost_model_simulate():
+            logger.info("Cost model simulation is enabled, experiments are predicted instead of launched.")
+            self.rm = SimulatedResourceManager(args=self.args,
+                                               hosts=[node.host for node in self.rm.nodes],
+                                               num_gpus_per_node=self.rm.num_gpus_per_node,
+                                               results_dir=self.results_dir,
+                                               exps_dir=self.exps_dir,
+                                               arg_mappings=self.autotuning_config.arg_mappings,
+                                               cost_model=self.cost_model,
+                                               device_memory=self.get_gpu_memory_info())
+
+    def prune_experiments(self, exps):
+        """Drops the experiments that the cost model predicts to run out of memory and keeps the best
+        predicted keep_ratio of the rest, ordered from best to worst prediction."""
+        config = self.autotuning_config.cost_model
+        gpu_mem = self.get_gpu_memory_info()
+        scored = []
+        for exp in exps:
+            ds_config = exp[DS_CONFIG]
+            if not self.cost_model.fits(ds_config, gpu_mem):
+                continue
+            scored.append((self.cost_model.estimate_metrics(ds_config)[self.metric()], exp))
+
+        reverse = self.metric() != AUTOTUNING_METRIC_LATENCY
+        scored.sort(key=lambda x: x[0], reverse=reverse)
+        num_kept = max(config[COST_MODEL_MIN_CANDIDATES], math.ceil(len(scored) * config[COST_MODEL_KEEP_RATIO]))
+        kept = [exp for _, exp in scored[:num_kept]]
+        logger.info(f"Cost model kept {len(kept)} of {len(exps)} experiments "
+                    f"({len(exps) - len(scored)} predicted to run out of memory)")
+        return kept
+
     def get_gpu_memory_info(self):
+        if self.cost_model and self.cost_model.profile.get('device_memory'):
+            return self.cost_model.profile['device_memory']
         return get_accelerator().total_memory()
 
     def get_activation_memory_per_gpu(self):
@@ -412,6 +468,10 @@ class Autotuner:
         if self.fast_enabled():
             logger.info(f"Fast mode is enabled. Tuning micro batch size only.")
 
+        if self.cost_model_simulate():
+            assert self.autotuning_config.model_info and MODEL_INFO_NUM_PARAMS in self.autotuning_config.model_info, \
+                "cost model simulation requires num_params in the model_info of the autotuning config"
+
         # model info profile run with DEFAULT_MIN_MEM_CONFIG
         model_info = self.model_info_profile_run()
         if model_info:
@@ -419,12 +479,17 @@ class Autotuner:
         else:
             return
 
+        if self.cost_model_enabled():
+            self._init_cost_model()
+
         logger.info(f"The model has {number_to_string(self.get_model_num_params())} parameters.")
 
         self.gpu_mem = self.get_gpu_memory_info()
         logger.info(f"Memory per GPU in the system is {memory_to_string(self.gpu_mem, postfix='B')}.")
 
         self.activation_mem = self.get_activation_memory_per_gpu()
+        if not self.activation_mem and self.cost_model:
+            self.activation_mem = self.cost_model.estimate_activation_memory(1)
         logger.info(
             f"The model requires at least {memory_to_string(self.activation_mem, postfix='B')} activation memory for micro batch size 1."
         )
@@ -606,6 +671,8 @@ class Autotuner:
         logger.info(f'Tuning space name is {tuning_space_name}')
 
         exps = self._generate_experiments(tuning_space, max_train_batch_size_per_gpu)
+        if self.cost_model and not self.cost_model_simulate():
+            exps = self.prune_experiments(exps)
 
         logger.info(f'Tuner type is {self.autotuning_config.tuner_type}')
         if self.autotuning_config.tuner_type == AUTOTUNING_TUNER_MODELBASED:
@@ -84,6 +84,8 @@ class DeepSpeedAutotuningConfig(DeepSpeedConfigObject):
         self.num_tuning_micro_batch_sizes = get_dict_param(autotuning_dict, AUTOTUNING_NUM_TUNING_MICRO_BATCH_SIZES,
                                                            AUTOTUNING_NUM_TUNING_MICRO_BATCH_SIZES_DEFAULT)
 
+        self.cost_model = get_cost_model_config(autotuning_dict)
+
 
 def get_model_info_config(param_dict):
     if MODEL_INFO in param_dict and param_dict[MODEL_INFO] is not None:
@@ -94,5 +96,13 @@ def get_model_info_config(param_dict):
     return None
 
 
+def get_cost_model_config(param_dict):
+    cost_model_dict = param_dict.get(COST_MODEL, None) or {}
+    cost_model_config = {}
+    for key, default_value in COST_MODEL_KEY_DEFAULT_DICT.items():
+        cost_model_config[key] = get_scalar_param(cost_model_dict, key, default_value)
+    return cost_model_config
+
+
 def get_default_model_info_config():
     return MODEL_INFO_KEY_DEFAULT_DICT
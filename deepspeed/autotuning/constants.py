@@ -129,6 +129,50 @@ MODEL_INFO_KEY_DEFAULT_DICT = {
     MODEL_INFO_NUM_LAYERS: MODEL_INFO_NUM_LAYERS_DEFAULT
 }
 
+#########################################
+# COST MODEL
+#########################################
+COST_MODEL_FORMAT = '''
+"cost_model": {
+  "enabled": true,
+  "simulate": false,
+  "seq_length": 1024,
+  "keep_ratio": 0.25,
+  "min_candidates": 2,
+  "machine_profile_path": null,
+  "nvme_path": null
+}
+'''
+COST_MODEL = "cost_model"
+COST_MODEL_ENABLED = "enabled"
+COST_MODEL_ENABLED_DEFAULT = False
+# predict the metrics of every experiment instead of launching it
+COST_MODEL_SIMULATE = "simulate"
+COST_MODEL_SIMULATE_DEFAULT = False
+COST_MODEL_SEQ_LENGTH = "seq_length"
+COST_MODEL_SEQ_LENGTH_DEFAULT = 1024
+# fraction of the candidate experiments of a tuning space that is launched, best predicted first
+COST_MODEL_KEEP_RATIO = "keep_ratio"
+COST_MODEL_KEEP_RATIO_DEFAULT = 0.25
+COST_MODEL_MIN_CANDIDATES = "min_candidates"
+COST_MODEL_MIN_CANDIDATES_DEFAULT = 2
+# cached microbenchmark results, measured on first use
+COST_MODEL_MACHINE_PROFILE_PATH = "machine_profile_path"
+COST_MODEL_MACHINE_PROFILE_PATH_DEFAULT = None
+# directory on the NVMe device used to measure the AIO bandwidth
+COST_MODEL_NVME_PATH = "nvme_path"
+COST_MODEL_NVME_PATH_DEFAULT = None
+
+COST_MODEL_KEY_DEFAULT_DICT = {
+    COST_MODEL_ENABLED: COST_MODEL_ENABLED_DEFAULT,
+    COST_MODEL_SIMULATE: COST_MODEL_SIMULATE_DEFAULT,
+    COST_MODEL_SEQ_LENGTH: COST_MODEL_SEQ_LENGTH_DEFAULT,
+    COST_MODEL_KEEP_RATIO: COST_MODEL_KEEP_RATIO_DEFAULT,
+    COST_MODEL_MIN_CANDIDATES: COST_MODEL_MIN_CANDIDATES_DEFAULT,
+    COST_MODEL_MACHINE_PROFILE_PATH: COST_MODEL_MACHINE_PROFILE_PATH_DEFAULT,
+    COST_MODEL_NVME_PATH: COST_MODEL_NVME_PATH_DEFAULT
+}
+
 #########################################
 # autotuner search space constants
 #########################################
@@ -0,0 +1,206 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+"""
+Per-machine microbenchmarks that feed the analytical cost model of the autotuner.
+
+The machine profile holds the achieved GEMM throughput over a range of problem sizes, the device
+memory and host-device bandwidths, the step throughput of the native CPU Adam optimizer, the AIO
+read/write bandwidth of an NVMe path, and the all-reduce bus bandwidth and latency. It is measured
+once and cached as JSON, by default under ``~/.cache/deepspeed/autotuning``.
+"""
+
+import json
+import os
+import socket
+import tempfile
+import time
+
+import torch
+
+from deepspeed.accelerator import get_accelerator
+from deepspeed.utils import logger
+
+MACHINE_PROFILE_VERSION = 1
+
+# rows of the [rows, hidden] x [hidden, 4 * hidden] GEMMs, i.e. tokens per micro batch
+GEMM_ROWS = [128, 512, 2048, 8192, 32768]
+GEMM_HIDDEN_SIZE = 2048
+
+# fallbacks for bandwidths that cannot be measured on the launching node
+DEFAULT_INTRA_NODE_BANDWIDTH_GBPS = 100.0
+DEFAULT_INTER_NODE_BANDWIDTH_GBPS = 12.5
+DEFAULT_COLLECTIVE_LATENCY_USEC = 30.0
+
+
+def _device_available():
+    return get_accelerator().is_available()
+
+
+def _synchronize():
+    if _device_available():
+        get_accelerator().synchronize()
+
+
+def _time_per_iter(fn, warmup=2, iters=5):
+    for _ in range(warmup):
+        fn()
+    _synchronize()
+    start = time.perf_counter()
+    for _ in range(iters):
+        fn()
+    _synchronize()
+    return (time.perf_counter() - start) / iters
+
+
+def benchmark_gemm(hidden_size=GEMM_HIDDEN_SIZE, rows=GEMM_ROWS):
+    """Returns a list of (rows, TFLOPS) of half precision GEMMs on the accelerator, or of fp32 GEMMs
+    on the CPU if no accelerator is available."""
+    if _device_available():
+        device, dtype = get_accelerator().device_name(), torch.half
+    else:
+        device, dtype = 'cpu', torch.float
+        rows = [r for r in rows if r <= 2048]
+    weight = torch.randn(hidden_size, 4 * hidden_size, dtype=dtype, device=device)
+    results = []
+    for num_rows in rows:
+        activation = torch.randn(num_rows, hidden_size, dtype=dtype, device=device)
+        seconds = _time_per_iter(lambda: torch.matmul(activation, weight))
+        results.append((num_rows, 2 * num_rows * hidden_size * 4 * hidden_size / seconds / 1e12))
+    return results
+
+
+def benchmark_device_memory_bandwidth(num_bytes=256 * 1024**2):
+    """Device copy bandwidth in GB/s, counting the bytes read and written."""
+    if not _device_available():
+        return None
+    src = torch.empty(num_bytes, dtype=torch.uint8, device=get_accelerator().device_name())
+    dst = torch.empty_like(src)
+    seconds = _time_per_iter(lambda: dst.copy_(src))
+    return 2 * num_bytes / seconds / 1e9
+
+
+def benchmark_host_device_bandwidth(num_bytes=256 * 1024**2):
+    """Pinned host to device copy bandwidth in GB/s."""
+    if not _device_available():
+        return None
+    host = get_accelerator().pin_memory(torch.empty(num_bytes, dtype=torch.uint8))
+    device = torch.empty(num_bytes, dtype=torch.uint8, device=get_accelerator().device_name())
+    seconds = _time_per_iter(lambda: device.copy_(host, non_blocking=True))
+    return num_bytes / seconds / 1e9
+
+
+def benchmark_cpu_adam(num_elements=2**24):
+    """Steps per second of the CPU Adam optimizer expressed as GB/s of fp32 params, grads, and both
+    moments, i.e. 16 bytes per element. Uses the native DeepSpeedCPUAdam when it can be built."""
+    param = torch.nn.Parameter(torch.zeros(num_elements, dtype=torch.float))
+    param.grad = torch.randn(num_elements, dtype=torch.float)
+    try:
+        from deepspeed.ops.adam import DeepSpeedCPUAdam
+        optimizer = DeepSpeedCPUAdam([param])
+    except Exception as e:
+        logger.warning(f"Native CPU Adam is not available ({e}), measuring torch.optim.Adam instead")
+        optimizer = torch.optim.Adam([param])
+    seconds = _time_per_iter(optimizer.step, warmup=1, iters=3)
+    return 16 * num_elements / seconds / 1e9
+
+
+def benchmark_aio(nvme_path, num_bytes=256 * 1024**2, block_size=1024**2, queue_depth=32, num_threads=8):
+    """Returns the (read, write) bandwidth in GB/s of the async I/O op on nvme_path, or None."""
+    if nvme_path is None:
+        return None
+    try:
+        from deepspeed.ops.op_builder import AsyncIOBuilder
+        handle = AsyncIOBuilder().load(verbose=False).aio_handle(block_size, queue_depth, False, True, num_threads)
+    except Exception as e:
+        logger.warning(f"Async I/O is not available ({e}), skipping the AIO benchmark")
+        return None
+
+    buffer = handle.new_cpu_locked_tensor(num_bytes, torch.empty(0, dtype=torch.uint8))
+    fd, path = tempfile.mkstemp(dir=nvme_path, suffix='.swp')
+    os.close(fd)
+    try:
+        start = time.perf_counter()
+        handle.sync_pwrite(buffer, path)
+        write_seconds = time.perf_counter() - start
+        start = time.perf_counter()
+        handle.sync_pread(buffer, path)
+        read_seconds = time.perf_counter() - start
+    finally:
+        os.remove(path)
+        handle.free_cpu_locked_tensor(buffer)
+    return num_bytes / read_seconds / 1e9, num_bytes / write_seconds / 1e9
+
+
+def benchmark_allreduce(num_bytes=64 * 1024**2):
+    """Returns the all-reduce (bus bandwidth in GB/s, latency in usec) among the ranks of an initialized
+    process group, or None."""
+    from deepspeed import comm as dist
+    if not dist.is_initialized() or dist.get_world_size() < 2:
+        return None
+    world_size = dist.get_world_size()
+    device = get_accelerator().device_name() if _device_available() else 'cpu'
+    large = torch.empty(num_bytes // 2, dtype=torch.half, device=device)
+    small = torch.empty(1, dtype=torch.half, device=device)
+    seconds = _time_per_iter(lambda: dist.all_reduce(large))
+    latency = _time_per_iter(lambda: dist.all_reduce(small), iters=20)
+    return 2 * (world_size - 1) / world_size * num_bytes / seconds / 1e9, latency * 1e6
+
+
+def run_microbenchmarks(nvme_path=None):
+    """Measures all microbenchmarks and returns the machine profile."""
+    logger.info("Running autotuning microbenchmarks")
+    profile = {
+        'version': MACHINE_PROFILE_VERSION,
+        'hostname': socket.gethostname(),
+        'device': get_accelerator().device_name() if _device_available() else 'cpu',
+        'device_memory': get_accelerator().total_memory() if _device_available() else None,
+        'gemm_hidden_size': GEMM_HIDDEN_SIZE,
+        'gemm_tflops': benchmark_gemm(),
+        'device_memory_GBps': benchmark_device_memory_bandwidth(),
+        'host_device_GBps': benchmark_host_device_bandwidth(),
+        'cpu_adam_GBps': benchmark_cpu_adam(),
+        'intra_node_GBps': DEFAULT_INTRA_NODE_BANDWIDTH_GBPS,
+        'inter_node_GBps': DEFAULT_INTER_NODE_BANDWIDTH_GBPS,
+        'collective_latency_usec': DEFAULT_COLLECTIVE_LATENCY_USEC,
+        'aio_read_GBps': None,
+        'aio_write_GBps': None,
+    }
+
+    aio = benchmark_aio(nvme_path)
+    if aio is not None:
+        profile['aio_read_GBps'], profile['aio_write_GBps'] = aio
+
+    allreduce = benchmark_allreduce()
+    if allreduce is not None:
+        profile['intra_node_GBps'], profile['collective_latency_usec'] = allreduce
+
+    logger.info(f"Machine profile: {profile}")
+    return profile
+
+
+def get_default_machine_profile_path():
+    device = get_accelerator().device_name() if _device_available() else 'cpu'
+    return os.path.join(os.path.expanduser('~'), '.cache', 'deepspeed', 'autotuning',
+                        f'machine_profile_{socket.gethostname()}_{device}.json')
+
+
+def load_machine_profile(path=None, nvme_path=None):
+    """Returns the machine profile cached at path, running and caching the microbenchmarks first if
+    there is none. Inter-node bandwidth and collective figures can be edited in the cached file."""
+    path = path or get_default_machine_profile_path()
+    if os.path.exists(path):
+        with open(path, 'r') as fd:
+            profile = json.load(fd)
+        if profile.get('version') == MACHINE_PROFILE_VERSION and (nvme_path is None
+                                                                    or profile.get('aio_read_GBps') is not None):
+            logger.info(f"Loaded machine profile from {path}")
+            return profile
+
+    profile = run_microbenchmarks(nvme_path=nvme_path)
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, 'w') as fd:
+        json.dump(profile, fd, indent=2)
+    logger.info(f"Wrote machine profile to {path}")
+    return profile
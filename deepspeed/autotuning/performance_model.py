@@ -0,0 +1,268 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+"""
+Analytical step time and memory model of a DeepSpeed training configuration.
+
+Given a machine profile (see ``microbenchmarks.py``) and the model size, the model predicts the
+per-GPU memory and the time of one training step of a candidate DeepSpeed configuration, so that
+the autotuner can discard configurations that would run out of memory or are clearly slower than
+others before launching any experiment. It accounts for:
+
+* compute: 6 flops per parameter and token at the GEMM throughput measured for the micro batch size,
+* ZeRO communication: all-reduce, reduce-scatter and all-gather volumes per micro step and per step,
+  bucket counts times the collective latency, and the part hidden by ``overlap_comm``,
+* the optimizer step on the device, with the native CPU Adam, or with NVMe swapping,
+* parameter and gradient transfers of ZeRO-Offload and ZeRO-Infinity.
+
+The numbers are estimates meant for ranking configurations, not for predicting absolute throughput.
+"""
+
+import bisect
+import math
+
+from deepspeed.runtime.constants import (BFLOAT16, FP16, GRADIENT_ACCUMULATION_STEPS, TRAIN_BATCH_SIZE,
+                                         TRAIN_MICRO_BATCH_SIZE_PER_GPU)
+from deepspeed.runtime.zero.config import ZERO_OPTIMIZATION
+
+from .constants import (AUTOTUNING_METRIC_FLOPS, AUTOTUNING_METRIC_LATENCY, AUTOTUNING_METRIC_THROUGHPUT,
+                        MODEL_INFO_HIDDEN_SIZE, MODEL_INFO_NUM_LAYERS, MODEL_INFO_NUM_PARAMS)
+
+# fraction of the device memory that can be used by the model, the rest is kept for the framework
+MEMORY_USABLE_FRACTION = 0.9
+
+# activation bytes per token, hidden unit and layer in half precision without activation checkpointing
+ACTIVATION_BYTES_PER_TOKEN_HIDDEN_LAYER = 34
+
+# DeepSpeed bucket defaults, used when a configuration does not set them
+DEFAULT_REDUCE_BUCKET_SIZE = 5e8
+DEFAULT_ALLGATHER_BUCKET_SIZE = 5e8
+DEFAULT_PREFETCH_BUCKET_SIZE = 5e7
+
+# fraction of the backward pass that overlapped gradient communication can hide behind
+OVERLAP_EFFICIENCY = 0.8
+
+
+class AnalyticalCostModel:
+    """Predicts memory and step time of DeepSpeed configurations from a machine profile.
+
+    Args:
+        machine_profile (dict): Results of ``microbenchmarks.run_microbenchmarks``.
+        model_info (dict): ``num_params`` and optionally ``hidden_size``, ``num_layers`` and
+            ``activation_mem_per_gpu`` (activation memory at micro batch size 1, if profiled).
+        num_gpus (int): GPUs per node used by each experiment.
+        num_nodes (int): Nodes used by each experiment.
+        mp_size (int): Model parallelism degree.
+        seq_length (int): Tokens per sample.
+    """
+
+    def __init__(self, machine_profile, model_info, num_gpus, num_nodes, mp_size=1, seq_length=1024):
+        assert model_info and model_info.get(MODEL_INFO_NUM_PARAMS), \
+            "the cost model requires the number of model parameters"
+        self.profile = machine_profile
+        self.model_info = model_info
+        self.num_params = model_info[MODEL_INFO_NUM_PARAMS]
+        self.num_gpus = num_gpus
+        self.num_nodes = num_nodes
+        self.mp_size = mp_size
+        self.seq_length = seq_length
+        self.dp_size = max(1, num_gpus * num_nodes // mp_size)
+
+        gemm = sorted(machine_profile['gemm_tflops'])
+        self.gemm_rows = [rows for rows, _ in gemm]
+        self.gemm_tflops = [tflops for _, tflops in gemm]
+
+    def _gemm_tflops(self, rows):
+        """Achieved throughput for GEMMs with the given number of rows, interpolated in log space."""
+        if rows <= self.gemm_rows[0]:
+            return self.gemm_tflops[0] * rows / self.gemm_rows[0]
+        if rows >= self.gemm_rows[-1]:
+            return self.gemm_tflops[-1]
+        i = bisect.bisect_left(self.gemm_rows, rows)
+        lo, hi = self.gemm_rows[i - 1], self.gemm_rows[i]
+        t = (math.log(rows) - math.log(lo)) / (math.log(hi) - math.log(lo))
+        return self.gemm_tflops[i - 1] + t * (self.gemm_tflops[i] - self.gemm_tflops[i - 1])
+
+    def _collective_bandwidth(self):
+        key = 'inter_node_GBps' if self.num_nodes > 1 else 'intra_node_GBps'
+        return self.profile[key] * 1e9
+
+    def _collective_time(self, num_bytes, num_calls):
+        latency = self.profile['collective_latency_usec'] * 1e-6
+        return num_calls * latency + num_bytes / self._collective_bandwidth()
+
+    @staticmethod
+    def _precision_bytes(ds_config):
+        half = ds_config.get(FP16, {}).get('enabled', False) or ds_config.get(BFLOAT16, {}).get('enabled', False)
+        return 2 if half else 4
+
+    @staticmethod
+    def _zero_config(ds_config):
+        return ds_config.get(ZERO_OPTIMIZATION, {}) or {}
+
+    @staticmethod
+    def _offload_device(zero_config, key):
+        offload = zero_config.get(key, None)
+        if not offload:
+            return None
+        device = offload.get('device', 'none')
+        return None if device in (None, 'none') else device
+
+    def estimate_activation_memory(self, micro_batch_size):
+        """Activation memory per GPU in bytes."""
+        if self.model_info.get('activation_mem_per_gpu'):
+            return self.model_info['activation_mem_per_gpu'] * micro_batch_size
+        hidden_size = self.model_info.get(MODEL_INFO_HIDDEN_SIZE)
+        num_layers = self.model_info.get(MODEL_INFO_NUM_LAYERS)
+        if not hidden_size or not num_layers:
+            # transformer with 12 * L * h^2 parameters and L = h / 128
+            hidden_size = round((self.num_params * 128 / 12)**(1 / 3))
+            num_layers = max(1, hidden_size // 128)
+        return (ACTIVATION_BYTES_PER_TOKEN_HIDDEN_LAYER * micro_batch_size * self.seq_length * hidden_size *
+                num_layers / self.mp_size)
+
+    def estimate_memory(self, ds_config):
+        """Peak memory per GPU in bytes."""
+        zero = self._zero_config(ds_config)
+        stage = zero.get('stage', 0)
+        half_bytes = self._precision_bytes(ds_config)
+        num_params = self.num_params / self.mp_size
+
+        params_mem = num_params * half_bytes
+        grads_mem = num_params * half_bytes
+        # fp32 master weights and gradients and both Adam moments for mixed precision, moments otherwise
+        optimizer_mem = num_params * (16 if half_bytes == 2 else 8)
+
+        if stage >= 1:
+            optimizer_mem /= self.dp_size
+        if stage >= 2:
+            grads_mem /= self.dp_size
+        if stage >= 3:
+            params_mem /= self.dp_size
+
+        if self._offload_device(zero, 'offload_optimizer'):
+            optimizer_mem = 0
+        if stage >= 3 and self._offload_device(zero, 'offload_param'):
+            params_mem = 0
+
+        reduce_bucket = zero.get('reduce_bucket_size', DEFAULT_REDUCE_BUCKET_SIZE)
+        buffers_mem = reduce_bucket * half_bytes * (2 if zero.get('overlap_comm', False) else 1)
+        if stage in (1, 2):
+            buffers_mem += zero.get('allgather_bucket_size', DEFAULT_ALLGATHER_BUCKET_SIZE) * half_bytes
+        elif stage >= 3:
+            buffers_mem += zero.get('stage3_prefetch_bucket_size', DEFAULT_PREFETCH_BUCKET_SIZE) * half_bytes
+
+        micro_batch_size = ds_config.get(TRAIN_MICRO_BATCH_SIZE_PER_GPU, 1)
+        activation_mem = self.estimate_activation_memory(micro_batch_size)
+        if half_bytes == 4 and not self.model_info.get('activation_mem_per_gpu'):
+            activation_mem *= 2
+
+        return params_mem + grads_mem + optimizer_mem + buffers_mem + activation_mem
+
+    def fits(self, ds_config, device_memory):
+        return self.estimate_memory(ds_config) <= MEMORY_USABLE_FRACTION * device_memory
+
+    def estimate_step_time(self, ds_config):
+        """Returns a dict with the predicted ``compute``, ``communication``, ``optimizer`` and ``total``
+        seconds of one training step, i.e. of gradient_accumulation_steps micro steps."""
+        zero = self._zero_config(ds_config)
+        stage = zero.get('stage', 0)
+        half_bytes = self._precision_bytes(ds_config)
+        micro_batch_size = ds_config.get(TRAIN_MICRO_BATCH_SIZE_PER_GPU, 1)
+        gas = ds_config.get(GRADIENT_ACCUMULATION_STEPS, 1)
+        dp = self.dp_size
+        num_params = self.num_params / self.mp_size
+        overlap = zero.get('overlap_comm', False)
+
+        # compute of one micro step, a third forward and two thirds backward
+        tokens = micro_batch_size * self.seq_length
+        flops = 6 * num_params * tokens
+        micro_compute = flops / (self._gemm_tflops(tokens) * 1e12)
+        backward = micro_compute * 2 / 3
+
+        param_bytes = num_params * half_bytes
+        grad_bytes = num_params * half_bytes
+        reduce_bucket = zero.get('reduce_bucket_size', DEFAULT_REDUCE_BUCKET_SIZE) * half_bytes
+        allgather_bucket = zero.get('allgather_bucket_size', DEFAULT_ALLGATHER_BUCKET_SIZE) * half_bytes
+        ring = (dp - 1) / dp
+
+        micro_comm = 0.0
+        step_comm = 0.0
+        if dp > 1:
+            reduce_calls = math.ceil(grad_bytes / reduce_bucket)
+            if stage == 0:
+                # gradients are all-reduced once per step, after the last backward
+                step_comm += self._collective_time(2 * ring * grad_bytes, reduce_calls)
+            else:
+                # gradients are reduced into their partition during every backward
+                volume = ring * grad_bytes if zero.get('reduce_scatter', True) else 2 * ring * grad_bytes
+                micro_comm += self._collective_time(volume, reduce_calls)
+
+            if stage in (1, 2):
+                # updated partitions are gathered after the step
+                calls = math.ceil(param_bytes / allgather_bucket)
+                if not zero.get('allgather_partitions', True):
+                    calls *= dp
+                step_comm += self._collective_time(ring * param_bytes, calls)
+            elif stage >= 3:
+                # parameters are gathered for forward and again for backward
+                prefetch_bucket = zero.get('stage3_prefetch_bucket_size', DEFAULT_PREFETCH_BUCKET_SIZE) * half_bytes
+                calls = 2 * max(math.ceil(param_bytes / prefetch_bucket), self.model_info.get(MODEL_INFO_NUM_LAYERS)
+                                or 1)
+                micro_comm += self._collective_time(2 * ring * param_bytes, calls)
+
+        if overlap:
+            hidden = min(micro_comm, OVERLAP_EFFICIENCY * (micro_compute if stage >= 3 else backward))
+            micro_comm -= hidden
+
+        # optimizer step over the local partition
+        partition = num_params / dp if stage >= 1 else num_params
+        optimizer_device = self._offload_device(zero, 'offload_optimizer')
+        optimizer = 0.0
+        if optimizer_device is None:
+            device_bw = (self.profile.get('device_memory_GBps') or 1000.0) * 1e9
+            # read and write fp32 params and both moments, read gradients
+            optimizer = partition * (2 * 12 + 4) / device_bw
+        else:
+            host_bw = (self.profile.get('host_device_GBps') or 10.0) * 1e9
+            optimizer = partition * 16 / (self.profile['cpu_adam_GBps'] * 1e9)
+            # gradients down and updated parameters up
+            optimizer += partition * 2 * half_bytes / host_bw
+            if optimizer_device == 'nvme':
+                optimizer += self._nvme_time(partition * 12, partition * 12)
+
+        param_device = self._offload_device(zero, 'offload_param') if stage >= 3 else None
+        if param_device is not None:
+            host_bw = (self.profile.get('host_device_GBps') or 10.0) * 1e9
+            fetch_bytes = 2 * partition * half_bytes
+            micro_comm += fetch_bytes / host_bw
+            if param_device == 'nvme':
+                micro_comm += self._nvme_time(fetch_bytes, 0)
+
+        compute = gas * micro_compute
+        communication = gas * micro_comm + step_comm
+        total = compute + communication + optimizer
+        return {'compute': compute, 'communication': communication, 'optimizer': optimizer, 'total': total}
+
+    def _nvme_time(self, read_bytes, write_bytes):
+        read_bw = self.profile.get('aio_read_GBps') or 1.0
+        write_bw = self.profile.get('aio_write_GBps') or 1.0
+        return read_bytes / (read_bw * 1e9) + write_bytes / (write_bw * 1e9)
+
+    def estimate_metrics(self, ds_config):
+        """Predicted metrics in the format written by the engine at the end of an autotuning experiment."""
+        micro_batch_size = ds_config.get(TRAIN_MICRO_BATCH_SIZE_PER_GPU, 1)
+        gas = ds_config.get(GRADIENT_ACCUMULATION_STEPS, 1)
+        train_batch_size = ds_config.get(TRAIN_BATCH_SIZE, micro_batch_size * gas * self.dp_size)
+        step_time = self.estimate_step_time(ds_config)
+        latency_ms = step_time['total'] * 1000
+        flops_per_gpu = 6 * self.num_params / self.mp_size * micro_batch_size * self.seq_length * gas
+        return {
+            AUTOTUNING_METRIC_LATENCY: latency_ms,
+            AUTOTUNING_METRIC_THROUGHPUT: train_batch_size * 1_000_000 / latency_ms,
+            AUTOTUNING_METRIC_FLOPS: flops_per_gpu / step_time['total'],
+            'FLOPS_per_gpu': flops_per_gpu / step_time['total'],
+            'memory_per_gpu': self.estimate_memory(ds_config),
+            'step_time_breakdown': step_time,
+        }
@@ -257,6 +257,59 @@ class ResourceManager:
         self.exp_paths = set()
 
 
+class SimulatedResourceManager(ResourceManager):
+    """A resource manager that does not launch experiments. The metrics of each experiment are predicted
+    by an analytical cost model and written where the experiment would have written them, so the tuners
+    and the autotuner run unchanged. Experiments predicted to run out of memory fail.
+    """
+
+    def __init__(self, args, hosts, num_gpus_per_node, results_dir, exps_dir, arg_mappings, cost_model,
+                 device_memory):
+        super().__init__(args, hosts, num_gpus_per_node, results_dir, exps_dir, arg_mappings)
+        self.cost_model = cost_model
+        self.device_memory = device_memory
+
+    def run(self):
+        while len(self.experiment_queue) > 0:
+            exp = self.experiment_queue.pop(0)
+            exp_dir = exp["result_dir"] = os.path.join(self.results_dir, exp['name'])
+            os.makedirs(exp_dir, exist_ok=True)
+            ds_config = exp["ds_config"]
+            ds_config_path = os.path.join(exp_dir, "ds_config.json")
+            with open(ds_config_path, "w", buffering=BUFSIZE) as fd:
+                json.dump(ds_config, fd)
+
+            # the command that would have launched the experiment, used for the optimal config
+            user_args = list(self.args.user_args) if self.args and self.args.user_args else []
+            for flag in ("--deepspeed_config", "--deepspeed"):
+                if flag in user_args and user_args.index(flag) + 1 < len(user_args):
+                    user_args[user_args.index(flag) + 1] = ds_config_path
+                    break
+            user_script = [self.args.user_script] if self.args else []
+            cmd = ["deepspeed", "--num_nodes", str(exp['num_nodes']), "--num_gpus", str(exp['num_gpus'])]
+            with open(os.path.join(exp_dir, "cmd.txt"), "w", buffering=BUFSIZE) as fd:
+                fd.write(" ".join(cmd + user_script + user_args))
+                fd.write("\n")
+
+            err = None
+            if not self.cost_model.fits(ds_config, self.device_memory):
+                err = "CUDA out of memory (predicted by the autotuning cost model)"
+            else:
+                metrics = self.cost_model.estimate_metrics(ds_config)
+                metric_file = ds_config.get(AUTOTUNING, {}).get(AUTOTUNING_METRIC_PATH,
+                                                                os.path.join(exp_dir, "metrics.json"))
+                with open(metric_file, "w", buffering=BUFSIZE) as fd:
+                    json.dump(metrics, fd)
+            logger.debug(f"Simulated exp_id = {exp['exp_id']}, exp_name = {exp['name']}, error = {err}")
+            self.finished_experiments[exp["exp_id"]] = (exp, err)
+
+    def clear(self):
+        self.experiment_queue = []
+        self.running_experiments = {}
+        self.finished_experiments = {}
+        self.exp_paths = set()
+
+
 class Node:
 
     def __init__(self, host, max_slots):
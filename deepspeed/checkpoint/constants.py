@@ -20,6 +20,7 @@ GROUP_PADDINGS = 'group_paddings'
 PARTITION_COUNT = 'partition_count'
 ZERO_STAGE = 'zero_stage'
 CLIP_GRAD = 'clip_grad'
+ROUNDING_STEP = 'rounding_step'
 FP32_WEIGHT_KEY = "fp32"
 LOSS_SCALER = 'loss_scaler'
 
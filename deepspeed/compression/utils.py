@@ -7,6 +7,27 @@ import torch
 from torch import autograd
 import math
 
+from deepspeed.accelerator import get_accelerator
+
+cpu_quantizer_module = None
+
+
+def fused_fake_quantizer(input):
+    """
+    Returns the native quantizer module when ``input`` can be fake quantized by its fused CPU
+    kernels, i.e. an fp32 tensor on the CPU accelerator, or None to use the torch ops.
+    """
+    global cpu_quantizer_module
+    if input.device.type != 'cpu' or input.dtype != torch.float32 or get_accelerator().device_name() != 'cpu':
+        return None
+    if cpu_quantizer_module is None:
+        builder = get_accelerator().create_op_builder("QuantizerBuilder")
+        if builder is None or not builder.is_compatible(verbose=False):
+            cpu_quantizer_module = False
+        else:
+            cpu_quantizer_module = builder.load()
+    return cpu_quantizer_module or None
+
 
 class TopKBinarizer(autograd.Function):
     """
@@ -82,6 +103,11 @@ class SymQuantizer(torch.autograd.Function):
         """
         assert (min_value is None and max_value is None) or (min_value is not None and max_value is not None
                                                              and num_groups == 1)
+        quantizer_module = fused_fake_quantizer(input)
+        if quantizer_module is not None:
+            return quantizer_module.fake_quantize(input, num_bits, num_groups, quantizer_module.SymmetricFakeQuant,
+                                                  min_value, max_value)
+
         q_range = 2**num_bits
         input_shape = input.shape
         if min_value is None:
@@ -125,6 +151,11 @@ class AsymQuantizer(torch.autograd.Function):
 
         assert (min_value is None and max_value is None) or (min_value is not None and max_value is not None
                                                              and num_groups == 1)
+        quantizer_module = fused_fake_quantizer(input)
+        if quantizer_module is not None:
+            return quantizer_module.fake_quantize(input, num_bits, num_groups, quantizer_module.AsymmetricFakeQuant,
+                                                  min_value, max_value)
+
         q_range = 2**num_bits
         input_shape = input.shape
         if min_value is None:
@@ -168,6 +199,11 @@ class TernaryQuantizer(torch.autograd.Function):
         """
 
         assert (min_value is None and max_value is None)
+        quantizer_module = fused_fake_quantizer(input)
+        if quantizer_module is not None:
+            return quantizer_module.fake_quantize(input, num_bits, num_groups, quantizer_module.TernaryFakeQuant, None,
+                                                  None)
+
         input_flat = input.reshape(num_groups, -1)
         n = input_flat.shape[1]
         m = input_flat.norm(p=1, dim=1).div(n)
@@ -209,6 +245,11 @@ class BinaryQuantizer(torch.autograd.Function):
         """
 
         assert (min_value is None and max_value is None)
+        quantizer_module = fused_fake_quantizer(input)
+        if quantizer_module is not None:
+            return quantizer_module.fake_quantize(input, num_bits, num_groups, quantizer_module.BinaryFakeQuant, None,
+                                                  None)
+
         input_flat = input.reshape(num_groups, -1)
         n = input_flat.shape[1]
         m = input_flat.norm(p=1, dim=1, keepdim=True).div(n)
@@ -3,6 +3,7 @@
 
 # DeepSpeed Team
 
+from contextlib import contextmanager
 from functools import reduce
 from typing import Iterable
 from collections import defaultdict
@@ -14,7 +15,12 @@ from deepspeed.accelerator import get_accelerator
 class Allocator:
     cache = defaultdict(dict)
 
+    # Set by ``ActivationMemoryPlanner.record`` to observe every allocation of a forward.
+    recorder = None
+
     def empty_from(tensor: torch.Tensor, shape: Iterable[int]) -> torch.Tensor:
+        if Allocator.recorder is not None:
+            Allocator.recorder.on_allocation(tensor)
         try:
             return Allocator.cache[tensor][shape]
         except KeyError:
@@ -28,6 +34,25 @@ class Allocator:
 empty_from = Allocator.empty_from
 
 
+# Set by ``finalize_on_host`` when the finalized parameters should stay in host memory.
+_finalize_on_host = False
+
+
+@contextmanager
+def finalize_on_host():
+    """
+    Keep the parameters finalized by ``on_device`` methods in host memory. Used when the model is
+    flattened into host memory, for instance to stream its weights, and the whole model would
+    not fit on the accelerator.
+    """
+    global _finalize_on_host
+    previous, _finalize_on_host = _finalize_on_host, True
+    try:
+        yield
+    finally:
+        _finalize_on_host = previous
+
+
 def on_device(method) -> torch.Tensor:
     """
     Wraps a method to ensure the returned tensor is on the current device.
@@ -35,7 +60,7 @@ def on_device(method) -> torch.Tensor:
 
     def wrapped(self, *args, **kwargs):
         tensor = method(self, *args, **kwargs)
-        if isinstance(tensor, torch.Tensor):
+        if isinstance(tensor, torch.Tensor) and not _finalize_on_host:
             return tensor.to(get_accelerator().current_device())
         return tensor
 
@@ -5,22 +5,89 @@
 
 import os
 import json
+import struct
 import torch
 from .base_engine import CheckpointEngineBase
-from typing import Iterable, Tuple
+from typing import Dict, Iterable, List, NamedTuple, Optional, Tuple
 from functools import partial
 
+from deepspeed.ops.op_builder import RaggedUtilsBuilder
+from ..inference_utils import elem_size
 from ..logging import inference_logger
 
+SAFETENSORS_DTYPES = {
+    "F64": torch.float64,
+    "F32": torch.float32,
+    "F16": torch.float16,
+    "BF16": torch.bfloat16,
+    "I64": torch.int64,
+    "I32": torch.int32,
+    "I16": torch.int16,
+    "I8": torch.int8,
+    "U8": torch.uint8,
+    "BOOL": torch.bool,
+}
+
+# Range_Dtype codes of the native loader, the dtypes it can convert between.
+RAW_RANGE = 0
+CONVERTIBLE_DTYPES = {torch.float32: 1, torch.float16: 2, torch.bfloat16: 3}
+
+
+class TensorRead(NamedTuple):
+    name: str
+    file_index: int
+    file_offset: int
+    n_bytes: int
+    src_dtype: torch.dtype
+    dst_dtype: torch.dtype
+    shape: Tuple[int, ...]
+
+    @property
+    def dst_bytes(self) -> int:
+        return self.n_bytes // elem_size(self.src_dtype) * elem_size(self.dst_dtype)
+
+
+def read_safetensors_header(path: str) -> Tuple[int, Dict[str, Dict]]:
+    """
+    Parse the header of a safetensors file.
+
+    Returns:
+        Tuple[int, Dict]: The file offset of the tensor data and the per-tensor entries with
+            their ``dtype``, ``shape`` and ``data_offsets`` relative to that offset.
+    """
+    with open(path, "rb") as f:
+        header_size = struct.unpack("<Q", f.read(8))[0]
+        header = json.loads(f.read(header_size))
+    header.pop("__metadata__", None)
+    return 8 + header_size, header
+
 
 class HuggingFaceCheckpointEngine(CheckpointEngineBase):
 
-    def __init__(self, model_name_or_path: str, auth_token: str = None) -> None:
+    def __init__(self,
+                 model_name_or_path: str,
+                 auth_token: str = None,
+                 load_dtype: Optional[torch.dtype] = None,
+                 io_threads: int = 8,
+                 io_window_bytes: int = 4 * 2**30) -> None:
+        """
+        Arguments:
+            model_name_or_path: HuggingFace model name or local checkpoint directory.
+            auth_token: Token used to download gated models.
+            load_dtype: If set, floating point safetensors parameters are converted to this dtype
+                while they are read.
+            io_threads: Number of threads reading safetensors shards in parallel.
+            io_window_bytes: Upper bound on the host memory of one batch of parallel reads. The
+                parameters of a batch are yielded once all of its reads have completed.
+        """
         super().__init__()
         from transformers import AutoConfig, GenerationConfig
 
         self.model_name_or_path = model_name_or_path
         self.auth_token = auth_token
+        self._load_dtype = load_dtype
+        self._io_threads = io_threads
+        self._io_window_bytes = io_window_bytes
         self.model_config = AutoConfig.from_pretrained(self.model_name_or_path)
         # Define this property here so we can use it in the model implementation
         if not hasattr(self.model_config, "max_seq_length"):
@@ -72,7 +139,8 @@ class HuggingFaceCheckpointEngine(CheckpointEngineBase):
         ), f"Checkpoint dir {self._local_checkpoint_dir} is not a directory, cannot load checkpoint."
 
         # Set the appropriate file names based on whether we have safetensors or not
-        if model_has_safetensors(self._local_checkpoint_dir):
+        self._is_safetensors = model_has_safetensors(self._local_checkpoint_dir)
+        if self._is_safetensors:
             from safetensors.torch import load_file
             model_param_json_fname = "model.safetensors.index.json"
             model_file_fname = "model.safetensors"
@@ -101,10 +169,86 @@ class HuggingFaceCheckpointEngine(CheckpointEngineBase):
 
         return all_checkpoint_files
 
+    def _plan_safetensors_reads(self) -> Optional[List[TensorRead]]:
+        """
+        Collect the byte range of every tensor across all shards, in file order. Returns None
+        if a shard holds a dtype the native loader cannot represent.
+        """
+        plan = []
+        for file_index, path in enumerate(self._all_ckpt_paths):
+            data_offset, header = read_safetensors_header(path)
+            for name, entry in sorted(header.items(), key=lambda item: item[1]["data_offsets"][0]):
+                src_dtype = SAFETENSORS_DTYPES.get(entry["dtype"])
+                if src_dtype is None:
+                    return None
+                dst_dtype = src_dtype
+                if self._load_dtype in CONVERTIBLE_DTYPES and src_dtype in CONVERTIBLE_DTYPES:
+                    dst_dtype = self._load_dtype
+                begin, end = entry["data_offsets"]
+                plan.append(
+                    TensorRead(name, file_index, data_offset + begin, end - begin, src_dtype, dst_dtype,
+                               tuple(entry["shape"])))
+        return plan
+
+    def _load_window(self, window: List[TensorRead]) -> Iterable[Tuple[str, torch.Tensor]]:
+        """
+        Read one batch of planned tensors into a single host buffer and yield views of it.
+        """
+        dst_offsets = []
+        total_size = 0
+        for read in window:
+            dst_offsets.append(total_size)
+            # Keep every tensor aligned for vectorized consumers
+            total_size += (read.dst_bytes + 63) // 64 * 64
+
+        def range_dtype(read: TensorRead, dtype: torch.dtype) -> int:
+            return CONVERTIBLE_DTYPES[dtype] if read.src_dtype != read.dst_dtype else RAW_RANGE
+
+        buffer = torch.empty(max(total_size, 1), dtype=torch.uint8)
+        RaggedUtilsBuilder().load().load_tensor_ranges(
+            self._all_ckpt_paths,
+            [read.file_index for read in window],
+            [read.file_offset for read in window],
+            [read.n_bytes for read in window],
+            [range_dtype(read, read.src_dtype) for read in window],
+            dst_offsets,
+            [range_dtype(read, read.dst_dtype) for read in window],
+            buffer,
+            self._io_threads,
+            16 * 2**20,
+        )
+
+        for read, offset in zip(window, dst_offsets):
+            yield read.name, buffer[offset:offset + read.dst_bytes].view(read.dst_dtype).view(read.shape)
+
+    def _safetensors_parameters(self, plan: List[TensorRead]) -> Iterable[Tuple[str, torch.Tensor]]:
+        """
+        Load the planned tensors in windows of at most ``io_window_bytes``.
+        """
+        window = []
+        window_bytes = 0
+        for read in plan:
+            if window and window_bytes + read.dst_bytes > self._io_window_bytes:
+                yield from self._load_window(window)
+                window = []
+                window_bytes = 0
+            window.append(read)
+            window_bytes += read.dst_bytes
+        if window:
+            yield from self._load_window(window)
+
     def parameters(self) -> Iterable[Tuple[str, torch.Tensor]]:
         """
         Generator of model parameters (satisfies the CheckpointEngineBase interface).
         """
+        if self._is_safetensors:
+            plan = self._plan_safetensors_reads()
+            if plan is not None:
+                inference_logger().info(f"Loading {len(self._all_ckpt_paths)} safetensors checkpoint files "
+                                        f"with {self._io_threads} threads")
+                yield from self._safetensors_parameters(plan)
+                return
+
         for checkpoint in self._all_ckpt_paths:
             inference_logger().info(f"Loading checkpoint: {checkpoint}")
             checkpoint_sd = self._checkpoint_load_fn(checkpoint)
@@ -3,6 +3,7 @@
 
 # DeepSpeed Team
 
+from enum import Enum
 from typing import Optional
 from deepspeed.pydantic_v1 import Field
 from deepspeed.runtime.config_utils import DeepSpeedConfigModel
@@ -26,6 +27,40 @@ class QuantizationConfig(DeepSpeedConfigModel):
     # TODO: may reuse the constants in deepspeed/compression/constants.py
 
 
+class WeightStreamingSource(Enum):
+    host = "host"
+    nvme = "nvme"
+
+
+class WeightStreamingConfig(DeepSpeedConfigModel):
+    """ Configure streaming of the transformer layer weights for models larger than memory """
+
+    enabled: bool = False
+    """
+    Keep only two transformer layers resident on the accelerator. The weights of the next layer are
+    loaded into the spare staging buffer while the current layer computes.
+    """
+
+    source: WeightStreamingSource = WeightStreamingSource.host
+    """
+    Where the streamed weights live. ``host`` keeps the flattened model in pinned host memory.
+    ``nvme`` reads one file per layer through the AIO handle and requires the engine to be
+    restored from a model snapshot, which is split into the layer files on first use.
+    """
+
+    nvme_path: Optional[str] = None
+    """ Directory of the layer files of the ``nvme`` source. """
+
+    aio_block_size: int = 1048576
+    """ Block size of the AIO reads of the ``nvme`` source. """
+
+    aio_queue_depth: int = 8
+    """ Queue depth of the AIO reads of the ``nvme`` source. """
+
+    aio_thread_count: int = 1
+    """ Number of AIO threads of the ``nvme`` source. """
+
+
 class RaggedInferenceEngineConfig(DeepSpeedConfigModel):
     """ Sets parameters for DeepSpeed Inference Engine. """
 
@@ -41,3 +76,15 @@ class RaggedInferenceEngineConfig(DeepSpeedConfigModel):
     """
 
     quantization: QuantizationConfig = {}
+
+    plan_activation_memory: bool = False
+    """
+    Trace one forward of ``max_ragged_batch_size`` tokens when the engine is created and pack the
+    module activation buffers into a single arena, reusing memory between buffers whose lifetimes
+    do not overlap.
+    """
+
+    weight_streaming: WeightStreamingConfig = {}
+    """
+    Configuration for serving models whose transformer weights do not fit in accelerator memory.
+    """
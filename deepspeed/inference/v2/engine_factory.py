@@ -24,7 +24,12 @@ from .model_implementations import (
     Qwen2Policy,
 )
 from .model_implementations.inference_policy_base import POLICIES, InferenceV2Policy
-from .model_implementations.flat_model_helpers import make_metadata_filename, ModelMetadata
+from .model_implementations.flat_model_helpers import (
+    make_metadata_filename,
+    make_snapshot_filename,
+    read_snapshot_metadata,
+    ModelMetadata,
+)
 
 
 def build_engine_from_ds_checkpoint(path: str,
@@ -47,9 +52,13 @@ def build_engine_from_ds_checkpoint(path: str,
     inference_logger(level=debug_level)
     # Load metadata, for grabbing the policy name we'll have all ranks just check for
     # rank 0.
-    metadata_filename = make_metadata_filename(path, 0, engine_config.tensor_parallel.tp_size)
-    metadata = json.load(open(metadata_filename, "r"))
-    metadata = ModelMetadata.parse_raw(metadata)
+    snapshot_filename = make_snapshot_filename(path, 0, engine_config.tensor_parallel.tp_size)
+    if os.path.isfile(snapshot_filename):
+        metadata, _ = read_snapshot_metadata(snapshot_filename)
+    else:
+        metadata_filename = make_metadata_filename(path, 0, engine_config.tensor_parallel.tp_size)
+        metadata = json.load(open(metadata_filename, "r"))
+        metadata = ModelMetadata.parse_raw(metadata)
 
     # Get the policy
     try:
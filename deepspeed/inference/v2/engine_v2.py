@@ -17,9 +17,16 @@ from deepspeed.comm.comm import init_distributed
 
 from .model_implementations import InferenceV2Policy
 from .logging import inference_logger
+from .memory_planner import ActivationMemoryPlanner
 from .ragged import DSStateManager, RaggedBatchWrapper, PlaceholderSequenceDescriptor
+from .ragged.host_staging import reset_host_staging_arena
 from .scheduling_utils import SchedulingError, SchedulingResult
-from .model_implementations.flat_model_helpers import make_param_filename, make_metadata_filename
+from .model_implementations.flat_model_helpers import (
+    make_param_filename,
+    make_metadata_filename,
+    make_snapshot_filename,
+    write_model_snapshot,
+)
 from .model_implementations.inference_model_base import DSInferenceModelBase
 
 from .config_v2 import RaggedInferenceEngineConfig
@@ -78,6 +85,9 @@ class InferenceEngineV2:
         self._policy = policy
         self._base_mp_group = self._initialize_tp_group()
 
+        # The model and the state manager allocate their host mirrors from the staging arena.
+        reset_host_staging_arena(self._config.state_manager.host_staging_huge_pages)
+
         # Build model from policy
         inference_logger().info("Building model...")
         self._model = self._policy.build_model(self._config, self._base_mp_group)
@@ -90,6 +100,9 @@ class InferenceEngineV2:
                                              base_mp_group=self._base_mp_group)
         self._model.set_state_manager(self._state_manager)
 
+        if self._config.plan_activation_memory:
+            self._plan_activation_memory()
+
     def _initialize_tp_group(self):
         """
         Implementation of our TP group initialization.
@@ -104,6 +117,29 @@ class InferenceEngineV2:
         ranks = list(range(self._config.tensor_parallel.tp_size))
         return dist.new_group(ranks=ranks)
 
+    def _plan_activation_memory(self) -> None:
+        """
+        Run a forward of the largest schedulable batch under the activation memory planner and
+        move the module buffers into the planned arena.
+        """
+        manager_config = self._config.state_manager
+        n_tokens = min(manager_config.max_ragged_batch_size, manager_config.max_context)
+
+        # Any uid unknown to the state manager works, since the sequence is flushed right after.
+        planning_uid = -1
+        n_tokens, _ = self.query(planning_uid, n_tokens, self.free_blocks.min().item())
+        tokens = torch.zeros((n_tokens, ), dtype=torch.long)
+
+        planner = ActivationMemoryPlanner(self._model)
+        with planner.record():
+            logits = self.put([planning_uid], [tokens], do_checks=False)
+            planner.mark_output(logits)
+        self.flush(planning_uid)
+
+        baseline_bytes, arena_bytes = planner.apply()
+        inference_logger().info(f"Planned activation memory: {arena_bytes / 2**20:.1f} MiB "
+                                f"(was {baseline_bytes / 2**20:.1f} MiB).")
+
     def put(self,
             batch_uids: Iterable[int],
             batch_tokens: Iterable[torch.Tensor],
@@ -118,6 +154,7 @@ class InferenceEngineV2:
             batch_tokens: Iterable of token tensors for the batch on the host
             do_checks: Check schedulability when it is set to True. You can skip this check for better performance when it has already been completed.
         """
+        self._state_manager.reclaim_flushed()
 
         if do_checks:
             token_lens = [len(tokens) for tokens in batch_tokens]
@@ -171,6 +208,8 @@ class InferenceEngineV2:
             Tuple[int, Optional[int]]: Tuple of free kv blocks and the number of blocks
                 required to schedule the sequence.
         """
+        self._state_manager.reclaim_flushed()
+
         seq_desc = self._state_manager.get_sequence(uid)
         if seq_desc is None:
             if (self._state_manager.n_tracked_sequences == self._config.state_manager.max_tracked_sequences):
@@ -195,6 +234,7 @@ class InferenceEngineV2:
         Returns:
             bool: True if the batch can be scheduled, False otherwise.
         """
+        self._state_manager.reclaim_flushed()
 
         cur_seqs = self._state_manager.n_tracked_sequences
         free_blocks = self._state_manager.free_blocks
@@ -248,6 +288,19 @@ class InferenceEngineV2:
         """
         self._state_manager.flush_sequence(uid)
 
+    def flush_batch(self, uids: Iterable[int]) -> None:
+        """
+        Remove all state associated with a set of sequences. The uids can be reused right away,
+        but their KV blocks are returned to the cache at the start of the next ``put``,
+        ``can_schedule`` or ``query``, in a single free per KV cache group. Prefer this over
+        ``flush`` when many sequences finish in the same step.
+
+        Arguments:
+            uids (Iterable[int]): The UIDs of the sequences to flush.
+        """
+        for uid in uids:
+            self._state_manager.enqueue_flush(uid)
+
     def serialize(self, save_path: str) -> None:
         """
         Serialize the model to a file.
@@ -266,3 +319,20 @@ class InferenceEngineV2:
 
         if self._model.tp_rank == 0:
             pickle.dump(self._model._config, open(os.path.join(save_path, "ds_model_config.pkl"), "wb"))
+
+    def snapshot(self, save_path: str) -> None:
+        """
+        Write a memory-mappable snapshot of the model. Compared to ``serialize``, restoring a
+        snapshot maps the flattened parameters instead of unpickling them and verifies them
+        against a checksum table. ``build_hf_engine`` and ``build_engine_from_ds_checkpoint``
+        prefer the snapshot when a directory has one.
+
+        Arguments:
+            save_path (str): Directory to write the snapshot to.
+        """
+        snapshot_file_name = make_snapshot_filename(save_path, self._model.tp_rank, self._model.tp_size)
+        write_model_snapshot(snapshot_file_name, self._model.flattened_params, self._model.flattened_param_metadata,
+                             self._model.kv_cache_config())
+
+        if self._model.tp_rank == 0:
+            pickle.dump(self._model._config, open(os.path.join(save_path, "ds_model_config.pkl"), "wb"))
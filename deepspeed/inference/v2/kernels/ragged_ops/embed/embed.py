@@ -8,7 +8,7 @@ from typing import Optional
 import torch
 
 from ... import DSKernelBase
-from deepspeed.ops.op_builder import RaggedOpsBuilder
+from deepspeed.accelerator import get_accelerator
 from ....inference_utils import elem_size
 from ....ragged import RaggedBatchWrapper
 
@@ -18,6 +18,9 @@ class RaggedEmbeddingKernel(DSKernelBase):
     Ragged-aware CUDA kernel implementation for an embedding lookup. This will only lookup
     the necessary tokens for a padded batch (i.e. if we are CGed and running with a slightly
     larger batch size than the actual tokens).
+
+    On the CPU accelerator the lookup is a multithreaded gather that prefetches the upcoming
+    embedding rows and fuses the positional embedding addition.
     """
 
     supported_dtypes = [torch.float16, torch.bfloat16, torch.float32]
@@ -43,7 +46,7 @@ class RaggedEmbeddingKernel(DSKernelBase):
         if elem_size(embed_dtype) * embed_dim % 16 != 0:
             raise ValueError("Embedding dimension must be aligned to 16 bytes, got {}".format(embed_dim))
 
-        inf_module = RaggedOpsBuilder().load()
+        inf_module = get_accelerator().create_op_builder("RaggedOpsBuilder").load()
         self.kernel = inf_module.ragged_embed
 
     def __call__(self,
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <omp.h>
+#include <algorithm>
+#include <string.h>
+#include "embed_cpu.h"
+#include "ragged_kernel_helpers.h"
+
+namespace embed {
+
+constexpr int cache_line = 64;
+
+// Rows gathered ahead of the current one. Embedding rows of large vocabularies are never in
+// cache, so the next rows are fetched while the current one is copied.
+constexpr int32_t prefetch_distance = 4;
+
+}  // namespace embed
+
+template <typename TokenType>
+static inline bool valid_token(TokenType token, int32_t vocab_size)
+{
+    return token >= 0 && token < vocab_size;
+}
+
+template <typename TokenType, typename EmbedType>
+static inline void prefetch_row(const TokenType* input_ids,
+                                const EmbedType* embedding_weight,
+                                int32_t token_idx,
+                                int32_t end_idx,
+                                int32_t embed_dim,
+                                int32_t vocab_size)
+{
+    if (token_idx >= end_idx) return;
+    const TokenType token_value = input_ids[token_idx];
+    if (!valid_token(token_value, vocab_size)) return;
+
+    const char* row =
+        reinterpret_cast<const char*>(embedding_weight + (int64_t)token_value * embed_dim);
+    const int64_t row_bytes = (int64_t)embed_dim * sizeof(EmbedType);
+    for (int64_t offset = 0; offset < row_bytes; offset += embed::cache_line) {
+        __builtin_prefetch(row + offset, 0, 0);
+    }
+}
+
+template <typename TokenType, typename EmbedType>
+static void launch_ragged_embed_cpu(EmbedType* embedded_tokens,
+                                    const TokenType* input_ids,
+                                    const EmbedType* embedding_weight,
+                                    const EmbedType* position_weight,
+                                    const BatchWrapperCPP& batch_desc,
+                                    const int32_t n_tokens,
+                                    const int32_t embed_dim,
+                                    const int32_t vocab_size,
+                                    const int32_t max_position_embed_idx,
+                                    const int32_t position_embed_offset)
+{
+#pragma omp parallel
+    {
+        // Contiguous token ranges per thread so the prefetches run ahead of this thread's rows.
+        const int32_t n_threads = omp_get_num_threads();
+        const int32_t tid = omp_get_thread_num();
+        const int32_t per_thread = (n_tokens + n_threads - 1) / n_threads;
+        const int32_t begin = std::min(n_tokens, tid * per_thread);
+        const int32_t end = std::min(n_tokens, begin + per_thread);
+
+        for (int32_t i = begin; i < std::min(end, begin + embed::prefetch_distance); i++) {
+            prefetch_row(input_ids, embedding_weight, i, end, embed_dim, vocab_size);
+        }
+
+        for (int32_t token_idx = begin; token_idx < end; token_idx++) {
+            prefetch_row(input_ids,
+                         embedding_weight,
+                         token_idx + embed::prefetch_distance,
+                         end,
+                         embed_dim,
+                         vocab_size);
+
+            const TokenType token_value = input_ids[token_idx];
+            // Invalid tokens are skipped, as in the CUDA kernel.
+            if (!valid_token(token_value, vocab_size)) continue;
+
+            const EmbedType* embedding_row = embedding_weight + (int64_t)token_value * embed_dim;
+            EmbedType* dest_row = embedded_tokens + (int64_t)token_idx * embed_dim;
+
+            if (position_weight == nullptr) {
+                memcpy(dest_row, embedding_row, (size_t)embed_dim * sizeof(EmbedType));
+                continue;
+            }
+
+            const int32_t seq_idx = batch_desc.tokens_to_seq[token_idx];
+            const InflightSeqDescriptor seq_desc = batch_desc.seq_metadata[seq_idx];
+            int32_t pos_emb_idx = seq_desc.seen_tokens + (token_idx - seq_desc.start_idx);
+
+            // Position offset is specific to OPT, clamp to the table as the CUDA kernel does.
+            pos_emb_idx = pos_emb_idx + position_embed_offset;
+            pos_emb_idx = (pos_emb_idx < 0) ? 0 : pos_emb_idx;
+            pos_emb_idx = (pos_emb_idx >= max_position_embed_idx) ? max_position_embed_idx
+                                                                  : pos_emb_idx;
+
+            const EmbedType* position_row = position_weight + (int64_t)pos_emb_idx * embed_dim;
+            for (int32_t c = 0; c < embed_dim; c++) {
+                dest_row[c] = static_cast<EmbedType>(static_cast<float>(embedding_row[c]) +
+                                                     static_cast<float>(position_row[c]));
+            }
+        }
+    }
+}
+
+#define DISPATCH_FOR_INT(DTYPE, ...)                         \
+    [&] {                                                    \
+        if (DTYPE == torch::kInt32) {                        \
+            using int_t = int32_t;                           \
+            return __VA_ARGS__();                            \
+        } else if (DTYPE == torch::kInt64) {                 \
+            using int_t = int64_t;                           \
+            return __VA_ARGS__();                            \
+        } else {                                             \
+            TORCH_CHECK(false, "Unsupported dispatch type"); \
+        }                                                    \
+    }()
+
+/*
+Embeddings kernel aware of ragged batch structure.
+*/
+void ragged_embed(torch::Tensor& embedded_tokens,
+                  torch::Tensor& input_ids,
+                  torch::Tensor& embedding_weight,
+                  c10::optional<torch::Tensor>& position_embedding_weight,
+                  int32_t pos_embed_offset,
+                  torch::Tensor& batch_metadata,
+                  torch::Tensor& seq_metadata,
+                  torch::Tensor& tokens_to_seq,
+                  torch::Tensor& kv_ptrs)
+{
+    TORCH_CHECK(embedded_tokens.is_contiguous() && embedding_weight.is_contiguous(),
+                "embedded_tokens and embedding_weight must be contiguous");
+    TORCH_CHECK(embedded_tokens.scalar_type() == embedding_weight.scalar_type(),
+                "embedded_tokens and embedding_weight must have the same dtype");
+
+    // We don't care about KV cache here, so just hardcoding 0s for block_size/num_blocks
+    BatchWrapperCPP batch_wrapper =
+        make_cpp_batch_wrapper(batch_metadata, seq_metadata, tokens_to_seq, kv_ptrs, 0, 0);
+
+    // The batch may be padded, only the tokens of the batch descriptor are gathered.
+    const int32_t n_tokens =
+        std::min<int32_t>(input_ids.numel(), batch_wrapper.batch_metadata->n_tokens);
+    const int32_t embed_dim = embedding_weight.size(1);
+    const int32_t vocab_size = embedding_weight.size(0);
+
+    DISPATCH_FOR_INT(input_ids.scalar_type(), [&] {
+        AT_DISPATCH_FLOATING_TYPES_AND2(
+            at::ScalarType::Half,
+            at::ScalarType::BFloat16,
+            embedding_weight.scalar_type(),
+            "ragged_embed_cpu",
+            [&] {
+                const scalar_t* pos_embed_ptr = nullptr;
+                int32_t max_position_embed_idx = 0;
+                if (position_embedding_weight.has_value()) {
+                    const torch::Tensor& position_weight = position_embedding_weight.value();
+                    TORCH_CHECK(position_weight.scalar_type() == embedding_weight.scalar_type(),
+                                "position_embedding_weight and embedding_weight must have the "
+                                "same dtype");
+                    TORCH_CHECK(position_weight.is_contiguous(),
+                                "position_embedding_weight must be contiguous");
+                    pos_embed_ptr = position_weight.data_ptr<scalar_t>();
+                    max_position_embed_idx = position_weight.size(0) - 1;
+                }
+
+                launch_ragged_embed_cpu(embedded_tokens.data_ptr<scalar_t>(),
+                                        input_ids.data_ptr<int_t>(),
+                                        embedding_weight.data_ptr<scalar_t>(),
+                                        pos_embed_ptr,
+                                        batch_wrapper,
+                                        n_tokens,
+                                        embed_dim,
+                                        vocab_size,
+                                        max_position_embed_idx,
+                                        pos_embed_offset);
+            });
+    });
+}
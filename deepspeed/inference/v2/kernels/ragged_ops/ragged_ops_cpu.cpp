@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include <torch/extension.h>
+
+#include "embed_cpu.h"
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
+{
+    // embed_cpu.h
+    m.def("ragged_embed", &ragged_embed, "Embedding lookup for ragged batch (CPU)");
+}
@@ -0,0 +1,174 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from contextlib import contextmanager
+from typing import Any, Dict, List, Optional, Tuple
+
+import torch
+
+from deepspeed.ops.op_builder import RaggedUtilsBuilder
+
+from .allocator import Allocator
+from .modules.ds_module import DSModuleBase
+
+
+class ActivationMemoryPlanner:
+    """
+    Static planner for the activation buffers of a ragged model.
+
+    Every module reserves its own output buffer for ``max_tokens`` rows, so without planning the
+    peak activation memory is the sum of all module outputs. The planner records one forward,
+    numbering each top-level module call as a step. A buffer becomes live when ``empty_from`` is
+    called on it inside a module and stays live until the last module call that receives a view
+    of it as an argument or returns one. The buffers are then packed into one arena per device,
+    sharing bytes between buffers whose lifetimes never overlap, and each buffer is rebound in
+    place to its offset in the arena. ``empty_from`` is unchanged, so a lookup after planning is
+    still a cached view, now of the arena.
+
+    This assumes activations only pass between modules as arguments and return values. Buffers
+    that are allocated outside of a module call, or that share storage with another buffer, are
+    left where they are.
+    """
+
+    def __init__(self, model: torch.nn.Module, alignment: int = 256) -> None:
+        """
+        Arguments:
+            model (torch.nn.Module): The model whose ``DSModuleBase`` children will be traced.
+            alignment (int): Alignment in bytes of each buffer within the arena.
+        """
+        self._model = model
+        self._alignment = alignment
+
+        self._buffers: List[torch.Tensor] = []
+        self._buffer_ids: Dict[int, int] = {}
+        self._excluded = set()
+
+        # Closed live ranges as (buffer, first step, last step) and the open range of each buffer.
+        self._intervals: List[Tuple[int, int, int]] = []
+        self._open: Dict[int, List[int]] = {}
+
+        self._step = 0
+        self._depth = 0
+
+    @contextmanager
+    def record(self):
+        """
+        Trace the allocations and module calls made while the context is active.
+        """
+        handles = []
+        for module in self._model.modules():
+            if isinstance(module, DSModuleBase):
+                handles.append(module.register_forward_pre_hook(self._pre_forward))
+                handles.append(module.register_forward_hook(self._post_forward))
+
+        Allocator.recorder = self
+        try:
+            yield self
+        finally:
+            Allocator.recorder = None
+            for handle in handles:
+                handle.remove()
+
+    def mark_output(self, output: Any) -> None:
+        """
+        Keep the buffers backing ``output`` live until the end of the recorded forward.
+        """
+        self._mark_use(output, self._step + 1)
+
+    def on_allocation(self, tensor: torch.Tensor) -> None:
+        """
+        Called by ``Allocator.empty_from`` while recording.
+        """
+        idx = self._register(tensor)
+        if idx is None:
+            return
+
+        if self._depth == 0:
+            self._excluded.add(idx)
+            return
+
+        # Allocating over a buffer ends the lifetime of its previous contents.
+        if idx in self._open:
+            start, end = self._open.pop(idx)
+            self._intervals.append((idx, start, end))
+        self._open[idx] = [self._step, self._step]
+
+    def _register(self, tensor: torch.Tensor) -> Optional[int]:
+        key = tensor.untyped_storage().data_ptr()
+        idx = self._buffer_ids.get(key)
+        if idx is None:
+            idx = len(self._buffers)
+            self._buffer_ids[key] = idx
+            self._buffers.append(tensor)
+            if not tensor.is_contiguous() or tensor.storage_offset() != 0:
+                self._excluded.add(idx)
+        elif self._buffers[idx] is not tensor:
+            self._excluded.add(idx)
+        return idx
+
+    def _pre_forward(self, module: torch.nn.Module, args: Tuple) -> None:
+        if self._depth == 0:
+            self._step += 1
+        self._depth += 1
+        self._mark_use(args, self._step)
+
+    def _post_forward(self, module: torch.nn.Module, args: Tuple, output: Any) -> None:
+        self._mark_use(output, self._step)
+        self._depth -= 1
+
+    def _mark_use(self, obj: Any, step: int) -> None:
+        if isinstance(obj, torch.Tensor):
+            idx = self._buffer_ids.get(obj.untyped_storage().data_ptr())
+            if idx is not None and idx in self._open:
+                self._open[idx][1] = max(self._open[idx][1], step)
+        elif isinstance(obj, (list, tuple)):
+            for item in obj:
+                self._mark_use(item, step)
+        elif isinstance(obj, dict):
+            for item in obj.values():
+                self._mark_use(item, step)
+
+    def apply(self) -> Tuple[int, int]:
+        """
+        Pack the recorded buffers and rebind them into the arenas. Must be called after
+        ``record`` has exited.
+
+        Returns:
+            Tuple[int, int]: The bytes held by the planned buffers before and after planning.
+        """
+        for idx, (start, end) in self._open.items():
+            self._intervals.append((idx, start, end))
+        self._open = {}
+
+        groups: Dict[torch.device, List[int]] = {}
+        for idx, buffer in enumerate(self._buffers):
+            if idx not in self._excluded:
+                groups.setdefault(buffer.device, []).append(idx)
+
+        utils = RaggedUtilsBuilder().load()
+        baseline_bytes = 0
+        arena_bytes = 0
+
+        for device, indices in groups.items():
+            local_ids = {idx: i for i, idx in enumerate(indices)}
+            sizes = [self._buffers[idx].numel() * self._buffers[idx].element_size() for idx in indices]
+            intervals = [(local_ids[idx], start, end) for idx, start, end in self._intervals if idx in local_ids]
+            owners, starts, ends = (list(col) for col in zip(*intervals))
+
+            offsets, arena_size = utils.plan_activation_arena(sizes, owners, starts, ends, self._alignment)
+
+            arena = torch.empty(arena_size, dtype=torch.uint8, device=device)
+            storage = arena.untyped_storage()
+            with torch.no_grad():
+                for idx, offset in zip(indices, offsets):
+                    buffer = self._buffers[idx]
+                    buffer.set_(storage, offset // buffer.element_size(), buffer.shape, buffer.stride())
+
+            baseline_bytes += sum(sizes)
+            arena_bytes += arena_size
+
+        # Cached views still point at the old storage.
+        Allocator.cache.clear()
+        return baseline_bytes, arena_bytes
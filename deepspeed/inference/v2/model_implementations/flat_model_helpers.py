@@ -3,7 +3,12 @@
 
 # DeepSpeed Team
 
-from typing import Dict, Iterable, Tuple, Optional
+import json
+import os
+import struct
+import zlib
+from concurrent.futures import ThreadPoolExecutor
+from typing import Any, Dict, Iterable, List, Tuple, Optional
 from os import path
 
 import torch
@@ -84,6 +89,20 @@ def make_metadata_filename(base: str, rank: int, n_ranks: int) -> str:
     return path.join(base, f"metadata_rank_{rank}_of_{n_ranks}.json")
 
 
+def make_snapshot_filename(base: str, rank: int, n_ranks: int) -> str:
+    """
+    Make a filename for a model snapshot file.
+
+    Arguments:
+        rank: Rank of the file.
+        n_ranks: Total number of ranks.
+
+    Returns:
+        str: Filename.
+    """
+    return path.join(base, f"snapshot_rank_{rank}_of_{n_ranks}.dss")
+
+
 def make_model_config_filename(base: str) -> str:
     """
     Make a filename for a model config file.
@@ -101,6 +120,7 @@ def flatten_inference_model(
     transformer_containers: Iterable[LayerContainer],
     non_transformer_container: LayerContainer,
     policy_name: str,
+    host_buffer: bool = False,
 ) -> Tuple[torch.Tensor, ModelMetadata]:
     """
     Flatten the underlying parameters into
@@ -110,6 +130,7 @@ def flatten_inference_model(
             parameters.
         non_transformer_container: Layer container corresponding to the non-transformer parameters.
         policy_name: The name of the policy class (typically accessed with `type(policy).__name__`).
+        host_buffer: Flatten into pinned host memory instead of accelerator memory.
 
     Returns:
         Iterable[Any]: Flattened list of parameters.
@@ -178,7 +199,10 @@ def flatten_inference_model(
     l_name = "non_transformer"
     total_size = process_layer(non_transformer_container, l_name, total_size)
 
-    buffer = torch.empty(total_size, dtype=torch.uint8, device=get_accelerator().current_device())
+    if host_buffer:
+        buffer = torch.empty(total_size, dtype=torch.uint8, pin_memory=not get_accelerator().is_synchronized_device())
+    else:
+        buffer = torch.empty(total_size, dtype=torch.uint8, device=get_accelerator().current_device())
 
     def copy_layer(layer_container: LayerContainer, l_name: str) -> None:
         """
@@ -222,6 +246,71 @@ def flatten_inference_model(
     return buffer, metadata
 
 
+def make_layer_views(layer_metadata: LayerMetadata,
+                     buffer: torch.Tensor,
+                     base_offset: int = 0) -> Dict[str, Optional[InferenceParameter]]:
+    """
+    Construct views for the parameters of a single layer onto a flattened buffer. No data
+    movement is performed.
+
+    Arguments:
+        layer_metadata: The metadata describing each parameter of the layer.
+        buffer: The flattened buffer to reconstruct views on top of.
+        base_offset: Offset into the flattened model of the first byte of ``buffer``. Used to
+            build views onto a buffer that only holds that layer.
+
+    Returns:
+        Dict[str, Optional[InferenceParameter]]: The parameters of the layer by name, None for
+            parameters the layer does not have.
+    """
+    alloc_fn = RaggedUtilsBuilder().load().allocate_view_like
+
+    views = {}
+    for p_name, p_metadata in layer_metadata.params.items():
+        if p_metadata.core_param.offset == -1:
+            views[p_name] = None
+            continue
+
+        dummy_tensor = torch.empty([], dtype=STR_TO_DTYPE[p_metadata.core_param.dtype])
+        core_param = alloc_fn(p_metadata.core_param.shape, p_metadata.core_param.strides, dummy_tensor, buffer,
+                              p_metadata.core_param.offset - base_offset)
+
+        aux_params = {}
+
+        for t_name, t_metadata in p_metadata.aux_params.items():
+            dummy_tensor = torch.empty([], dtype=STR_TO_DTYPE[t_metadata.dtype])
+            t_view = alloc_fn(t_metadata.shape, t_metadata.strides, dummy_tensor, buffer,
+                              t_metadata.offset - base_offset)
+
+            aux_params[t_name] = t_view
+
+        views[p_name] = InferenceParameter.initialize(core_param, **aux_params)
+    return views
+
+
+def bind_layer_views(layer_container: LayerContainer, views: Dict[str, Optional[InferenceParameter]]) -> None:
+    """
+    Point the parameters of a layer container at ``views``. A container that is already
+    populated (for example flattened on the host) is rebound without being populated again.
+    """
+    populated = layer_container.is_populated
+    for p_name in layer_container.annotation_attrs:
+        if populated:
+            setattr(layer_container, p_name, views[p_name])
+        else:
+            layer_container.direct_injection(p_name, views[p_name])
+
+
+def restore_layer_container(layer_container: LayerContainer,
+                            layer_metadata: LayerMetadata,
+                            buffer: torch.Tensor,
+                            base_offset: int = 0) -> None:
+    """
+    Restore a single layer container from a flattened buffer. See ``make_layer_views``.
+    """
+    bind_layer_views(layer_container, make_layer_views(layer_metadata, buffer, base_offset))
+
+
 def restore_inference_model(buffer: torch.Tensor, metadata: ModelMetadata,
                             transformer_containers: Iterable[LayerContainer],
                             non_transformer_container: LayerContainer) -> None:
@@ -234,49 +323,174 @@ def restore_inference_model(buffer: torch.Tensor, metadata: ModelMetadata,
         transformer_containers: Iterable of transformer layer containers.
         non_transformer_container: Non-transformer layer container.
     """
-    alloc_fn = RaggedUtilsBuilder().load().allocate_view_like
+    for i, layer in enumerate(transformer_containers):
+        l_name = f"transformer_layer_{i}"
+        restore_layer_container(layer, metadata.layers[l_name], buffer)
 
-    def restore_layer(layer_container: LayerContainer, l_name: str) -> None:
-        """
-        Local method for restoring a layer container from a flattened buffer. This
-        only constructs views for the parameters onto the buffer. No data movement
-        is performed.
+    l_name = "non_transformer"
+    restore_layer_container(non_transformer_container, metadata.layers[l_name], buffer)
 
-        Arguments:
-            layer_container: The layer container to restore.
-            l_name: The name of the layer container to key the metadata.
 
-        Captured Variables:
-            buffer: The flattened buffer to reconstruct views on top of.
-            metadata: The metadata object describing the each parameter in the model.
-        """
-        l_metadata = metadata.layers[l_name]
+def layer_byte_range(layer_metadata: LayerMetadata) -> Tuple[int, int]:
+    """
+    The [start, end) byte range of a layer in the flattened buffer. The tensors of a layer are
+    flattened contiguously, so the range holds that layer only.
+    """
+    start, end = None, 0
+    for p_metadata in layer_metadata.params.values():
+        if p_metadata.core_param.offset == -1:
+            continue
+        for t_metadata in [p_metadata.core_param, *p_metadata.aux_params.values()]:
+            numel = 1
+            for dim in t_metadata.shape:
+                numel *= dim
+            t_size = pad_to_aligned_offset(elem_size(STR_TO_DTYPE[t_metadata.dtype]) * numel)
+            start = t_metadata.offset if start is None else min(start, t_metadata.offset)
+            end = max(end, t_metadata.offset + t_size)
+    return (0, 0) if start is None else (start, end)
+
+
+"""
+Snapshot file layout. Every offset is in bytes from the start of the file.
+
+    [0, 4096)                      header (SNAPSHOT_HEADER, zero padded)
+    [meta_offset, +meta_size)      JSON with the ModelMetadata and the KV-cache configurations
+    [table_offset, +4 * n_chunks)  little endian crc32 of every SNAPSHOT_CHUNK_SIZE chunk of data
+    [data_offset, +data_size)      the flattened parameter buffer, page aligned
+
+The data is page aligned so that it can be memory mapped and used (or copied to the
+accelerator) without first reading it into an intermediate host buffer.
+"""
+SNAPSHOT_MAGIC = b"DSSNAP01"
+SNAPSHOT_ALIGNMENT = 4096
+SNAPSHOT_CHUNK_SIZE = 64 * 2**20
+
+# magic, meta crc32, table crc32, meta offset, meta size, table offset, n chunks, chunk size,
+# data offset, data size
+SNAPSHOT_HEADER = struct.Struct("<8sIIQQQQQQQ")
+
+
+def kv_cache_config_to_dict(config: Any) -> Dict[str, Any]:
+    """
+    JSON-friendly form of a ``KVCacheConfig``, used to check a snapshot against the model that
+    restores it.
+    """
+    return {
+        "type": config.type.value,
+        "block_size": config.block_size,
+        "num_allocation_groups": config.num_allocation_groups,
+        "cache_shape": list(config.cache_shape),
+        "cache_dtype": config.cache_dtype.name,
+        "max_blocks_per_allocation_group": config.max_blocks_per_allocation_group,
+    }
 
-        for p_name in layer_container.annotation_attrs:
-            p_metadata = l_metadata.params[p_name]
 
-            if p_metadata.core_param.offset == -1:
-                layer_container.direct_injection(p_name, None)
-                continue
+def _chunk_checksums(data: memoryview, chunk_size: int) -> List[int]:
+    # zlib releases the GIL on large buffers, so the chunks are hashed in parallel.
+    chunks = [data[i:i + chunk_size] for i in range(0, len(data), chunk_size)]
+    with ThreadPoolExecutor(max_workers=min(8, os.cpu_count() or 1)) as pool:
+        return list(pool.map(zlib.crc32, chunks))
 
-            dummy_tensor = torch.empty([], dtype=STR_TO_DTYPE[p_metadata.core_param.dtype])
-            core_param = alloc_fn(p_metadata.core_param.shape, p_metadata.core_param.strides, dummy_tensor, buffer,
-                                  p_metadata.core_param.offset)
 
-            aux_params = {}
+def write_model_snapshot(filename: str, buffer: torch.Tensor, metadata: ModelMetadata,
+                         kv_cache_configs: Iterable[Any]) -> None:
+    """
+    Write the flattened parameters, their layout and the KV-cache configuration to a single
+    memory-mappable snapshot file. The file is written under a temporary name and renamed, so a
+    reader never observes a partial snapshot.
 
-            for t_name, t_metadata in p_metadata.aux_params.items():
-                dummy_tensor = torch.empty([], dtype=STR_TO_DTYPE[t_metadata.dtype])
-                t_view = alloc_fn(t_metadata.shape, t_metadata.strides, dummy_tensor, buffer, t_metadata.offset)
+    Arguments:
+        filename: Snapshot file to write.
+        buffer: The flattened parameter buffer (uint8) produced by ``flatten_inference_model``.
+        metadata: The layout of ``buffer``.
+        kv_cache_configs: The ``KVCacheConfig`` objects of the model.
+    """
+    data = memoryview(buffer.contiguous().cpu().numpy()).cast("B")
+    checksums = _chunk_checksums(data, SNAPSHOT_CHUNK_SIZE)
 
-                aux_params[t_name] = t_view
+    meta = json.dumps({
+        "model_metadata": metadata.json(),
+        "kv_cache_configs": [kv_cache_config_to_dict(config) for config in kv_cache_configs],
+    }).encode("utf-8")
+    table = struct.pack(f"<{len(checksums)}I", *checksums)
 
-            restored_param = InferenceParameter.initialize(core_param, **aux_params)
-            layer_container.direct_injection(p_name, restored_param)
+    meta_offset = SNAPSHOT_ALIGNMENT
+    table_offset = meta_offset + len(meta)
+    data_offset = pad_to_aligned_offset(table_offset + len(table), SNAPSHOT_ALIGNMENT)
 
-    for i, layer in enumerate(transformer_containers):
-        l_name = f"transformer_layer_{i}"
-        restore_layer(layer, l_name)
+    header = SNAPSHOT_HEADER.pack(SNAPSHOT_MAGIC, zlib.crc32(meta), zlib.crc32(table), meta_offset, len(meta),
+                                  table_offset, len(checksums), SNAPSHOT_CHUNK_SIZE, data_offset, len(data))
 
-    l_name = "non_transformer"
-    restore_layer(non_transformer_container, l_name)
+    tmp_filename = filename + ".tmp"
+    with open(tmp_filename, "wb") as f:
+        f.write(header.ljust(SNAPSHOT_ALIGNMENT, b"\0"))
+        f.write(meta)
+        f.write(table)
+        f.write(b"\0" * (data_offset - table_offset - len(table)))
+        f.write(data)
+    os.replace(tmp_filename, filename)
+
+
+def read_snapshot_metadata(filename: str) -> Tuple[ModelMetadata, List[Dict[str, Any]]]:
+    """
+    Read the parameter layout and KV-cache configurations of a snapshot without mapping its data.
+    """
+    with open(filename, "rb") as f:
+        header = SNAPSHOT_HEADER.unpack(f.read(SNAPSHOT_HEADER.size))
+        magic, meta_crc, _, meta_offset, meta_size = header[:5]
+        if magic != SNAPSHOT_MAGIC:
+            raise ValueError(f"{filename} is not a DeepSpeed model snapshot")
+        f.seek(meta_offset)
+        meta = f.read(meta_size)
+    if zlib.crc32(meta) != meta_crc:
+        raise ValueError(f"Snapshot {filename} has a corrupted metadata section")
+
+    meta = json.loads(meta)
+    return ModelMetadata.parse_raw(meta["model_metadata"]), meta["kv_cache_configs"]
+
+
+def load_model_snapshot(filename: str,
+                        verify_checksums: bool = True,
+                        to_device: bool = True) -> Tuple[torch.Tensor, ModelMetadata, List[Dict[str, Any]]]:
+    """
+    Map a snapshot written by ``write_model_snapshot``. On a host accelerator the returned buffer
+    is a view of the mapping, otherwise the mapped pages are copied once to the accelerator.
+
+    Arguments:
+        filename: Snapshot file to load.
+        verify_checksums: Check every data chunk against the checksum table.
+        to_device: Copy the data to the accelerator. If False the mapping is always returned.
+
+    Returns:
+        Tuple of the flattened parameter buffer, its layout and the KV-cache configurations the
+        snapshot was taken with.
+    """
+    metadata, kv_cache_configs = read_snapshot_metadata(filename)
+
+    with open(filename, "rb") as f:
+        header = SNAPSHOT_HEADER.unpack(f.read(SNAPSHOT_HEADER.size))
+        _, _, table_crc, _, _, table_offset, n_chunks, chunk_size, data_offset, data_size = header
+        f.seek(table_offset)
+        table = f.read(4 * n_chunks)
+    if zlib.crc32(table) != table_crc:
+        raise ValueError(f"Snapshot {filename} has a corrupted checksum table")
+
+    file_size = path.getsize(filename)
+    if data_offset + data_size > file_size:
+        raise ValueError(f"Snapshot {filename} is truncated")
+
+    mapped = torch.from_file(filename, shared=False, size=file_size, dtype=torch.uint8)
+    data = mapped[data_offset:data_offset + data_size]
+
+    if verify_checksums:
+        checksums = _chunk_checksums(memoryview(data.numpy()), chunk_size)
+        expected = struct.unpack(f"<{n_chunks}I", table)
+        for i, (checksum, reference) in enumerate(zip(checksums, expected)):
+            if checksum != reference:
+                raise ValueError(f"Snapshot {filename} failed the checksum of chunk {i}")
+
+    device = torch.device(get_accelerator().current_device_name())
+    if to_device and device.type != "cpu":
+        data = data.to(device)
+
+    return data, metadata, kv_cache_configs
@@ -4,23 +4,33 @@
 # DeepSpeed Team
 
 import json
+import os
 from abc import ABC, ABCMeta, abstractmethod
+from contextlib import nullcontext
 from typing import Any, Iterable, List, Optional, Union
 
 import torch
 
-from ..config_v2 import RaggedInferenceEngineConfig
+from deepspeed.accelerator import get_accelerator
+from ..allocator import finalize_on_host
+from ..config_v2 import RaggedInferenceEngineConfig, WeightStreamingSource
 from ..checkpoint import CheckpointEngineBase
 from ..logging import inference_logger
 from .layer_container_base import LayerContainer
 from .inference_model_base import DSInferenceModelBase
 from .flat_model_helpers import (
     flatten_inference_model,
+    kv_cache_config_to_dict,
+    layer_byte_range,
+    load_model_snapshot,
     make_param_filename,
     make_metadata_filename,
+    make_snapshot_filename,
     ModelMetadata,
     restore_inference_model,
+    restore_layer_container,
 )
+from .weight_streaming import HostLayerSource, NVMeLayerSource, StreamedLayers, write_layer_files
 
 POLICIES = {}
 
@@ -193,28 +203,94 @@ class InferenceV2Policy(ABC, metaclass=PolicyMeta):
         """
 
         container_map = self.build_container_map()
+        streaming = self.model.engine_config.weight_streaming
 
         if self._checkpoint_engine is not None:
-            for name, parameter in self._checkpoint_engine.parameters():
-                container_map.map_param(name, parameter)
+            if streaming.enabled and streaming.source == WeightStreamingSource.nvme:
+                raise ValueError("NVMe weight streaming restores the model from a snapshot, build the engine with host "
+                                 "streaming and save one with InferenceEngineV2.snapshot first.")
+
+            # Streamed models may not fit on the accelerator, keep their parameters on the host
+            # until they are flattened.
+            with finalize_on_host() if streaming.enabled else nullcontext():
+                for name, parameter in self._checkpoint_engine.parameters():
+                    container_map.map_param(name, parameter)
 
             buffer, metadata = flatten_inference_model(container_map.transformer_params,
-                                                       container_map.non_transformer_params, self.__class__.__name__)
+                                                       container_map.non_transformer_params,
+                                                       self.__class__.__name__,
+                                                       host_buffer=streaming.enabled)
         else:
-
-            buffer_path = make_param_filename(self._inf_checkpoint_path, self.model.tp_rank, self.model.tp_size)
-            metadata_path = make_metadata_filename(self._inf_checkpoint_path, self.model.tp_rank, self.model.tp_size)
-
-            buffer = torch.load(buffer_path)
-            metadata = json.load(open(metadata_path, "r"))
-            metadata = ModelMetadata.parse_raw(metadata)
-
-            restore_inference_model(buffer, metadata, container_map.transformer_params,
-                                    container_map.non_transformer_params)
+            snapshot_path = make_snapshot_filename(self._inf_checkpoint_path, self.model.tp_rank, self.model.tp_size)
+
+            if os.path.isfile(snapshot_path):
+                buffer, metadata, kv_cache_configs = load_model_snapshot(snapshot_path,
+                                                                         to_device=not streaming.enabled)
+                current_configs = [kv_cache_config_to_dict(config) for config in self.model.kv_cache_config()]
+                if kv_cache_configs != current_configs:
+                    inference_logger().warning(
+                        f"KV-cache configuration {current_configs} differs from the one the snapshot was taken "
+                        f"with ({kv_cache_configs}), check that the engine config matches the snapshot.")
+            else:
+                if streaming.enabled and streaming.source == WeightStreamingSource.nvme:
+                    raise ValueError(f"NVMe weight streaming requires a model snapshot, {snapshot_path} not found.")
+
+                buffer_path = make_param_filename(self._inf_checkpoint_path, self.model.tp_rank, self.model.tp_size)
+                metadata_path = make_metadata_filename(self._inf_checkpoint_path, self.model.tp_rank,
+                                                       self.model.tp_size)
+
+                map_location = "cpu" if streaming.enabled else get_accelerator().current_device_name()
+                buffer = torch.load(buffer_path, map_location=map_location)
+                metadata = json.load(open(metadata_path, "r"))
+                metadata = ModelMetadata.parse_raw(metadata)
+
+            if not streaming.enabled:
+                restore_inference_model(buffer, metadata, container_map.transformer_params,
+                                        container_map.non_transformer_params)
+
+        transformer_params = container_map.transformer_params
+        if streaming.enabled:
+            transformer_params = self._stream_transformer_params(container_map, buffer, metadata)
 
         container_map.validate()
 
-        self.model.set_parameters(transformer=container_map.transformer_params,
+        self.model.set_parameters(transformer=transformer_params,
                                   non_transformer=container_map.non_transformer_params,
                                   flattened_param_buffer=buffer,
                                   flattened_param_metadata=metadata)
+
+    def _stream_transformer_params(self, container_map: ContainerMap, buffer: torch.Tensor,
+                                   metadata: ModelMetadata) -> StreamedLayers:
+        """
+        Set up weight streaming over a flattened model in host memory (pinned, or a memory
+        mapped snapshot). The non-transformer parameters are used by every forward and are copied
+        to the accelerator once; the transformer layers are streamed.
+        """
+        streaming = self.model.engine_config.weight_streaming
+
+        start, end = layer_byte_range(metadata.layers["non_transformer"])
+        non_transformer_buffer = buffer[start:end].to(get_accelerator().current_device())
+        restore_layer_container(container_map.non_transformer_params,
+                                metadata.layers["non_transformer"],
+                                non_transformer_buffer,
+                                base_offset=start)
+        # The container views do not keep the buffer alive.
+        self._non_transformer_buffer = non_transformer_buffer
+
+        containers = list(container_map.transformer_params)
+        ranges = [layer_byte_range(metadata.layers[f"transformer_layer_{i}"]) for i in range(len(containers))]
+
+        if streaming.source == WeightStreamingSource.nvme:
+            nvme_path = streaming.nvme_path
+            if nvme_path is None:
+                nvme_path = os.path.join(self._inf_checkpoint_path, "streaming")
+            filenames = write_layer_files(nvme_path, buffer, ranges, self.model.tp_rank, self.model.tp_size)
+
+            def source_factory(slot_bytes: int, n_slots: int) -> NVMeLayerSource:
+                return NVMeLayerSource(filenames, slot_bytes, n_slots, streaming)
+        else:
+
+            def source_factory(slot_bytes: int, n_slots: int) -> HostLayerSource:
+                return HostLayerSource(buffer, ranges, n_slots)
+
+        return StreamedLayers(containers, metadata, ranges, source_factory)
@@ -8,7 +8,7 @@ from typing import Optional
 import torch
 
 from .types import ShardingType
-from .utils import shard_param, get_shard_endpoints
+from .utils import shard_param, get_shard_endpoints, get_shard_segments, gather_shard_segments
 
 
 def shard_attn_out_param(param: torch.Tensor,
@@ -55,13 +55,12 @@ def shard_attn_out_param(param: torch.Tensor,
             q_sharding_rank = shard_rank % q_sharding_degree
             q_factor = n_heads_q // n_heads_kv
 
-            q_chunk = param[..., q_factor * kv_head * head_size:q_factor * (kv_head + 1) * head_size]
-
-            return shard_param(q_chunk,
-                               ShardingType.INNER_DIMENSION,
-                               q_sharding_rank,
-                               q_sharding_degree,
-                               granularity=head_size)
+            segments = get_shard_segments(q_factor * head_size,
+                                          q_sharding_rank,
+                                          q_sharding_degree,
+                                          granularity=head_size,
+                                          base_offset=q_factor * kv_head * head_size)
+            return gather_shard_segments(param, -1, segments)
 
 
 def attn_out_in_features(out_features: int,
@@ -8,7 +8,7 @@ from typing import Optional
 import torch
 
 from .types import ShardingType
-from .utils import shard_param, get_shard_endpoints
+from .utils import shard_param, get_shard_endpoints, get_shard_segments, gather_shard_segments
 
 
 def shard_qkv_param(param: torch.Tensor,
@@ -76,40 +76,38 @@ def shard_qkv_param(param: torch.Tensor,
         if param is None:
             return None
 
-        q_param = param[:head_size * n_heads_q]
-        kv_param = param[head_size * n_heads_q:]
+        # Segments are gathered along the output dimension (dim 0 for both weights and biases)
+        # straight from the fused parameter, so no per-matrix intermediates are created.
+        q_size = head_size * n_heads_q
 
         if even_kv_sharding:
             # This is equivalent to the original sharding algorithm since n_heads_q = C * n_heads_kv.
             # If n_heads_kv % num_shards == 0, then n_heads_q % num_shards == 0.
-            q_param = shard_param(q_param, ShardingType.OUTER_DIMENSION, shard_rank, num_shards, granularity=head_size)
-            kv_param = shard_param(kv_param,
-                                   ShardingType.OUTER_DIMENSION,
-                                   shard_rank,
-                                   num_shards,
-                                   num_concatenated_matrices=2,
-                                   granularity=head_size)
-            return torch.cat([q_param, kv_param], dim=0)
+            segments = get_shard_segments(q_size, shard_rank, num_shards, granularity=head_size)
+            segments += get_shard_segments(param.shape[0] - q_size,
+                                           shard_rank,
+                                           num_shards,
+                                           num_concatenated_matrices=2,
+                                           granularity=head_size,
+                                           base_offset=q_size)
         else:
             # We will first do a sharding on the KV and Q to map to the one KV shard per group of Q.
             q_sharding_degree = num_shards // n_heads_kv
 
             kv_head = shard_rank // q_sharding_degree
-            k_param = kv_param[kv_head * head_size:(kv_head + 1) * head_size]
-            v_param = kv_param[(n_heads_kv + kv_head) * head_size:(n_heads_kv + kv_head + 1) * head_size]
 
             q_sharding_rank = shard_rank % q_sharding_degree
             q_factor = n_heads_q // n_heads_kv
 
-            q_chunk = q_param[q_factor * kv_head * head_size:q_factor * (kv_head + 1) * head_size]
+            segments = get_shard_segments(q_factor * head_size,
+                                          q_sharding_rank,
+                                          q_sharding_degree,
+                                          granularity=head_size,
+                                          base_offset=q_factor * kv_head * head_size)
+            segments.append((q_size + kv_head * head_size, head_size))
+            segments.append((q_size + (n_heads_kv + kv_head) * head_size, head_size))
 
-            q_param = shard_param(q_chunk,
-                                  ShardingType.OUTER_DIMENSION,
-                                  q_sharding_rank,
-                                  q_sharding_degree,
-                                  granularity=head_size)
-
-            return torch.cat([q_param, k_param, v_param], dim=0)
+        return gather_shard_segments(param, 0, segments)
 
 
 def qkv_out_features(in_features: int,
@@ -3,10 +3,12 @@
 
 # DeepSpeed Team
 
-from typing import Optional, Tuple
+from functools import lru_cache
+from typing import List, Optional, Tuple
 
 import torch
 
+from deepspeed.ops.op_builder import RaggedUtilsBuilder
 from .types import ShardingType, DEFAULT_SHARD_GRANULARITY
 
 
@@ -40,6 +42,49 @@ def get_shard_endpoints(dim_size: int,
     return start_chunk_id * granularity, end_chunk_id * granularity
 
 
+def get_shard_segments(dim_size: int,
+                       shard_rank: int,
+                       num_shards: int,
+                       num_concatenated_matrices: int = 1,
+                       granularity: int = DEFAULT_SHARD_GRANULARITY,
+                       base_offset: int = 0) -> List[Tuple[int, int]]:
+    """
+    Return the (start, length) segments of a dimension of ``dim_size`` elements, made of
+    ``num_concatenated_matrices`` equally sized matrices, that belong to the given rank.
+
+    Args:
+        dim_size (int): The size of the full dimension, including all concatenated matrices.
+        shard_rank (int): The rank of the shard to return.
+        num_shards (int): Total number of shards the dimension will be distributed across.
+        num_concatenated_matrices (int): The number of matrices concatenated along the dimension.
+        granularity (int): The minimum alignment of the shard endpoints.
+        base_offset (int): Offset added to every segment start, used when the dimension is itself
+            a slice of a larger parameter.
+    """
+    matrix_size = dim_size // num_concatenated_matrices
+    start, end = get_shard_endpoints(matrix_size, shard_rank, num_shards, granularity)
+    return [(base_offset + i * matrix_size + start, end - start) for i in range(num_concatenated_matrices)]
+
+
+@lru_cache(maxsize=None)
+def _native_gather_fn():
+    builder = RaggedUtilsBuilder()
+    if not builder.is_compatible(verbose=False):
+        return None
+    return builder.load().gather_shard_segments
+
+
+def gather_shard_segments(param: torch.Tensor, dim: int, segments: List[Tuple[int, int]]) -> torch.Tensor:
+    """
+    Concatenate the given (start, length) segments of dimension ``dim`` of ``param`` into a new
+    Tensor. The result is allocated once and filled straight from ``param``.
+    """
+    gather_fn = _native_gather_fn()
+    if gather_fn is not None:
+        return gather_fn(param, dim, [start for start, _ in segments], [length for _, length in segments])
+    return torch.cat([param.narrow(dim, start, length) for start, length in segments], dim=dim)
+
+
 def shard_param(param: Optional[torch.Tensor],
                 shard_mode: ShardingType,
                 shard_rank: int,
@@ -81,24 +126,11 @@ def shard_param(param: Optional[torch.Tensor],
         return param
 
     if shard_mode == ShardingType.OUTER_DIMENSION:
-
-        def get_matrices(dim_idx: int) -> torch.Tensor:
-            dim_size = param.size(dim_idx) // num_concatenated_matrices
-            start_channel_id, end_channel_id = get_shard_endpoints(dim_size, shard_rank, num_shards, granularity)
-            return torch.chunk(param, num_concatenated_matrices, dim=dim_idx), start_channel_id, end_channel_id
-
-        if param.ndim == bias_dims:
-            # Special case for bias parameters.
-            matrices, start_channel_id, end_channel_id = get_matrices(dim_idx=-1)
-            return torch.cat([mat[..., start_channel_id:end_channel_id] for mat in matrices], dim=-1)
-        else:
-            # General case for weight parameters. This assumes MoE parameters are stored in the format of
-            # [num_experts, out_features, in_features]
-            matrices, start_channel_id, end_channel_id = get_matrices(dim_idx=-2)
-            return torch.cat([mat[..., start_channel_id:end_channel_id, :] for mat in matrices], dim=-2)
-
+        # Biases are sharded along their last dimension. Weights assume MoE parameters are stored
+        # in the format of [num_experts, out_features, in_features].
+        dim = -1 if param.ndim == bias_dims else -2
     elif shard_mode == ShardingType.INNER_DIMENSION:
-        dim_size = param.size(-1) // num_concatenated_matrices
-        start_channel_id, end_channel_id = get_shard_endpoints(dim_size, shard_rank, num_shards, granularity)
-        matrices = torch.chunk(param, num_concatenated_matrices, dim=-1)
-        return torch.cat([mat[..., start_channel_id:end_channel_id] for mat in matrices], dim=-1)
+        dim = -1
+
+    segments = get_shard_segments(param.size(dim), shard_rank, num_shards, num_concatenated_matrices, granularity)
+    return gather_shard_segments(param, dim, segments)
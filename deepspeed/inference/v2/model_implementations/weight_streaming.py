@@ -0,0 +1,253 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import os
+from abc import ABC, abstractmethod
+from typing import List, Sequence, Tuple
+
+import torch
+
+from deepspeed.accelerator import get_accelerator
+from deepspeed.ops.op_builder import AsyncIOBuilder
+from .flat_model_helpers import ModelMetadata, bind_layer_views, make_layer_views, pad_to_aligned_offset
+from .layer_container_base import LayerContainer
+from ..config_v2 import WeightStreamingConfig
+from ..logging import inference_logger
+
+# Layer files are read with O_DIRECT, so their size and the staging buffers are padded to this.
+STREAMING_FILE_ALIGNMENT = 4096
+
+
+def make_layer_filename(base: str, layer_idx: int, rank: int, n_ranks: int) -> str:
+    """
+    Make a filename for the weights of one transformer layer of the ``nvme`` streaming source.
+    """
+    return os.path.join(base, f"layer_{layer_idx}_rank_{rank}_of_{n_ranks}.bin")
+
+
+class LayerSource(ABC):
+    """
+    Where the bytes of the streamed layers live. Loads are split in two phases so that the read
+    of the next layer overlaps the compute of the current one: ``start`` is called when the
+    prefetch is issued and ``finish`` right before the layer is first used.
+    """
+
+    @abstractmethod
+    def start(self, layer_idx: int, slot_idx: int, slot: torch.Tensor) -> None:
+        ...
+
+    @abstractmethod
+    def finish(self, layer_idx: int, slot_idx: int, slot: torch.Tensor) -> None:
+        ...
+
+
+class HostLayerSource(LayerSource):
+    """
+    Streams layers from the flattened model in pinned host memory. The copies run on a side stream
+    that waits for the previous user of the staging slot. A host accelerator has no side stream,
+    and the copy is made when the layer is first used.
+    """
+
+    def __init__(self, buffer: torch.Tensor, ranges: List[Tuple[int, int]], n_slots: int) -> None:
+        self._buffer = buffer
+        self._ranges = ranges
+        if get_accelerator().is_synchronized_device():
+            self._copy_stream = None
+        else:
+            self._copy_stream = get_accelerator().Stream()
+            self._loaded = [get_accelerator().Event() for _ in range(n_slots)]
+
+    def _copy(self, layer_idx: int, slot: torch.Tensor) -> None:
+        start, end = self._ranges[layer_idx]
+        slot[:end - start].copy_(self._buffer[start:end], non_blocking=True)
+
+    def start(self, layer_idx: int, slot_idx: int, slot: torch.Tensor) -> None:
+        if self._copy_stream is None:
+            return
+
+        # The slot was last read by kernels already enqueued on the compute stream.
+        self._copy_stream.wait_stream(get_accelerator().current_stream())
+        with get_accelerator().stream(self._copy_stream):
+            self._copy(layer_idx, slot)
+            self._loaded[slot_idx].record(self._copy_stream)
+
+    def finish(self, layer_idx: int, slot_idx: int, slot: torch.Tensor) -> None:
+        if self._copy_stream is None:
+            self._copy(layer_idx, slot)
+        else:
+            get_accelerator().current_stream().wait_event(self._loaded[slot_idx])
+
+
+class NVMeLayerSource(LayerSource):
+    """
+    Streams layers from one file per layer through the AIO handle. Each slot has its own handle
+    so that waiting for one layer does not wait for the prefetch of the next. On a host
+    accelerator the files are read straight into the staging slots, otherwise into pinned bounce
+    buffers that are then copied to the accelerator.
+    """
+
+    def __init__(self, filenames: List[str], slot_bytes: int, n_slots: int, config: WeightStreamingConfig) -> None:
+        self._filenames = filenames
+        self._sizes = [os.path.getsize(filename) for filename in filenames]
+
+        aio_op = AsyncIOBuilder().load(verbose=False)
+        self._handles = [
+            aio_op.aio_handle(config.aio_block_size, config.aio_queue_depth, False, True, config.aio_thread_count)
+            for _ in range(n_slots)
+        ]
+
+        self._direct = get_accelerator().is_synchronized_device()
+        if self._direct:
+            self._bounce = None
+            self._copied = None
+        else:
+            self._bounce = [
+                get_accelerator().pin_memory(torch.empty(slot_bytes, dtype=torch.uint8)) for _ in range(n_slots)
+            ]
+            self._copied = [None] * n_slots
+
+    def start(self, layer_idx: int, slot_idx: int, slot: torch.Tensor) -> None:
+        size = self._sizes[layer_idx]
+        if self._direct:
+            target = slot
+        else:
+            # The bounce buffer may still be the source of the copy of the previous layer.
+            if self._copied[slot_idx] is not None:
+                self._copied[slot_idx].synchronize()
+                self._copied[slot_idx] = None
+            target = self._bounce[slot_idx]
+        self._handles[slot_idx].async_pread(target[:size], self._filenames[layer_idx])
+
+    def finish(self, layer_idx: int, slot_idx: int, slot: torch.Tensor) -> None:
+        self._handles[slot_idx].wait()
+        if not self._direct:
+            size = self._sizes[layer_idx]
+            slot[:size].copy_(self._bounce[slot_idx][:size], non_blocking=True)
+            self._copied[slot_idx] = get_accelerator().Event()
+            self._copied[slot_idx].record()
+
+
+class StreamedLayers(Sequence):
+    """
+    Drop-in replacement for the list of transformer ``LayerContainer``s of a model whose layer
+    weights are streamed. The model implementations access ``self._transformer[i]`` for layer i
+    and then ``self._transformer[i + 1]`` at the end of layer i (to fuse the next layer norm), so
+    indexing a layer is the point where it must be resident. Making layer i resident issues the
+    load of layer i + 1 (wrapping to the first layer for the next forward) into the other
+    staging slot, so it overlaps with the compute of layer i.
+
+    Only two layers are resident at a time. A container that is not resident still holds views
+    onto a staging slot and must not be used.
+    """
+
+    N_SLOTS = 2
+
+    def __init__(self, containers: List[LayerContainer], metadata: ModelMetadata, ranges: List[Tuple[int, int]],
+                 source_factory) -> None:
+        """
+        Arguments:
+            containers: The transformer layer containers of the model.
+            metadata: Layout of the flattened model.
+            ranges: Byte range of each layer in the flattened model.
+            source_factory: Called with the staging slot size and number of slots, returns the
+                ``LayerSource`` to load from.
+        """
+        self._containers = containers
+        self._metadata = metadata
+        self._ranges = ranges
+
+        slot_bytes = pad_to_aligned_offset(max(end - start for start, end in ranges), STREAMING_FILE_ALIGNMENT)
+        self._slots = [
+            torch.empty(slot_bytes, dtype=torch.uint8, device=get_accelerator().current_device())
+            for _ in range(self.N_SLOTS)
+        ]
+        self._source = source_factory(slot_bytes, self.N_SLOTS)
+
+        self._slot_layer = [-1] * self.N_SLOTS
+        self._slot_ready = [False] * self.N_SLOTS
+        self._views = {}
+
+        # Every container points at a staging slot from the start, so the model sees parameters
+        # on the accelerator. The data only becomes valid when the layer is loaded.
+        for layer_idx in range(len(containers)):
+            self._bind(layer_idx, 0)
+
+        inference_logger().info(f"Streaming {len(containers)} transformer layers through {self.N_SLOTS} staging "
+                                f"buffers of {slot_bytes / 2**20:.1f} MiB")
+
+    def __len__(self) -> int:
+        return len(self._containers)
+
+    def _issue(self, layer_idx: int, slot_idx: int) -> None:
+        if self._slot_layer[slot_idx] != -1 and not self._slot_ready[slot_idx]:
+            # Drain a load that is still in flight into this slot, only happens after a miss.
+            self._source.finish(self._slot_layer[slot_idx], slot_idx, self._slots[slot_idx])
+        self._source.start(layer_idx, slot_idx, self._slots[slot_idx])
+        self._slot_layer[slot_idx] = layer_idx
+        self._slot_ready[slot_idx] = False
+
+    def _bind(self, layer_idx: int, slot_idx: int) -> None:
+        """
+        Point the parameters of a layer at a staging slot. The views are built once per layer and
+        slot and reused afterwards.
+        """
+        views = self._views.get((layer_idx, slot_idx))
+        if views is None:
+            start, _ = self._ranges[layer_idx]
+            views = make_layer_views(self._metadata.layers[f"transformer_layer_{layer_idx}"],
+                                     self._slots[slot_idx],
+                                     base_offset=start)
+            self._views[(layer_idx, slot_idx)] = views
+        bind_layer_views(self._containers[layer_idx], views)
+
+    def _acquire(self, layer_idx: int) -> LayerContainer:
+        if layer_idx in self._slot_layer:
+            slot_idx = self._slot_layer.index(layer_idx)
+        else:
+            # Miss, only on the first access or when the access pattern is not sequential. Load
+            # into the slot that is not holding the previous layer.
+            previous = (layer_idx - 1) % len(self)
+            slot_idx = 1 if self._slot_layer[0] == previous else 0
+            self._issue(layer_idx, slot_idx)
+
+        if not self._slot_ready[slot_idx]:
+            self._source.finish(layer_idx, slot_idx, self._slots[slot_idx])
+            self._bind(layer_idx, slot_idx)
+            self._slot_ready[slot_idx] = True
+
+        next_idx = (layer_idx + 1) % len(self)
+        if next_idx != layer_idx and next_idx not in self._slot_layer:
+            self._issue(next_idx, 1 - slot_idx)
+
+        return self._containers[layer_idx]
+
+    def __getitem__(self, layer_idx):
+        if isinstance(layer_idx, slice):
+            return [self[i] for i in range(*layer_idx.indices(len(self)))]
+        if layer_idx < 0:
+            layer_idx += len(self)
+        return self._acquire(layer_idx)
+
+
+def write_layer_files(base: str, buffer: torch.Tensor, ranges: List[Tuple[int, int]], rank: int,
+                      n_ranks: int) -> List[str]:
+    """
+    Split the transformer layers of a flattened (host, typically memory mapped) model into one
+    file per layer for the ``nvme`` streaming source. Files of the right size are kept, so this is
+    a no-op after the first run.
+    """
+    os.makedirs(base, exist_ok=True)
+    filenames = []
+    for layer_idx, (start, end) in enumerate(ranges):
+        filename = make_layer_filename(base, layer_idx, rank, n_ranks)
+        file_size = pad_to_aligned_offset(end - start, STREAMING_FILE_ALIGNMENT)
+        if not os.path.isfile(filename) or os.path.getsize(filename) != file_size:
+            tmp_filename = filename + ".tmp"
+            with open(tmp_filename, "wb") as f:
+                f.write(memoryview(buffer[start:end].numpy()))
+                f.write(b"\0" * (file_size - (end - start)))
+            os.replace(tmp_filename, filename)
+        filenames.append(filename)
+    return filenames
@@ -20,7 +20,7 @@ from ....kernels.ragged_ops import (
     LinearBlockedKVCopy,
 )
 from ....ragged import RaggedBatchWrapper, split_kv
-from deepspeed.ops.op_builder import RaggedUtilsBuilder
+from ....ragged.host_staging import allocate_host_mirror
 
 from ...interfaces import DSSelfAttentionBase, DSSelfAttentionRegistry
 from ...configs import DSSelfAttentionConfig, PositionalEmbeddingType, MaskingType
@@ -116,8 +116,7 @@ class DSDenseBlockedAttention(DSSelfAttentionBase):
         self._max_atoms = self._config.max_sequences
         self._atoms = torch.empty((self._max_atoms, 8), dtype=torch.int32, device=get_accelerator().current_device())
 
-        alloc_func = RaggedUtilsBuilder().load().allocate_fast_host_buffer
-        self._atoms_shadow = alloc_func(self._atoms)
+        self._atoms_shadow = allocate_host_mirror(self._atoms)
         self._cur_atoms = 0
 
     @cached_property
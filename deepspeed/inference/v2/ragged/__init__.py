@@ -8,6 +8,7 @@ from .manager_configs import (
     AllocationMode,
     DSStateManagerConfig,
     KVCacheConfig,
+    KVReclaimFill,
     MemoryConfig,
 )
 from .ragged_manager import DSStateManager
@@ -7,6 +7,8 @@ from typing import Iterable, Union
 
 import torch
 
+from deepspeed.ops.op_builder import RaggedUtilsBuilder
+
 
 class BlockedAllocator:
     """
@@ -15,8 +17,8 @@ class BlockedAllocator:
     to keep track of which blocks are free/used. The cost of allocation/deallocation
     is O(blocks), where blocks is the number of blocks to allocate/deallocate.
 
-    TODO(cmikeh2): Evaluate performance of this allocator and migrate
-    to C++ if necessary.
+    Frees are validated and relinked in a single native call, so freeing the blocks of many
+    sequences at once costs one call rather than one Python iteration per block.
     """
     # Number of blocks in the KV-cache(s).
     _num_blocks: int
@@ -46,6 +48,7 @@ class BlockedAllocator:
         self._blocks = torch.arange(1, num_blocks + 1, dtype=torch.int32, device='cpu', pin_memory=True)
         self._head = 0
         self._free_blocks = num_blocks
+        self._free_fn = RaggedUtilsBuilder().load().free_blocks
 
     def allocate(self, num_blocks: int) -> torch.Tensor:
         """
@@ -74,28 +77,21 @@ class BlockedAllocator:
     def free(self, blocks: Union[Iterable[int], int]) -> None:
         """
         Return a list of blocks to the free pool. If a single invalid block is provided (i.e.,
-        one that is out of range of the allocator or is already free), then an exception is raised
-        and no blocks are freed.
+        one that is out of range of the allocator, is already free or is repeated), then an
+        exception is raised and no blocks are freed.
 
         Parameters:
-            blocks (Union[Iterable[int], int]): The list of blocks to free. If only one block
-                is to be freed, this can be alone as an integer.
+            blocks (Union[Iterable[int], int, torch.Tensor]): The list of blocks to free. If only
+                one block is to be freed, this can be alone as an integer.
         """
         if isinstance(blocks, int):
             blocks = [blocks]
+        if not isinstance(blocks, torch.Tensor):
+            blocks = torch.tensor(list(blocks), dtype=torch.int64)
+        blocks = blocks.flatten().cpu()
 
-        for block in blocks:
-            # Parse all blocks for validity before mutating the list.
-            if block < 0 or block >= self._num_blocks:
-                raise ValueError(f'Invalid block {block} provided to free')
-
-            if self._blocks[block] != -1:
-                raise ValueError(f'Block {block} is already free')
-
-        for block in blocks:
-            self._blocks[block] = self._head
-            self._head = block
-            self._free_blocks += 1
+        self._head = self._free_fn(self._blocks, self._head, blocks)
+        self._free_blocks += blocks.numel()
 
     @property
     def free_blocks(self) -> int:
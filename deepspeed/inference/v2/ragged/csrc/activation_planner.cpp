@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "activation_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+using Interval = std::pair<int64_t, int64_t>;
+
+// Both lists are sorted by start and merged, so a linear sweep finds any overlap.
+bool lifetimes_overlap(const std::vector<Interval>& a, const std::vector<Interval>& b)
+{
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i].second < b[j].first) {
+            i++;
+        } else if (b[j].second < a[i].first) {
+            j++;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+void merge_intervals(std::vector<Interval>& intervals)
+{
+    if (intervals.empty()) return;
+    std::sort(intervals.begin(), intervals.end());
+    size_t out = 0;
+    for (size_t i = 1; i < intervals.size(); i++) {
+        if (intervals[i].first <= intervals[out].second + 1) {
+            intervals[out].second = std::max(intervals[out].second, intervals[i].second);
+        } else {
+            intervals[++out] = intervals[i];
+        }
+    }
+    intervals.resize(out + 1);
+}
+
+}  // namespace
+
+int64_t plan_activation_arena(const std::vector<int64_t>& sizes,
+                              const std::vector<int64_t>& interval_owner,
+                              const std::vector<int64_t>& interval_start,
+                              const std::vector<int64_t>& interval_end,
+                              int64_t alignment,
+                              std::vector<int64_t>& offsets)
+{
+    if (alignment <= 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("alignment must be a power of two");
+    }
+    if (interval_owner.size() != interval_start.size() ||
+        interval_owner.size() != interval_end.size()) {
+        throw std::invalid_argument("live range arrays must have the same length");
+    }
+
+    const int64_t n_buffers = sizes.size();
+    std::vector<std::vector<Interval>> lifetimes(n_buffers);
+    for (size_t i = 0; i < interval_owner.size(); i++) {
+        const int64_t owner = interval_owner[i];
+        if (owner < 0 || owner >= n_buffers) {
+            throw std::invalid_argument("live range refers to an unknown buffer");
+        }
+        if (interval_end[i] < interval_start[i]) {
+            throw std::invalid_argument("live range ends before it starts");
+        }
+        lifetimes[owner].emplace_back(interval_start[i], interval_end[i]);
+    }
+    for (auto& lifetime : lifetimes) merge_intervals(lifetime);
+
+    std::vector<int64_t> aligned(n_buffers);
+    for (int64_t i = 0; i < n_buffers; i++) {
+        aligned[i] = (sizes[i] + alignment - 1) & ~(alignment - 1);
+    }
+
+    std::vector<int64_t> order(n_buffers);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        return aligned[a] > aligned[b];
+    });
+
+    offsets.assign(n_buffers, -1);
+    std::vector<int64_t> placed;
+    std::vector<Interval> occupied;
+    int64_t arena_size = 0;
+
+    for (const int64_t buffer : order) {
+        occupied.clear();
+        for (const int64_t other : placed) {
+            if (lifetimes_overlap(lifetimes[buffer], lifetimes[other])) {
+                occupied.emplace_back(offsets[other], offsets[other] + aligned[other]);
+            }
+        }
+        std::sort(occupied.begin(), occupied.end());
+
+        // Best fit among the gaps between conflicting buffers, else the end of the conflicts.
+        int64_t best_offset = -1;
+        int64_t best_waste = std::numeric_limits<int64_t>::max();
+        int64_t cursor = 0;
+        for (const auto& range : occupied) {
+            const int64_t gap = range.first - cursor;
+            if (gap >= aligned[buffer] && gap - aligned[buffer] < best_waste) {
+                best_offset = cursor;
+                best_waste = gap - aligned[buffer];
+            }
+            cursor = std::max(cursor, range.second);
+        }
+        if (best_offset < 0) best_offset = cursor;
+
+        offsets[buffer] = best_offset;
+        placed.push_back(buffer);
+        arena_size = std::max(arena_size, best_offset + aligned[buffer]);
+    }
+
+    return arena_size;
+}
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "blocked_allocator.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr int32_t used_block = -1;
+
+// Marks the blocks of the batch while it is validated, to catch repeated blocks.
+constexpr int32_t pending_block = -2;
+
+}  // namespace
+
+int64_t free_blocks(torch::Tensor& links, int64_t head, torch::Tensor& blocks)
+{
+    TORCH_CHECK(links.device().is_cpu() && links.scalar_type() == torch::kInt32 &&
+                    links.is_contiguous(),
+                "links must be a contiguous int32 host tensor");
+    TORCH_CHECK(blocks.device().is_cpu(), "blocks must be a host tensor");
+
+    const torch::Tensor ids_tensor = blocks.to(torch::kInt64).contiguous();
+    const int64_t* ids = ids_tensor.data_ptr<int64_t>();
+    const int64_t n_ids = ids_tensor.numel();
+
+    int32_t* next = links.data_ptr<int32_t>();
+    const int64_t n_blocks = links.numel();
+
+    int64_t n_valid = 0;
+    for (; n_valid < n_ids; n_valid++) {
+        const int64_t block = ids[n_valid];
+        if (block < 0 || block >= n_blocks || next[block] != used_block) break;
+        next[block] = pending_block;
+    }
+
+    if (n_valid < n_ids) {
+        for (int64_t i = 0; i < n_valid; i++) next[ids[i]] = used_block;
+
+        const int64_t block = ids[n_valid];
+        if (block < 0 || block >= n_blocks) {
+            throw std::invalid_argument("Invalid block " + std::to_string(block) +
+                                        " provided to free");
+        }
+        throw std::invalid_argument("Block " + std::to_string(block) + " is already free");
+    }
+
+    for (int64_t i = 0; i < n_ids; i++) {
+        next[ids[i]] = static_cast<int32_t>(head);
+        head = ids[i];
+    }
+    return head;
+}
@@ -16,3 +16,13 @@ void* get_cuda_fast_buffer(int64_t size)
     cudaHostAlloc(&buffer_ptr, size, alloc_flags);
     return buffer_ptr;
 }
+
+void free_cuda_fast_buffer(void* buffer_ptr) { cudaFreeHost(buffer_ptr); }
+
+bool register_cuda_host_buffer(void* buffer_ptr, int64_t size)
+{
+    unsigned int register_flags = cudaHostRegisterPortable | cudaHostRegisterMapped;
+    return cudaHostRegister(buffer_ptr, size, register_flags) == cudaSuccess;
+}
+
+void unregister_cuda_host_buffer(void* buffer_ptr) { cudaHostUnregister(buffer_ptr); }
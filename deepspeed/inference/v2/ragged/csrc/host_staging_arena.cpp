@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "host_staging_arena.h"
+
+#include <sys/mman.h>
+#include <cstring>
+
+#if !defined(__DISABLE_CUDA__)
+#include "fast_host_buffer.h"
+#endif
+
+namespace {
+
+constexpr int64_t huge_page_bytes = 2 << 20;
+
+int64_t round_up(int64_t value, int64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+struct HostStagingArena::Chunk {
+    uint8_t* data = nullptr;
+    int64_t bytes = 0;
+    bool huge_pages = false;
+    // How the memory was obtained, determines how it is released.
+    bool mapped = false;
+    bool registered = false;
+    bool fast_buffer = false;
+    torch::Tensor storage;
+
+    ~Chunk()
+    {
+#if !defined(__DISABLE_CUDA__)
+        if (registered) unregister_cuda_host_buffer(data);
+        if (fast_buffer) free_cuda_fast_buffer(data);
+#endif
+        if (mapped) munmap(data, bytes);
+    }
+};
+
+HostStagingArena::HostStagingArena(int64_t chunk_bytes, bool pinned, bool huge_pages)
+    : chunk_bytes_(chunk_bytes),
+      pinned_(pinned),
+      huge_pages_(huge_pages),
+      current_chunk_(0),
+      offset_(0),
+      used_bytes_(0)
+{
+    TORCH_CHECK(chunk_bytes > 0, "chunk_bytes must be positive");
+#if defined(__DISABLE_CUDA__)
+    TORCH_CHECK(!pinned, "pinned staging memory is not available in a CPU build");
+#endif
+}
+
+std::shared_ptr<HostStagingArena::Chunk> HostStagingArena::new_chunk(int64_t min_bytes) const
+{
+    auto chunk = std::make_shared<Chunk>();
+    chunk->bytes = std::max(chunk_bytes_, round_up(min_bytes, alignment));
+    chunk->huge_pages = huge_pages_;
+
+    if (huge_pages_) {
+        chunk->bytes = round_up(chunk->bytes, huge_page_bytes);
+        void* ptr = mmap(nullptr,
+                         chunk->bytes,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                         -1,
+                         0);
+        if (ptr == MAP_FAILED) {
+            // No reserved huge pages, ask for transparent huge pages instead.
+            ptr = mmap(
+                nullptr, chunk->bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            TORCH_CHECK(
+                ptr != MAP_FAILED, "failed to map ", chunk->bytes, " bytes of staging memory");
+            madvise(ptr, chunk->bytes, MADV_HUGEPAGE);
+        }
+        chunk->data = static_cast<uint8_t*>(ptr);
+        chunk->mapped = true;
+#if !defined(__DISABLE_CUDA__)
+        if (pinned_) {
+            chunk->registered = register_cuda_host_buffer(chunk->data, chunk->bytes);
+            TORCH_CHECK(
+                chunk->registered, "failed to pin ", chunk->bytes, " bytes of staging memory");
+        }
+#endif
+    } else if (pinned_) {
+#if defined(__DISABLE_CUDA__)
+        TORCH_CHECK(false, "pinned staging memory is not available in a CPU build");
+#elif defined(__HIP_PLATFORM_HCC__)
+        auto options =
+            torch::TensorOptions().device(torch::kCPU).pinned_memory(true).dtype(torch::kUInt8);
+        chunk->storage = torch::empty({chunk->bytes}, options);
+        chunk->data = chunk->storage.data_ptr<uint8_t>();
+#else
+        chunk->data = static_cast<uint8_t*>(get_cuda_fast_buffer(chunk->bytes));
+        TORCH_CHECK(chunk->data != nullptr, "failed to allocate ", chunk->bytes, " pinned bytes");
+        chunk->fast_buffer = true;
+#endif
+    } else {
+        void* ptr = mmap(
+            nullptr, chunk->bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        TORCH_CHECK(ptr != MAP_FAILED, "failed to map ", chunk->bytes, " bytes of staging memory");
+        chunk->data = static_cast<uint8_t*>(ptr);
+        chunk->mapped = true;
+    }
+    return chunk;
+}
+
+torch::Tensor HostStagingArena::allocate(torch::Tensor device_mirror)
+{
+    const int64_t bytes = device_mirror.numel() * device_mirror.element_size();
+
+    // The first chunk that still has room. Chunks are never revisited until the next reset, so
+    // the arena wastes at most the tail of each chunk.
+    while (current_chunk_ < chunks_.size() &&
+           round_up(offset_, alignment) + bytes > chunks_[current_chunk_]->bytes) {
+        current_chunk_++;
+        offset_ = 0;
+    }
+    if (current_chunk_ == chunks_.size()) {
+        chunks_.push_back(new_chunk(bytes));
+        offset_ = 0;
+    }
+
+    std::shared_ptr<Chunk> chunk = chunks_[current_chunk_];
+    const int64_t start = round_up(offset_, alignment);
+    offset_ = start + bytes;
+    used_bytes_ += bytes;
+
+    uint8_t* data = chunk->data + start;
+    std::memset(data, 0, bytes);
+
+    auto options = torch::TensorOptions().device(torch::kCPU).dtype(device_mirror.dtype());
+    return torch::from_blob(
+        data, device_mirror.sizes(), [chunk](void*) {}, options);
+}
+
+void HostStagingArena::reset(bool huge_pages)
+{
+    // A chunk referenced by a mirror of a live engine cannot be handed out again.
+    std::vector<std::shared_ptr<Chunk>> reusable;
+    for (auto& chunk : chunks_) {
+        if (chunk.use_count() == 1 && chunk->huge_pages == huge_pages) {
+            reusable.push_back(std::move(chunk));
+        }
+    }
+    chunks_ = std::move(reusable);
+    huge_pages_ = huge_pages;
+    current_chunk_ = 0;
+    offset_ = 0;
+    used_bytes_ = 0;
+}
+
+int64_t HostStagingArena::reserved_bytes() const
+{
+    int64_t reserved = 0;
+    for (const auto& chunk : chunks_) reserved += chunk->bytes;
+    return reserved;
+}
@@ -3,10 +3,20 @@
 
 // DeepSpeed Team
 
+#if !defined(__DISABLE_CUDA__)
 #include <c10/cuda/CUDAStream.h>
+#endif
 #include <torch/extension.h>
 
+#include "activation_planner.h"
+#include "blocked_allocator.h"
+#if !defined(__DISABLE_CUDA__)
 #include "fast_host_buffer.h"
+#endif
+#include "host_staging_arena.h"
+#include "request_queue.h"
+#include "shard_copy.h"
+#include "tensor_range_loader.h"
 
 /*
 Similar to doing an empty_like to replicate a Tensor on the host, but will
@@ -23,7 +33,11 @@ copies.
 */
 torch::Tensor allocate_fast_host_buffer(torch::Tensor device_mirror)
 {
-#ifdef __HIP_PLATFORM_HCC__
+#if defined(__DISABLE_CUDA__)
+    // CPU builds stage on the host itself, there is nothing to pin.
+    auto options = torch::TensorOptions().device(torch::kCPU).dtype(device_mirror.dtype());
+    auto buffer = torch::empty(device_mirror.sizes(), options);
+#elif defined(__HIP_PLATFORM_HCC__)
     auto options =
         torch::TensorOptions().device(torch::kCPU).pinned_memory(true).dtype(device_mirror.dtype());
     auto buffer = torch::empty(device_mirror.sizes(), options);
@@ -32,7 +46,8 @@ torch::Tensor allocate_fast_host_buffer(torch::Tensor device_mirror)
     void* buffer_ptr = get_cuda_fast_buffer(device_mirror.numel() * device_mirror.element_size());
 
     auto options = torch::TensorOptions().device(torch::kCPU).dtype(device_mirror.dtype());
-    auto buffer = torch::from_blob(buffer_ptr, device_mirror.sizes(), options);
+    auto buffer =
+        torch::from_blob(buffer_ptr, device_mirror.sizes(), free_cuda_fast_buffer, options);
 #endif
     return buffer;
 }
@@ -62,6 +77,79 @@ torch::Tensor allocate_view_like(py::tuple shape,
                          options);
 }
 
+/*
+Computes the arena layout of the activation memory planner. See activation_planner.h.
+
+Returns:
+    A tuple of (offsets, arena_size) in bytes.
+*/
+py::tuple plan_activation_arena_py(std::vector<int64_t> sizes,
+                                   std::vector<int64_t> interval_owner,
+                                   std::vector<int64_t> interval_start,
+                                   std::vector<int64_t> interval_end,
+                                   int64_t alignment)
+{
+    std::vector<int64_t> offsets;
+    const int64_t arena_size = plan_activation_arena(
+        sizes, interval_owner, interval_start, interval_end, alignment, offsets);
+    return py::make_tuple(offsets, arena_size);
+}
+
+/*
+Reads byte ranges of checkpoint files into a host buffer with parallel preads, converting
+between fp32, fp16 and bf16 on the fly. See tensor_range_loader.h.
+
+Arguments:
+    paths: Files the ranges refer to.
+    file_index, file_offset, n_bytes, src_dtype: Source of each range. The dtypes are
+        Range_Dtype codes.
+    dst_offset, dst_dtype: Destination of each range within `buffer`, in bytes.
+    buffer: Contiguous host tensor large enough for every destination range.
+*/
+void load_tensor_ranges_py(std::vector<std::string> paths,
+                           std::vector<int64_t> file_index,
+                           std::vector<int64_t> file_offset,
+                           std::vector<int64_t> n_bytes,
+                           std::vector<int64_t> src_dtype,
+                           std::vector<int64_t> dst_offset,
+                           std::vector<int64_t> dst_dtype,
+                           torch::Tensor& buffer,
+                           int64_t n_threads,
+                           int64_t chunk_bytes)
+{
+    TORCH_CHECK(buffer.device().is_cpu() && buffer.is_contiguous(),
+                "buffer must be a contiguous host tensor");
+    const size_t n_ranges = file_index.size();
+    TORCH_CHECK(file_offset.size() == n_ranges && n_bytes.size() == n_ranges &&
+                    src_dtype.size() == n_ranges && dst_offset.size() == n_ranges &&
+                    dst_dtype.size() == n_ranges,
+                "range arrays must have the same length");
+
+    auto elem_size = [](int64_t dtype) {
+        return static_cast<Range_Dtype>(dtype) == Range_Dtype::Float
+                   ? 4
+                   : (static_cast<Range_Dtype>(dtype) == Range_Dtype::Raw ? 1 : 2);
+    };
+
+    const int64_t buffer_bytes = buffer.numel() * buffer.element_size();
+    std::vector<Tensor_Range> ranges(n_ranges);
+    for (size_t i = 0; i < n_ranges; i++) {
+        ranges[i] = {file_index[i],
+                     file_offset[i],
+                     n_bytes[i],
+                     static_cast<Range_Dtype>(src_dtype[i]),
+                     dst_offset[i],
+                     static_cast<Range_Dtype>(dst_dtype[i])};
+        const int64_t dst_bytes = n_bytes[i] / elem_size(src_dtype[i]) * elem_size(dst_dtype[i]);
+        TORCH_CHECK(dst_offset[i] >= 0 && dst_offset[i] + dst_bytes <= buffer_bytes,
+                    "range does not fit in the destination buffer");
+    }
+
+    uint8_t* dst = reinterpret_cast<uint8_t*>(buffer.data_ptr());
+    py::gil_scoped_release release;
+    load_tensor_ranges(paths, ranges, dst, n_threads, chunk_bytes);
+}
+
 PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
 {
     m.def("allocate_fast_host_buffer",
@@ -73,4 +161,45 @@ PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
     m.def("allocate_view_like",
           &allocate_view_like,
           "Allocate a view on a Tensor on the same device as the input Tensor.");
+    m.def("free_blocks",
+          &free_blocks,
+          "Return a batch of blocks to the free list of a blocked allocator.");
+    m.def("plan_activation_arena",
+          &plan_activation_arena_py,
+          "Pack buffers with known lifetimes into a single arena.");
+    m.def("load_tensor_ranges",
+          &load_tensor_ranges_py,
+          "Read checkpoint byte ranges into a host buffer with parallel preads.");
+    m.def("gather_shard_segments",
+          &gather_shard_segments,
+          "Concatenate segments of one dimension of a Tensor into a new Tensor.");
+
+    py::class_<HostStagingArena>(m, "HostStagingArena")
+        .def(py::init<int64_t, bool, bool>(),
+             py::arg("chunk_bytes"),
+             py::arg("pinned"),
+             py::arg("huge_pages") = false)
+        .def("allocate",
+             &HostStagingArena::allocate,
+             "Allocate a host mirror of an accelerator Tensor.")
+        .def("reset", &HostStagingArena::reset, py::arg("huge_pages") = false)
+        .def_property_readonly("used_bytes", &HostStagingArena::used_bytes)
+        .def_property_readonly("reserved_bytes", &HostStagingArena::reserved_bytes)
+        .def_property_readonly("pinned", &HostStagingArena::pinned)
+        .def_property_readonly("huge_pages", &HostStagingArena::huge_pages);
+
+    py::class_<RequestQueue>(m, "RequestQueue")
+        .def(py::init<torch::Tensor>())
+        .def("try_push", &RequestQueue::try_push, py::call_guard<py::gil_scoped_release>())
+        .def("ready", &RequestQueue::ready)
+        .def("uid", &RequestQueue::uid)
+        .def("tokens", &RequestQueue::tokens)
+        .def("pop", &RequestQueue::pop)
+        .def_property_readonly("capacity", &RequestQueue::capacity);
+
+    py::class_<CompletionRing>(m, "CompletionRing")
+        .def(py::init<torch::Tensor>())
+        .def("try_push", &CompletionRing::try_push, py::call_guard<py::gil_scoped_release>())
+        .def("try_pop", &CompletionRing::try_pop, py::call_guard<py::gil_scoped_release>())
+        .def("size", &CompletionRing::size);
 }
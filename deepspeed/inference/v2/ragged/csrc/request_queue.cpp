@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "request_queue.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool is_power_of_two(int64_t value) { return value > 0 && (value & (value - 1)) == 0; }
+
+}  // namespace
+
+RequestQueue::RequestQueue(torch::Tensor token_buffer)
+    : token_buffer_(token_buffer),
+      capacity_(token_buffer.size(0)),
+      max_request_tokens_(token_buffer.size(1)),
+      slots_(new Slot[token_buffer.size(0)]),
+      enqueue_pos_(0),
+      dequeue_pos_(0)
+{
+    TORCH_CHECK(token_buffer.dim() == 2 && token_buffer.is_contiguous() &&
+                    token_buffer.device().is_cpu() && token_buffer.scalar_type() == torch::kInt64,
+                "token_buffer must be a contiguous [capacity, max_request_tokens] int64 host tensor");
+    TORCH_CHECK(is_power_of_two(capacity_), "queue capacity must be a power of two");
+    for (int64_t i = 0; i < capacity_; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool RequestQueue::try_push(int64_t uid, torch::Tensor tokens)
+{
+    TORCH_CHECK(tokens.device().is_cpu(), "tokens must be on the host");
+    const int64_t n_tokens = tokens.numel();
+    if (n_tokens > max_request_tokens_) return false;
+
+    const uint64_t mask = capacity_ - 1;
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[pos & mask];
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const int64_t diff = (int64_t)sequence - (int64_t)pos;
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // The slot is exclusively ours until its sequence is published below.
+    slot->uid = uid;
+    slot->n_tokens = n_tokens;
+    if (n_tokens > 0) {
+        torch::Tensor row = token_buffer_[pos & mask].narrow(0, 0, n_tokens);
+        row.copy_(tokens.reshape({-1}));
+    }
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+const RequestQueue::Slot& RequestQueue::slot_at(int64_t index) const
+{
+    return slots_[(dequeue_pos_ + index) & (capacity_ - 1)];
+}
+
+int64_t RequestQueue::ready(int64_t limit) const
+{
+    limit = std::min(limit, capacity_);
+    int64_t n_ready = 0;
+    while (n_ready < limit && slot_at(n_ready).sequence.load(std::memory_order_acquire) ==
+                                  dequeue_pos_ + n_ready + 1) {
+        n_ready++;
+    }
+    return n_ready;
+}
+
+int64_t RequestQueue::uid(int64_t index) const { return slot_at(index).uid; }
+
+torch::Tensor RequestQueue::tokens(int64_t index) const
+{
+    const int64_t row = (dequeue_pos_ + index) & (capacity_ - 1);
+    return token_buffer_[row].narrow(0, 0, slot_at(index).n_tokens);
+}
+
+void RequestQueue::pop(int64_t n_requests)
+{
+    TORCH_CHECK(n_requests <= ready(n_requests), "cannot pop requests that are not ready");
+    for (int64_t i = 0; i < n_requests; i++) {
+        slots_[(dequeue_pos_ + i) & (capacity_ - 1)].sequence.store(dequeue_pos_ + i + capacity_,
+                                                                     std::memory_order_release);
+    }
+    dequeue_pos_ += n_requests;
+}
+
+CompletionRing::CompletionRing(torch::Tensor slots)
+    : slots_(slots),
+      depth_(slots.size(0)),
+      record_bytes_(slots.numel() / std::max<int64_t>(slots.size(0), 1) * slots.element_size()),
+      head_(0),
+      tail_(0)
+{
+    TORCH_CHECK(slots.is_contiguous() && slots.device().is_cpu(),
+                "completion slots must be a contiguous host tensor");
+    TORCH_CHECK(is_power_of_two(depth_), "completion ring depth must be a power of two");
+}
+
+bool CompletionRing::try_push(torch::Tensor record)
+{
+    TORCH_CHECK(record.device().is_cpu() && record.is_contiguous() &&
+                    record.numel() * record.element_size() == record_bytes_ &&
+                    record.scalar_type() == slots_.scalar_type(),
+                "completion record does not match the ring slots");
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == depth_) return false;
+
+    uint8_t* dst = reinterpret_cast<uint8_t*>(slots_.data_ptr()) + (tail & (depth_ - 1)) * record_bytes_;
+    memcpy(dst, record.data_ptr(), record_bytes_);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool CompletionRing::try_pop(torch::Tensor out)
+{
+    TORCH_CHECK(out.device().is_cpu() && out.is_contiguous() &&
+                    out.numel() * out.element_size() == record_bytes_,
+                "output does not match the ring slots");
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+
+    const uint8_t* src =
+        reinterpret_cast<const uint8_t*>(slots_.data_ptr()) + (head & (depth_ - 1)) * record_bytes_;
+    memcpy(out.data_ptr(), src, record_bytes_);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+int64_t CompletionRing::size() const
+{
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+}
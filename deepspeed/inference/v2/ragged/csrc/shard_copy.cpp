@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "shard_copy.h"
+
+#include <ATen/Parallel.h>
+#include <cstring>
+
+torch::Tensor gather_shard_segments(torch::Tensor& src,
+                                    int64_t dim,
+                                    std::vector<int64_t> starts,
+                                    std::vector<int64_t> lengths)
+{
+    TORCH_CHECK(starts.size() == lengths.size(), "starts and lengths must have the same length");
+    dim = at::maybe_wrap_dim(dim, src.dim());
+
+    const int64_t src_dim = src.size(dim);
+    std::vector<int64_t> dst_offsets(starts.size());
+    int64_t dst_dim = 0;
+    for (size_t i = 0; i < starts.size(); i++) {
+        TORCH_CHECK(starts[i] >= 0 && lengths[i] >= 0 && starts[i] + lengths[i] <= src_dim,
+                    "shard segment is out of bounds");
+        dst_offsets[i] = dst_dim;
+        dst_dim += lengths[i];
+    }
+
+    std::vector<int64_t> dst_shape = src.sizes().vec();
+    dst_shape[dim] = dst_dim;
+    torch::Tensor dst = torch::empty(dst_shape, src.options());
+
+    if (!src.device().is_cpu()) {
+        for (size_t i = 0; i < starts.size(); i++) {
+            dst.narrow(dim, dst_offsets[i], lengths[i]).copy_(src.narrow(dim, starts[i], lengths[i]));
+        }
+        return dst;
+    }
+
+    torch::Tensor source = src.contiguous();
+    const int64_t outer = source.numel() == 0 ? 0 : source.numel() / (src_dim * source.stride(dim));
+    const int64_t row_bytes = source.stride(dim) * source.element_size();
+    const int64_t n_segments = starts.size();
+
+    const uint8_t* src_ptr = reinterpret_cast<const uint8_t*>(source.data_ptr());
+    uint8_t* dst_ptr = reinterpret_cast<uint8_t*>(dst.data_ptr());
+
+    // Each task copies one contiguous block: one segment of one leading index. Tasks are grouped
+    // so that every thread moves at least about 1 MB at a time.
+    const int64_t task_bytes = std::max<int64_t>(row_bytes * dst_dim / std::max<int64_t>(n_segments, 1), 1);
+    const int64_t grain = std::max<int64_t>(1, (1 << 20) / task_bytes);
+    at::parallel_for(0, outer * n_segments, grain, [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; task++) {
+            const int64_t o = task / n_segments;
+            const int64_t s = task % n_segments;
+            memcpy(dst_ptr + (o * dst_dim + dst_offsets[s]) * row_bytes,
+                   src_ptr + (o * src_dim + starts[s]) * row_bytes,
+                   lengths[s] * row_bytes);
+        }
+    });
+
+    return dst;
+}
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#include "tensor_range_loader.h"
+
+#include <c10/util/BFloat16.h>
+#include <c10/util/Half.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+struct Chunk {
+    int64_t range;
+    int64_t begin;  // Offset within the range, in source bytes
+    int64_t n_bytes;
+};
+
+int64_t dtype_size(Range_Dtype dtype)
+{
+    switch (dtype) {
+        case Range_Dtype::Float: return 4;
+        case Range_Dtype::Half:
+        case Range_Dtype::BFloat16: return 2;
+        default: return 1;
+    }
+}
+
+float load_float(const uint8_t* src, int64_t i, Range_Dtype dtype)
+{
+    if (dtype == Range_Dtype::Float) {
+        float value;
+        memcpy(&value, src + i * 4, 4);
+        return value;
+    }
+    uint16_t raw;
+    memcpy(&raw, src + i * 2, 2);
+    return dtype == Range_Dtype::Half ? c10::detail::fp16_ieee_to_fp32_value(raw)
+                                      : c10::detail::f32_from_bits(raw);
+}
+
+void store_float(uint8_t* dst, int64_t i, Range_Dtype dtype, float value)
+{
+    if (dtype == Range_Dtype::Float) {
+        memcpy(dst + i * 4, &value, 4);
+        return;
+    }
+    // Same round to nearest even as torch, including at the half subnormal boundary.
+    const uint16_t raw = dtype == Range_Dtype::Half ? c10::detail::fp16_ieee_from_fp32_value(value)
+                                                    : c10::detail::round_to_nearest_even(value);
+    memcpy(dst + i * 2, &raw, 2);
+}
+
+void read_fully(int fd, uint8_t* dst, int64_t n_bytes, int64_t offset)
+{
+    while (n_bytes > 0) {
+        const ssize_t n = pread(fd, dst, n_bytes, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("pread failed: ") + strerror(errno));
+        }
+        if (n == 0) throw std::runtime_error("unexpected end of file");
+        dst += n;
+        offset += n;
+        n_bytes -= n;
+    }
+}
+
+}  // namespace
+
+void load_tensor_ranges(const std::vector<std::string>& paths,
+                        const std::vector<Tensor_Range>& ranges,
+                        uint8_t* dst,
+                        int n_threads,
+                        int64_t chunk_bytes)
+{
+    // Chunks must hold whole elements of every dtype.
+    chunk_bytes = std::max<int64_t>(chunk_bytes - chunk_bytes % 4, 4);
+
+    std::vector<Chunk> chunks;
+    for (size_t r = 0; r < ranges.size(); r++) {
+        const Tensor_Range& range = ranges[r];
+        if (range.file_index < 0 || range.file_index >= (int64_t)paths.size()) {
+            throw std::invalid_argument("range refers to an unknown file");
+        }
+        if (range.src_dtype == Range_Dtype::Raw || range.dst_dtype == Range_Dtype::Raw) {
+            if (range.src_dtype != range.dst_dtype) {
+                throw std::invalid_argument("raw ranges cannot be converted");
+            }
+        } else if (range.n_bytes % dtype_size(range.src_dtype) != 0) {
+            throw std::invalid_argument("range size is not a multiple of its element size");
+        }
+        for (int64_t begin = 0; begin < range.n_bytes; begin += chunk_bytes) {
+            chunks.push_back({(int64_t)r, begin, std::min(chunk_bytes, range.n_bytes - begin)});
+        }
+    }
+
+    std::vector<int> fds(paths.size(), -1);
+    auto close_all = [&]() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    };
+    for (size_t i = 0; i < paths.size(); i++) {
+        fds[i] = open(paths[i].c_str(), O_RDONLY);
+        if (fds[i] < 0) {
+            const std::string reason = strerror(errno);
+            close_all();
+            throw std::runtime_error("unable to open " + paths[i] + ": " + reason);
+        }
+    }
+
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_lock;
+    std::string error;
+
+    auto worker = [&]() {
+        std::vector<uint8_t> staging;
+        try {
+            for (size_t c = next_chunk++; c < chunks.size() && !failed; c = next_chunk++) {
+                const Chunk& chunk = chunks[c];
+                const Tensor_Range& range = ranges[chunk.range];
+                const int fd = fds[range.file_index];
+                const int64_t file_offset = range.file_offset + chunk.begin;
+
+                if (range.src_dtype == range.dst_dtype) {
+                    read_fully(fd, dst + range.dst_offset + chunk.begin, chunk.n_bytes, file_offset);
+                    continue;
+                }
+
+                staging.resize(chunk_bytes);
+                read_fully(fd, staging.data(), chunk.n_bytes, file_offset);
+
+                const int64_t src_size = dtype_size(range.src_dtype);
+                const int64_t first = chunk.begin / src_size;
+                uint8_t* out = dst + range.dst_offset + first * dtype_size(range.dst_dtype);
+                for (int64_t i = 0; i < chunk.n_bytes / src_size; i++) {
+                    store_float(out, i, range.dst_dtype, load_float(staging.data(), i, range.src_dtype));
+                }
+            }
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> guard(error_lock);
+            if (!failed.exchange(true)) error = e.what();
+        }
+    };
+
+    n_threads = std::max(1, std::min<int>(n_threads, (int)chunks.size()));
+    std::vector<std::thread> threads;
+    for (int t = 1; t < n_threads; t++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+
+    close_all();
+    if (failed) throw std::runtime_error(error);
+}
@@ -0,0 +1,44 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import torch
+
+from deepspeed.accelerator import get_accelerator
+
+# Size of one arena chunk. Large enough for the batch metadata mirrors of typical engine
+# configurations; larger mirrors get a chunk of their own.
+HOST_STAGING_CHUNK_BYTES = 32 * 2**20
+
+_host_staging_arena = None
+
+
+def host_staging_arena():
+    """
+    Process wide arena that backs the host mirrors of the batch metadata. Chunks are pinned
+    unless the accelerator is the host itself, in which case the CPU build of the ragged utils
+    provides plain host chunks.
+    """
+    global _host_staging_arena
+    if _host_staging_arena is None:
+        pinned = not get_accelerator().is_synchronized_device()
+        utils = get_accelerator().create_op_builder("RaggedUtilsBuilder").load()
+        _host_staging_arena = utils.HostStagingArena(HOST_STAGING_CHUNK_BYTES, pinned)
+    return _host_staging_arena
+
+
+def reset_host_staging_arena(huge_pages: bool = False) -> None:
+    """
+    Rewind the arena before the mirrors of a new engine are allocated. Chunks still used by the
+    mirrors of a live engine are not reused.
+    """
+    host_staging_arena().reset(huge_pages)
+
+
+def allocate_host_mirror(device_mirror: torch.Tensor) -> torch.Tensor:
+    """
+    Allocate a zeroed host tensor with the shape and dtype of ``device_mirror`` from the arena,
+    for fast host -> accelerator copies of per batch metadata.
+    """
+    return host_staging_arena().allocate(device_mirror)
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*
+Packs a set of buffers into a single arena, allowing two buffers to share bytes when their
+lifetimes never overlap. Each buffer may be live over several disjoint step ranges (a module
+output is rewritten once per layer), so the conflict graph is built on sets of intervals
+rather than single intervals.
+
+Buffers are placed largest first at the lowest-waste aligned offset that does not collide
+with an already placed, conflicting buffer (greedy interval-graph coloring on offsets).
+
+Arguments:
+    sizes: Size in bytes of each buffer.
+    interval_owner: For every live range, the index of the buffer it belongs to.
+    interval_start: First step (inclusive) of every live range.
+    interval_end: Last step (inclusive) of every live range.
+    alignment: Alignment in bytes of every placed offset. Must be a power of two.
+    offsets: Output, the byte offset of each buffer within the arena.
+
+Returns:
+    The arena size in bytes.
+*/
+int64_t plan_activation_arena(const std::vector<int64_t>& sizes,
+                              const std::vector<int64_t>& interval_owner,
+                              const std::vector<int64_t>& interval_start,
+                              const std::vector<int64_t>& interval_end,
+                              int64_t alignment,
+                              std::vector<int64_t>& offsets);
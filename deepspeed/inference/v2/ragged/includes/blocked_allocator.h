@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <torch/extension.h>
+
+/*
+Returns a batch of blocks to the free list of a BlockedAllocator in one pass. `links` is the
+allocator's int32 host array of next pointers, where -1 marks a used block, and `head` is the
+current head of the free list. The blocks are pushed in order, so the last block of the batch
+becomes the new head, which is returned.
+
+Every block is validated before the list is modified: a block out of range, already free or
+repeated in the batch raises a ValueError and leaves the allocator untouched.
+*/
+int64_t free_blocks(torch::Tensor& links, int64_t head, torch::Tensor& blocks);
@@ -12,3 +12,14 @@ Wrapper around cudaHostAlloc with some specific flags. Returns a pointer to the
 memory region of `size` bytes.
 */
 void* get_cuda_fast_buffer(int64_t size);
+
+// Releases a buffer returned by get_cuda_fast_buffer.
+void free_cuda_fast_buffer(void* buffer_ptr);
+
+/*
+Page-locks an existing host allocation (e.g. a huge page mapping) so that it can be the source
+of asynchronous host -> accelerator copies. Returns false if the driver refused.
+*/
+bool register_cuda_host_buffer(void* buffer_ptr, int64_t size);
+
+void unregister_cuda_host_buffer(void* buffer_ptr);
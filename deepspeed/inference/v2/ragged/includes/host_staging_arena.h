@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <torch/extension.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+Bump allocator for the host mirrors of the ragged batch metadata. Instead of one pinned
+allocation per mirror, the mirrors are carved out of a few large chunks, each a single pinned
+(write-combined) allocation or, with huge pages, one huge page mapping that is registered with
+the driver. Without pinning the chunks are plain host mappings, for accelerators that stage on
+the host. CPU builds (__DISABLE_CUDA__) only support the unpinned arena.
+
+Every mirror is aligned to `alignment` bytes and holds a reference to its chunk, so a chunk is
+only released once the arena and all mirrors carved from it are gone. `reset` rewinds the arena
+for a new engine: chunks that are no longer referenced by any mirror are reused, the others
+are left to their mirrors.
+*/
+class HostStagingArena {
+public:
+    static constexpr int64_t alignment = 256;
+
+    HostStagingArena(int64_t chunk_bytes, bool pinned, bool huge_pages);
+
+    // Zero-initialized contiguous host tensor with the shape and dtype of `device_mirror`.
+    torch::Tensor allocate(torch::Tensor device_mirror);
+
+    void reset(bool huge_pages);
+
+    int64_t used_bytes() const { return used_bytes_; }
+
+    int64_t reserved_bytes() const;
+
+    bool pinned() const { return pinned_; }
+
+    bool huge_pages() const { return huge_pages_; }
+
+private:
+    struct Chunk;
+
+    std::shared_ptr<Chunk> new_chunk(int64_t min_bytes) const;
+
+    const int64_t chunk_bytes_;
+    const bool pinned_;
+    bool huge_pages_;
+
+    std::vector<std::shared_ptr<Chunk>> chunks_;
+    size_t current_chunk_;
+    int64_t offset_;
+    int64_t used_bytes_;
+};
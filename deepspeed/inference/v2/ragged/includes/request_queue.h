@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <torch/extension.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/*
+Bounded lock-free multi-producer, single-consumer queue of (uid, tokens) requests (Vyukov's
+bounded queue with per-slot sequence numbers). Tokens are copied into a row of a caller
+provided host buffer, which is normally pinned so the batch can be staged to the accelerator
+without another copy.
+
+Any number of frontend threads may call try_push concurrently. Only the engine loop may call
+the consumer methods (ready, uid, tokens, pop). The consumer peeks at the first `ready()`
+requests without dequeuing them and releases their slots with `pop` once their tokens have
+been consumed.
+*/
+class RequestQueue {
+public:
+    // token_buffer: [capacity, max_request_tokens] int64 host tensor, capacity a power of two.
+    explicit RequestQueue(torch::Tensor token_buffer);
+
+    // Returns false without blocking if the queue is full or the request is too long. A request
+    // without tokens is passed through as is, callers may use it as a control message.
+    bool try_push(int64_t uid, torch::Tensor tokens);
+
+    // Number of requests at the head of the queue that are fully written, at most `limit`.
+    int64_t ready(int64_t limit) const;
+
+    int64_t uid(int64_t index) const;
+
+    // View of the tokens of a ready request, valid until it is popped.
+    torch::Tensor tokens(int64_t index) const;
+
+    void pop(int64_t n_requests);
+
+    int64_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        int64_t uid;
+        int64_t n_tokens;
+    };
+
+    const Slot& slot_at(int64_t index) const;
+
+    torch::Tensor token_buffer_;
+    int64_t capacity_;
+    int64_t max_request_tokens_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<uint64_t> enqueue_pos_;
+    alignas(64) uint64_t dequeue_pos_;
+};
+
+/*
+Single-producer, single-consumer ring of fixed-size completion records (for example a row of
+logits). The engine loop pushes and a frontend pops, and neither side ever waits for the other:
+try_push fails when the frontend has fallen `depth` completions behind.
+*/
+class CompletionRing {
+public:
+    // slots: [depth, ...] host tensor, depth a power of two. Each record is one slots[i].
+    explicit CompletionRing(torch::Tensor slots);
+
+    bool try_push(torch::Tensor record);
+
+    bool try_pop(torch::Tensor out);
+
+    int64_t size() const;
+
+private:
+    torch::Tensor slots_;
+    uint64_t depth_;
+    int64_t record_bytes_;
+
+    alignas(64) std::atomic<uint64_t> head_;
+    alignas(64) std::atomic<uint64_t> tail_;
+};
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <torch/extension.h>
+#include <vector>
+
+/*
+Builds a tensor-parallel shard of `src` by concatenating the segments
+[starts[i], starts[i] + lengths[i]) of dimension `dim`, in order. The shard is allocated once
+and every segment is copied straight from the source, so fused parameters (QKV, gated MLP) and
+GQA layouts need no per-matrix intermediates. Host tensors are copied with a single parallel
+loop over (leading index, segment) blocks.
+*/
+torch::Tensor gather_shard_segments(torch::Tensor& src,
+                                    int64_t dim,
+                                    std::vector<int64_t> starts,
+                                    std::vector<int64_t> lengths);
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation.
+// SPDX-License-Identifier: Apache-2.0
+
+// DeepSpeed Team
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Element types the loader can convert between. Raw ranges are copied byte for byte.
+enum class Range_Dtype : int64_t { Raw = 0, Float = 1, Half = 2, BFloat16 = 3 };
+
+struct Tensor_Range {
+    int64_t file_index;
+    int64_t file_offset;
+    int64_t n_bytes;  // Size of the range in the file
+    Range_Dtype src_dtype;
+    int64_t dst_offset;
+    Range_Dtype dst_dtype;
+};
+
+/*
+Reads byte ranges of a set of files into a single host buffer. Every range is split into
+chunks of at most `chunk_bytes` and the chunks of all ranges and files are read with `pread`
+by `n_threads` workers, so a load of many shards keeps several requests in flight. When the
+source and destination dtypes differ, each chunk is read into a per-thread staging buffer and
+converted while it is still in cache.
+
+Throws std::runtime_error if a file cannot be opened or is shorter than a requested range.
+*/
+void load_tensor_ranges(const std::vector<std::string>& paths,
+                        const std::vector<Tensor_Range>& ranges,
+                        uint8_t* dst,
+                        int n_threads,
+                        int64_t chunk_bytes);
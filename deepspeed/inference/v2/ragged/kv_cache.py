@@ -152,7 +152,7 @@ class BlockedKVCache:
         """
         return self._allocators[cache_group].allocate(num_blocks)
 
-    def free(self, blocks: Iterable[int], cache_group: int = 0) -> None:
+    def free(self, blocks: Iterable[int], cache_group: int = 0, fill: Optional[float] = None) -> None:
         """
         Free a set of blocks from the cache. This will mark the blocks as free in the
         allocator.
@@ -160,9 +160,17 @@ class BlockedKVCache:
         Parameters:
             blocks (Iterable[int]): The blocks to free.
             cache_group (int): The cache group to free from. Default is 0.
+            fill (Optional[float]): If set, the freed blocks of every cache in the group are
+                filled with this value. Intended for debugging.
         """
         self._allocators[cache_group].free(blocks)
 
+        if fill is not None:
+            if not isinstance(blocks, torch.Tensor):
+                blocks = torch.tensor([blocks] if isinstance(blocks, int) else list(blocks), dtype=torch.int64)
+            block_ids = blocks.to(device=self._caches[cache_group].device, dtype=torch.int64)
+            self._caches[cache_group].index_fill_(1, block_ids, fill)
+
     def offload(self, blocks: Iterable[int], cache_group: int = 0) -> torch.Tensor:
         """
         Offload KV-cache blocks from accelerator memory to the host.
@@ -4,7 +4,7 @@
 # DeepSpeed Team
 
 from enum import Enum
-from typing import Tuple
+from typing import Optional, Tuple
 
 from deepspeed.pydantic_v1 import PositiveInt, validator
 
@@ -134,6 +134,22 @@ class MemoryConfig(DeepSpeedConfigModel):
     """
 
 
+class KVReclaimFill(Enum):
+    """
+    Debug fill of the KV-cache blocks reclaimed from flushed sequences.
+    """
+
+    ZERO = "zero"
+    """
+    Zero the reclaimed blocks.
+    """
+
+    POISON = "poison"
+    """
+    Fill the reclaimed blocks with NaN, so reads of a freed block show up in the outputs.
+    """
+
+
 class DSStateManagerConfig(DeepSpeedConfigModel):
 
     max_tracked_sequences: PositiveInt = 2048
@@ -173,6 +189,18 @@ class DSStateManagerConfig(DeepSpeedConfigModel):
     Enable tracking for offloading KV-cache to host memory. Currently unsupported.
     """
 
+    kv_reclaim_fill: Optional[KVReclaimFill] = None
+    """
+    Fill the KV-cache blocks of flushed sequences when they are reclaimed. A debugging aid that
+    costs one fill per reclaimed batch, disabled by default.
+    """
+
+    host_staging_huge_pages: bool = False
+    """
+    Back the host mirrors of the batch metadata with huge pages. Falls back to transparent huge
+    pages if no huge pages are reserved.
+    """
+
     @validator("max_ragged_sequence_count")
     def max_ragged_sequence_count_validator(cls, v: int, values: dict):
         # If the attributes below failed their validation they won't appear in the values dict.
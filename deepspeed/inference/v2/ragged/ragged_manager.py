@@ -4,15 +4,15 @@
 # DeepSpeed Team
 
 import torch
-from typing import Any, Dict, Optional, Tuple
+from typing import Any, Dict, List, Optional, Tuple
 
 from deepspeed.accelerator import get_accelerator
-from deepspeed.ops.op_builder import RaggedUtilsBuilder
 from deepspeed.utils.logging import logger
 
 from .blocked_allocator import BlockedAllocator
+from .host_staging import allocate_host_mirror
 from .kv_cache import BlockedKVCache
-from .manager_configs import DSStateManagerConfig, KVCacheConfig
+from .manager_configs import DSStateManagerConfig, KVCacheConfig, KVReclaimFill
 from .sequence_descriptor import DSSequenceDescriptor
 
 
@@ -47,6 +47,12 @@ class DSStateManager:
     TODO(cmikeh2): Evaluate if this has any performance implications.
     """
 
+    _pending_flushes: List[DSSequenceDescriptor]
+    """
+    Sequences flushed with ``enqueue_flush`` whose tracking slot and KV blocks are reclaimed by
+    the next ``reclaim_flushed``.
+    """
+
     # Allocator for tracking sequences.
     _tracking_allocator: BlockedAllocator
     _all_block_ids: Tuple[torch.Tensor, ...]
@@ -65,9 +71,6 @@ class DSStateManager:
         self._config = config
         self._kv_configs = kv_configs
 
-        # Load our helpers for host allocation.
-        self._ragged_utils = RaggedUtilsBuilder().load()
-
         # Initialize the allocator for tracking sequences (so this doesn't need to be ad-hoc).
         self._tracking_allocator = BlockedAllocator(self._config.max_tracked_sequences)
 
@@ -83,13 +86,14 @@ class DSStateManager:
             )
 
             all_block_ids.append(torch.zeros(ids_shape, dtype=torch.int32, device=get_accelerator().current_device()))
-            all_block_ids_shadow.append(self._ragged_utils.allocate_fast_host_buffer(all_block_ids[-1]))
+            all_block_ids_shadow.append(allocate_host_mirror(all_block_ids[-1]))
 
         self._all_block_ids = tuple(all_block_ids)
         self._all_block_ids_shadow = tuple(all_block_ids_shadow)
 
         # Initialize the sequence container.
         self._seqs = {}
+        self._pending_flushes = []
 
         # Finally initialize the KV cache.
         self._kv_cache = BlockedKVCache(self._kv_configs,
@@ -117,11 +121,45 @@ class DSStateManager:
 
         seq = self._seqs[uid]
         for i in range(self.n_kv_cache_groups):
-            self._kv_cache.free(seq.all_block_ids(cache_group=i), cache_group=i)
+            self._kv_cache.free(seq.all_block_ids(cache_group=i), cache_group=i, fill=self._reclaim_fill())
 
         self._tracking_allocator.free(seq.tracking_id)
         del self._seqs[uid]
 
+    def enqueue_flush(self, uid: int) -> None:
+        """
+        Retire the given sequence without freeing its resources yet. The uid is released
+        immediately (it may be reused by a new sequence), while the tracking slot and KV blocks
+        stay reserved until the next ``reclaim_flushed``, which frees the blocks of every retired
+        sequence in one call per cache group.
+        """
+        seq = self._seqs.pop(uid, None)
+        if seq is None:
+            logger.warning(f"Attempting to flush sequence {uid} which does not exist.")
+            return
+
+        self._pending_flushes.append(seq)
+
+    def reclaim_flushed(self) -> None:
+        """
+        Free the resources of all sequences retired with ``enqueue_flush``. Should be called at step
+        boundaries, before the next batch is scheduled.
+        """
+        if not self._pending_flushes:
+            return
+
+        for i in range(self.n_kv_cache_groups):
+            blocks = torch.cat([seq.all_block_ids(cache_group=i) for seq in self._pending_flushes])
+            self._kv_cache.free(blocks, cache_group=i, fill=self._reclaim_fill())
+
+        self._tracking_allocator.free(torch.tensor([seq.tracking_id for seq in self._pending_flushes]))
+        self._pending_flushes = []
+
+    def _reclaim_fill(self) -> Optional[float]:
+        if self._config.kv_reclaim_fill is None:
+            return None
+        return float("nan") if self._config.kv_reclaim_fill == KVReclaimFill.POISON else 0.0
+
     def get_sequence(self, uid: int) -> Optional[DSSequenceDescriptor]:
         """
         Get the sequence descriptor for the given sequence id. If the sequence does not exist,
@@ -177,9 +215,10 @@ class DSStateManager:
     @property
     def n_tracked_sequences(self) -> int:
         """
-        Return the number of sequences currently tracked.
+        Return the number of sequences currently tracked, including flushed sequences that have
+        not been reclaimed.
         """
-        return len(self._seqs)
+        return len(self._seqs) + len(self._pending_flushes)
 
     @property
     def kv_block_size(self) -> int:
@@ -8,8 +8,8 @@ from typing import Optional
 import torch
 
 from deepspeed.accelerator import get_accelerator
-from deepspeed.ops.op_builder import RaggedUtilsBuilder
 
+from .host_staging import allocate_host_mirror
 from .sequence_descriptor import DSSequenceDescriptor
 from .manager_configs import DSStateManagerConfig
 
@@ -101,8 +101,7 @@ class RaggedBatchWrapper:
                                     dtype=torch.int64,
                                     device=get_accelerator().current_device())
 
-        self._utils_module = RaggedUtilsBuilder().load()
-        host_alloc = self._utils_module.allocate_fast_host_buffer
+        host_alloc = allocate_host_mirror
 
         self._input_ids_shadow = host_alloc(self._input_ids)
         self._batch_metadata_storage_shadow = host_alloc(self._batch_metadata_storage)
@@ -0,0 +1,209 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from collections import deque
+from typing import Deque, Dict, List, Optional, Tuple
+
+import torch
+
+from deepspeed.accelerator import get_accelerator
+from deepspeed.ops.op_builder import RaggedUtilsBuilder
+
+from .engine_v2 import InferenceEngineV2
+from .scheduling_utils import SchedulingResult
+
+
+class RaggedRequestQueue:
+    """
+    Lock-free submission layer in front of ``InferenceEngineV2.put``.
+
+    Frontend threads (tokenizers, HTTP handlers) call ``submit`` and ``poll`` concurrently
+    without any Python-level lock. Requests go into a native multi-producer, single-consumer
+    queue whose token rows live in pinned host memory. The engine loop calls ``step``, which
+    drains as many requests as fit in one ragged batch, runs the forward and pushes the logits of
+    each sequence into that sequence's single-producer, single-consumer completion ring. When a
+    frontend falls behind and its ring is full, the completion is held by the engine loop and
+    retried on the next step, so the decode loop never waits on a frontend.
+
+    Only the thread that calls ``step`` may touch the engine.
+    """
+
+    def __init__(self, engine: InferenceEngineV2, capacity: int = 1024, completion_depth: int = 4) -> None:
+        """
+        Arguments:
+            engine (InferenceEngineV2): The engine to feed.
+            capacity (int): Maximum number of queued requests. Must be a power of two.
+            completion_depth (int): Number of completions buffered per sequence. Must be a power
+                of two.
+        """
+        self._engine = engine
+        self._manager_config = engine._config.state_manager
+        self._completion_depth = completion_depth
+
+        self._utils = RaggedUtilsBuilder().load()
+        token_buffer = torch.zeros((capacity, self._manager_config.max_ragged_batch_size), dtype=torch.int64)
+        self._queue = self._utils.RequestQueue(get_accelerator().pin_memory(token_buffer))
+
+        # Created by the engine loop on the first completion of a sequence, read by frontends.
+        self._rings: Dict[int, object] = {}
+        self._pending: Dict[int, Deque[torch.Tensor]] = {}
+
+    def submit(self, uid: int, tokens: torch.Tensor) -> bool:
+        """
+        Queue tokens for a sequence. Safe to call from any thread.
+
+        Returns:
+            bool: False if the queue is full or the request has more tokens than fit in one
+                ragged batch. The request is not queued in that case.
+        """
+        if tokens.numel() == 0:
+            raise ValueError("Cannot submit a request without tokens")
+        return self._queue.try_push(uid, tokens)
+
+    def close(self, uid: int) -> bool:
+        """
+        Ask the engine loop to flush a sequence once its queued requests have been served. Any
+        completion that has not been polled by then is dropped. Safe to call from any thread.
+
+        Returns:
+            bool: False if the queue is full.
+        """
+        return self._queue.try_push(uid, torch.empty((0, ), dtype=torch.int64))
+
+    def poll(self, uid: int) -> Optional[torch.Tensor]:
+        """
+        Return the next completion (logits row) of a sequence, or None if there is none yet.
+        Safe to call from any thread, but each sequence must be polled by a single thread.
+        """
+        entry = self._rings.get(uid)
+        if entry is None:
+            return None
+        ring, record = entry
+        out = torch.empty_like(record)
+        return out if ring.try_pop(out) else None
+
+    def _deliver(self, uid: int, completion: torch.Tensor) -> None:
+        entry = self._rings.get(uid)
+        if entry is None:
+            slots = torch.empty((self._completion_depth, *completion.shape), dtype=completion.dtype)
+            entry = (self._utils.CompletionRing(slots), slots[0])
+            self._rings[uid] = entry
+
+        pending = self._pending.get(uid)
+        if pending is None and entry[0].try_push(completion):
+            return
+        if pending is None:
+            pending = self._pending[uid] = deque()
+        pending.append(completion.clone())
+
+    def _retry_pending(self) -> None:
+        for uid in list(self._pending.keys()):
+            pending = self._pending[uid]
+            ring = self._rings[uid][0]
+            while pending and ring.try_push(pending[0]):
+                pending.popleft()
+            if not pending:
+                del self._pending[uid]
+
+    def _flush(self, uids: List[int]) -> None:
+        self._engine.flush_batch(uids)
+        for uid in uids:
+            self._rings.pop(uid, None)
+            self._pending.pop(uid, None)
+
+    def _schedulable_prefix(self, uids: List[int], tokens: List[torch.Tensor]) -> int:
+        """
+        Length of a prefix of the candidates the engine can schedule, halved until it fits.
+        """
+        n_candidates = len(uids)
+        while n_candidates > 0:
+            lengths = [t.numel() for t in tokens[:n_candidates]]
+            if self._engine.can_schedule(uids[:n_candidates], lengths) == SchedulingResult.Success:
+                break
+            n_candidates //= 2
+        return n_candidates
+
+    def _is_idle_except(self, uid: int) -> bool:
+        state_manager = self._engine._state_manager
+        n_others = state_manager.n_tracked_sequences
+        if state_manager.get_sequence(uid) is not None:
+            n_others -= 1
+        return n_others == 0
+
+    def step(self) -> int:
+        """
+        Run one engine step on the queued requests. Must only be called from the engine loop.
+
+        Returns:
+            int: The number of requests consumed from the queue, including flushes.
+
+        Raises:
+            RuntimeError: If the first queued request cannot be scheduled although the engine
+                holds no other sequence, so it never will be. The request is dropped from the
+                queue after the rest of the step ran, and the next step carries on behind it.
+        """
+        self._retry_pending()
+
+        max_tokens = self._manager_config.max_ragged_batch_size
+        max_sequences = self._manager_config.max_ragged_sequence_count
+
+        uids: List[int] = []
+        tokens: List[torch.Tensor] = []
+        consumed: List[Tuple[int, bool]] = []
+        flushed = set()
+        n_tokens = 0
+
+        n_ready = self._queue.ready(self._queue.capacity)
+        for i in range(n_ready):
+            uid = self._queue.uid(i)
+            request_tokens = self._queue.tokens(i)
+
+            if uid in uids or uid in flushed:
+                # A sequence may only appear once per batch and flushes run after the forward, so
+                # later requests of the sequence wait for the next step.
+                break
+
+            if request_tokens.numel() == 0:
+                consumed.append((uid, True))
+                flushed.add(uid)
+                continue
+
+            if len(uids) == max_sequences or n_tokens + request_tokens.numel() > max_tokens:
+                break
+
+            uids.append(uid)
+            tokens.append(request_tokens)
+            consumed.append((uid, False))
+            n_tokens += request_tokens.numel()
+
+        n_scheduled = self._schedulable_prefix(uids, tokens)
+        rejected = None
+        if n_scheduled == 0 and uids and self._is_idle_except(uids[0]):
+            rejected = uids[0]
+        if n_scheduled < len(uids):
+            # Cut the consumed requests right before the first one that does not fit.
+            n_seen = 0
+            for idx, (_, is_flush) in enumerate(consumed):
+                if not is_flush:
+                    if n_seen == n_scheduled:
+                        consumed = consumed[:idx]
+                        break
+                    n_seen += 1
+            uids, tokens = uids[:n_scheduled], tokens[:n_scheduled]
+
+        if uids:
+            logits = self._engine.put(uids, tokens, do_checks=False).cpu()
+            for row, uid in enumerate(uids):
+                self._deliver(uid, logits[row])
+
+        self._flush([uid for uid, is_flush in consumed if is_flush])
+
+        if rejected is not None:
+            # The rejected request sits right behind the consumed flushes.
+            self._queue.pop(len(consumed) + 1)
+            raise RuntimeError(f"Request of sequence {rejected} cannot be scheduled even on an idle engine")
+
+        self._queue.pop(len(consumed))
+        return len(consumed)
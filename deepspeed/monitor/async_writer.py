@@ -0,0 +1,104 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import atexit
+import threading
+
+from deepspeed.accelerator import get_accelerator
+from deepspeed.utils import logger
+
+metrics_ring_module = None
+
+
+def load_metrics_ring():
+    global metrics_ring_module
+    if metrics_ring_module is None:
+        metrics_ring_module = get_accelerator().create_op_builder("MetricsRingBuilder").load()
+    return metrics_ring_module
+
+
+class AsyncMetricsWriter(object):
+    """Moves the writes of monitor events off the training thread.
+
+    ``write_events`` only enqueues (tag, value, step) events into a bounded native ring buffer,
+    which costs a lock-free compare-and-swap per event. A background thread drains the ring every
+    ``flush_interval`` seconds and hands the events to the sinks in one ``write_events`` call per
+    drain, so the sinks open, write and flush their files once per interval instead of once per
+    step. When the writer falls behind and the ring is full, new events are dropped and counted
+    rather than blocking training.
+
+    Values are converted with ``float``, so they should already be on the host: a device tensor
+    would synchronize the accelerator on enqueue.
+
+    Args:
+        sinks (list): Objects with a ``write_events(event_list)`` method, e.g. ``Monitor``s.
+        capacity (int): Number of events the ring can hold. Must be a power of two.
+        flush_interval (float): Seconds between two drains of the ring.
+    """
+
+    def __init__(self, sinks, capacity=65536, flush_interval=1.0):
+        self.sinks = list(sinks)
+        self.flush_interval = flush_interval
+        self.ring = load_metrics_ring().MetricsRing(capacity)
+        self.dropped_events = 0
+
+        # Tags are passed to the ring as ids. Only the first event of a new tag takes the lock.
+        self.tag_ids = {}
+        self.tag_names = []
+        self.tag_lock = threading.Lock()
+
+        # Serializes drains of the background thread and of explicit flushes.
+        self.drain_lock = threading.Lock()
+        self.stop_event = threading.Event()
+        self.drain_thread = threading.Thread(target=self._run, name="ds_metrics_writer", daemon=True)
+        self.drain_thread.start()
+        atexit.register(self.close)
+
+    def _tag_id(self, tag):
+        tag_id = self.tag_ids.get(tag)
+        if tag_id is None:
+            with self.tag_lock:
+                tag_id = self.tag_ids.get(tag)
+                if tag_id is None:
+                    # The name is visible to the writer before any event can carry its id.
+                    tag_id = len(self.tag_names)
+                    self.tag_names.append(tag)
+                    self.tag_ids[tag] = tag_id
+        return tag_id
+
+    def write_events(self, event_list):
+        for tag, value, step in event_list:
+            self.ring.push(self._tag_id(tag), float(value), int(step))
+
+    def _drain(self):
+        with self.drain_lock:
+            events, dropped = self.ring.drain(self.ring.capacity)
+            if dropped:
+                self.dropped_events += dropped
+                logger.warning(f"AsyncMetricsWriter dropped {dropped} events, the ring of {self.ring.capacity} "
+                               f"events filled up within {self.flush_interval}s")
+            if not events:
+                return
+            event_list = [(self.tag_names[tag], value, step) for tag, value, step in events]
+            for sink in self.sinks:
+                try:
+                    sink.write_events(event_list)
+                except Exception as e:
+                    logger.warning(f"AsyncMetricsWriter failed to write events to {type(sink).__name__}: {e}")
+
+    def _run(self):
+        while not self.stop_event.wait(self.flush_interval):
+            self._drain()
+
+    def flush(self):
+        """Write all events enqueued so far to the sinks before returning."""
+        self._drain()
+
+    def close(self):
+        """Stop the background thread and write the remaining events. Safe to call more than once."""
+        if not self.stop_event.is_set():
+            self.stop_event.set()
+            self.drain_thread.join()
+        self._drain()
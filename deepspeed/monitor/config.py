@@ -8,7 +8,7 @@ from deepspeed.runtime.config_utils import DeepSpeedConfigModel
 
 
 def get_monitor_config(param_dict):
-    monitor_dict = {key: param_dict.get(key, {}) for key in ("tensorboard", "wandb", "csv_monitor")}
+    monitor_dict = {key: param_dict.get(key, {}) for key in ("tensorboard", "wandb", "csv_monitor", "async_monitor")}
     return DeepSpeedMonitorConfig(**monitor_dict)
 
 
@@ -60,6 +60,22 @@ class CSVConfig(DeepSpeedConfigModel):
     """ Name for the current job. This will become a new directory inside `output_path`. """
 
 
+class AsyncMonitorConfig(DeepSpeedConfigModel):
+    """Sets parameters for writing monitor events from a background thread."""
+
+    enabled: bool = False
+    """
+    Whether the enabled monitors are written from a background thread. The training thread then
+    only enqueues events into a bounded buffer.
+    """
+
+    capacity: int = 65536
+    """ Number of events that can be buffered between two writes. Must be a power of two. """
+
+    flush_interval: float = 1.0
+    """ Seconds between two writes of the buffered events to the monitors. """
+
+
 class DeepSpeedMonitorConfig(DeepSpeedConfigModel):
     """Sets parameters for various monitoring methods."""
 
@@ -72,6 +88,9 @@ class DeepSpeedMonitorConfig(DeepSpeedConfigModel):
     csv_monitor: CSVConfig = {}
     """ Local CSV output of monitoring data. """
 
+    async_monitor: AsyncMonitorConfig = {}
+    """ Write the monitors above from a background thread. """
+
     @root_validator
     def check_enabled(cls, values):
         values["enabled"] = values.get("tensorboard").enabled or values.get("wandb").enabled or values.get(
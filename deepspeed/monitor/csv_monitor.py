@@ -4,6 +4,7 @@
 # DeepSpeed Team
 
 from .monitor import Monitor
+import atexit
 import os
 
 import deepspeed.comm as dist
@@ -14,10 +15,13 @@ class csvMonitor(Monitor):
     def __init__(self, csv_config):
         super().__init__(csv_config)
         self.filenames = []
+        self.files = {}
         self.enabled = csv_config.enabled
         self.output_path = csv_config.output_path
         self.job_name = csv_config.job_name
         self.log_dir = self.setup_log_dir()
+        if self.enabled:
+            atexit.register(self.close)
 
     def setup_log_dir(self, base=os.path.join(os.path.expanduser("~"), "csv_monitor")):
         if self.enabled and dist.get_rank() == 0:
@@ -58,10 +62,24 @@ class csvMonitor(Monitor):
                 filename = log_name.replace('/', '_').replace(' ', '_')
                 fname = self.log_dir + '/' + filename + '.csv'
 
-                # Open file and record event. Insert header if this is the first time writing
-                with open(fname, 'a+') as csv_monitor_file:
-                    csv_monitor_writer = csv.writer(csv_monitor_file)
-                    if filename not in self.filenames:
-                        self.filenames.append(filename)
-                        csv_monitor_writer.writerow(['step', header])
-                    csv_monitor_writer.writerow([step, value])
+                # Open file on first use and keep it open. Insert header if this is the first time writing
+                if filename not in self.files:
+                    csv_monitor_file = open(fname, 'a+')
+                    self.files[filename] = (csv_monitor_file, csv.writer(csv_monitor_file))
+                csv_monitor_file, csv_monitor_writer = self.files[filename]
+                if filename not in self.filenames:
+                    self.filenames.append(filename)
+                    csv_monitor_writer.writerow(['step', header])
+                csv_monitor_writer.writerow([step, value])
+
+            self.flush()
+
+    def flush(self):
+        for csv_monitor_file, _ in self.files.values():
+            csv_monitor_file.flush()
+
+    def close(self):
+        """Flush and close the open files. A later write_events opens them again."""
+        for csv_monitor_file, _ in self.files.values():
+            csv_monitor_file.close()
+        self.files.clear()
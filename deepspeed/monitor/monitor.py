@@ -24,6 +24,7 @@ class Monitor(ABC):
 from .wandb import WandbMonitor
 from .tensorboard import TensorBoardMonitor
 from .csv_monitor import csvMonitor
+from .async_writer import AsyncMetricsWriter
 
 
 class MonitorMaster(Monitor):
@@ -33,6 +34,7 @@ class MonitorMaster(Monitor):
         self.tb_monitor = None
         self.wandb_monitor = None
         self.csv_monitor = None
+        self.async_writer = None
         self.enabled = monitor_config.enabled
 
         if dist.get_rank() == 0:
@@ -43,8 +45,17 @@ class MonitorMaster(Monitor):
             if monitor_config.csv_monitor.enabled:
                 self.csv_monitor = csvMonitor(monitor_config.csv_monitor)
 
+            sinks = [m for m in (self.tb_monitor, self.wandb_monitor, self.csv_monitor) if m is not None]
+            if monitor_config.async_monitor.enabled and sinks:
+                self.async_writer = AsyncMetricsWriter(sinks,
+                                                       capacity=monitor_config.async_monitor.capacity,
+                                                       flush_interval=monitor_config.async_monitor.flush_interval)
+
     def write_events(self, event_list):
         if dist.get_rank() == 0:
+            if self.async_writer is not None:
+                self.async_writer.write_events(event_list)
+                return
             if self.tb_monitor is not None:
                 self.tb_monitor.write_events(event_list)
             if self.wandb_monitor is not None:
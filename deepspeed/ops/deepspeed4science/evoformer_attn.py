@@ -5,33 +5,40 @@
 
 import torch
 import numpy as np
-from deepspeed.ops.op_builder import EvoformerAttnBuilder
 from deepspeed.accelerator import get_accelerator
 
 kernel_ = None
 
 
+def _load_kernel():
+    global kernel_
+    if kernel_ is None:
+        kernel_ = get_accelerator().create_op_builder("EvoformerAttnBuilder").load()
+    return kernel_
+
+
 def _attention(Q, K, V, bias1, bias2):
-    assert Q.shape[-3] > 16, "seq_len must be greater than 16"
+    # the tiled CPU kernel has no minimum sequence length or maximum head size
+    if Q.device.type != 'cpu':
+        assert Q.shape[-3] > 16, "seq_len must be greater than 16"
     O = torch.empty_like(Q, dtype=Q.dtype)
     assert get_accelerator().on_accelerator(Q), "Q must be on cuda"
     assert get_accelerator().on_accelerator(K), "K must be on cuda"
     assert get_accelerator().on_accelerator(V), "V must be on cuda"
     assert get_accelerator().on_accelerator(bias1), "bias1 must be on cuda"
     assert get_accelerator().on_accelerator(bias2), "bias2 must be on cuda"
-    global kernel_
-    if kernel_ is None:
-        kernel_ = EvoformerAttnBuilder().load()
+    kernel = _load_kernel()
     nheads = Q.shape[-2]
     nq = (Q.shape[-3] + 31) // 32 * 32
     nb = np.prod(Q.shape[:-3])
     lse = torch.empty((nb, nheads, nq), dtype=torch.float32, device=Q.device)
-    kernel_.attention(Q, K, V, bias1, bias2, O, lse)
+    kernel.attention(Q, K, V, bias1, bias2, O, lse)
     return O, lse
 
 
 def attention_bwd(dO, Q, K, V, O, lse, bias1, bias2, bias1_grad, bias2_grad):
-    assert max(Q.shape[-1], V.shape[-1]) <= 64, "Hidden size is too large. Need to change kMax to a larger value"
+    if Q.device.type != 'cpu':
+        assert max(Q.shape[-1], V.shape[-1]) <= 64, "Hidden size is too large. Need to change kMax to a larger value"
     dQ = torch.empty_like(Q, dtype=Q.dtype)
     dK = torch.empty_like(K, dtype=K.dtype)
     dV = torch.empty_like(V, dtype=V.dtype)
@@ -40,9 +47,7 @@ def attention_bwd(dO, Q, K, V, O, lse, bias1, bias2, bias1_grad, bias2_grad):
     assert get_accelerator().on_accelerator(K), "K must be on cuda"
     assert get_accelerator().on_accelerator(V), "V must be on cuda"
     assert get_accelerator().on_accelerator(O), "O must be on cuda"
-    global kernel_
-    if kernel_ is None:
-        kernel_ = EvoformerAttnBuilder().load()
+    kernel = _load_kernel()
     delta = torch.empty_like(lse)
     if bias1_grad:
         dB1 = torch.zeros_like(bias1, dtype=torch.float32)
@@ -52,7 +57,7 @@ def attention_bwd(dO, Q, K, V, O, lse, bias1, bias2, bias1_grad, bias2_grad):
         dB2 = torch.zeros_like(bias2, dtype=torch.float32)
     else:
         dB2 = torch.tensor([], dtype=torch.float32, device=bias2.device)
-    kernel_.attention_bwd(dO, Q, K, V, O, lse, delta, bias1, bias2, dQ, dK, dV, dB1, dB2)
+    kernel.attention_bwd(dO, Q, K, V, O, lse, delta, bias1, bias2, dQ, dK, dV, dB1, dB2)
     return dQ, dK, dV, dB1.to(dO.dtype), dB2.to(dO.dtype)
 
 
@@ -0,0 +1,7 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .cpu_multi_tensor import (load_cpu_multi_tensor, multi_tensor_norm, multi_tensor_accumulate,
+                               multi_tensor_copy_to_bf16)
@@ -0,0 +1,74 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import torch
+
+from deepspeed.accelerator import get_accelerator
+
+# C++ module will be loaded on first use
+cpu_multi_tensor_module = None
+
+
+def load_cpu_multi_tensor():
+    """Returns the native multi-tensor module, or None if it cannot be built on this system."""
+    global cpu_multi_tensor_module
+    if cpu_multi_tensor_module is None:
+        builder = get_accelerator().create_op_builder("CPUMultiTensorBuilder")
+        if builder is not None and builder.is_compatible(verbose=False):
+            cpu_multi_tensor_module = builder.load()
+            from deepspeed.profiling.flops_profiler.native_profiler import attach_native_profiler
+            attach_native_profiler(cpu_multi_tensor_module)
+    return cpu_multi_tensor_module
+
+
+def is_multi_tensor_eligible(tensors):
+    return all(t.device.type == 'cpu' and t.dtype == torch.float32 and t.is_contiguous() for t in tensors)
+
+
+def multi_tensor_norm(tensors, norm_type=2.0):
+    """Computes the norm of the concatenation of a list of CPU fp32 tensors in a single native call.
+
+    Arguments:
+        tensors (list of Tensor): contiguous CPU fp32 tensors.
+        norm_type (float): 2.0 for the L2 norm, ``inf`` for the max absolute value.
+
+    Returns:
+        (norm, inf_or_nan): the global norm as a python float, and whether any element is inf or nan.
+    """
+    module = load_cpu_multi_tensor()
+    assert module is not None, "cpu_multi_tensor op is not compatible with this system"
+    return module.multi_tensor_norm(tensors, float(norm_type))
+
+
+def multi_tensor_accumulate(dst_tensors, src_tensors, accumulate=True, compute_norm=False):
+    """Copies or adds a list of CPU gradients into fp32 tensors in a single native call.
+
+    Arguments:
+        dst_tensors (list of Tensor): contiguous CPU fp32 tensors, updated in place.
+        src_tensors (list of Tensor): contiguous CPU fp32/fp16/bf16 tensors of matching sizes.
+        accumulate (bool): add into ``dst_tensors`` if True, overwrite them otherwise.
+        compute_norm (bool): also return the squared L2 norm of every updated tensor.
+
+    Returns:
+        (sum_sq, inf_or_nan): list of squared norms (empty unless ``compute_norm``), and whether any
+        updated element is inf or nan.
+    """
+    module = load_cpu_multi_tensor()
+    assert module is not None, "cpu_multi_tensor op is not compatible with this system"
+    return module.multi_tensor_accumulate(dst_tensors, src_tensors, accumulate, compute_norm)
+
+
+def multi_tensor_copy_to_bf16(dst_tensors, src_tensors, stochastic_rounding=False, seed=0):
+    """Copies a list of CPU fp32 tensors into bf16 tensors in a single native call.
+
+    Arguments:
+        dst_tensors (list of Tensor): contiguous CPU bf16 tensors, overwritten in place.
+        src_tensors (list of Tensor): contiguous CPU fp32 tensors of matching sizes.
+        stochastic_rounding (bool): round stochastically instead of to nearest even.
+        seed (int): seed of the rounding noise. The same seed gives the same result for any number of threads.
+    """
+    module = load_cpu_multi_tensor()
+    assert module is not None, "cpu_multi_tensor op is not compatible with this system"
+    module.multi_tensor_copy_to_bf16(dst_tensors, src_tensors, stochastic_rounding, seed)
@@ -5,7 +5,7 @@
 
 from typing import Optional
 import torch
-from deepspeed.ops.op_builder import SpatialInferenceBuilder
+from deepspeed.accelerator import get_accelerator
 
 spatial_cuda_module = None
 
@@ -16,7 +16,7 @@ def nhwc_bias_add(activation: torch.Tensor,
                   other_bias: Optional[torch.Tensor] = None) -> torch.Tensor:
     global spatial_cuda_module
     if spatial_cuda_module is None:
-        spatial_cuda_module = SpatialInferenceBuilder().load()
+        spatial_cuda_module = get_accelerator().create_op_builder("SpatialInferenceBuilder").load()
 
     if other is None:
         return spatial_cuda_module.nhwc_bias_add(activation, bias)
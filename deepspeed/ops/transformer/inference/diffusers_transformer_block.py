@@ -10,7 +10,8 @@ from deepspeed import module_inject
 from .diffusers_attention import DeepSpeedDiffusersAttention
 from .bias_add import nhwc_bias_add
 from .diffusers_2d_transformer import Diffusers2DTransformerConfig
-from deepspeed.ops.op_builder import InferenceBuilder, SpatialInferenceBuilder
+from deepspeed.ops.op_builder import InferenceBuilder
+from deepspeed.accelerator import get_accelerator
 from deepspeed.utils.types import ActivationFuncType
 
 # Ops will be loaded on demand
@@ -28,7 +29,7 @@ def load_transformer_module():
 def load_spatial_module():
     global spatial_cuda_module
     if spatial_cuda_module is None:
-        spatial_cuda_module = SpatialInferenceBuilder().load()
+        spatial_cuda_module = get_accelerator().create_op_builder("SpatialInferenceBuilder").load()
     return spatial_cuda_module
 
 
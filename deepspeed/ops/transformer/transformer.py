@@ -9,7 +9,6 @@ import torch
 from torch import nn
 from torch.autograd import Function
 from deepspeed.accelerator import get_accelerator
-from deepspeed.ops.op_builder import TransformerBuilder, StochasticTransformerBuilder
 
 # Cuda modules will be imported if needed
 transformer_cuda_module = None
@@ -360,11 +359,14 @@ class DeepSpeedTransformerLayer(nn.Module):
         # Load cuda modules if needed
         global transformer_cuda_module, stochastic_transformer_cuda_module
         if transformer_cuda_module is None and not self.config.stochastic_mode:
-            transformer_cuda_module = TransformerBuilder().load()
+            transformer_cuda_module = get_accelerator().create_op_builder("TransformerBuilder").load()
         if stochastic_transformer_cuda_module is None and self.config.stochastic_mode:
-            stochastic_transformer_cuda_module = StochasticTransformerBuilder().load()
+            stochastic_transformer_cuda_module = get_accelerator().create_op_builder(
+                "StochasticTransformerBuilder").load()
 
         # create the layer in cuda kernels.
+        if get_accelerator().device_name() == 'cpu':
+            assert not self.config.fp16, "The CPU transformer kernels only support fp32"
         cuda_module = stochastic_transformer_cuda_module if self.config.stochastic_mode else transformer_cuda_module
         create_layer_func = cuda_module.create_transformer_layer_fp16 if self.config.fp16 else cuda_module.create_transformer_layer_fp32
 
@@ -4,3 +4,4 @@
 # DeepSpeed Team
 
 from .profiler import *
+from .native_profiler import NativeFlopsProfiler
@@ -0,0 +1,213 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import threading
+from collections import OrderedDict
+
+import torch
+import torch.nn as nn
+
+from deepspeed.accelerator import get_accelerator
+from deepspeed.utils import logger
+
+# Op ids of module and kernel events, see csrc/includes/ds_profiler.h
+MODULE_OP = 0
+KERNEL_OPS = {1: 'multi_tensor_norm', 2: 'multi_tensor_accumulate', 3: 'multi_tensor_copy_to_bf16'}
+
+# C++ module will be loaded on first use
+native_profiler_module = None
+
+# Loaded extensions whose kernels record events
+attached_ops = []
+
+
+def load_native_profiler():
+    global native_profiler_module
+    if native_profiler_module is None:
+        native_profiler_module = get_accelerator().create_op_builder("NativeProfilerBuilder").load()
+        for op in attached_ops:
+            op.profile_attach(native_profiler_module.recorder())
+    return native_profiler_module
+
+
+def attach_native_profiler(op):
+    """Makes the kernels of a loaded extension record into the native profiler.
+
+    Extensions are loaded with their own copy of the recorder pointer of ``ds_profiler.h``, which stays
+    unset until the profiler's recorder is passed to the ``profile_attach`` binding of the extension.
+    The profiler itself is not loaded here, extensions attached before it are attached when it loads.
+    """
+    if op in attached_ops:
+        return
+    attached_ops.append(op)
+    if native_profiler_module is not None:
+        op.profile_attach(native_profiler_module.recorder())
+
+
+def _leaf_flops(module, output):
+    if not isinstance(output, torch.Tensor):
+        return 0
+    if isinstance(module, nn.Linear):
+        return 2 * output.numel() * module.in_features
+    if isinstance(module, (nn.Conv1d, nn.Conv2d, nn.Conv3d)):
+        return 2 * output.numel() * module.weight[0].numel()
+    return 0
+
+
+class NativeFlopsProfiler(object):
+    """Continuously measures the latency and flops of the modules of a model at low overhead.
+
+    Unlike ``FlopsProfiler``, no hooks are installed on the individual modules and no functionals are
+    patched. A single global forward pre/post hook pair forwards module boundaries to a native
+    recorder, which keeps a lock-free ring buffer of events per thread. Native kernels record into
+    the same rings, and a background thread folds the events into per-module totals off the critical
+    path, so the profiler can stay enabled for a whole training run.
+
+    Flops are counted for ``nn.Linear`` and ``nn.Conv`` layers from their output shape. Latency is
+    measured on the host, so on asynchronous accelerators it is the launch latency unless
+    ``synchronize`` is set.
+
+        .. code-block:: python
+
+            prof = NativeFlopsProfiler(model)
+            prof.start_profile()
+            for batch in data_loader:
+                loss = model(batch)
+                ...
+            prof.stop_profile()
+            prof.print_model_profile(top_modules=10)
+
+    Args:
+        model (torch.nn.Module): The PyTorch model to profile.
+        drain_interval (float): Seconds between two aggregations of the per-thread event buffers.
+        synchronize (bool): Synchronize the accelerator at module boundaries.
+    """
+
+    def __init__(self, model, drain_interval=0.5, synchronize=False):
+        self.model = model
+        self.drain_interval = drain_interval
+        self.synchronize = synchronize
+        self.started = False
+        self.module_names = {}
+        self.hook_handles = []
+        self.drain_thread = None
+        self.drain_stop = threading.Event()
+        self.op = load_native_profiler()
+
+    def _pre_hook(self, module, input):
+        if id(module) in self.module_names:
+            if self.synchronize:
+                get_accelerator().synchronize()
+            self.op.begin(id(module))
+
+    def _post_hook(self, module, input, output):
+        if id(module) in self.module_names:
+            if self.synchronize:
+                get_accelerator().synchronize()
+            self.op.end(id(module), _leaf_flops(module, output))
+
+    def _drain_loop(self):
+        while not self.drain_stop.wait(self.drain_interval):
+            self.op.aggregate()
+
+    def start_profile(self):
+        """Starts recording module events. Previously collected results are discarded."""
+        if self.started:
+            return
+        self.module_names = {id(module): name for name, module in self.model.named_modules()}
+        self.op.reset()
+        self.op.set_enabled(True)
+        self.hook_handles = [
+            nn.modules.module.register_module_forward_pre_hook(self._pre_hook),
+            nn.modules.module.register_module_forward_hook(self._post_hook)
+        ]
+        self.drain_stop.clear()
+        self.drain_thread = threading.Thread(target=self._drain_loop, daemon=True)
+        self.drain_thread.start()
+        self.started = True
+        logger.info("Native flops profiler started")
+
+    def stop_profile(self):
+        """Stops recording. The collected results stay available until the next ``start_profile``."""
+        if not self.started:
+            return
+        self.op.set_enabled(False)
+        for handle in self.hook_handles:
+            handle.remove()
+        self.hook_handles = []
+        self.drain_stop.set()
+        self.drain_thread.join()
+        self.op.aggregate()
+        self.started = False
+
+    def get_module_profile(self):
+        """Returns an ordered dict of module name to its ``calls``, ``flops``, ``duration`` and
+        ``max_duration`` (in seconds), in ``named_modules`` order. Flops of a module include its
+        children."""
+        stats = {}
+        for module_id, op, calls, flops, total_ns, max_ns in self.op.get_stats():
+            if op == MODULE_OP and module_id in self.module_names:
+                stats[module_id] = (calls, flops, total_ns, max_ns)
+
+        subtree_flops = {}
+
+        def accumulate_flops(module):
+            flops = stats.get(id(module), (0, 0, 0, 0))[1]
+            flops += sum(accumulate_flops(child) for child in module.children())
+            subtree_flops[id(module)] = flops
+            return flops
+
+        accumulate_flops(self.model)
+
+        profile = OrderedDict()
+        for name, module in self.model.named_modules():
+            calls, _, total_ns, max_ns = stats.get(id(module), (0, 0, 0, 0))
+            flops = subtree_flops[id(module)]
+            profile[name] = {
+                'calls': calls,
+                'flops': flops,
+                'duration': total_ns / 1e9,
+                'max_duration': max_ns / 1e9
+            }
+        return profile
+
+    def get_kernel_profile(self):
+        """Returns a dict of native kernel name to its ``calls``, ``flops``, ``duration`` and
+        ``max_duration`` (in seconds). Kernels record from any extension attached with
+        ``attach_native_profiler``."""
+        profile = {}
+        for _, op, calls, flops, total_ns, max_ns in self.op.get_stats():
+            if op == MODULE_OP:
+                continue
+            entry = profile.setdefault(KERNEL_OPS.get(op, op), {
+                'calls': 0,
+                'flops': 0,
+                'duration': 0.0,
+                'max_duration': 0.0
+            })
+            entry['calls'] += calls
+            entry['flops'] += flops
+            entry['duration'] += total_ns / 1e9
+            entry['max_duration'] = max(entry['max_duration'], max_ns / 1e9)
+        return profile
+
+    def get_total_flops(self):
+        return self.get_module_profile()['']['flops']
+
+    def get_total_duration(self):
+        return self.get_module_profile()['']['duration']
+
+    def get_dropped_events(self):
+        """Number of events lost because a thread's buffer filled up between two drains."""
+        return self.op.get_dropped_events()
+
+    def print_model_profile(self, top_modules=10):
+        profile = self.get_module_profile()
+        ranked = sorted(profile.items(), key=lambda item: item[1]['duration'], reverse=True)
+        logger.info(f"Native flops profiler: top {top_modules} modules by latency "
+                    f"({self.get_dropped_events()} events dropped)")
+        for name, entry in ranked[:top_modules]:
+            logger.info(f"{name or 'model'}: calls = {entry['calls']}, flops = {entry['flops']}, "
+                        f"latency = {entry['duration']:.6f} s, max = {entry['max_duration']:.6f} s")
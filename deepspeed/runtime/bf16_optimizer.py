@@ -14,6 +14,8 @@ from deepspeed.runtime import ZeROOptimizer
 from packaging import version as pkg_version
 
 from deepspeed.git_version_info import version
+from deepspeed.accelerator import get_accelerator
+from deepspeed.ops.multi_tensor import load_cpu_multi_tensor
 from deepspeed.runtime.utils import (get_global_norm_of_tensors, clip_tensors_by_global_norm, DummyOptim,
                                      align_dense_tensors, all_gather_dp_groups, bwc_tensor_model_parallel_rank,
                                      is_model_parallel_parameter, see_memory_usage, graph_process)
@@ -22,11 +24,22 @@ from deepspeed.utils import link_hp_params, lazy_init_hp_params_optimizer_state,
 from deepspeed.checkpoint import enable_universal_checkpoint
 from deepspeed.checkpoint.constants import (DS_VERSION, PARTITION_COUNT, BASE_OPTIMIZER_STATE,
                                             SINGLE_PARTITION_OF_FP32_GROUPS, CLIP_GRAD, GROUP_PADDINGS,
-                                            PARAM_SLICE_MAPPINGS)
+                                            PARAM_SLICE_MAPPINGS, ROUNDING_STEP)
 
 setattr(sys.modules[__name__], 'fragment_address', fragment_address)
 
 
+@torch.no_grad()
+def stochastic_round_to_bf16_(dst, src, generator):
+    """Writes src (fp32) into dst (bf16), rounding each value up or down with probability
+    proportional to its distance from the two neighbouring bf16 values. The rounding noise is
+    drawn from generator, leaving the global RNG state untouched."""
+    bits = src.view(torch.int32)
+    noise = torch.randint(0, 1 << 16, bits.shape, dtype=torch.int32, device=bits.device, generator=generator)
+    rounded = ((bits + noise) >> 16).to(torch.int16).view(torch.bfloat16)
+    dst.copy_(torch.where(torch.isnan(src), src.to(torch.bfloat16), rounded))
+
+
 class BF16_Optimizer(ZeROOptimizer):
 
     def __init__(self,
@@ -40,7 +53,8 @@ class BF16_Optimizer(ZeROOptimizer):
                  timers=None,
                  grad_acc_dtype=None,
                  graph_harvesting=False,
-                 immediate_grad_update=False):
+                 immediate_grad_update=False,
+                 stochastic_rounding=False):
         super().__init__()
         see_memory_usage('begin bf16_optimizer', force=True)
         self.timers = timers
@@ -52,6 +66,13 @@ class BF16_Optimizer(ZeROOptimizer):
                                   ], f"BF16Optimizer: Unsupported gradient accumulation data type: {grad_acc_dtype}"
         self.grad_acc_dtype = grad_acc_dtype
         self.immediate_grad_update = immediate_grad_update
+        self.stochastic_rounding = stochastic_rounding
+        self.rounding_step = 0
+
+        # Native multi-tensor kernels for the hp/lp copies when training on CPU
+        self.cpu_multi_tensor = None
+        if get_accelerator().device_name() == 'cpu':
+            self.cpu_multi_tensor = load_cpu_multi_tensor()
 
         self.clip_grad = clip_grad
         self.norm_type = norm_type
@@ -314,10 +335,42 @@ class BF16_Optimizer(ZeROOptimizer):
 
     @torch.no_grad()
     def _update_hp_grads_func(self, clear_lp_grads=False):
+        if self.grad_acc_dtype == torch.float32 and not self.graph_harvesting:
+            self._update_hp_grads_multi_tensor(clear_lp_grads)
+            return
+
         for i, group in enumerate(self.bf16_groups):
             for j, lp in enumerate(group):
                 self._update_hp_grad(lp, i, j, clear_lp_grads)
 
+    @torch.no_grad()
+    def _update_hp_grads_multi_tensor(self, clear_lp_grads):
+        """Accumulate all bf16 grads into their fp32 copies with a single multi-tensor call."""
+        hp_grads = []
+        lp_grads = []
+        for i, group in enumerate(self.bf16_groups):
+            for j, lp in enumerate(group):
+                if lp.grad is None:
+                    continue
+                hp_grad = self.fp32_groups_gradients[i][j]
+                assert hp_grad is not None, \
+                    f'high precision param has no gradient, lp param_id = {id(lp)} group_info = [{i}][{j}]'
+                hp_grads.append(hp_grad)
+                lp_grads.append(lp.grad.data.view(hp_grad.shape))
+                lp._hp_grad = hp_grad
+                self.fp32_groups_has_gradients[i][j] = True
+
+        if len(hp_grads) == 0:
+            return
+
+        if self.cpu_multi_tensor is not None and all(g.is_contiguous() for g in lp_grads):
+            self.cpu_multi_tensor.multi_tensor_accumulate(hp_grads, lp_grads, True, False)
+        else:
+            torch._foreach_add_(hp_grads, lp_grads)
+
+        if clear_lp_grads:
+            torch._foreach_zero_(lp_grads)
+
     @torch.no_grad()
     def update_hp_grads(self, clear_lp_grads=False):
         if self.immediate_grad_update:
@@ -360,13 +413,29 @@ class BF16_Optimizer(ZeROOptimizer):
 
     @torch.no_grad()
     def update_lp_params(self):
+        # The hp fragments of every lp param in a group are contiguous in both flat partitions,
+        # so each group is copied as a single fragment and all groups go down in one call.
+        lp_partitions = []
+        hp_partitions = []
         for i, (bf16_partitions,
                 fp32_partition) in enumerate(zip(self.bf16_partitioned_groups, self.fp32_groups_flat_partition)):
             partition_id = dist.get_rank(group=self.real_dp_process_group[i])
-            bf16_partitions[partition_id].data.copy_(fp32_partition.data)
-            # print_rank_0(f'update_lp_params {i=} {partition_id=}', force=True)
-            # if i == 0:
-            #     print_rank_0(f'{fp32_partition[:10]=}', force=True)
+            lp_partitions.append(bf16_partitions[partition_id].data)
+            hp_partitions.append(fp32_partition.data)
+
+        # Advanced once per step on every path, so a resumed run draws the same noise on any device.
+        seed = self._get_rounding_seed()
+        if self.cpu_multi_tensor is not None and all(p.dtype == torch.bfloat16 for p in lp_partitions):
+            self.cpu_multi_tensor.multi_tensor_copy_to_bf16(lp_partitions, hp_partitions, self.stochastic_rounding,
+                                                            seed)
+        elif self.stochastic_rounding:
+            generator = torch.Generator(device=hp_partitions[0].device)
+            generator.manual_seed(seed)
+            for lp_partition, hp_partition in zip(lp_partitions, hp_partitions):
+                stochastic_round_to_bf16_(lp_partition, hp_partition, generator)
+        else:
+            for lp_partition, hp_partition in zip(lp_partitions, hp_partitions):
+                lp_partition.copy_(hp_partition)
 
         all_gather_dp_groups(groups_flat=self.bf16_groups_flat,
                              partitioned_param_groups=self.bf16_partitioned_groups,
@@ -374,6 +443,13 @@ class BF16_Optimizer(ZeROOptimizer):
                              start_alignment_factor=self.nccl_start_alignment_factor,
                              allgather_bucket_size=self.allgather_bucket_size)
 
+    def _get_rounding_seed(self):
+        # Distinct per step and per rank so rounding noise never repeats across the partitions
+        dp_world_size = dist.get_world_size(group=self.dp_process_group)
+        seed = self.rounding_step * dp_world_size + self.dp_rank
+        self.rounding_step += 1
+        return seed
+
     def clear_hp_grads(self):
         for flat_gradients in self.fp32_groups_gradients_flat:
             flat_gradients.zero_()
@@ -397,6 +473,7 @@ class BF16_Optimizer(ZeROOptimizer):
         state_dict[PARTITION_COUNT] = self.partition_count
         state_dict[DS_VERSION] = version
         state_dict[PARAM_SLICE_MAPPINGS] = self._param_slice_mappings
+        state_dict[ROUNDING_STEP] = self.rounding_step
 
         return state_dict
 
@@ -431,6 +508,8 @@ class BF16_Optimizer(ZeROOptimizer):
         ckpt_version = pkg_version.parse(ckpt_version)
 
         self.clip_grad = current_rank_sd.get(CLIP_GRAD, self.clip_grad)
+        # Resume the stochastic rounding seeds where the run left off instead of replaying them
+        self.rounding_step = current_rank_sd.get(ROUNDING_STEP, self.rounding_step)
 
         if load_optimizer_states:
             self.optimizer.load_state_dict(current_rank_sd[BASE_OPTIMIZER_STATE])
@@ -445,6 +524,11 @@ class BF16_Optimizer(ZeROOptimizer):
             self._link_all_hp_params()
 
     def _load_universal_checkpoint(self, checkpoint_folder, load_optimizer_states, load_from_fp32_weights):
+        # The rounding step is the same on every rank, so the one of rank 0 kept by the conversion applies.
+        optim_state_path = os.path.join(checkpoint_folder, "zero", "optimizer_state.pt")
+        if os.path.isfile(optim_state_path):
+            optim_sd = torch.load(optim_state_path)
+            self.rounding_step = optim_sd.get(ROUNDING_STEP, self.rounding_step)
         self._load_hp_checkpoint_state(checkpoint_folder)
 
     @property
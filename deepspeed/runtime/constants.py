@@ -130,6 +130,10 @@ BFLOAT16_ENABLED_DEFAULT = False
 BFLOAT16_IMMEDIATE_GRAD_UPDATE = "immediate_grad_update"
 BFLOAT16_IMMEDIATE_GRAD_UPDATE_DEFAULT = False
 
+# BFLOAT16 optimizer stochastic rounding of the fp32 -> bf16 parameter copy
+BFLOAT16_STOCHASTIC_ROUNDING = "stochastic_rounding"
+BFLOAT16_STOCHASTIC_ROUNDING_DEFAULT = False
+
 #########################################
 # FP16 support
 #########################################
@@ -31,11 +31,19 @@ class AsyncTensorSwapper(object):
         self.timers = timers
         self.timer_names = set()
         self.num_elements_swapped = 0
+        self.num_direct_swaps = 0
+        self.num_direct_elements = 0
         self.dtype = None
 
     def has_buffers(self):
         return len(self.all_buffers) > 0
 
+    def has_pending_swaps(self):
+        return self.num_pending_swaps > 0
+
+    def can_write_directly(self, tensor):
+        return hasattr(self.aio_handle, 'async_pwritev') and tensor.device.type == 'cpu' and tensor.is_contiguous()
+
     def add_buffers(self, buffer_list):
         assert len(self.all_buffers) == 0
         assert all([get_accelerator().is_pinned(buffer) for buffer in buffer_list])
@@ -61,6 +69,7 @@ class AsyncTensorSwapper(object):
         self.free_buffer_index = []
         self.current_buffer_index = INVALID_BUFFER_INDEX
         self.num_elements_swapped = 0
+        self.num_direct_swaps = 0
         self.dtype = None
 
         return pinned_buffers
@@ -69,11 +78,23 @@ class AsyncTensorSwapper(object):
         for tensor, swap_path in zip(tensor_list, path_list):
             self._swap_out_tensor(tensor, swap_path)
 
+    def write_tensors(self, tensor_list, path_list):
+        """Writes host tensors to their swap files from their own memory instead of copying them into
+        the swap buffers first. The tensors must not be modified until the swapper is flushed."""
+        for tensor, swap_path in zip(tensor_list, path_list):
+            assert self.can_write_directly(tensor)
+            assert self.aio_handle.async_pwritev([tensor], swap_path, 0) == 0
+            self.dtype = tensor.dtype
+            self.num_direct_swaps += 1
+            self.num_direct_elements += tensor.numel()
+            self.num_pending_swaps += 1
+
     def _report_statistics(self, message):
         if dist.get_rank() == 0:
             element_size = torch.tensor([], dtype=self.dtype).element_size()
             swapped_GB = (self.num_elements_swapped * element_size) / (1024**3)
-            logger.debug(f'{message} num_elems = {self.num_elements_swapped}, {swapped_GB:5.2f} GB')
+            logger.debug(f'{message} num_elems = {self.num_elements_swapped}, {swapped_GB:5.2f} GB, '
+                         f'direct writes = {self.num_direct_swaps}')
 
     def _swap_out_tensor(self, tensor, swap_path):
         assert len(self.all_buffers) > 0
@@ -121,7 +142,8 @@ class AsyncTensorSwapper(object):
         self._flush_ready_buffers()
         assert len(self.ready_buffer_index) == 0
 
-        self._wait_for_swap_complete()
+        if self.has_pending_swaps():
+            self._wait_for_swap_complete()
         assert len(self.swapping_buffer_index) == 0
         assert len(self.free_buffer_index) == len(self.all_buffers)
 
@@ -137,7 +159,7 @@ class AsyncTensorSwapper(object):
         self.ready_buffer_index = []
 
     def _wait_for_swap_complete(self):
-        assert len(self.swapping_buffer_index) > 0
+        assert self.has_pending_swaps()
 
         self._start_timer(ASYNC_SWAPPER_WAIT_TIMER)
         assert self.aio_handle.wait() == self.num_pending_swaps
@@ -145,6 +167,8 @@ class AsyncTensorSwapper(object):
         self.timer_names.add(ASYNC_SWAPPER_WAIT_TIMER)
 
         self.num_pending_swaps = 0
+        self.num_elements_swapped += self.num_direct_elements
+        self.num_direct_elements = 0
 
         for buffer_index in self.swapping_buffer_index:
             buffer = self._get_buffer(buffer_index)
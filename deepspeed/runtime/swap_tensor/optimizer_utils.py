@@ -173,7 +173,7 @@ class OptimizerSwapper(object):
         pass
 
     def _flush_gradient_swapper(self, gradient_swapper):
-        if gradient_swapper.has_buffers():
+        if gradient_swapper.has_buffers() or gradient_swapper.has_pending_swaps():
             self._start_timer(SWAP_OUT_GRADIENT_TIMER)
             pinned_buffers = gradient_swapper.release_buffers()
             self.swap_buffer_manager.free(pinned_buffers)
@@ -205,14 +205,30 @@ class OptimizerSwapper(object):
             swappable_lengths.append(tensor.numel())
 
         if len(swappable_tensors) > 0:
-            if not gradient_swapper.has_buffers():
-                pinned_buffers = self.swap_buffer_manager.allocate_all(num_elems=self.largest_numel, dtype=self.dtype)
+            swappable_paths = swap_info.get_or_create_gradient_paths(swappable_offsets, swappable_lengths)
 
-                gradient_swapper.add_buffers(pinned_buffers)
+            # Host gradients are written from their own memory, only the others are staged in the
+            # pinned swap buffers.
+            direct_tensors, direct_paths, staged_tensors, staged_paths = [], [], [], []
+            for tensor, path in zip(swappable_tensors, swappable_paths):
+                if tensor.dtype == self.dtype and gradient_swapper.can_write_directly(tensor):
+                    direct_tensors.append(tensor)
+                    direct_paths.append(path)
+                else:
+                    staged_tensors.append(tensor)
+                    staged_paths.append(path)
 
-            swappable_paths = swap_info.get_or_create_gradient_paths(swappable_offsets, swappable_lengths)
+            if len(direct_tensors) > 0:
+                gradient_swapper.write_tensors(tensor_list=direct_tensors, path_list=direct_paths)
+
+            if len(staged_tensors) > 0:
+                if not gradient_swapper.has_buffers():
+                    pinned_buffers = self.swap_buffer_manager.allocate_all(num_elems=self.largest_numel,
+                                                                           dtype=self.dtype)
+
+                    gradient_swapper.add_buffers(pinned_buffers)
 
-            gradient_swapper.swap_out_tensors(tensor_list=swappable_tensors, path_list=swappable_paths)
+                gradient_swapper.swap_out_tensors(tensor_list=staged_tensors, path_list=staged_paths)
 
         self._stop_timer(SWAP_OUT_GRADIENT_TIMER)
         self.timer_names.add(SWAP_OUT_GRADIENT_TIMER)
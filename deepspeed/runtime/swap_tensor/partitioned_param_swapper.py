@@ -40,6 +40,7 @@ class AsyncPartitionedParameterSwapper(object):
         aio_op = AsyncIOBuilder().load(verbose=False)
         self.aio_handle = aio_op.aio_handle
         self.dtype = model_dtype
+        self.print_exclude_list = ['aio_read_handle', 'aio_write_handle', 'buffers']
 
         #set swap buffers, create aio handles
         self._configure_aio(ds_config)
@@ -75,8 +76,7 @@ class AsyncPartitionedParameterSwapper(object):
         self.invalid_buffer = torch.tensor(1).half()
 
         if dist.get_rank() == 0:
-            exclude_list = ['aio_read_handle', 'aio_write_handle', 'buffers']
-            print_object(obj=self, name='AsyncPartitionedParameterSwapper', exclude_list=exclude_list)
+            print_object(obj=self, name=self.__class__.__name__, exclude_list=self.print_exclude_list)
 
     def available_swap_in_buffers(self):
         return len(self.available_buffer_ids)
@@ -102,13 +102,7 @@ class AsyncPartitionedParameterSwapper(object):
         self.aligned_elements_per_buffer = self._io_aligned_numel(self.elements_per_buffer)
         self.param_buffer_count = self.swap_config.buffer_count
 
-        self.available_buffer_ids = [i for i in range(self.param_buffer_count)]
-        self.reserved_buffer_ids = []
-        self.buffers = get_accelerator().pin_memory(torch.empty(int(self.aligned_elements_per_buffer *
-                                                                    self.param_buffer_count),
-                                                                dtype=self.dtype,
-                                                                requires_grad=False),
-                                                    align_bytes=0)
+        self._configure_buffers()
 
         self.aio_read_handle = self.aio_handle(self.aio_config[AIO_BLOCK_SIZE], self.aio_config[AIO_QUEUE_DEPTH],
                                                self.aio_config[AIO_SINGLE_SUBMIT], self.aio_config[AIO_OVERLAP_EVENTS],
@@ -120,6 +114,22 @@ class AsyncPartitionedParameterSwapper(object):
 
         self.swap_out_params = []
 
+    def _configure_buffers(self):
+        self.available_buffer_ids = [i for i in range(self.param_buffer_count)]
+        self.reserved_buffer_ids = []
+        self.buffers = get_accelerator().pin_memory(torch.empty(int(self.aligned_elements_per_buffer *
+                                                                    self.param_buffer_count),
+                                                                dtype=self.dtype,
+                                                                requires_grad=False),
+                                                    align_bytes=0)
+
+    def _has_swap_in_buffers(self, count):
+        return count <= len(self.available_buffer_ids)
+
+    # Number of the leading params of the list that can be swapped in with the free buffers
+    def swap_in_capacity(self, params):
+        return min(len(params), self.available_swap_in_buffers())
+
     #Check if partitioned param or numel in a tensor is swappable or not
     def swappable_tensor(self, param=None, numel=None):
         if param is not None:
@@ -283,7 +293,7 @@ class AsyncPartitionedParameterSwapper(object):
         swap_in_paths = self._get_swap_paths(params)
 
         if swap_in_buffers is None:
-            if len(self.available_buffer_ids) < len(swap_in_paths):
+            if not self._has_swap_in_buffers(len(swap_in_paths)):
                 ids = [p.ds_id for p in params]
                 print_rank_0(
                     f'Not enough swap in buffers {len(self.available_buffer_ids)} for {len(swap_in_paths)} params, ids = {ids}',
@@ -295,9 +305,8 @@ class AsyncPartitionedParameterSwapper(object):
                     f'Num available params: count = {len(self.available_params)}, ids = {self.available_params}, numel = {self.available_numel}',
                     force=True)
 
-            assert len(swap_in_paths) <= len(
-                self.available_buffer_ids
-            ), f"Not enough buffers {len(self.available_buffer_ids)} for swapping {len(swap_in_paths)}"
+            assert self._has_swap_in_buffers(len(swap_in_paths)), \
+            f"Not enough buffers {len(self.available_buffer_ids)} for swapping {len(swap_in_paths)}"
             compute_buffers, swap_in_buffers = self._allocate_and_return_buffers_for_swap_in(params)
             inflight_numel = sum([t.numel() for t in compute_buffers])
         else:
@@ -318,7 +327,7 @@ class AsyncPartitionedParameterSwapper(object):
                                    and self._is_io_aligned(dest_buffer.numel()))
 
         if require_swap_buffer:
-            assert len(self.available_buffer_ids) > 0, f"No buffer available to swap param {param.ds_id}."
+            assert self._has_swap_in_buffers(1), f"No buffer available to swap param {param.ds_id}."
             compute_buffers, swap_in_buffers = self._allocate_and_return_buffers_for_swap_in([param])
             inflight_numel = compute_buffers[0].numel()
         else:
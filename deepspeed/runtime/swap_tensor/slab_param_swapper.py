@@ -0,0 +1,217 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+"""
+Functionality of swapping parameter partitions to/from (NVMe) storage devices through swap buffers
+sub-allocated in large pinned slabs.
+"""
+
+import torch
+
+from deepspeed.accelerator import get_accelerator
+from deepspeed.ops.op_builder import AsyncIOBuilder
+from .partitioned_param_swapper import AsyncPartitionedParameterSwapper, PartitionedParamStatus
+
+# Upper bound of the size of one pinned slab, a slab holds at least one full-size buffer
+SWAP_SLAB_BYTES = 1 << 30
+
+# Keys of the buffers handed out by reserve_available_buffers, which are not used by any param
+RESERVED_BUFFER_KEY_BASE = -1
+
+
+class SlabPartitionedParameterSwapper(AsyncPartitionedParameterSwapper):
+    """
+    Parameter swapper that carves a swap buffer of the size of each partition out of a few
+    pinned slabs, holding the same ``buffer_count * buffer_size`` elements as the fixed pool, so
+    small partitions no longer take a whole buffer each.
+
+    A released partition still matches its swap file, so its buffer is kept cached and swapping
+    the partition in again is served from memory. Cached buffers are evicted, the least recently
+    released first, when the space is needed. When the slabs are full, the allocation waits for
+    the pending writes and reads and retries, and only gives up once no I/O is left in flight.
+    """
+
+    def _configure_buffers(self):
+        buffer_bytes = self.aligned_elements_per_buffer * self.swap_element_size
+        buffers_per_slab = max(1, SWAP_SLAB_BYTES // buffer_bytes)
+        slab_buffer_counts = [buffers_per_slab] * (self.param_buffer_count // buffers_per_slab)
+        if self.param_buffer_count % buffers_per_slab:
+            slab_buffer_counts.append(self.param_buffer_count % buffers_per_slab)
+
+        self.slabs = [
+            get_accelerator().pin_memory(torch.empty(int(count * self.aligned_elements_per_buffer),
+                                                     dtype=self.dtype,
+                                                     requires_grad=False),
+                                         align_bytes=0) for count in slab_buffer_counts
+        ]
+        aio_op = AsyncIOBuilder().load(verbose=False)
+        self.buffer_manager = aio_op.swap_buffer_manager([slab.numel() * self.swap_element_size for slab in self.slabs],
+                                                         self.aligned_bytes)
+
+        # mapping from param_id to the swap buffer of released partitions kept in memory
+        self.cached_swap_buffers = {}
+        self.reserved_buffer_keys = []
+
+        self.print_exclude_list += ['slabs', 'buffer_manager', 'cached_swap_buffers']
+
+    def _slab_buffer(self, slab, offset, numel):
+        return self.slabs[slab].narrow(0, offset // self.swap_element_size, numel)
+
+    def _drop_cached(self, param_ids):
+        for param_id in param_ids:
+            self.cached_swap_buffers.pop(param_id, None)
+
+    def _allocate_swap_buffer(self, key, numel):
+        aligned_numel = self._io_aligned_numel(numel)
+        num_bytes = aligned_numel * self.swap_element_size
+        # A cached buffer of the same key is dropped by the allocation without being reported
+        self._drop_cached([key])
+        slab, offset, evicted = self.buffer_manager.allocate(key, num_bytes)
+        self._drop_cached(evicted)
+
+        # Back-pressure: wait for the I/O in flight and retry, only giving up once none is left.
+        # Written partitions are released as cached buffers, which can then be evicted.
+        while slab < 0 and (self.pending_writes > 0 or self.pending_reads > 0):
+            if self.pending_writes > 0:
+                self.synchronize_writes()
+            else:
+                self.synchronize_reads()
+            slab, offset, evicted = self.buffer_manager.allocate(key, num_bytes)
+            self._drop_cached(evicted)
+
+        if slab < 0:
+            raise RuntimeError(
+                f'No space for {num_bytes} bytes of swap buffer for param {key}: '
+                f'{self.buffer_manager.free_bytes()} bytes free, all other buffers hold partitions in use '
+                f'({len(self.available_params)} available, {len(self.inflight_params)} in flight)')
+
+        return self._slab_buffer(slab, offset, aligned_numel)
+
+    def _reuse_cached_partitions(self, params):
+        """Makes the params with a cached partition available, returns the others."""
+        missing = []
+        for param in params:
+            param_id = param.ds_id
+            if not self.buffer_manager.acquire(param_id):
+                missing.append(param)
+                continue
+
+            swap_buffer = self.cached_swap_buffers.pop(param_id)
+            self.param_id_to_swap_buffer[param_id] = swap_buffer
+            param.ds_tensor.data = swap_buffer.narrow(0, 0, self.param_id_to_numel[param_id]).data
+            param.ds_tensor.status = PartitionedParamStatus.AVAILABLE
+            self.available_params.add(param_id)
+            self.available_numel += self.param_id_to_numel[param_id]
+
+        return missing
+
+    def _invalidate_cached_partitions(self, params):
+        for param in params:
+            if self.buffer_manager.is_cached(param.ds_id):
+                self.buffer_manager.free(param.ds_id)
+                self._drop_cached([param.ds_id])
+
+    def available_swap_in_buffers(self):
+        # Full-size buffers that the free and cached space could hold, ignoring fragmentation
+        buffer_bytes = self.aligned_elements_per_buffer * self.swap_element_size
+        return (self.buffer_manager.free_bytes() + self.buffer_manager.cached_bytes()) // buffer_bytes
+
+    def swap_in_capacity(self, params):
+        keys = [param.ds_id for param in params]
+        num_bytes = [self._io_aligned_numel(param.ds_tensor.ds_numel) * self.swap_element_size for param in params]
+        return self.buffer_manager.count_fits(keys, num_bytes)
+
+    def _has_swap_in_buffers(self, count):
+        # Fits depend on the partition sizes and are only known per allocation, which waits for
+        # the I/O in flight when the slabs are full and raises once there is none left
+        return True
+
+    def _allocate_and_return_buffers_for_swap_in(self, params):
+        compute_buffers = []
+        swap_buffers = []
+
+        for param in params:
+            param_id = param.ds_id
+            assert param_id in self.param_id_to_numel.keys(), f" Number of elements in param {param_id} is unknown"
+            assert param_id not in self.param_id_to_swap_buffer.keys(
+            ), f"param {param_id} has already been assigned a swap buffer"
+
+            swap_buffer = self._allocate_swap_buffer(param_id, self.param_id_to_numel[param_id])
+            self.param_id_to_swap_buffer[param_id] = swap_buffer
+            compute_buffers.append(swap_buffer.narrow(0, 0, self.param_id_to_numel[param_id]))
+            swap_buffers.append(swap_buffer)
+
+        return compute_buffers, swap_buffers
+
+    def remove_partition_and_release_buffers(self, params):
+        for param in params:
+            param_id = param.ds_id
+
+            swap_buffer = self.param_id_to_swap_buffer.pop(param_id, None)
+            if swap_buffer is not None:
+                # The partition matches its swap file, keep it until the space is needed
+                self.buffer_manager.release(param_id, True)
+                self.cached_swap_buffers[param_id] = swap_buffer
+
+                if param_id in self.available_params:
+                    self.available_params.remove(param_id)
+                    self.available_numel -= self.param_id_to_numel[param_id]
+
+            param.ds_tensor.data = self.invalid_buffer.data
+            param.ds_tensor.status = PartitionedParamStatus.NOT_AVAILABLE
+
+    def swap_in(self, params, async_op=True, swap_in_buffers=None):
+        if swap_in_buffers is None:
+            assert all([param.ds_tensor.status == PartitionedParamStatus.NOT_AVAILABLE
+                        for param in params]), "Some params are already available or in flight"
+            params = self._reuse_cached_partitions(params)
+            if not params:
+                if not async_op:
+                    self.synchronize_reads()
+                return
+
+        super().swap_in(params, async_op=async_op, swap_in_buffers=swap_in_buffers)
+
+    def swap_into_buffer(self, param, dest_buffer):
+        cached_buffer = self.cached_swap_buffers.get(param.ds_id)
+        if cached_buffer is None:
+            super().swap_into_buffer(param, dest_buffer)
+            return
+
+        assert param.ds_tensor.status == PartitionedParamStatus.NOT_AVAILABLE, f"param {param.ds_id} is already available or inflight"
+        dest_buffer.data.copy_(cached_buffer.narrow(0, 0, self.param_id_to_numel[param.ds_id]))
+
+    def get_buffer(self, param, numel):
+        param_id = param.ds_id
+        assert numel <= self.aligned_elements_per_buffer, f"More elements {numel} than buffer size {self.elements_per_buffer}"
+
+        self.param_id_to_numel[param_id] = numel
+        swap_buffer = self._allocate_swap_buffer(param_id, numel)
+        self.param_id_to_swap_buffer[param_id] = swap_buffer
+        return swap_buffer.narrow(0, 0, numel)
+
+    def reserve_available_buffers(self):
+        self._drop_cached(self.buffer_manager.evict_all())
+
+        buffers = []
+        while True:
+            key = RESERVED_BUFFER_KEY_BASE - len(self.reserved_buffer_keys)
+            slab, offset, _ = self.buffer_manager.allocate(key,
+                                                           self.aligned_elements_per_buffer * self.swap_element_size)
+            if slab < 0:
+                break
+            buffers.append(self._slab_buffer(slab, offset, self.aligned_elements_per_buffer))
+            self.reserved_buffer_keys.append(key)
+
+        return buffers
+
+    def release_reserved_buffers(self):
+        for key in self.reserved_buffer_keys:
+            self.buffer_manager.free(key)
+        self.reserved_buffer_keys = []
+
+    def swap_out_partitioned_params(self, dst_fp16_params, src_fp32_params):
+        # The swap files are rewritten, the cached copies go stale
+        self._invalidate_cached_partitions(dst_fp16_params)
+        super().swap_out_partitioned_params(dst_fp16_params, src_fp32_params)
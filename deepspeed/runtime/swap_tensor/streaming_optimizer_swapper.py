@@ -0,0 +1,138 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+"""
+Functionality of stepping the optimizer over state swapped to (NVMe) storage devices, streaming it
+through a native read/step/write pipeline instead of swapping whole tensors in and out.
+"""
+
+import torch
+
+from deepspeed import comm as dist
+from deepspeed.accelerator import get_accelerator
+from deepspeed.runtime.swap_tensor.constants import *
+from deepspeed.runtime.swap_tensor.utils import swap_in_tensors, print_object
+from deepspeed.runtime.swap_tensor.optimizer_utils import OptimizerSwapper
+from deepspeed.runtime.swap_tensor.pipelined_optimizer_swapper import PipelinedOptimizerSwapper
+
+# Files and staging slots are accessed with O_DIRECT where possible.
+STREAMING_IO_ALIGNMENT = 4096
+
+SWAP_IN_GRADIENT_TIMER = 'swap_in_gradient'
+STREAM_STEP_TIMER = 'stream_optimizer_step'
+
+
+class StreamingOptimizerSwapper(PipelinedOptimizerSwapper):
+    """
+    Optimizer swapper whose step streams the fp32 parameter, exp_avg and exp_avg_sq of a sub group
+    in chunks through a small ring of staging slots, overlapping the read of the next chunk and
+    the write back of the previous one with the Adam step of the current one. Only the gradients
+    of the sub group are read into a swap buffer, which holds the updated fp32 parameter after the
+    step so that it can be copied to the fp16 partition.
+
+    Initialization and the checkpointing paths swap whole tensors as the pipelined swapper does,
+    so the files and the optimizer state keep the same layout.
+    """
+
+    N_STAGING_SLOTS = 3
+
+    def __init__(self, swap_config, aio_config, base_folder, optimizer, largest_numel, device, dtype, timers):
+        super(StreamingOptimizerSwapper, self).__init__(swap_config, aio_config, base_folder, optimizer, largest_numel,
+                                                        device, dtype, timers)
+        assert dtype == torch.float32, f'StreamingOptimizerSwapper steps fp32 partitions, not {dtype}'
+
+        block_bytes = self._round_up(aio_config[AIO_BLOCK_SIZE], STREAMING_IO_ALIGNMENT)
+        chunk_bytes = self._round_up(block_bytes * aio_config[AIO_QUEUE_DEPTH], STREAMING_IO_ALIGNMENT)
+        chunk_numel = min(chunk_bytes // self.swap_element_size, self._round_up(self.largest_numel, 1024))
+        self.staging = get_accelerator().pin_memory(
+            torch.empty((self.N_STAGING_SLOTS, 3, chunk_numel), dtype=dtype, device='cpu'))
+
+        io_threads = max(aio_config[AIO_THREAD_COUNT], aio_config[AIO_QUEUE_DEPTH])
+        self.pipeline = optimizer.ds_opt_adam.AdamNVMePipeline(self.staging, io_threads, block_bytes)
+        self.gradient_buffers = {}
+
+        self.print_exclude_list += ['staging', 'pipeline', 'gradient_buffers']
+
+        if dist.get_rank() == 0:
+            print_object(obj=self, name='StreamingOptimizerSwapper', exclude_list=self.print_exclude_list)
+
+    @staticmethod
+    def _round_up(value, alignment):
+        return (value + alignment - 1) // alignment * alignment
+
+    def swap_in_gradients(self, parameter):
+        """
+        Read the gradients of a sub group into a swap buffer and point ``parameter.grad`` at it.
+        Returns False if the sub group has no gradients to step with.
+        """
+        swap_info = self._get_param_swap_info(parameter)
+        if swap_info is None or not swap_info.has_gradients():
+            return False
+
+        self._flush_gradient_swapper(self.gradient_swapper)
+
+        self._start_timer(SWAP_IN_GRADIENT_TIMER)
+        buffers = self.swap_buffer_manager.allocate(num_elems=self._io_aligned_numel(swap_info.numel()),
+                                                    count=1,
+                                                    dtype=parameter.dtype)
+        assert buffers is not None, \
+        f"StreamingOptimizerSwapper ran out of swap buffers, try increasing 'buffer_count'"
+        self.gradient_buffers[swap_info.param_id] = buffers
+
+        parameter.grad = buffers[0].narrow(0, 0, swap_info.numel())
+        if swap_info.swapped_gradients:
+            swap_buffers = swap_info.get_swap_gradient_buffers(parameter.grad)
+            swap_in_tensors(self.read_aio_handle, swap_buffers, swap_info.get_swap_gradient_paths())
+            assert self.read_aio_handle.wait() == len(swap_buffers)
+
+        if swap_info.unswapped_gradients:
+            self._retrieve_unswapped_grad_partitions(swap_info=swap_info, dest_buffer=parameter.grad)
+
+        self._stop_timer(SWAP_IN_GRADIENT_TIMER)
+        self.timer_names.add(SWAP_IN_GRADIENT_TIMER)
+        return True
+
+    def stream_optimizer_step(self, parameter, param_group):
+        """
+        Apply the Adam step to a sub group whose gradients were read by ``swap_in_gradients``. On
+        return ``parameter`` holds the updated fp32 partition until ``release_streamed_parameter``.
+        """
+        swap_info = self._get_param_swap_info(parameter)
+        assert swap_info is not None and parameter.grad is not None
+
+        state = self.optimizer.state[parameter]
+        if len(state) == 0:
+            # The state tensors only stand for their swap files, the data is streamed. Registering
+            # them keeps the swap in of the checkpointing paths working.
+            state['step'] = 0
+            state['exp_avg'] = torch.Tensor()
+            state['exp_avg_sq'] = torch.Tensor()
+        self._update_param_state_info(swap_info, parameter)
+        assert len(swap_info.swap_paths) == 3, \
+        f'StreamingOptimizerSwapper expects the param, exp_avg and exp_avg_sq files, got {swap_info.swap_paths}'
+
+        # exp_avg and exp_avg_sq files only hold state once a step wrote them, stale files of an
+        # earlier run in the same swap folder must not be read.
+        state_initialized = state['step'] > 0
+        state['step'] += 1
+        beta1, beta2 = param_group['betas']
+
+        self._start_timer(STREAM_STEP_TIMER)
+        grads = parameter.grad.data
+        self.pipeline.step(self.optimizer.opt_id, state['step'], param_group['lr'], beta1, beta2,
+                           param_group['eps'], param_group['weight_decay'], param_group['bias_correction'], grads,
+                           swap_info.swap_paths, self._io_aligned_numel(swap_info.numel()), state_initialized)
+        self._stop_timer(STREAM_STEP_TIMER)
+        self.timer_names.add(STREAM_STEP_TIMER)
+
+        # The gradient buffer now holds the updated parameter.
+        parameter.data = grads
+        parameter.grad = None
+
+    def release_streamed_parameter(self, parameter):
+        buffers = self.gradient_buffers.pop(OptimizerSwapper.parameter_id(parameter), None)
+        parameter.grad = None
+        parameter.data = torch.Tensor()
+        if buffers is not None:
+            self.swap_buffer_manager.free(buffers)
@@ -26,6 +26,22 @@ def swap_out_tensors(swap_handle, tensor_buffers, swap_paths):
         assert (swap_handle.async_pwrite(buffer, path) == 0)
 
 
+def get_aio_stats(aio_handle):
+    """Returns the per-operation totals of an aio handle as a dict of op name ("read", "write",
+    "pread", "pwrite", "pwritev") to its ``count``, ``bytes``, ``aio_usec``, ``call_usec`` and ``max_call_usec``.
+    Per-op timings are only logged at the debug level of the DS_AIO_LOG_LEVEL environment variable."""
+    stats = {}
+    for op, count, num_bytes, aio_usec, call_usec, max_call_usec in aio_handle.get_stats():
+        stats[op] = {
+            'count': count,
+            'bytes': num_bytes,
+            'aio_usec': aio_usec,
+            'call_usec': call_usec,
+            'max_call_usec': max_call_usec
+        }
+    return stats
+
+
 def print_object(obj, name, exclude_list=[]):
     logger.info('{}:'.format(name))
     for arg in sorted(vars(obj)):
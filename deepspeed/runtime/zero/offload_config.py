@@ -40,6 +40,13 @@ class DeepSpeedZeroOffloadParamConfig(DeepSpeedConfigModel):
     NVMe is enabled.
     """
 
+    slab_buffers: bool = False
+    """
+    Sub-allocate the NVMe swap buffers of the size of each partition inside
+    large pinned slabs holding the same `buffer_count * buffer_size` elements,
+    and keep released partitions cached in them until their space is needed.
+    """
+
     pin_memory: bool = False
     """
     Offload to page-locked CPU memory. This could boost throughput at the cost
@@ -88,6 +95,15 @@ class DeepSpeedZeroOffloadOptimizerConfig(DeepSpeedConfigModel):
     fast_init: bool = False
     """ Enable fast optimizer initialization when offloading to NVMe. """
 
+    native_pipeline: bool = False
+    """
+    With `nvme` offload and DeepSpeedCPUAdam, stream the parameter and
+    optimizer state of each sub group through a native read/step/write
+    pipeline in chunks instead of swapping whole sub groups in and out. Only
+    the gradients of one sub group and a small staging ring are held in
+    memory. Used in ZeRO-Infinity.
+    """
+
     @validator("pipeline_read", "pipeline_write", always=True)
     def set_pipeline(cls, field_value, values):
         values["pipeline"] = field_value or values.get("pipeline", False)
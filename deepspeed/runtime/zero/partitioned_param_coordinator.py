@@ -532,12 +532,14 @@ class PartitionedParameterCoordinator:
             param = param_in_trace.param
             if param.nvme_swapper is None:
                 continue
-            if (numel_considered > 2 * numel_in_flight
-                    or len(swap_in_params) >= param.nvme_swapper.available_swap_in_buffers()):
+            if numel_considered > 2 * numel_in_flight:
                 break
             if param.ds_tensor.status == PartitionedParamStatus.NOT_AVAILABLE:
                 swap_in_params.append(param)
             numel_considered += param.ds_numel
 
+        if swap_in_params:
+            # Only prefetch what the swap buffers can hold
+            swap_in_params = swap_in_params[:swap_in_params[0].nvme_swapper.swap_in_capacity(swap_in_params)]
         if swap_in_params:
             swap_in_params[0].nvme_swapper.swap_in(swap_in_params, async_op=True)
@@ -26,6 +26,7 @@ from deepspeed.runtime.swap_tensor.partitioned_param_swapper import PartitionedP
 from deepspeed.runtime.swap_tensor.optimizer_utils import OptimizerSwapper
 from deepspeed.runtime.swap_tensor.partitioned_optimizer_swapper import PartitionedOptimizerSwapper
 from deepspeed.runtime.swap_tensor.pipelined_optimizer_swapper import PipelinedOptimizerSwapper
+from deepspeed.runtime.swap_tensor.streaming_optimizer_swapper import StreamingOptimizerSwapper
 from deepspeed.checkpoint.constants import OPTIMIZER_STATE_DICT, FP32_FLAT_GROUPS, PARTITION_COUNT, ZERO_STAGE, LOSS_SCALER
 from deepspeed.accelerator import get_accelerator
 from deepspeed.utils import z3_leaf_parameter
@@ -154,6 +155,7 @@ class DeepSpeedZeroOptimizer_Stage3(ZeROOptimizer):
         self.external_loss_scale = None
 
         self.optimizer_swapper = None
+        self.stream_optimizer_state = False
         self.swap_optimizer = False
 
         self.offload_optimizer = False
@@ -587,6 +589,12 @@ class DeepSpeedZeroOptimizer_Stage3(ZeROOptimizer):
             logger.info(f'Tensor Swapping: Adding optimizer tensors')
 
         swapper_type = PipelinedOptimizerSwapper if offload_optimizer_config.pipeline else PartitionedOptimizerSwapper
+        if offload_optimizer_config.native_pipeline:
+            if type(self.optimizer) == DeepSpeedCPUAdam:
+                swapper_type = StreamingOptimizerSwapper
+                self.stream_optimizer_state = True
+            elif dist.get_rank() == 0:
+                logger.warning(f'native_pipeline requires DeepSpeedCPUAdam, falling back to {swapper_type.__name__}')
 
         self.optimizer_swapper = swapper_type(swap_config=offload_optimizer_config,
                                               aio_config=aio_config,
@@ -2006,6 +2014,23 @@ class DeepSpeedZeroOptimizer_Stage3(ZeROOptimizer):
         else:
             self._partitioned_params_swap_out(sub_group_id)
 
+    def _streamed_optimizer_subgroup(self, sub_group_id):
+        return (self.stream_optimizer_state and self._swappable_optimizer_subgroup(sub_group_id)
+                and self.subgroup_to_device[sub_group_id] == 'cpu')
+
+    @instrument_w_nvtx
+    def _streamed_optimizer_step(self, sub_group_id, scaled_global_grad_norm):
+        fp32_param = self.fp32_partitioned_groups_flat[sub_group_id]
+        param_group = self.optimizer.param_groups[self.sub_group_to_group_id[sub_group_id]]
+
+        #read the gradients, the fp32 parameters and optimizer states are streamed by the step
+        if self.optimizer_swapper.swap_in_gradients(fp32_param):
+            self.unscale_and_clip_grads(sub_group_id, scaled_global_grad_norm)
+            self.optimizer_swapper.stream_optimizer_step(fp32_param, param_group)
+            self._reassign_or_swap_out_partitioned_parameters(sub_group_id)
+
+        self.optimizer_swapper.release_streamed_parameter(fp32_param)
+
     def override_loss_scale(self, loss_scale):
         if loss_scale != self.external_loss_scale:
             logger.info(f'[deepspeed] setting loss scale from {self.external_loss_scale} -> {loss_scale}')
@@ -2040,6 +2065,10 @@ class DeepSpeedZeroOptimizer_Stage3(ZeROOptimizer):
         #update parameters one sub group at a time
         for sub_group_id, group in enumerate(self.fp16_groups):
 
+            if self._streamed_optimizer_subgroup(sub_group_id):
+                self._streamed_optimizer_step(sub_group_id, scaled_global_grad_norm)
+                continue
+
             #prepare optimizer states, gradients and fp32 parameters for update
             self._prepare_sub_group(sub_group_id, timer_names)
 
@@ -18,6 +18,8 @@ from deepspeed.runtime.utils import (bwc_tensor_model_parallel_rank, empty_cache
 from deepspeed.runtime.zero.config import ZeroStageEnum
 from deepspeed.runtime.zero.offload_config import OffloadDeviceEnum
 from deepspeed.ops.adam import DeepSpeedCPUAdam
+from deepspeed.ops.multi_tensor import load_cpu_multi_tensor
+from deepspeed.ops.multi_tensor.cpu_multi_tensor import is_multi_tensor_eligible
 from deepspeed.utils import logger
 from deepspeed.moe.utils import is_moe_param
 from deepspeed.git_version_info import version
@@ -458,10 +460,21 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
             for param in param_group:
                 self.is_param_in_current_partition[self.get_param_id(param)] = False
 
+        # native multi-tensor norm for gradients that live in host memory
+        self.cpu_multi_tensor = None
+        if self.cpu_offload or get_accelerator().device_name() == 'cpu':
+            self.cpu_multi_tensor = load_cpu_multi_tensor()
+
         if self.cpu_offload:
             self.accumulated_grads_in_cpu = {}
             self.norm_for_param_grads = {}
             self.local_overflow = False
+            # low precision host copies of the gradient partitions, one per param group
+            self.offload_grad_staging = []
+            # (param_id, fp32 grad slice, staging slice) waiting for the fused host accumulation
+            self.offload_grads_to_accumulate = []
+            # whether the fp32 grads hold partial sums of the current accumulation window
+            self.offload_grads_partially_accumulated = False
             self.grad_position = {}
             self.temp_grad_buffer_for_cpu_offload = torch.zeros(largest_param_numel,
                                                                 device=self.device,
@@ -673,6 +686,11 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
             self.single_partition_of_fp32_groups[i].grad = get_accelerator().pin_memory(
                 single_grad_partition) if self.cpu_offload_pin_memory else single_grad_partition
 
+            if self.cpu_offload and self._use_native_offload_grads():
+                grad_staging = torch.empty(int(self.partition_size[i]), dtype=self.dtype, device='cpu')
+                self.offload_grad_staging.append(
+                    get_accelerator().pin_memory(grad_staging) if self.cpu_offload_pin_memory else grad_staging)
+
         # Initialize the optimizer states with the flattened fp32 partition.
         # State initialization for the Adagrad optimizer occurs at construction as opposed to other optimizers
         # which do lazy initialization of the state at the first call to step.
@@ -755,6 +773,9 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
         for i in range(len(self.params_already_reduced)):
             self.params_already_reduced[i] = False
 
+        if self.cpu_offload and self._use_native_offload_grads():
+            self.accumulate_staged_grads_in_cpu()
+
         if self.overlap_comm:
             if not get_accelerator().resolves_data_dependency():
                 get_accelerator().synchronize()
@@ -1270,6 +1291,47 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
         dest_tensor.copy_(src_tensor, non_blocking=True)
         param.grad = None  #offload only
 
+    def _use_native_offload_grads(self):
+        return self.cpu_multi_tensor is not None and not self.fp16_master_weights_and_gradients
+
+    def async_stage_grad_to_cpu(self, param):
+        param_id = self.get_param_id(param)
+
+        [i, source_offset, dest_offset, num_elements] = self.grad_position[param_id]
+
+        grad_accum = self.get_param_gradient_attribute(param)
+        src_tensor = grad_accum.view(-1).narrow(0, source_offset, num_elements)
+        staging_tensor = self.offload_grad_staging[i].narrow(0, dest_offset, num_elements)
+        dest_tensor = self.single_partition_of_fp32_groups[i].grad.view(-1).narrow(0, dest_offset, num_elements)
+
+        # only the low precision gradient crosses the bus, the fp32 conversion happens on the host
+        staging_tensor.copy_(src_tensor, non_blocking=True)
+        self.offload_grads_to_accumulate.append((param_id, dest_tensor, staging_tensor))
+
+    def accumulate_staged_grads_in_cpu(self):
+        """Copies (first micro step) or adds (later micro steps) all staged gradients into the fp32
+        partition in a single native call. At the accumulation boundary the per-param squared norms
+        and the overflow flag are produced by the same pass."""
+        if len(self.offload_grads_to_accumulate) == 0:
+            return
+
+        # wait for the non-blocking device to host gradient copies
+        get_accelerator().synchronize()
+
+        param_ids, dest_tensors, staging_tensors = zip(*self.offload_grads_to_accumulate)
+        self.offload_grads_to_accumulate = []
+
+        sum_sq, inf_or_nan = self.cpu_multi_tensor.multi_tensor_accumulate(list(dest_tensors),
+                                                                           list(staging_tensors),
+                                                                           self.offload_grads_partially_accumulated,
+                                                                           self.is_gradient_accumulation_boundary)
+        self.offload_grads_partially_accumulated = not self.is_gradient_accumulation_boundary
+        if self.is_gradient_accumulation_boundary:
+            for param_id, param_sum_sq in zip(param_ids, sum_sq):
+                self.norm_for_param_grads[param_id] = param_sum_sq
+            if inf_or_nan:
+                self.local_overflow = True
+
     def complete_grad_norm_calculation_for_cpu_offload(self, params):
         total_norm = 0.0
         norm_type = 2.0
@@ -1284,8 +1346,12 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
                 # their backward hooks in self.create_reduce_and_remove_grad_hooks() will not run,
                 # so they have no norm_for_param_grads
                 if param_id in self.norm_for_param_grads:
-                    param_norm = self.norm_for_param_grads[param_id]
-                    total_norm += param_norm.item()**2
+                    if self._use_native_offload_grads():
+                        # squared norm produced by accumulate_staged_grads_in_cpu
+                        total_norm += self.norm_for_param_grads[param_id]
+                    else:
+                        param_norm = self.norm_for_param_grads[param_id]
+                        total_norm += param_norm.item()**2
                 else:
                     # As unused parameters in modules may not be expected sometimes,
                     # add an explicit error msg when it occurred and an option to
@@ -1316,6 +1382,12 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
     def copy_grads_in_partition(self, param):
         if self.cpu_offload:
 
+            if self._use_native_offload_grads():
+                self.async_stage_grad_to_cpu(param)
+                if self.is_gradient_accumulation_boundary:
+                    param.grad = None  #offload only
+                return
+
             if self.gradient_accumulation_steps > 1:
                 self.async_accumulate_grad_in_cpu_via_gpu(param)
 
@@ -1646,6 +1718,9 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
         else:
             dist.all_reduce(tensor=tensor, op=op, group=self.model_parallel_group)
 
+    def _use_native_grad_norm(self, gradients):
+        return self.cpu_multi_tensor is not None and is_multi_tensor_eligible(gradients)
+
     def get_grad_norm_direct(self, gradients, params, norm_type=2):
         """Clips gradient norm of an iterable of parameters.
 
@@ -1666,9 +1741,15 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
         norm_type = float(norm_type)
         all_norms = []
         if norm_type == inf:
-            for g in gradients:
-                all_norms.append(g.data.abs().max().float())
-            total_norm = torch.stack(all_norms).max()
+            if self._use_native_grad_norm(gradients):
+                norm, inf_or_nan = self.cpu_multi_tensor.multi_tensor_norm([g.data for g in gradients], norm_type)
+                total_norm = torch.tensor(float('inf') if inf_or_nan else norm,
+                                          dtype=torch.float,
+                                          device=self.device)
+            else:
+                for g in gradients:
+                    all_norms.append(g.data.abs().max().float())
+                total_norm = torch.stack(all_norms).max()
             dist.all_reduce(total_norm, op=dist.ReduceOp.MAX, group=self.dp_process_group)
 
             # Take max across all GPUs.
@@ -1676,14 +1757,22 @@ class DeepSpeedZeroOptimizer(ZeROOptimizer):
         else:
             # if dist.get_rank() == 0:
             #    logger.info(f"Total Norm beginning {total_norm}")
+            grads_for_norm = []
             for g, p in zip(gradients, params):
                 # Pipeline parallelism may replicate parameters. Avoid multi-counting.
                 if hasattr(p, PIPE_REPLICATED) and p.ds_pipe_replicated:
                     continue
                 if is_model_parallel_parameter(p) or (self.model_parallel_rank == 0):
+                    grads_for_norm.append(g.data)
+            if len(grads_for_norm) > 0 and self._use_native_grad_norm(grads_for_norm):
+                norm, inf_or_nan = self.cpu_multi_tensor.multi_tensor_norm(grads_for_norm, norm_type)
+                total_norm = torch.tensor(float('inf') if inf_or_nan else norm**2,
+                                          dtype=torch.float,
+                                          device=self.device)
+            elif len(grads_for_norm) > 0:
+                for g in grads_for_norm:
                     all_norms.append(
-                        torch.norm(g.data.double().detach(), norm_type).to(get_accelerator().current_device_name()))
-            if len(all_norms) > 0:
+                        torch.norm(g.double().detach(), norm_type).to(get_accelerator().current_device_name()))
                 total_norm = torch.stack(all_norms).square().sum().float()
             else:
                 total_norm = torch.tensor(0.0, dtype=torch.float32).to(self.device)
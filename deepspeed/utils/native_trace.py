@@ -0,0 +1,100 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+"""
+Chrome/Perfetto trace of the native ops.
+
+Native ops built with ``csrc/common/ds_trace.cpp`` (AIO, CCL comm, CPU optimizers) record spans
+such as swap reads/writes, collectives and optimizer steps into per-thread buffers. This module
+switches recording on and off in every loaded op and merges their events into one trace file that
+can be opened in ``chrome://tracing`` or https://ui.perfetto.dev.
+
+    .. code-block:: python
+
+        from deepspeed.utils import native_trace
+
+        native_trace.enable()
+        engine.step()
+        native_trace.export_chrome_trace("trace.json")
+"""
+
+import ctypes
+import json
+import os
+
+from deepspeed.utils import logger
+
+TRACE_ENV = "DS_NATIVE_TRACE"
+
+# Libraries that are not loaded through an op builder, e.g. dlopen'ed AIO device plugins
+_extra_libraries = set()
+_handles = {}
+
+
+def register_native_library(path):
+    """Adds a shared library built with ds_trace.cpp that is not loaded through an op builder."""
+    _extra_libraries.add(os.path.abspath(path))
+
+
+def _get_handle(path):
+    if path not in _handles:
+        handle = None
+        try:
+            # the library is already loaded, so this returns the existing instance
+            library = ctypes.CDLL(path)
+            library.ds_trace_collect_json.restype = ctypes.c_char_p
+            library.ds_trace_dropped_events.restype = ctypes.c_int64
+            library.ds_trace_set_enabled.argtypes = [ctypes.c_int]
+            handle = library
+        except (OSError, AttributeError):
+            pass
+        _handles[path] = handle
+    return _handles[path]
+
+
+def _traced_libraries():
+    from deepspeed.ops.op_builder.builder import OpBuilder
+    paths = set(_extra_libraries)
+    for op_module in OpBuilder._loaded_ops.values():
+        path = getattr(op_module, '__file__', None)
+        if path is not None:
+            paths.add(os.path.abspath(path))
+    return [handle for handle in map(_get_handle, sorted(paths)) if handle is not None]
+
+
+def set_enabled(enabled):
+    """Turns recording on or off in all loaded native ops, and in ops loaded afterwards."""
+    os.environ[TRACE_ENV] = "1" if enabled else "0"
+    for library in _traced_libraries():
+        library.ds_trace_set_enabled(int(enabled))
+
+
+def enable():
+    set_enabled(True)
+
+
+def disable():
+    set_enabled(False)
+
+
+def collect_events():
+    """Moves the buffered events of all loaded native ops out and returns them as a list of dicts."""
+    events = []
+    dropped = 0
+    for library in _traced_libraries():
+        collected = library.ds_trace_collect_json().decode()
+        if collected:
+            events += json.loads(f"[{collected}]")
+        dropped += library.ds_trace_dropped_events()
+    if dropped > 0:
+        logger.warning(f"native trace: {dropped} events dropped, collect more often")
+    return events
+
+
+def export_chrome_trace(path):
+    """Writes all events buffered so far to ``path`` in the Chrome trace event format."""
+    events = collect_events()
+    with open(path, "w") as fd:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, fd)
+    return len(events)
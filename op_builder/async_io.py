@@ -29,12 +29,16 @@ class AsyncIOBuilder(OpBuilder):
         return [
             'csrc/aio/py_lib/py_ds_aio.cpp',
             'csrc/aio/py_lib/py_ds_aio_trampoline.cpp',
+            'csrc/aio/py_lib/deepspeed_swap_buffer_manager.cpp',
             'csrc/aio/py_lib/trampoline.h'
         ]
 
     def load(self, verbose=True):
         op_module = super().load(verbose)
         self.trampoline = op_module.Trampoline(self.device_type)
+        # The trampoline dlopens the device plugin, so the native trace has to be told where it is
+        from deepspeed.utils.native_trace import register_native_library
+        register_native_library(os.path.join(os.getcwd(), 'deepspeed', 'ops', 'plugins', f'{self.device_type}_op.so'))
         return op_module
     
     def __getattr__(self, name):
@@ -7,4 +7,13 @@
 from .comm import CCLCommBuilder
 from .fused_adam import FusedAdamBuilder
 from .cpu_adam import CPUAdamBuilder
+from .cpu_multi_tensor import CPUMultiTensorBuilder
+from .native_profiler import NativeProfilerBuilder
+from .metrics_ring import MetricsRingBuilder
+from .evoformer_attn import EvoformerAttnBuilder
+from .spatial_inference import SpatialInferenceBuilder
+from .transformer import TransformerBuilder, StochasticTransformerBuilder
+from .ragged_ops import RaggedOpsBuilder
+from .ragged_utils import RaggedUtilsBuilder
+from .quantizer import QuantizerBuilder
 from .no_impl import NotImplementedBuilder
@@ -19,10 +19,10 @@ class CCLCommBuilder(CPUOpBuilder):
         return f'deepspeed.ops.comm.{self.NAME}_op'
 
     def sources(self):
-        return ['csrc/cpu/comm/ccl.cpp']
+        return ['csrc/cpu/comm/ccl.cpp', 'csrc/common/ds_trace.cpp']
 
     def include_paths(self):
-        includes = ['csrc/cpu/includes']
+        includes = ['csrc/cpu/includes', 'csrc/includes']
         return includes
 
     def cxx_args(self):
@@ -17,7 +17,10 @@ class CPUAdamBuilder(CPUOpBuilder):
         return f'deepspeed.ops.adam.{self.NAME}_op'
 
     def sources(self):
-        return ['csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp']
+        return [
+            'csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp', 'csrc/adam/cpu_adam_nvme.cpp',
+            'csrc/common/ds_trace.cpp'
+        ]
 
     def libraries_args(self):
         args = super().libraries_args()
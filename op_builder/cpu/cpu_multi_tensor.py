@@ -0,0 +1,34 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .builder import CPUOpBuilder
+
+
+class CPUMultiTensorBuilder(CPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_CPU_MULTI_TENSOR"
+    NAME = "cpu_multi_tensor"
+
+    def __init__(self):
+        super().__init__(name=self.NAME)
+
+    def absolute_name(self):
+        return f'deepspeed.ops.multi_tensor.{self.NAME}_op'
+
+    def sources(self):
+        return [
+            'csrc/multi_tensor/cpu_multi_tensor.cpp', 'csrc/multi_tensor/cpu_multi_tensor_norm.cpp',
+            'csrc/multi_tensor/cpu_multi_tensor_accumulate.cpp', 'csrc/multi_tensor/cpu_multi_tensor_bf16.cpp'
+        ]
+
+    def include_paths(self):
+        return ['csrc/includes']
+
+    def cxx_args(self):
+        args = super().cxx_args()
+        args += [self.cpu_arch(), '-fopenmp', self.simd_width()]
+        return args
+
+    def extra_ldflags(self):
+        return ['-fopenmp']
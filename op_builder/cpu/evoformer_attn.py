@@ -0,0 +1,32 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .builder import CPUOpBuilder
+
+
+class EvoformerAttnBuilder(CPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_EVOFORMER_ATTN"
+    NAME = "evoformer_attn"
+
+    def __init__(self, name=None):
+        name = self.NAME if name is None else name
+        super().__init__(name=name)
+
+    def absolute_name(self):
+        return f'deepspeed.ops.{self.NAME}_op'
+
+    def sources(self):
+        return ['csrc/deepspeed4science/evoformer_attn/attention_cpu.cpp']
+
+    def include_paths(self):
+        return ['csrc/deepspeed4science/evoformer_attn']
+
+    def cxx_args(self):
+        args = super().cxx_args()
+        args += [self.cpu_arch(), '-fopenmp', self.simd_width()]
+        return args
+
+    def extra_ldflags(self):
+        return ['-fopenmp']
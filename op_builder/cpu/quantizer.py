@@ -0,0 +1,37 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .builder import CPUOpBuilder
+
+
+class QuantizerBuilder(CPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_QUANTIZER"
+    NAME = "quantizer"
+
+    def __init__(self, name=None):
+        name = self.NAME if name is None else name
+        super().__init__(name=name)
+
+    def absolute_name(self):
+        return f'deepspeed.ops.quantizer.{self.NAME}_op'
+
+    def sources(self):
+        return [
+            'csrc/quantization/pt_binding_cpu.cpp',
+            'csrc/quantization/quantize_cpu.cpp',
+            'csrc/quantization/fake_quantizer_cpu.cpp',
+        ]
+
+    def include_paths(self):
+        return ['csrc/includes']
+
+    def cxx_args(self):
+        args = super().cxx_args()
+        # No fused multiply-adds, the fake quantizers must round like the torch ops.
+        args += [self.cpu_arch(), '-fopenmp', self.simd_width(), '-ffp-contract=off']
+        return args
+
+    def extra_ldflags(self):
+        return ['-fopenmp']
@@ -0,0 +1,53 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import os
+
+from .builder import CPUOpBuilder
+
+
+class RaggedOpsBuilder(CPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_RAGGED_DEVICE_OPS"
+    NAME = "ragged_device_ops"
+
+    def __init__(self, name=None):
+        name = self.NAME if name is None else name
+        super().__init__(name=name)
+
+    def absolute_name(self):
+        return f'deepspeed.inference.v2.kernels.ragged_ops.{self.NAME}'
+
+    def get_prefix(self):
+        ds_path = self.deepspeed_src_path("deepspeed")
+        return "deepspeed" if os.path.isdir(ds_path) else ".."
+
+    def sources(self):
+        sources = [
+            "inference/v2/kernels/ragged_ops/ragged_ops_cpu.cpp",
+            "inference/v2/kernels/ragged_ops/embed/embed_cpu.cpp",
+            "inference/v2/kernels/ragged_ops/ragged_helpers/ragged_kernel_helpers.cpp",
+        ]
+
+        prefix = self.get_prefix()
+        sources = [os.path.join(prefix, src) for src in sources]
+        return sources
+
+    def include_paths(self):
+        sources = [
+            'inference/v2/kernels/ragged_ops/embed',
+            'inference/v2/kernels/ragged_ops/ragged_helpers',
+        ]
+
+        prefix = self.get_prefix()
+        sources = [os.path.join(prefix, src) for src in sources]
+        return sources
+
+    def cxx_args(self):
+        args = super().cxx_args()
+        args += [self.cpu_arch(), '-fopenmp', self.simd_width()]
+        return args
+
+    def extra_ldflags(self):
+        return ['-fopenmp']
@@ -0,0 +1,52 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import os
+
+from .builder import CPUOpBuilder
+
+
+class RaggedUtilsBuilder(CPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_RAGGED_OPS"
+    NAME = "ragged_ops"
+
+    def __init__(self, name=None):
+        name = self.NAME if name is None else name
+        super().__init__(name=name)
+
+    def absolute_name(self):
+        return f'deepspeed.inference.v2.{self.NAME}'
+
+    def get_prefix(self):
+        ds_path = self.deepspeed_src_path("deepspeed")
+        return "deepspeed" if os.path.isdir(ds_path) else ".."
+
+    def sources(self):
+        # Same sources as the CUDA build, without the pinned host allocations of fast_host_buffer.cu.
+        sources = [
+            "inference/v2/ragged/csrc/activation_planner.cpp",
+            "inference/v2/ragged/csrc/blocked_allocator.cpp",
+            "inference/v2/ragged/csrc/host_staging_arena.cpp",
+            "inference/v2/ragged/csrc/ragged_ops.cpp",
+            "inference/v2/ragged/csrc/request_queue.cpp",
+            "inference/v2/ragged/csrc/shard_copy.cpp",
+            "inference/v2/ragged/csrc/tensor_range_loader.cpp",
+        ]
+
+        prefix = self.get_prefix()
+        sources = [os.path.join(prefix, src) for src in sources]
+        return sources
+
+    def include_paths(self):
+        include_dirs = ['inference/v2/ragged/includes']
+        prefix = self.get_prefix()
+        includes = [os.path.join(prefix, include_dir) for include_dir in include_dirs]
+
+        return includes
+
+    def cxx_args(self):
+        args = super().cxx_args()
+        args += ['-D__DISABLE_CUDA__']
+        return args
@@ -0,0 +1,35 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .builder import CPUOpBuilder
+
+
+class SpatialInferenceBuilder(CPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_SPATIAL_INFERENCE"
+    NAME = "spatial_inference"
+
+    def __init__(self, name=None):
+        name = self.NAME if name is None else name
+        super().__init__(name=name)
+
+    def absolute_name(self):
+        return f'deepspeed.ops.spatial.{self.NAME}_op'
+
+    def sources(self):
+        return [
+            'csrc/spatial/csrc/opt_bias_add_cpu.cpp',
+            'csrc/spatial/csrc/pt_binding_cpu.cpp',
+        ]
+
+    def include_paths(self):
+        return ['csrc/spatial/includes', 'csrc/includes']
+
+    def cxx_args(self):
+        args = super().cxx_args()
+        args += [self.cpu_arch(), '-fopenmp', self.simd_width()]
+        return args
+
+    def extra_ldflags(self):
+        return ['-fopenmp']
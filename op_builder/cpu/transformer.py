@@ -0,0 +1,42 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .builder import CPUOpBuilder
+
+
+class TransformerBuilder(CPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_TRANSFORMER"
+    NAME = "transformer"
+
+    def __init__(self, name=None):
+        name = self.NAME if name is None else name
+        super().__init__(name=name)
+
+    def absolute_name(self):
+        return f'deepspeed.ops.transformer.{self.NAME}_op'
+
+    def sources(self):
+        return ['csrc/cpu/transformer/ds_transformer_cpu.cpp', 'csrc/cpu/transformer/transformer_kernels_cpu.cpp']
+
+    def include_paths(self):
+        return ['csrc/includes']
+
+    def cxx_args(self):
+        args = super().cxx_args()
+        args += [self.cpu_arch(), '-fopenmp', self.simd_width()]
+        return args
+
+    def extra_ldflags(self):
+        return ['-fopenmp']
+
+
+class StochasticTransformerBuilder(TransformerBuilder):
+    """The CPU layer runs the same kernels in both modes, stochastic mode only affects CUDA
+    stream synchronization."""
+    BUILD_VAR = "DS_BUILD_STOCHASTIC_TRANSFORMER"
+    NAME = "stochastic_transformer"
+
+    def __init__(self):
+        super().__init__(name=self.NAME)
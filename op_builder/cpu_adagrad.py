@@ -19,9 +19,9 @@ class CPUAdagradBuilder(TorchCPUOpBuilder):
 
     def sources(self):
         if self.build_for_cpu:
-            return ['csrc/adagrad/cpu_adagrad.cpp']
+            return ['csrc/adagrad/cpu_adagrad.cpp', 'csrc/common/ds_trace.cpp']
 
-        return ['csrc/adagrad/cpu_adagrad.cpp', 'csrc/common/custom_cuda_kernel.cu']
+        return ['csrc/adagrad/cpu_adagrad.cpp', 'csrc/common/ds_trace.cpp', 'csrc/common/custom_cuda_kernel.cu']
 
     def libraries_args(self):
         args = super().libraries_args()
@@ -19,9 +19,15 @@ class CPUAdamBuilder(TorchCPUOpBuilder):
 
     def sources(self):
         if self.build_for_cpu:
-            return ['csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp']
-
-        return ['csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp', 'csrc/common/custom_cuda_kernel.cu']
+            return [
+                'csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp', 'csrc/adam/cpu_adam_nvme.cpp',
+                'csrc/common/ds_trace.cpp'
+            ]
+
+        return [
+            'csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp', 'csrc/adam/cpu_adam_nvme.cpp',
+            'csrc/common/ds_trace.cpp', 'csrc/common/custom_cuda_kernel.cu'
+        ]
 
     def libraries_args(self):
         args = super().libraries_args()
@@ -19,9 +19,12 @@ class CPULionBuilder(TorchCPUOpBuilder):
 
     def sources(self):
         if self.build_for_cpu:
-            return ['csrc/lion/cpu_lion.cpp', 'csrc/lion/cpu_lion_impl.cpp']
+            return ['csrc/lion/cpu_lion.cpp', 'csrc/lion/cpu_lion_impl.cpp', 'csrc/common/ds_trace.cpp']
 
-        return ['csrc/lion/cpu_lion.cpp', 'csrc/lion/cpu_lion_impl.cpp', 'csrc/common/custom_cuda_kernel.cu']
+        return [
+            'csrc/lion/cpu_lion.cpp', 'csrc/lion/cpu_lion_impl.cpp', 'csrc/common/ds_trace.cpp',
+            'csrc/common/custom_cuda_kernel.cu'
+        ]
 
     def libraries_args(self):
         args = super().libraries_args()
@@ -18,7 +18,10 @@ class CPUAdamBuilder(CPUOpBuilder):
         return f'deepspeed.ops.adam.{self.NAME}_op'
 
     def sources(self):
-        return ['csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp']
+        return [
+            'csrc/adam/cpu_adam.cpp', 'csrc/adam/cpu_adam_impl.cpp', 'csrc/adam/cpu_adam_nvme.cpp',
+            'csrc/common/ds_trace.cpp'
+        ]
 
     def cxx_args(self):
         args = super().cxx_args()
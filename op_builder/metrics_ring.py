@@ -0,0 +1,23 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .builder import TorchCPUOpBuilder
+
+
+class MetricsRingBuilder(TorchCPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_METRICS_RING"
+    NAME = "metrics_ring"
+
+    def __init__(self):
+        super().__init__(name=self.NAME)
+
+    def absolute_name(self):
+        return f'deepspeed.ops.monitor.{self.NAME}_op'
+
+    def sources(self):
+        return ['csrc/monitor/py_ds_metrics_ring.cpp']
+
+    def include_paths(self):
+        return ['csrc/includes']
@@ -0,0 +1,23 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from .builder import TorchCPUOpBuilder
+
+
+class NativeProfilerBuilder(TorchCPUOpBuilder):
+    BUILD_VAR = "DS_BUILD_NATIVE_PROFILER"
+    NAME = "native_profiler"
+
+    def __init__(self):
+        super().__init__(name=self.NAME)
+
+    def absolute_name(self):
+        return f'deepspeed.ops.profiler.{self.NAME}_op'
+
+    def sources(self):
+        return ['csrc/profiler/ds_profiler.cpp', 'csrc/profiler/py_ds_profiler.cpp']
+
+    def include_paths(self):
+        return ['csrc/includes']
@@ -25,12 +25,13 @@ class AsyncIOBuilder(NPUOpBuilder):
             'csrc/aio/py_lib/deepspeed_py_aio.cpp', 'csrc/aio/py_lib/deepspeed_py_aio_handle.cpp',
             'csrc/aio/py_lib/deepspeed_aio_thread.cpp', 'csrc/aio/common/deepspeed_aio_utils.cpp',
             'csrc/aio/common/deepspeed_aio_common.cpp', 'csrc/aio/common/deepspeed_aio_types.cpp',
-            'csrc/aio/py_lib/deepspeed_pin_tensor.cpp'
+            'csrc/aio/py_lib/deepspeed_pin_tensor.cpp', 'csrc/aio/py_lib/deepspeed_swap_buffer_manager.cpp',
+            'csrc/common/ds_trace.cpp'
         ]
 
     def include_paths(self):
         args = super().include_paths()
-        args += ['csrc/aio/py_lib', 'csrc/aio/common']
+        args += ['csrc/aio/py_lib', 'csrc/aio/common', 'csrc/includes']
         return args
 
     def cxx_args(self):
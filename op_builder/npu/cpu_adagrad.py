@@ -17,7 +17,7 @@ class CPUAdagradBuilder(NPUOpBuilder):
         return f'deepspeed.ops.adagrad.{self.NAME}_op'
 
     def sources(self):
-        return ['csrc/adagrad/cpu_adagrad.cpp']
+        return ['csrc/adagrad/cpu_adagrad.cpp', 'csrc/common/ds_trace.cpp']
 
     def include_paths(self):
         args = super().include_paths()
@@ -17,7 +17,7 @@ class CPULionBuilder(NPUOpBuilder):
         return f'deepspeed.ops.lion.{self.NAME}_op'
 
     def sources(self):
-        return ['csrc/lion/cpu_lion.cpp', 'csrc/lion/cpu_lion_impl.cpp']
+        return ['csrc/lion/cpu_lion.cpp', 'csrc/lion/cpu_lion_impl.cpp', 'csrc/common/ds_trace.cpp']
 
     def include_paths(self):
         args = super().include_paths()
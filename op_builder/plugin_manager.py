@@ -34,7 +34,10 @@ class PluginManager:
         plugin_sources = [os.path.join(plugin_base_path, f) for f in os.listdir(abs_plugin_base_path) if f.endswith(('.cpp', '.h'))]
         common_sources = [os.path.join(common_base_path, f) for f in os.listdir(abs_common_base_path) if f.endswith(('.cpp', '.h'))]
         
-        return plugin_sources + common_sources
+        # shared native tracing, see csrc/includes/ds_trace.h
+        trace_sources = ['csrc/common/ds_trace.cpp']
+
+        return plugin_sources + common_sources + trace_sources
 
     def get_include_paths(self, device_type):
         plugin_base_path = os.path.join('csrc/aio/plugins', device_type)
@@ -45,7 +48,7 @@ class PluginManager:
             device_type = self.default_device_type
             plugin_base_path = os.path.join('csrc/aio/plugins', device_type)
 
-        return [plugin_base_path, common_base_path]
+        return [plugin_base_path, common_base_path, 'csrc/includes']
 
     def get_plugin_info(self, device_type):
         if device_type in self.plugins:
@@ -58,8 +58,14 @@ class RaggedUtilsBuilder(CUDAOpBuilder):
 
     def sources(self):
         sources = [
+            "inference/v2/ragged/csrc/activation_planner.cpp",
+            "inference/v2/ragged/csrc/blocked_allocator.cpp",
             "inference/v2/ragged/csrc/fast_host_buffer.cu",
+            "inference/v2/ragged/csrc/host_staging_arena.cpp",
             "inference/v2/ragged/csrc/ragged_ops.cpp",
+            "inference/v2/ragged/csrc/request_queue.cpp",
+            "inference/v2/ragged/csrc/shard_copy.cpp",
+            "inference/v2/ragged/csrc/tensor_range_loader.cpp",
         ]
 
         prefix = self.get_prefix()
@@ -76,3 +76,104 @@ def test_autotuner_resources(tmpdir, active_resources):
 
     expected_num_gpus = min([len(v) for v in active_resources.values()])
     assert expected_num_gpus == tuner.exp_num_gpus
+
+
+MACHINE_PROFILE = {
+    'version': 1,
+    'device_memory': 80 * 1024**3,
+    'gemm_tflops': [[128, 20.0], [512, 80.0], [2048, 150.0], [8192, 200.0], [32768, 210.0]],
+    'device_memory_GBps': 1500.0,
+    'host_device_GBps': 20.0,
+    'cpu_adam_GBps': 10.0,
+    'intra_node_GBps': 100.0,
+    'inter_node_GBps': 12.5,
+    'collective_latency_usec': 30.0,
+    'aio_read_GBps': 3.0,
+    'aio_write_GBps': 2.0,
+}
+
+MODEL_INFO = {"num_params": 1_300_000_000, "hidden_size": 2048, "num_layers": 24}
+
+
+def _cost_model_ds_config(stage, mbs, **zero_config):
+    return {
+        "train_micro_batch_size_per_gpu": mbs,
+        "gradient_accumulation_steps": 1,
+        "fp16": {
+            "enabled": True
+        },
+        "zero_optimization": dict(stage=stage, **zero_config)
+    }
+
+
+def test_cost_model_memory():
+    from deepspeed.autotuning.performance_model import AnalyticalCostModel
+    model = AnalyticalCostModel(MACHINE_PROFILE, MODEL_INFO, num_gpus=8, num_nodes=1)
+
+    memory = [model.estimate_memory(_cost_model_ds_config(stage, 1)) for stage in range(4)]
+    assert memory == sorted(memory, reverse=True)
+    assert model.estimate_memory(_cost_model_ds_config(2, 8)) > model.estimate_memory(_cost_model_ds_config(2, 1))
+
+    offload = _cost_model_ds_config(2, 1, offload_optimizer={"device": "cpu"})
+    assert model.estimate_memory(offload) < memory[2]
+
+    # a 1.3B model does not fit a single 80GB GPU at stage 0 with a large micro batch
+    assert not model.fits(_cost_model_ds_config(0, 64), MACHINE_PROFILE['device_memory'])
+
+
+def test_cost_model_step_time():
+    from deepspeed.autotuning.performance_model import AnalyticalCostModel
+    model = AnalyticalCostModel(MACHINE_PROFILE, MODEL_INFO, num_gpus=8, num_nodes=1)
+
+    # larger micro batches use the GEMMs more efficiently
+    throughputs = [model.estimate_metrics(_cost_model_ds_config(2, mbs))['throughput'] for mbs in (1, 4, 16)]
+    assert throughputs == sorted(throughputs)
+
+    # fewer, larger buckets pay the collective latency less often
+    small_buckets = model.estimate_step_time(_cost_model_ds_config(2, 1, reduce_bucket_size=1e6))
+    large_buckets = model.estimate_step_time(_cost_model_ds_config(2, 1, reduce_bucket_size=5e8))
+    assert small_buckets['communication'] > large_buckets['communication']
+
+    no_overlap = model.estimate_step_time(_cost_model_ds_config(2, 1, overlap_comm=False))
+    overlap = model.estimate_step_time(_cost_model_ds_config(2, 1, overlap_comm=True))
+    assert overlap['communication'] < no_overlap['communication']
+
+    cpu_offload = model.estimate_step_time(_cost_model_ds_config(2, 1, offload_optimizer={"device": "cpu"}))
+    nvme_offload = model.estimate_step_time(_cost_model_ds_config(2, 1, offload_optimizer={"device": "nvme"}))
+    assert no_overlap['optimizer'] < cpu_offload['optimizer'] < nvme_offload['optimizer']
+
+
+def test_simulated_resource_manager(tmpdir):
+    import json
+    from deepspeed.autotuning.performance_model import AnalyticalCostModel
+    from deepspeed.autotuning.scheduler import SimulatedResourceManager
+    from deepspeed.autotuning.utils import write_experiments
+
+    model = AnalyticalCostModel(MACHINE_PROFILE, MODEL_INFO, num_gpus=8, num_nodes=1)
+    args = dsrun.parse_args(args=f'--autotuning {TUNE_OPTION} foo.py --deepspeed_config ds_config.json'.split())
+    rm = SimulatedResourceManager(args=args,
+                                  hosts=["worker-0"],
+                                  num_gpus_per_node=8,
+                                  results_dir=os.path.join(tmpdir, 'results'),
+                                  exps_dir=os.path.join(tmpdir, 'exps'),
+                                  arg_mappings=None,
+                                  cost_model=model,
+                                  device_memory=MACHINE_PROFILE['device_memory'])
+
+    exps = []
+    for mbs in (1, 4, 64):
+        ds_config = _cost_model_ds_config(0, mbs)
+        ds_config["autotuning"] = {"enabled": True}
+        exps.append({'name': f'z0_mbs{mbs}', 'ds_config': ds_config, 'num_gpus': 8, 'num_nodes': 1})
+    os.makedirs(rm.exps_dir)
+    rm.schedule_experiments(write_experiments(exps, rm.exps_dir))
+    rm.run()
+
+    errors = {exp['name']: err for exp, err in rm.finished_experiments.values()}
+    assert errors['z0_mbs1'] is None and errors['z0_mbs4'] is None
+    assert 'out of memory' in errors['z0_mbs64']
+
+    best_exp, best_throughput = rm.parse_results('throughput')
+    assert best_exp['name'] == 'z0_mbs4'
+    with open(os.path.join(best_exp['result_dir'], 'ds_config.json')) as fd:
+        assert json.load(fd)['train_micro_batch_size_per_gpu'] == 4
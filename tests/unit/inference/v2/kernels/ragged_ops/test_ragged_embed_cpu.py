@@ -0,0 +1,127 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from typing import List, Optional, Tuple
+
+import pytest
+import torch
+
+from deepspeed.accelerator import get_accelerator
+
+if get_accelerator().device_name() != 'cpu':
+    pytest.skip('The CPU ragged embedding kernel runs on the CPU accelerator', allow_module_level=True)
+
+if not get_accelerator().create_op_builder("RaggedOpsBuilder").is_compatible():
+    pytest.skip('The CPU ragged ops are not compatible', allow_module_level=True)
+
+# RaggedBatchWrapper needs the CUDA ragged utils, so the batch metadata is built here directly.
+
+
+def build_metadata(sequence_config: List[Tuple[int, int]],
+                   padding: int = 0) -> Tuple[torch.Tensor, torch.Tensor, torch.Tensor, torch.Tensor]:
+    """
+    Returns the batch descriptor, the inflight sequence descriptors, the token to sequence map
+    and an empty KV pointer table for sequences of (n_tokens, seen_tokens). Padded tokens are
+    mapped to sequence 0, like the padding of RaggedBatchWrapper.
+    """
+    n_tokens = sum(seq_len for seq_len, _ in sequence_config)
+    batch_metadata = torch.tensor([n_tokens, len(sequence_config)], dtype=torch.int32)
+
+    seq_metadata = torch.zeros((len(sequence_config), 4), dtype=torch.int32)
+    tokens_to_seq = torch.zeros(n_tokens + padding, dtype=torch.int32)
+    start_idx = 0
+    for seq_idx, (seq_len, seen_tokens) in enumerate(sequence_config):
+        seq_metadata[seq_idx, :3] = torch.tensor([start_idx, seq_len, seen_tokens], dtype=torch.int32)
+        tokens_to_seq[start_idx:start_idx + seq_len] = seq_idx
+        start_idx += seq_len
+
+    kv_ptrs = torch.zeros(len(sequence_config), dtype=torch.int64)
+    return batch_metadata, seq_metadata, tokens_to_seq, kv_ptrs
+
+
+def _ragged_embed_cpu_test_helper(sequence_config: List[Tuple[int, int]],
+                                  embed_dtype: torch.dtype,
+                                  token_dtype: torch.dtype,
+                                  embed_dim: int,
+                                  vocab_size: int,
+                                  padding: int = 0,
+                                  pos_embed_size: int = -1,
+                                  pos_embed_offset: int = 0) -> None:
+    kernel = get_accelerator().create_op_builder("RaggedOpsBuilder").load().ragged_embed
+
+    batch_metadata, seq_metadata, tokens_to_seq, kv_ptrs = build_metadata(sequence_config, padding)
+    n_tokens = int(batch_metadata[0])
+    input_ids = torch.randint(0, vocab_size, (n_tokens + padding, ), dtype=token_dtype)
+    embedding_table = torch.randn((vocab_size, embed_dim), dtype=embed_dtype)
+
+    expected = torch.nn.functional.embedding(input_ids[:n_tokens], embedding_table)
+    pos_embedding_table: Optional[torch.Tensor] = None
+    if pos_embed_size > 0:
+        pos_embedding_table = torch.randn((pos_embed_size, embed_dim), dtype=embed_dtype)
+        positional_ids = torch.cat([
+            torch.arange(seen_tokens, seen_tokens + seq_len, dtype=torch.int64)
+            for seq_len, seen_tokens in sequence_config
+        ]) + pos_embed_offset
+        positional_ids = positional_ids.clamp(0, pos_embed_size - 1)
+        expected = (expected.float() +
+                    torch.nn.functional.embedding(positional_ids, pos_embedding_table).float()).to(embed_dtype)
+
+    # Padded rows are not written.
+    output = torch.full((n_tokens + padding, embed_dim), -1.0, dtype=embed_dtype)
+    kernel(output, input_ids, embedding_table, pos_embedding_table, pos_embed_offset, batch_metadata, seq_metadata,
+           tokens_to_seq, kv_ptrs)
+
+    assert torch.equal(output[:n_tokens], expected)
+    assert torch.all(output[n_tokens:] == -1.0)
+
+
+@pytest.mark.inference_v2_ops
+@pytest.mark.parametrize('token_dtype', [torch.int32, torch.int64])
+@pytest.mark.parametrize('embed_dtype', [torch.float16, torch.bfloat16, torch.float32])
+def test_dtype_permutations(token_dtype: torch.dtype, embed_dtype: torch.dtype) -> None:
+    _ragged_embed_cpu_test_helper([(256, 0)], embed_dtype, token_dtype, 512, 4096)
+
+
+@pytest.mark.inference_v2_ops
+@pytest.mark.parametrize('seq_lens', [[128, 64, 192, 32], [57, 112, 63, 89, 1, 1, 1, 1]])
+@pytest.mark.parametrize('padding', [0, 17])
+def test_complex_sequences(seq_lens: List[int], padding: int) -> None:
+    _ragged_embed_cpu_test_helper([(seq_len, 0) for seq_len in seq_lens],
+                                  torch.float32,
+                                  torch.int32,
+                                  256,
+                                  32000,
+                                  padding=padding)
+
+
+@pytest.mark.inference_v2_ops
+@pytest.mark.parametrize('embed_dtype', [torch.bfloat16, torch.float32])
+@pytest.mark.parametrize('pos_embed_offset', [0, 2])
+def test_positional_embedding(embed_dtype: torch.dtype, pos_embed_offset: int) -> None:
+    # The last sequence runs past the table and is clamped to its last row.
+    seq_config = [(1, 877), (619, 0), (213, 372), (1, 45), (8, 2044)]
+    _ragged_embed_cpu_test_helper(seq_config,
+                                  embed_dtype,
+                                  torch.int32,
+                                  256,
+                                  4096,
+                                  pos_embed_size=2048,
+                                  pos_embed_offset=pos_embed_offset)
+
+
+@pytest.mark.inference_v2_ops
+def test_invalid_tokens_are_skipped() -> None:
+    kernel = get_accelerator().create_op_builder("RaggedOpsBuilder").load().ragged_embed
+
+    batch_metadata, seq_metadata, tokens_to_seq, kv_ptrs = build_metadata([(4, 0)])
+    input_ids = torch.tensor([3, -1, 100, 0], dtype=torch.int32)
+    embedding_table = torch.randn((100, 64))
+    output = torch.zeros((4, 64))
+
+    kernel(output, input_ids, embedding_table, None, 0, batch_metadata, seq_metadata, tokens_to_seq, kv_ptrs)
+
+    assert torch.equal(output[0], embedding_table[3])
+    assert torch.equal(output[3], embedding_table[0])
+    assert torch.all(output[1:3] == 0)
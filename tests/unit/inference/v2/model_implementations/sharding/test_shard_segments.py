@@ -0,0 +1,27 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import pytest
+import torch
+
+from deepspeed.inference.v2.model_implementations.sharding.utils import gather_shard_segments, get_shard_segments
+
+
+@pytest.mark.inference_v2
+@pytest.mark.parametrize("shape, dim", [((96, ), 0), ((96, 40), 0), ((40, 96), -1), ((4, 96, 40), -2)])
+@pytest.mark.parametrize("n_shards", [1, 2, 3])
+def test_host_gather_matches_cat(shape, dim: int, n_shards: int):
+    param = torch.randn(shape, dtype=torch.float16)
+    size = param.size(dim)
+
+    for shard_rank in range(n_shards):
+        segments = get_shard_segments(size, shard_rank, n_shards, num_concatenated_matrices=3, granularity=8)
+        expected = torch.cat([param.narrow(dim, start, length) for start, length in segments], dim=dim)
+        assert torch.equal(gather_shard_segments(param, dim, segments), expected)
+
+    # Arbitrary, unordered segments
+    segments = [(size - 8, 8), (0, 16), (40, 0), (24, 8)]
+    expected = torch.cat([param.narrow(dim, start, length) for start, length in segments], dim=dim)
+    assert torch.equal(gather_shard_segments(param, dim, segments), expected)
@@ -0,0 +1,59 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import pytest
+import torch
+
+from deepspeed.inference.v2.model_implementations.flat_model_helpers import (
+    kv_cache_config_to_dict,
+    load_model_snapshot,
+    write_model_snapshot,
+    LayerMetadata,
+    ModelMetadata,
+    ParameterMetadata,
+    TensorMetadata,
+)
+from deepspeed.inference.v2.ragged import KVCacheConfig
+
+
+def make_metadata() -> ModelMetadata:
+    metadata = ModelMetadata(policy="TestPolicy")
+    param = ParameterMetadata(core_param=TensorMetadata(dtype="torch.float16", shape=(4, 8), strides=(8, 1), offset=0))
+    metadata.layers["transformer_layer_0"] = LayerMetadata(params={"qkv_w": param})
+    return metadata
+
+
+@pytest.mark.inference_v2
+def test_snapshot_round_trip(tmp_path):
+    buffer = torch.randint(0, 255, (3 * 4096 + 17, ), dtype=torch.uint8)
+    metadata = make_metadata()
+    kv_configs = (KVCacheConfig(block_size=64, cache_shape=(2, 4, 64)), )
+
+    filename = str(tmp_path / "snapshot_rank_0_of_1.dss")
+    write_model_snapshot(filename, buffer, metadata, kv_configs)
+
+    restored, restored_metadata, restored_kv = load_model_snapshot(filename)
+    assert torch.equal(restored.cpu(), buffer)
+    assert restored_metadata == metadata
+    assert restored_kv == [kv_cache_config_to_dict(config) for config in kv_configs]
+
+
+@pytest.mark.inference_v2
+def test_snapshot_detects_corruption(tmp_path):
+    buffer = torch.randint(0, 255, (8192, ), dtype=torch.uint8)
+    filename = str(tmp_path / "snapshot_rank_0_of_1.dss")
+    write_model_snapshot(filename, buffer, make_metadata(), ())
+
+    with open(filename, "r+b") as f:
+        f.seek(-100, 2)
+        value = f.read(1)
+        f.seek(-100, 2)
+        f.write(bytes([value[0] ^ 0xff]))
+
+    with pytest.raises(ValueError):
+        load_model_snapshot(filename)
+
+    restored, _, _ = load_model_snapshot(filename, verify_checksums=False)
+    assert not torch.equal(restored.cpu(), buffer)
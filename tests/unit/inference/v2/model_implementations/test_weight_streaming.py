@@ -0,0 +1,76 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import pytest
+import torch
+
+from deepspeed.accelerator import get_accelerator
+from deepspeed.inference.v2.model_implementations.flat_model_helpers import (
+    flatten_inference_model,
+    layer_byte_range,
+)
+from deepspeed.inference.v2.model_implementations.layer_container_base import LayerContainer
+from deepspeed.inference.v2.model_implementations.weight_streaming import HostLayerSource, StreamedLayers
+
+from .parameters.utils import SimpleParam, DummyInferenceModel
+
+
+class StreamedLayer(LayerContainer):
+    qkv_w: SimpleParam
+    mlp_w: SimpleParam
+
+
+class NonTransformer(LayerContainer):
+    embed_w: SimpleParam
+
+
+@pytest.mark.inference_v2
+@pytest.mark.parametrize("n_layers", [1, 3, 4])
+def test_streamed_layers(n_layers: int):
+    inference_model = DummyInferenceModel()
+
+    containers = []
+    references = []
+    for layer_idx in range(n_layers):
+        layer = StreamedLayer(inference_model)
+        qkv = torch.randn(16, 24 + layer_idx)
+        mlp = torch.randn(8, 16)
+        layer.qkv_w.param = qkv
+        layer.mlp_w.param = mlp
+        containers.append(layer)
+        references.append((qkv, mlp))
+
+    non_transformer = NonTransformer(inference_model)
+    non_transformer.embed_w.param = torch.randn(32, 16)
+
+    buffer, metadata = flatten_inference_model(containers, non_transformer, "TestPolicy", host_buffer=True)
+    assert buffer.device == torch.device("cpu")
+
+    ranges = [layer_byte_range(metadata.layers[f"transformer_layer_{i}"]) for i in range(n_layers)]
+    for (_, end), (start, _) in zip(ranges[:-1], ranges[1:]):
+        assert end <= start
+
+    layers = StreamedLayers(containers, metadata, ranges,
+                            lambda slot_bytes, n_slots: HostLayerSource(buffer, ranges, n_slots))
+
+    device = torch.device(get_accelerator().current_device())
+    for container in containers:
+        assert container.is_initialized
+
+    # Access pattern of the model implementations, for two forwards.
+    for _ in range(2):
+        _ = layers[0]
+        for layer_idx in range(n_layers):
+            current = layers[layer_idx]
+            qkv, mlp = references[layer_idx]
+            assert current.qkv_w.device == device
+            assert torch.equal(current.qkv_w.cpu(), qkv)
+            assert torch.equal(current.mlp_w.cpu(), mlp)
+            if layer_idx != n_layers - 1:
+                _ = layers[layer_idx + 1]
+
+    # Out of order accesses fall back to a synchronous load.
+    for layer_idx in reversed(range(n_layers)):
+        assert torch.equal(layers[layer_idx].qkv_w.cpu(), references[layer_idx][0])
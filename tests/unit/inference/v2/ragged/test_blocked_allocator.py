@@ -114,6 +114,21 @@ def test_invalid_alloc_indices(index: int):
     assert allocator.free_blocks == 1
 
 
+@pytest.mark.inference_v2
+def test_duplicate_dealloc_indices():
+    allocator = BlockedAllocator(4)
+    allocator.allocate(4)
+
+    # Duplicates within a single batch are rejected before anything is freed.
+    with pytest.raises(ValueError):
+        allocator.free(torch.tensor([1, 3, 1]))
+    assert allocator.free_blocks == 0
+
+    allocator.free(torch.tensor([3, 1, 0, 2]))
+    assert allocator.free_blocks == 4
+    assert sorted(allocator.allocate(4).tolist()) == [0, 1, 2, 3]
+
+
 @pytest.mark.inference_v2
 @pytest.mark.parametrize('test_iters', [8192])
 def test_long_running_allocation(test_iters: int) -> None:
@@ -0,0 +1,65 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import pytest
+import torch
+
+from deepspeed.accelerator import get_accelerator
+
+
+def make_arena(chunk_bytes: int):
+    # Unpinned on the CPU accelerator, which loads the CPU build of the ragged utils.
+    pinned = not get_accelerator().is_synchronized_device()
+    arena = get_accelerator().create_op_builder("RaggedUtilsBuilder").load().HostStagingArena(chunk_bytes, pinned)
+    assert arena.pinned == pinned
+    return arena
+
+
+@pytest.mark.inference_v2
+def test_host_staging_allocation():
+    arena = make_arena(4096)
+    shapes = [((3, ), torch.int32), ((17, 5), torch.int64), ((1, ), torch.int32), ((200, 4), torch.int32)]
+
+    mirrors = []
+    for shape, dtype in shapes:
+        device_tensor = torch.empty(shape, dtype=dtype, device=get_accelerator().current_device())
+        mirror = arena.allocate(device_tensor)
+        assert mirror.device == torch.device("cpu")
+        assert mirror.shape == device_tensor.shape and mirror.dtype == dtype
+        assert mirror.data_ptr() % 256 == 0
+        assert torch.all(mirror == 0)
+        mirror.fill_(len(mirrors) + 1)
+        mirrors.append(mirror)
+
+    # Mirrors do not overlap.
+    for idx, mirror in enumerate(mirrors):
+        assert torch.all(mirror == idx + 1)
+
+    # The last mirror does not fit in the first chunk.
+    assert arena.reserved_bytes == 2 * 4096
+    assert arena.used_bytes == sum(m.numel() * m.element_size() for m in mirrors)
+
+
+@pytest.mark.inference_v2
+def test_host_staging_reset():
+    arena = make_arena(4096)
+    device_tensor = torch.empty((16, ), dtype=torch.int64, device=get_accelerator().current_device())
+
+    live = arena.allocate(device_tensor)
+    live.fill_(7)
+
+    # The chunk is still referenced, so the next engine gets a new one.
+    arena.reset()
+    other = arena.allocate(device_tensor)
+    assert other.data_ptr() != live.data_ptr()
+    assert torch.all(live == 7)
+
+    # Once its mirrors are gone, a chunk is reused and zeroed.
+    ptr = other.data_ptr()
+    other = None
+    arena.reset()
+    reused = arena.allocate(device_tensor)
+    assert reused.data_ptr() == ptr
+    assert torch.all(reused == 0)
@@ -0,0 +1,296 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import threading
+from types import SimpleNamespace
+from typing import List, Optional, Set, Tuple
+
+import pytest
+import torch
+
+from deepspeed.inference.v2.ragged import DSStateManagerConfig
+from deepspeed.inference.v2.request_queue import RaggedRequestQueue
+from deepspeed.inference.v2.scheduling_utils import SchedulingResult
+from deepspeed.ops.op_builder import RaggedUtilsBuilder
+
+
+@pytest.mark.inference_v2
+def test_request_queue_multi_producer():
+    utils = RaggedUtilsBuilder().load()
+    n_threads, per_thread = 4, 32
+    queue = utils.RequestQueue(torch.zeros((n_threads * per_thread, 8), dtype=torch.int64))
+
+    def producer(tid):
+        for i in range(per_thread):
+            uid = tid * per_thread + i
+            tokens = torch.full((i % 8 + 1, ), uid, dtype=torch.int64)
+            while not queue.try_push(uid, tokens):
+                pass
+
+    threads = [threading.Thread(target=producer, args=(t, )) for t in range(n_threads)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    n_ready = queue.ready(queue.capacity)
+    assert n_ready == n_threads * per_thread
+
+    seen = {}
+    for i in range(n_ready):
+        uid = queue.uid(i)
+        tokens = queue.tokens(i)
+        assert tokens.numel() == uid % per_thread % 8 + 1
+        assert torch.all(tokens == uid)
+        seen.setdefault(uid // per_thread, []).append(uid)
+    queue.pop(n_ready)
+
+    # Requests of one producer keep their order.
+    for tid, uids in seen.items():
+        assert uids == sorted(uids)
+    assert queue.ready(queue.capacity) == 0
+
+
+@pytest.mark.inference_v2
+def test_request_queue_bounds():
+    utils = RaggedUtilsBuilder().load()
+    queue = utils.RequestQueue(torch.zeros((2, 4), dtype=torch.int64))
+
+    assert not queue.try_push(0, torch.arange(5))
+    assert queue.try_push(0, torch.arange(4))
+    assert queue.try_push(1, torch.empty((0, ), dtype=torch.int64))
+    assert not queue.try_push(2, torch.arange(1))
+
+    assert queue.ready(1) == 1
+    assert queue.ready(queue.capacity) == 2
+    assert queue.tokens(1).numel() == 0
+    queue.pop(1)
+    assert queue.try_push(2, torch.arange(2))
+    assert [queue.uid(i) for i in range(queue.ready(queue.capacity))] == [1, 2]
+
+
+@pytest.mark.inference_v2
+def test_completion_ring():
+    utils = RaggedUtilsBuilder().load()
+    ring = utils.CompletionRing(torch.zeros((2, 3)))
+    out = torch.empty(3)
+
+    assert not ring.try_pop(out)
+    assert ring.try_push(torch.full((3, ), 1.0))
+    assert ring.try_push(torch.full((3, ), 2.0))
+    assert not ring.try_push(torch.full((3, ), 3.0))
+    assert ring.size() == 2
+
+    assert ring.try_pop(out)
+    assert torch.equal(out, torch.full((3, ), 1.0))
+    assert ring.try_push(torch.full((3, ), 3.0))
+    assert ring.try_pop(out)
+    assert torch.equal(out, torch.full((3, ), 2.0))
+    assert ring.try_pop(out)
+    assert torch.equal(out, torch.full((3, ), 3.0))
+
+
+class StubStateManager:
+    """
+    Tracks the sequences put and not yet flushed.
+    """
+
+    def __init__(self) -> None:
+        self.tracked: Set[int] = set()
+
+    @property
+    def n_tracked_sequences(self) -> int:
+        return len(self.tracked)
+
+    def get_sequence(self, uid: int) -> Optional[int]:
+        return uid if uid in self.tracked else None
+
+
+class StubEngine:
+    """
+    Records the calls of the request queue. The logits row of a sequence holds its uid plus 100
+    times the number of the put call, which tells completions of different steps apart.
+    """
+
+    def __init__(self,
+                 max_ragged_batch_size: int = 16,
+                 max_ragged_sequence_count: int = 4,
+                 max_schedulable: int = 4) -> None:
+        self._config = SimpleNamespace(state_manager=DSStateManagerConfig(
+            max_tracked_sequences=16,
+            max_ragged_batch_size=max_ragged_batch_size,
+            max_ragged_sequence_count=max_ragged_sequence_count))
+        self._state_manager = StubStateManager()
+        self.max_schedulable = max_schedulable
+        self.can_schedule_calls: List[List[int]] = []
+        self.put_calls: List[Tuple[List[int], List[torch.Tensor]]] = []
+        self.flushed: List[int] = []
+
+    def can_schedule(self, uids, lengths):
+        self.can_schedule_calls.append(list(uids))
+        if len(uids) > self.max_schedulable:
+            return SchedulingResult.EngineSequenceLimitExceeded
+        return SchedulingResult.Success
+
+    def put(self, uids, tokens, do_checks=True):
+        self.put_calls.append((list(uids), [t.clone() for t in tokens]))
+        self._state_manager.tracked.update(uids)
+        value = 100 * len(self.put_calls)
+        return torch.stack([torch.full((4, ), float(value + uid)) for uid in uids])
+
+    def flush_batch(self, uids):
+        self.flushed.extend(uids)
+        self._state_manager.tracked.difference_update(uids)
+
+
+def completion(queue: RaggedRequestQueue, uid: int) -> Optional[float]:
+    logits = queue.poll(uid)
+    return None if logits is None else logits[0].item()
+
+
+@pytest.mark.inference_v2
+def test_ragged_request_queue_batching():
+    engine = StubEngine()
+    queue = RaggedRequestQueue(engine, capacity=16)
+
+    for uid, n_tokens in [(0, 3), (1, 1), (2, 5)]:
+        assert queue.submit(uid, torch.full((n_tokens, ), uid, dtype=torch.int64))
+    assert completion(queue, 0) is None
+
+    assert queue.step() == 3
+    uids, tokens = engine.put_calls[0]
+    assert uids == [0, 1, 2]
+    assert [t.tolist() for t in tokens] == [[0] * 3, [1], [2] * 5]
+    assert [completion(queue, uid) for uid in uids] == [100.0, 101.0, 102.0]
+    assert completion(queue, 0) is None
+
+    # Nothing queued, no forward.
+    assert queue.step() == 0
+    assert len(engine.put_calls) == 1
+
+
+@pytest.mark.inference_v2
+def test_ragged_request_queue_batch_limits():
+    engine = StubEngine(max_ragged_batch_size=8, max_ragged_sequence_count=2)
+    queue = RaggedRequestQueue(engine, capacity=16)
+
+    # A sequence appears once per batch, and a batch is bounded in sequences and tokens.
+    for uid, n_tokens in [(0, 2), (0, 2), (1, 2), (2, 3), (3, 6), (4, 2)]:
+        assert queue.submit(uid, torch.arange(n_tokens))
+
+    assert queue.step() == 1
+    assert queue.step() == 2
+    assert queue.step() == 1
+    assert queue.step() == 2
+    assert [uids for uids, _ in engine.put_calls] == [[0], [0, 1], [2], [3, 4]]
+
+
+@pytest.mark.inference_v2
+def test_ragged_request_queue_schedulable_prefix():
+    engine = StubEngine(max_schedulable=1)
+    queue = RaggedRequestQueue(engine, capacity=16)
+
+    assert queue.submit(0, torch.arange(2))
+    assert queue.close(9)
+    assert queue.submit(1, torch.arange(2))
+    assert queue.submit(2, torch.arange(2))
+
+    # Three candidates are halved to one. The flush ahead of the cut is consumed with it, the
+    # requests behind the cut stay queued.
+    assert queue.step() == 2
+    assert engine.can_schedule_calls == [[0, 1, 2], [0]]
+    assert [uids for uids, _ in engine.put_calls] == [[0]]
+    assert engine.flushed == [9]
+
+    assert queue.step() == 1
+    assert queue.step() == 1
+    assert [uids for uids, _ in engine.put_calls] == [[0], [1], [2]]
+
+    # Nothing schedulable while other sequences are live, nothing consumed.
+    engine.max_schedulable = 0
+    assert queue.submit(3, torch.arange(2))
+    assert queue.step() == 0
+    assert len(engine.put_calls) == 3
+    engine.max_schedulable = 1
+    assert queue.step() == 1
+
+
+@pytest.mark.inference_v2
+def test_ragged_request_queue_rejects_unschedulable():
+    engine = StubEngine(max_schedulable=0)
+    queue = RaggedRequestQueue(engine, capacity=16)
+
+    # Another live sequence may still free room, the request waits.
+    engine._state_manager.tracked = {5}
+    assert queue.submit(0, torch.arange(2))
+    assert queue.step() == 0
+
+    # With only its own sequence left it never fits and is dropped.
+    engine._state_manager.tracked = {0}
+    with pytest.raises(RuntimeError):
+        queue.step()
+    assert queue.step() == 0
+    assert engine.can_schedule_calls == [[0], [0]]
+
+    # A flush ahead of the request still runs first, the request is only dropped once the
+    # flushed sequence is gone. The requests behind it stay queued.
+    engine._state_manager.tracked = {7}
+    assert queue.close(7)
+    assert queue.submit(1, torch.arange(2))
+    assert queue.submit(2, torch.arange(2))
+    assert queue.step() == 1
+    assert engine.flushed == [7]
+    with pytest.raises(RuntimeError):
+        queue.step()
+
+    engine.max_schedulable = 1
+    assert queue.step() == 1
+    assert [uids for uids, _ in engine.put_calls] == [[2]]
+
+
+@pytest.mark.inference_v2
+def test_ragged_request_queue_retries_pending():
+    engine = StubEngine()
+    queue = RaggedRequestQueue(engine, capacity=16, completion_depth=2)
+
+    # The ring of the sequence holds two completions, the third is held by the queue.
+    for _ in range(3):
+        assert queue.submit(0, torch.arange(2))
+        assert queue.step() == 1
+
+    assert completion(queue, 0) == 100.0
+    assert completion(queue, 0) == 200.0
+    assert completion(queue, 0) is None
+
+    # The next step moves it into the ring, even without a forward.
+    assert queue.step() == 0
+    assert completion(queue, 0) == 300.0
+    assert completion(queue, 0) is None
+
+
+@pytest.mark.inference_v2
+def test_ragged_request_queue_flush():
+    engine = StubEngine()
+    queue = RaggedRequestQueue(engine, capacity=16)
+
+    assert queue.submit(0, torch.arange(2))
+    assert queue.close(0)
+    assert queue.submit(0, torch.arange(3))
+
+    # Neither the flush nor a new request of a sequence join the batch of that sequence.
+    assert queue.step() == 1
+    assert engine.flushed == []
+
+    # The flush drops the unpolled completion, the request behind it waits for the next step.
+    assert queue.step() == 1
+    assert engine.flushed == [0]
+    assert len(engine.put_calls) == 1
+    assert completion(queue, 0) is None
+
+    # It starts a new sequence with the same uid.
+    assert queue.step() == 1
+    assert engine.put_calls[1][1][0].numel() == 3
+    assert completion(queue, 0) == 200.0
+    assert engine.flushed == [0]
@@ -0,0 +1,186 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from typing import Optional
+
+import pytest
+import torch
+
+from deepspeed.inference.v2 import InferenceEngineV2, RaggedInferenceEngineConfig
+from deepspeed.inference.v2.ragged import (
+    AllocationMode,
+    DSSequenceDescriptor,
+    DSStateManager,
+    DSStateManagerConfig,
+    KVCacheConfig,
+    KVReclaimFill,
+    MemoryConfig,
+)
+
+NUM_BLOCKS = 16
+
+
+def build_config(max_tracked_sequences: int = 8,
+                 kv_reclaim_fill: Optional[KVReclaimFill] = None) -> DSStateManagerConfig:
+    return DSStateManagerConfig(max_tracked_sequences=max_tracked_sequences,
+                                max_ragged_sequence_count=max_tracked_sequences,
+                                max_ragged_batch_size=64,
+                                max_context=256,
+                                memory_config=MemoryConfig(mode=AllocationMode.ALLOCATE, size=NUM_BLOCKS),
+                                kv_reclaim_fill=kv_reclaim_fill)
+
+
+def build_manager(config: DSStateManagerConfig) -> DSStateManager:
+    kv_config = KVCacheConfig(block_size=4, num_allocation_groups=1, cache_shape=(1, 2, 8))
+    return DSStateManager(config, (kv_config, ))
+
+
+def create_sequence(manager: DSStateManager, uid: int, n_blocks: int) -> DSSequenceDescriptor:
+    seq = manager.get_or_create_sequence(uid)
+    if n_blocks > 0:
+        seq.extend_kv_cache(manager.allocate_blocks(n_blocks))
+    return seq
+
+
+class StubModel:
+    """
+    Stands in for the model of an engine, only the KV requirements are needed to query.
+    """
+
+    def get_kv_requirements(self, seq_desc, max_request_tokens: int, max_request_blocks: int):
+        return max_request_tokens, 0
+
+
+def build_engine(manager: DSStateManager, config: DSStateManagerConfig) -> InferenceEngineV2:
+    # Skip the model setup of the constructor, flush_batch and query only need the state manager.
+    engine = InferenceEngineV2.__new__(InferenceEngineV2)
+    engine._config = RaggedInferenceEngineConfig(state_manager=config)
+    engine._state_manager = manager
+    engine._model = StubModel()
+    return engine
+
+
+@pytest.mark.inference_v2
+def test_enqueue_flush_defers_reclaim() -> None:
+    manager = build_manager(build_config())
+    create_sequence(manager, 0, 3)
+    create_sequence(manager, 1, 2)
+
+    manager.enqueue_flush(0)
+
+    # The uid is released, the tracking slot and blocks are not.
+    assert manager.get_sequence(0) is None
+    assert manager.n_tracked_sequences == 2
+    assert manager.free_blocks[0] == NUM_BLOCKS - 5
+
+    manager.reclaim_flushed()
+
+    assert manager.n_tracked_sequences == 1
+    assert manager.free_blocks[0] == NUM_BLOCKS - 2
+
+    # Nothing left to reclaim.
+    manager.reclaim_flushed()
+    assert manager.free_blocks[0] == NUM_BLOCKS - 2
+
+
+@pytest.mark.inference_v2
+def test_uid_reuse_before_reclaim() -> None:
+    manager = build_manager(build_config())
+    old_seq = create_sequence(manager, 0, 3)
+    old_blocks = old_seq.all_block_ids().cpu()
+
+    manager.enqueue_flush(0)
+    new_seq = create_sequence(manager, 0, 1)
+
+    # The new sequence does not inherit the tracking slot or blocks of the flushed one.
+    assert new_seq is not old_seq
+    assert new_seq.tracking_id != old_seq.tracking_id
+    assert not torch.isin(new_seq.all_block_ids().cpu(), old_blocks).any()
+    assert manager.n_tracked_sequences == 2
+
+    manager.reclaim_flushed()
+
+    assert manager.get_sequence(0) is new_seq
+    assert manager.n_tracked_sequences == 1
+    assert manager.free_blocks[0] == NUM_BLOCKS - 1
+
+
+@pytest.mark.inference_v2
+def test_pending_flushes_hold_tracking_slots() -> None:
+    manager = build_manager(build_config(max_tracked_sequences=2))
+    create_sequence(manager, 0, 1)
+    create_sequence(manager, 1, 1)
+
+    manager.enqueue_flush(0)
+
+    # The slot of the flushed sequence is only available after the reclaim.
+    assert manager.n_tracked_sequences == 2
+    with pytest.raises(RuntimeError):
+        create_sequence(manager, 2, 0)
+
+    manager.reclaim_flushed()
+    create_sequence(manager, 2, 0)
+    assert manager.n_tracked_sequences == 2
+
+
+@pytest.mark.inference_v2
+def test_enqueue_flush_unknown_uid() -> None:
+    manager = build_manager(build_config())
+    create_sequence(manager, 0, 1)
+
+    manager.enqueue_flush(7)
+    manager.reclaim_flushed()
+
+    assert manager.n_tracked_sequences == 1
+    assert manager.free_blocks[0] == NUM_BLOCKS - 1
+
+
+@pytest.mark.inference_v2
+@pytest.mark.parametrize('kv_reclaim_fill', [None, KVReclaimFill.ZERO, KVReclaimFill.POISON])
+def test_kv_reclaim_fill(kv_reclaim_fill: Optional[KVReclaimFill]) -> None:
+    manager = build_manager(build_config(kv_reclaim_fill=kv_reclaim_fill))
+    flushed = [create_sequence(manager, uid, 2) for uid in range(2)]
+    live = create_sequence(manager, 2, 2)
+
+    cache = manager.get_cache(0)
+    cache.fill_(1.0)
+
+    flushed_blocks = torch.cat([seq.all_block_ids() for seq in flushed]).to(device=cache.device, dtype=torch.int64)
+    live_blocks = live.all_block_ids().to(device=cache.device, dtype=torch.int64)
+
+    manager.enqueue_flush(0)
+    manager.enqueue_flush(1)
+    manager.reclaim_flushed()
+
+    reclaimed = cache.index_select(0, flushed_blocks)
+    if kv_reclaim_fill is None:
+        assert torch.all(reclaimed == 1.0)
+    elif kv_reclaim_fill == KVReclaimFill.ZERO:
+        assert torch.all(reclaimed == 0.0)
+    else:
+        assert torch.all(torch.isnan(reclaimed))
+
+    # Blocks of live sequences are never touched.
+    assert torch.all(cache.index_select(0, live_blocks) == 1.0)
+
+
+@pytest.mark.inference_v2
+def test_engine_flush_batch() -> None:
+    config = build_config()
+    manager = build_manager(config)
+    engine = build_engine(manager, config)
+    for uid in range(3):
+        create_sequence(manager, uid, 2)
+
+    engine.flush_batch([0, 1, 5])
+
+    assert manager.get_sequence(0) is None and manager.get_sequence(1) is None
+    assert manager.n_tracked_sequences == 3
+    assert manager.free_blocks[0] == NUM_BLOCKS - 6
+
+    # The next step boundary reclaims the whole batch.
+    assert engine.query(3, 8, 4) == (8, 0)
+    assert manager.n_tracked_sequences == 1
+    assert manager.free_blocks[0] == NUM_BLOCKS - 2
@@ -0,0 +1,121 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import json
+
+import pytest
+import torch
+
+from deepspeed.inference.v2.checkpoint.huggingface_engine import (CONVERTIBLE_DTYPES, RAW_RANGE,
+                                                                  read_safetensors_header)
+from deepspeed.ops.op_builder import RaggedUtilsBuilder
+
+
+@pytest.mark.inference_v2
+@pytest.mark.parametrize("dst_dtype", [None, torch.float16, torch.bfloat16, torch.float32])
+def test_load_safetensors_ranges(tmp_path, dst_dtype) -> None:
+    safetensors = pytest.importorskip("safetensors.torch")
+
+    shards = [{
+        "a": torch.randn(37, 19, dtype=torch.float32),
+        "ids": torch.arange(11, dtype=torch.int64),
+    }, {
+        "b": torch.randn(1024, dtype=torch.bfloat16),
+        "c": torch.randn(3, 5, 7, dtype=torch.float16),
+    }]
+    paths = []
+    for i, shard in enumerate(shards):
+        paths.append(str(tmp_path / f"model-{i}.safetensors"))
+        safetensors.save_file(shard, paths[-1])
+
+    reads = []
+    for file_index, path in enumerate(paths):
+        data_offset, header = read_safetensors_header(path)
+        for name, entry in header.items():
+            src = shards[file_index][name]
+            dst = dst_dtype if (dst_dtype is not None and src.dtype in CONVERTIBLE_DTYPES) else src.dtype
+            begin, end = entry["data_offsets"]
+            reads.append((name, file_index, data_offset + begin, end - begin, src, dst))
+
+    offsets = []
+    total = 0
+    for read in reads:
+        offsets.append(total)
+        total += (read[4].numel() * torch.tensor([], dtype=read[5]).element_size() + 63) // 64 * 64
+
+    def code(src: torch.dtype, dtype: torch.dtype, dst: torch.dtype) -> int:
+        return CONVERTIBLE_DTYPES[dtype] if src != dst else RAW_RANGE
+
+    buffer = torch.empty(total, dtype=torch.uint8)
+    RaggedUtilsBuilder().load().load_tensor_ranges(paths, [r[1] for r in reads], [r[2] for r in reads],
+                                                   [r[3] for r in reads],
+                                                   [code(r[4].dtype, r[4].dtype, r[5]) for r in reads], offsets,
+                                                   [code(r[4].dtype, r[5], r[5]) for r in reads], buffer, 4, 256)
+
+    for (name, _, _, _, src, dst), offset in zip(reads, offsets):
+        size = src.numel() * torch.tensor([], dtype=dst).element_size()
+        loaded = buffer[offset:offset + size].view(dst).view(src.shape)
+        assert torch.equal(loaded, src.to(dst)), name
+
+
+@pytest.mark.inference_v2
+def test_load_half_subnormals(tmp_path) -> None:
+    safetensors = pytest.importorskip("safetensors.torch")
+
+    # Values around the smallest half subnormal 2**-24, where rounding decides between 0 and it.
+    src = torch.tensor([2**-26, 2**-25, 1.25 * 2**-25, 1.5 * 2**-25, 2**-24, 1.5 * 2**-24, 2**-14])
+    src = torch.cat([src, -src])
+    path = str(tmp_path / "model.safetensors")
+    safetensors.save_file({"x": src}, path)
+
+    data_offset, header = read_safetensors_header(path)
+    begin, end = header["x"]["data_offsets"]
+    buffer = torch.empty(src.numel() * 2, dtype=torch.uint8)
+    RaggedUtilsBuilder().load().load_tensor_ranges([path], [0], [data_offset + begin], [end - begin],
+                                                   [CONVERTIBLE_DTYPES[torch.float32]], [0],
+                                                   [CONVERTIBLE_DTYPES[torch.float16]], buffer, 1, 256)
+
+    assert torch.equal(buffer.view(torch.float16), src.to(torch.float16))
+
+
+@pytest.mark.inference_v2
+@pytest.mark.parametrize("load_dtype", [None, torch.float16])
+def test_huggingface_engine_safetensors(tmp_path, load_dtype) -> None:
+    safetensors = pytest.importorskip("safetensors.torch")
+    transformers = pytest.importorskip("transformers")
+    from deepspeed.inference.v2.checkpoint import HuggingFaceCheckpointEngine
+
+    transformers.GPT2Config(n_layer=1, n_embd=8, n_head=2).save_pretrained(str(tmp_path))
+    shards = {
+        "model-00001-of-00002.safetensors": {
+            "wte.weight": torch.randn(64, 8, dtype=torch.bfloat16),
+            "h.0.attn.bias": torch.ones(1, 1, 4, 4, dtype=torch.bool),
+        },
+        "model-00002-of-00002.safetensors": {
+            "h.0.mlp.c_fc.weight": torch.randn(8, 32, dtype=torch.float32),
+            "h.0.mlp.c_fc.bias": torch.randn(32, dtype=torch.float16),
+        },
+    }
+    weight_map = {}
+    for file_name, shard in shards.items():
+        safetensors.save_file(shard, str(tmp_path / file_name))
+        weight_map.update({name: file_name for name in shard})
+    with open(tmp_path / "model.safetensors.index.json", "w") as f:
+        json.dump({"weight_map": weight_map}, f)
+
+    # A window smaller than any shard, so the shards are read in several batches.
+    engine = HuggingFaceCheckpointEngine(str(tmp_path), load_dtype=load_dtype, io_threads=2, io_window_bytes=1024)
+    assert engine._plan_safetensors_reads() is not None
+    loaded = dict(engine.parameters())
+
+    expected = {}
+    for file_name in shards:
+        expected.update(safetensors.load_file(str(tmp_path / file_name)))
+    assert loaded.keys() == expected.keys()
+    for name, param in expected.items():
+        if load_dtype is not None and param.dtype in CONVERTIBLE_DTYPES:
+            param = param.to(load_dtype)
+        assert loaded[name].dtype == param.dtype, name
+        assert torch.equal(loaded[name], param), name
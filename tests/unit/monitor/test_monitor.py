@@ -7,6 +7,7 @@ from deepspeed.monitor.tensorboard import TensorBoardMonitor
 from deepspeed.monitor.wandb import WandbMonitor
 from deepspeed.monitor.csv_monitor import csvMonitor
 from deepspeed.monitor.config import DeepSpeedMonitorConfig
+from deepspeed.monitor.async_writer import AsyncMetricsWriter
 
 from unit.common import DistributedTest
 from deepspeed.runtime.config import DeepSpeedConfig
@@ -97,3 +98,29 @@ class TestCSVMonitor(DistributedTest):
         assert csv_monitor.enabled == defaults.enabled
         assert csv_monitor.output_path == defaults.output_path
         assert csv_monitor.job_name == defaults.job_name
+
+
+class RecordingSink:
+
+    def __init__(self):
+        self.calls = []
+
+    def write_events(self, event_list):
+        self.calls.append(list(event_list))
+
+
+def test_async_metrics_writer():
+    sink = RecordingSink()
+    # Long interval, so events are only written by the explicit flushes below.
+    writer = AsyncMetricsWriter([sink], capacity=8, flush_interval=3600)
+
+    writer.write_events([("Train/loss", 1.5, 1), ("Train/lr", 0.1, 1)])
+    writer.write_events([("Train/loss", 1.25, 2)])
+    writer.flush()
+    assert sink.calls == [[("Train/loss", 1.5, 1), ("Train/lr", 0.1, 1), ("Train/loss", 1.25, 2)]]
+
+    # A full ring drops the new events instead of blocking.
+    writer.write_events([("Train/loss", float(step), step) for step in range(10)])
+    writer.close()
+    assert [event[2] for event in sink.calls[-1]] == list(range(8))
+    assert writer.dropped_events == 2
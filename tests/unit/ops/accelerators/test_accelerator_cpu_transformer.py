@@ -0,0 +1,98 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import math
+import pytest
+import torch
+import torch.nn.functional as F
+from deepspeed import DeepSpeedTransformerLayer, DeepSpeedTransformerConfig
+from deepspeed.accelerator import get_accelerator
+
+if get_accelerator().device_name() != 'cpu':
+    pytest.skip("CPU transformer kernels only", allow_module_level=True)
+
+
+def reference_layer(layer, x, mask):
+    config = layer.config
+    batch, seq_len, hidden = x.shape
+    head_size = hidden // config.heads
+    ln = lambda t, w, b: F.layer_norm(t, (hidden, ), w, b, config.layer_norm_eps)
+
+    inp = ln(x, layer.norm_w, layer.norm_b) if config.pre_layer_norm else x
+    qkv = F.linear(inp, layer.attn_qkvw, layer.attn_qkvb)
+    q, k, v = (t.view(batch, seq_len, config.heads, head_size).transpose(1, 2) for t in qkv.chunk(3, dim=-1))
+    probs = torch.softmax(q @ k.transpose(-1, -2) / math.sqrt(head_size) + mask, dim=-1)
+    context = (probs @ v).transpose(1, 2).reshape(batch, seq_len, hidden)
+    add_res = F.linear(context, layer.attn_ow, layer.attn_ob) + x
+    ff1_inp = ln(add_res, layer.attn_nw, layer.attn_nb)
+    gelu_out = F.gelu(F.linear(ff1_inp, layer.inter_w, layer.inter_b), approximate='tanh')
+    out = F.linear(gelu_out, layer.output_w, layer.output_b)
+    return out + add_res if config.pre_layer_norm else ln(out + ff1_inp, layer.norm_w, layer.norm_b)
+
+
+def make_layer(pre_layer_norm, normalize_invertible, gelu_checkpoint, attn_dropout_checkpoint, dropout=0.0):
+    config = DeepSpeedTransformerConfig(batch_size=2,
+                                        hidden_size=64,
+                                        intermediate_size=128,
+                                        heads=4,
+                                        attn_dropout_ratio=dropout,
+                                        hidden_dropout_ratio=dropout,
+                                        num_hidden_layers=1,
+                                        initializer_range=0.02,
+                                        seed=1234,
+                                        pre_layer_norm=pre_layer_norm,
+                                        normalize_invertible=normalize_invertible,
+                                        gelu_checkpoint=gelu_checkpoint,
+                                        attn_dropout_checkpoint=attn_dropout_checkpoint)
+    layer = DeepSpeedTransformerLayer(config)
+    with torch.no_grad():
+        for param in [layer.attn_qkvb, layer.attn_ob, layer.attn_nb, layer.inter_b, layer.output_b, layer.norm_b]:
+            param.normal_(std=0.1)
+        for param in [layer.attn_nw, layer.norm_w]:
+            param.add_(torch.randn_like(param) * 0.1)
+    return layer
+
+
+@pytest.mark.parametrize('pre_layer_norm', [True, False])
+@pytest.mark.parametrize('normalize_invertible, gelu_checkpoint, attn_dropout_checkpoint', [(False, False, False),
+                                                                                            (True, True, True)])
+@pytest.mark.parametrize('seq_len', [32, 20])
+def test_cpu_transformer_layer(pre_layer_norm, normalize_invertible, gelu_checkpoint, attn_dropout_checkpoint,
+                               seq_len):
+    torch.manual_seed(0)
+    layer = make_layer(pre_layer_norm, normalize_invertible, gelu_checkpoint, attn_dropout_checkpoint)
+    x = torch.randn(2, seq_len, 64, requires_grad=True)
+    mask = torch.randn(2, 1, 1, seq_len)
+    grad = torch.randn(2, seq_len, 64)
+
+    out = layer(x, mask)
+    out.backward(grad)
+    ds_grads = [x.grad] + [p.grad.clone() for p in layer.parameters()]
+
+    x.grad = None
+    layer.zero_grad()
+    ref_out = reference_layer(layer, x, mask)
+    ref_out.backward(grad)
+    ref_grads = [x.grad] + [p.grad for p in layer.parameters()]
+
+    assert torch.allclose(out, ref_out, atol=1e-4, rtol=1e-4)
+    for ds_grad, ref_grad in zip(ds_grads, ref_grads):
+        assert torch.allclose(ds_grad, ref_grad, atol=1e-4, rtol=1e-3)
+
+
+def test_cpu_transformer_layer_dropout():
+    torch.manual_seed(0)
+    layer = make_layer(True, False, False, True, dropout=0.1)
+    x = torch.randn(2, 32, 64, requires_grad=True)
+    mask = torch.zeros(2, 1, 1, 32)
+
+    out = layer(x, mask)
+    out.sum().backward()
+    assert torch.isfinite(x.grad).all()
+    assert not torch.allclose(out, reference_layer(layer, x, mask))
+
+    layer.eval()
+    with torch.no_grad():
+        assert torch.allclose(layer(x, mask), reference_layer(layer, x, mask), atol=1e-4, rtol=1e-4)
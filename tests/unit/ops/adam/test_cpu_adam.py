@@ -3,6 +3,7 @@
 
 # DeepSpeed Team
 
+import os
 import torch
 import numpy as np
 import pytest
@@ -125,3 +126,60 @@ class TestCPUAdamGPUError(DistributedTest):
         param.grad = torch.randn(model_size, device=device)
         with pytest.raises(AssertionError):
             optimizer.step()
+
+
+@pytest.mark.parametrize('numel', [1000, 5120, 20000])
+def test_cpu_adam_nvme_pipeline(tmpdir, numel):
+    from deepspeed.ops.adam import DeepSpeedCPUAdam
+
+    chunk_numel = 4096
+    file_numel = (numel + 1023) // 1024 * 1024
+    data = torch.randn(file_numel)
+    data.numpy().tofile(str(tmpdir.join('param.swp')))
+    paths = [str(tmpdir.join(f'{name}.swp')) for name in ('param', 'exp_avg', 'exp_avg_sq')]
+
+    ref_param = torch.nn.Parameter(data[:numel].clone())
+    ref_optimizer = DeepSpeedCPUAdam([ref_param])
+    optimizer = DeepSpeedCPUAdam([torch.nn.Parameter(torch.empty(0))])
+    pipeline = optimizer.ds_opt_adam.AdamNVMePipeline(torch.empty(3, 3, chunk_numel), 2, 8192)
+
+    group = optimizer.param_groups[0]
+    beta1, beta2 = group['betas']
+    for step in range(1, 4):
+        ref_param.grad = torch.randn(numel)
+        grads = ref_param.grad.clone()
+        ref_optimizer.step()
+
+        # The gradients are replaced by the updated parameter.
+        pipeline.step(optimizer.opt_id, step, group['lr'], beta1, beta2, group['eps'], group['weight_decay'],
+                      group['bias_correction'], grads, paths, file_numel, step > 1)
+        check_equal(grads, ref_param.data, atol=1e-6)
+
+    state = ref_optimizer.state[ref_param]
+    for path, expected in zip(paths, [ref_param.data, state['exp_avg'], state['exp_avg_sq']]):
+        swapped = torch.from_numpy(np.fromfile(path, dtype=np.float32))
+        assert swapped.numel() == file_numel
+        check_equal(swapped[:numel], expected, atol=1e-6)
+
+
+def test_cpu_adam_nvme_pipeline_read_error(tmpdir):
+    from deepspeed.ops.adam import DeepSpeedCPUAdam
+
+    chunk_numel = 4096
+    numel = 3 * chunk_numel
+    # The param file ends after the first chunk, the reads of the others come up short.
+    torch.randn(chunk_numel).numpy().tofile(str(tmpdir.join('param.swp')))
+    paths = [str(tmpdir.join(f'{name}.swp')) for name in ('param', 'exp_avg', 'exp_avg_sq')]
+
+    optimizer = DeepSpeedCPUAdam([torch.nn.Parameter(torch.empty(0))])
+    pipeline = optimizer.ds_opt_adam.AdamNVMePipeline(torch.empty(3, 3, chunk_numel), 2, 8192)
+
+    group = optimizer.param_groups[0]
+    beta1, beta2 = group['betas']
+    with pytest.raises(RuntimeError):
+        pipeline.step(optimizer.opt_id, 1, group['lr'], beta1, beta2, group['eps'], group['weight_decay'],
+                      group['bias_correction'], torch.randn(numel), paths, numel, False)
+
+    # Nothing is written for the chunks that failed to read.
+    for path in paths:
+        assert os.path.getsize(path) <= chunk_numel * 4
@@ -212,6 +212,147 @@ class TestWrite(DistributedTest):
         assert filecmp.cmp(ref_file, aio_file, shallow=False)
 
 
+class TestStats(DistributedTest):
+    world_size = 1
+    reuse_dist_env = True
+    requires_cuda_env = False
+    if not get_accelerator().is_available():
+        init_distributed = False
+        set_dist_env = False
+
+    def test_op_stats(self, tmpdir):
+        from deepspeed.runtime.swap_tensor.utils import get_aio_stats
+
+        ref_file, ref_buffer = _do_ref_write(tmpdir)
+        h = AsyncIOBuilder().load().aio_handle(BLOCK_SIZE, QUEUE_DEPTH, False, False, IO_PARALLEL)
+        aio_file, aio_buffer = _get_test_write_file_and_cpu_buffer(tmpdir, ref_buffer, h)
+
+        assert h.sync_pwrite(aio_buffer, aio_file) == 1
+        assert h.sync_pread(aio_buffer, ref_file) == 1
+        assert h.async_pread(aio_buffer, ref_file) == 0
+        assert h.wait() == 1
+
+        stats = get_aio_stats(h)
+        assert stats['pwrite']['count'] == 1
+        assert stats['pwrite']['bytes'] == IO_SIZE
+        assert stats['pread']['count'] == 2
+        assert stats['pread']['bytes'] == 2 * IO_SIZE
+        for op_stats in stats.values():
+            assert 0 < op_stats['aio_usec'] <= op_stats['call_usec']
+            assert op_stats['max_call_usec'] <= op_stats['call_usec']
+
+        h.reset_stats()
+        assert get_aio_stats(h) == {}
+        h.free_cpu_locked_tensor(aio_buffer)
+
+
+@pytest.mark.parametrize("async_op", [True, False])
+class TestVectoredWrite(DistributedTest):
+    world_size = 1
+    reuse_dist_env = True
+    requires_cuda_env = False
+    if not get_accelerator().is_available():
+        init_distributed = False
+        set_dist_env = False
+
+    def test_pwritev(self, tmpdir, async_op):
+        _, ref_buffer = _do_ref_write(tmpdir)
+        aio_file = _get_test_write_file(tmpdir, 0)
+        with open(aio_file, 'wb') as f:
+            f.write(bytes(IO_SIZE))
+
+        # Unaligned fragments of one tensor and of separate tensors, written after a header.
+        source = torch.ByteTensor(list(ref_buffer))
+        header = BLOCK_SIZE
+        fragments = [source.narrow(0, 0, 3), source.narrow(0, 3, 1021), source[1024:].clone()]
+
+        h = AsyncIOBuilder().load().aio_handle(BLOCK_SIZE, QUEUE_DEPTH, False, False, IO_PARALLEL)
+        if async_op:
+            assert h.async_pwritev(fragments, aio_file, header) == 0
+            assert h.wait() == 1
+        else:
+            assert h.sync_pwritev(fragments, aio_file, header) == 1
+
+        with open(aio_file, 'rb') as f:
+            written = f.read()
+        assert written[:header] == bytes(header)
+        assert written[header:] == ref_buffer
+
+        from deepspeed.runtime.swap_tensor.utils import get_aio_stats
+        assert get_aio_stats(h)['pwritev']['bytes'] == IO_SIZE
+
+    def test_pwritev_direct_io(self, tmpdir, async_op):
+        _, ref_buffer = _do_ref_write(tmpdir)
+        aio_file = _get_test_write_file(tmpdir, 0)
+
+        # Page-aligned fragments of page-multiple sizes at a page-aligned offset take the O_DIRECT path.
+        page = 4 * KILO_BYTE
+        storage = torch.empty(3 * page, dtype=torch.uint8)
+        aligned = storage[(-storage.data_ptr()) % page:][:2 * page]
+        aligned.copy_(torch.ByteTensor(list(ref_buffer) * 2))
+        fragments = [aligned[:page], aligned[page:]]
+
+        h = AsyncIOBuilder().load().aio_handle(BLOCK_SIZE, QUEUE_DEPTH, False, False, IO_PARALLEL)
+
+        if async_op:
+            assert h.async_pwritev(fragments, aio_file, page) == 0
+            assert h.wait() == 1
+        else:
+            assert h.sync_pwritev(fragments, aio_file, page) == 1
+
+        with open(aio_file, 'rb') as f:
+            written = f.read()
+        assert written[:page] == bytes(page)
+        assert written[page:] == ref_buffer * 2
+
+
+class TestSwapBufferManager(DistributedTest):
+    world_size = 1
+    reuse_dist_env = True
+    requires_cuda_env = False
+    if not get_accelerator().is_available():
+        init_distributed = False
+        set_dist_env = False
+
+    def test_sub_allocation_and_eviction(self):
+        page = 4 * KILO_BYTE
+        manager = AsyncIOBuilder().load().swap_buffer_manager([8 * page, 4 * page], page)
+        assert manager.free_bytes() == 12 * page
+
+        # Small buffers take only their aligned size, best fit first.
+        slab, offset, evicted = manager.allocate(0, 100)
+        assert (slab, offset, evicted) == (1, 0, [])
+        slab, offset, _ = manager.allocate(1, 3 * page)
+        assert (slab, offset) == (1, page)
+        slab, offset, _ = manager.allocate(2, 6 * page)
+        assert (slab, offset) == (0, 0)
+
+        # Released clean buffers stay cached and can be taken back.
+        manager.release(1, True)
+        manager.release(2, True)
+        assert manager.cached_bytes() == 9 * page
+        assert manager.acquire(1)
+        manager.release(1, True)
+
+        # Cached buffers are evicted in release order: 2 was released before 1.
+        assert manager.count_fits([3, 1], [2 * page, 3 * page]) == 2
+        assert manager.is_cached(2)
+        slab, offset, evicted = manager.allocate(3, 7 * page)
+        assert (slab, evicted) == (0, [2])
+        assert manager.is_cached(1)
+
+        # Nothing fits once only buffers in use are left.
+        slab, _, evicted = manager.allocate(4, 2 * page)
+        assert (slab, evicted) == (1, [1])
+        assert manager.allocate(5, 2 * page)[0] == -1
+
+        manager.release(0, False)
+        for key in [3, 4]:
+            assert manager.free(key)
+        assert manager.free_bytes() == 12 * page
+        assert manager.allocate(7, 8 * page)[:2] == (0, 0)
+
+
 @pytest.mark.sequential
 @pytest.mark.parametrize("use_cuda_pinned_tensor", [True, False])
 @pytest.mark.parametrize("cuda_device", [True, False])
@@ -101,3 +101,29 @@ def test_DS4Sci_EvoformerAttention(dtype, tensor_shape):
     assert torch.max(torch.abs(ref_dk - dk)) < eps, f"dk eps: {torch.max(torch.abs(ref_dk - dk))}"
     assert torch.max(torch.abs(ref_dq - dq)) < eps, f"dq eps: {torch.max(torch.abs(ref_dq - dq))}"
     assert torch.max(torch.abs(ref_db - db)) < 2 * eps, f"db eps: {torch.max(torch.abs(ref_db - db))}"
+
+
+@pytest.mark.parametrize("dtype", [torch.float32, torch.bfloat16])
+@pytest.mark.parametrize("tensor_shape", [(1, 3, 45, 2, 24), (2, 2, 70, 4, 80)])
+def test_DS4Sci_EvoformerAttention_cpu(dtype, tensor_shape):
+    if get_accelerator().device_name() != 'cpu':
+        pytest.skip("CPU kernel only")
+    batch, n, seq_len, heads, dim = tensor_shape
+    Q, K, V = (torch.randn(tensor_shape, dtype=dtype, requires_grad=True) for _ in range(3))
+    mask = torch.randint(0, 2, (batch, n, 1, 1, seq_len), dtype=dtype)
+    mask_bias = 1e9 * (mask - 1)
+    bias = torch.randn(batch, 1, heads, seq_len, seq_len, dtype=dtype, requires_grad=True)
+    dummy_out = torch.rand_like(Q)
+
+    ref_inputs = [x.detach().float().requires_grad_() for x in (Q, K, V, bias)]
+    ref_out = attention_reference(*ref_inputs[:3], [mask_bias.float(), ref_inputs[3]], 1 / (dim**0.5))
+    ref_out.backward(dummy_out.float())
+
+    out = DS4Sci_EvoformerAttention(Q, K, V, [mask_bias, bias])
+    out.backward(dummy_out)
+
+    eps = 1e-4 if dtype == torch.float32 else 5e-2
+    for ref, val, name in zip([ref_out] + [x.grad for x in ref_inputs], [out, Q.grad, K.grad, V.grad, bias.grad],
+                              ["out", "dq", "dk", "dv", "db"]):
+        err = torch.max(torch.abs(ref - val.float())).item()
+        assert err < eps * max(1.0, torch.max(torch.abs(ref)).item()), f"{name} eps: {err}"
@@ -0,0 +1,50 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import torch
+import pytest
+
+import deepspeed
+from deepspeed.ops.op_builder import CPUMultiTensorBuilder
+from deepspeed.ops.multi_tensor import multi_tensor_accumulate
+
+if not deepspeed.ops.__compatible_ops__[CPUMultiTensorBuilder.NAME]:
+    pytest.skip("cpu-multi-tensor is not compatible", allow_module_level=True)
+
+SIZES = [1, 33, 4097, 65536 * 2 + 5]
+
+
+@pytest.mark.parametrize('dtype', [torch.float32, torch.float16, torch.bfloat16], ids=["fp32", "fp16", "bf16"])
+@pytest.mark.parametrize('accumulate', [True, False])
+def test_accumulate(dtype, accumulate):
+    dst = [torch.randn(size) for size in SIZES]
+    src = [torch.randn(size).to(dtype) for size in SIZES]
+    expected = [(d + s.float()) if accumulate else s.float() for d, s in zip(dst, src)]
+
+    sum_sq, inf_or_nan = multi_tensor_accumulate(dst, src, accumulate=accumulate, compute_norm=True)
+
+    assert not inf_or_nan
+    for d, e, norm_sq in zip(dst, expected, sum_sq):
+        assert torch.equal(d, e)
+        assert norm_sq == pytest.approx(e.double().square().sum().item(), rel=1e-6)
+
+
+def test_no_norm():
+    dst = [torch.zeros(100)]
+    src = [torch.ones(100, dtype=torch.float16)]
+
+    sum_sq, _ = multi_tensor_accumulate(dst, src, accumulate=False, compute_norm=False)
+    assert len(sum_sq) == 0
+    assert torch.equal(dst[0], torch.ones(100))
+
+
+@pytest.mark.parametrize('dtype', [torch.float32, torch.float16, torch.bfloat16], ids=["fp32", "fp16", "bf16"])
+def test_inf_or_nan(dtype):
+    dst = [torch.zeros(size) for size in SIZES]
+    src = [torch.randn(size).to(dtype) for size in SIZES]
+    src[2][4000] = float('nan')
+
+    _, inf_or_nan = multi_tensor_accumulate(dst, src, accumulate=True)
+    assert inf_or_nan
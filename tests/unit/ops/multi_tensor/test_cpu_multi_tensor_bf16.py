@@ -0,0 +1,49 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import torch
+import pytest
+
+import deepspeed
+from deepspeed.ops.op_builder import CPUMultiTensorBuilder
+from deepspeed.ops.multi_tensor import multi_tensor_copy_to_bf16
+
+if not deepspeed.ops.__compatible_ops__[CPUMultiTensorBuilder.NAME]:
+    pytest.skip("cpu-multi-tensor is not compatible", allow_module_level=True)
+
+SIZES = [1, 33, 4097, 65536 * 2 + 5]
+
+
+def test_round_to_nearest():
+    src = [torch.randn(size) * 100 for size in SIZES]
+    src[2][7] = float('inf')
+    src[2][8] = float('nan')
+    dst = [torch.empty(size, dtype=torch.bfloat16) for size in SIZES]
+
+    multi_tensor_copy_to_bf16(dst, src, stochastic_rounding=False)
+
+    for d, s in zip(dst, src):
+        expected = s.to(torch.bfloat16)
+        assert torch.equal(d.isnan(), expected.isnan())
+        assert torch.equal(d.nan_to_num(0.0), expected.nan_to_num(0.0))
+
+
+def test_stochastic_rounding():
+    value = 1.0 + 2**-9  # a quarter of the way between two bf16 values
+    src = [torch.full((size, ), value) for size in SIZES]
+    dst = [torch.empty(size, dtype=torch.bfloat16) for size in SIZES]
+
+    multi_tensor_copy_to_bf16(dst, src, stochastic_rounding=True, seed=1234)
+
+    lower, upper = 1.0, 1.0 + 2**-7
+    result = dst[3].float()
+    assert torch.all((result == lower) | (result == upper))
+    assert result.mean().item() == pytest.approx(value, abs=1e-4)
+
+    # the same seed reproduces the same rounding
+    again = [torch.empty(size, dtype=torch.bfloat16) for size in SIZES]
+    multi_tensor_copy_to_bf16(again, src, stochastic_rounding=True, seed=1234)
+    for d, a in zip(dst, again):
+        assert torch.equal(d, a)
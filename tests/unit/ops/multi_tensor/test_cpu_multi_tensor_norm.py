@@ -0,0 +1,49 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import math
+import torch
+import pytest
+
+import deepspeed
+from deepspeed.ops.op_builder import CPUMultiTensorBuilder
+from deepspeed.ops.multi_tensor import multi_tensor_norm
+
+if not deepspeed.ops.__compatible_ops__[CPUMultiTensorBuilder.NAME]:
+    pytest.skip("cpu-multi-tensor is not compatible", allow_module_level=True)
+
+
+def _make_tensors(sizes):
+    return [torch.randn(size, dtype=torch.float32) for size in sizes]
+
+
+@pytest.mark.parametrize('sizes', [[1], [7, 64, 1000], [65536 * 3 + 17], [13] * 500])
+def test_l2_norm(sizes):
+    tensors = _make_tensors(sizes)
+    norm, inf_or_nan = multi_tensor_norm(tensors, 2.0)
+
+    ref = torch.cat([t.double() for t in tensors]).norm(2).item()
+    assert not inf_or_nan
+    assert math.isclose(norm, ref, rel_tol=1e-6)
+
+
+@pytest.mark.parametrize('sizes', [[1], [7, 64, 1000], [65536 * 3 + 17]])
+def test_inf_norm(sizes):
+    tensors = _make_tensors(sizes)
+    norm, inf_or_nan = multi_tensor_norm(tensors, float('inf'))
+
+    ref = torch.cat(tensors).abs().max().item()
+    assert not inf_or_nan
+    assert norm == ref
+
+
+@pytest.mark.parametrize('bad_value', [float('inf'), float('-inf'), float('nan')])
+@pytest.mark.parametrize('position', [0, 5000, -1])
+def test_inf_or_nan(bad_value, position):
+    tensors = _make_tensors([100, 70001])
+    tensors[1][position] = bad_value
+
+    _, inf_or_nan = multi_tensor_norm(tensors, 2.0)
+    assert inf_or_nan
@@ -68,3 +68,48 @@ def test_fake_quant_dequant(tensor_shape, groups):
     ref_out_4bit = quantize_dequantize_ref(ref_input_4bit, 4, groups)
     ds_out_4bit = run_quant_dequant(ds_input_4bit, groups, 4)
     assert (allclose(ds_out_4bit, ref_out_4bit))
+
+
+@pytest.mark.inference_ops
+@pytest.mark.parametrize("quantizer", ["SymQuantizer", "AsymQuantizer", "TernaryQuantizer", "BinaryQuantizer"])
+@pytest.mark.parametrize("groups", [1, 16])
+@pytest.mark.parametrize("bits", [4, 8])
+def test_fused_cpu_fake_quantizer(quantizer, groups, bits, monkeypatch):
+    from deepspeed.compression import utils as compression_utils
+    if compression_utils.fused_fake_quantizer(torch.empty(0)) is None:
+        pytest.skip("fused fake quantization runs on the CPU accelerator")
+
+    torch.manual_seed(0)
+    weight = torch.randn((128, 1000), requires_grad=True)
+    quantizer_fn = getattr(compression_utils, quantizer).apply
+
+    ds_out = quantizer_fn(weight, bits, None, None, groups)
+    ds_out.sum().backward()
+    assert torch.equal(weight.grad, torch.ones_like(weight))
+
+    monkeypatch.setattr(compression_utils, "cpu_quantizer_module", False)
+    ref_out = quantizer_fn(weight, bits, None, None, groups)
+    if quantizer == "TernaryQuantizer":
+        # Only the ternary alpha may differ by the order of its sum.
+        mismatches = (~torch.isclose(ds_out, ref_out, rtol=1e-4, atol=1e-6)).sum().item()
+        assert mismatches <= weight.numel() // 1000
+    else:
+        assert torch.equal(ds_out, ref_out)
+
+
+@pytest.mark.inference_ops
+@pytest.mark.parametrize("quantizer", ["SymQuantizer", "AsymQuantizer"])
+def test_fused_cpu_fake_quantizer_static_range(quantizer, monkeypatch):
+    from deepspeed.compression import utils as compression_utils
+    if compression_utils.fused_fake_quantizer(torch.empty(0)) is None:
+        pytest.skip("fused fake quantization runs on the CPU accelerator")
+
+    torch.manual_seed(0)
+    activations = torch.randn((32, 256))
+    x_min_max = torch.tensor([-2.0, 1.5])
+    quantizer_fn = getattr(compression_utils, quantizer).apply
+
+    ds_out = quantizer_fn(activations, 8, x_min_max[0], x_min_max[1])
+    monkeypatch.setattr(compression_utils, "cpu_quantizer_module", False)
+    ref_out = quantizer_fn(activations, 8, x_min_max[0], x_min_max[1])
+    assert torch.equal(ds_out, ref_out)
@@ -152,3 +152,55 @@ def test_float_quantize(num_elems, num_groups, is_symmetric_quant, q_bits, direc
     ds_quantization_error = torch.sum(torch.abs((activations_ds - ds_dequantized_tensor).to(torch.float64)))
 
     assert (ds_quantization_error <= ref_quantization_error * 1.05)
+
+
+@pytest.mark.inference_ops
+@pytest.mark.parametrize("nodes, devices_per_node", [(1, 4), (2, 2), (2, 4)])
+def test_swizzle_quant(nodes, devices_per_node):
+    global inference_module
+    if inference_module is None:
+        inference_module = QuantizerBuilder().load()
+
+    torch.manual_seed(0)
+    groups, elems_per_group = nodes * devices_per_node * 2, 64
+    activations = torch.randn((groups, elems_per_group), dtype=torch.float16, device=get_accelerator().device_name())
+
+    ref_data, ref_params = inference_module.quantize(activations, groups, 4, inference_module.Symmetric)
+    swizzled_data, swizzled_params = inference_module.swizzle_quant(activations, groups, 4,
+                                                                    inference_module.Symmetric, 1, nodes,
+                                                                    devices_per_node)
+
+    # The groups of partition (node, device) end up in position (device, node).
+    ref_data = ref_data.reshape(nodes, devices_per_node, -1).transpose(0, 1).reshape(-1)
+    ref_params = ref_params.reshape(nodes, devices_per_node, -1).transpose(0, 1).reshape(-1, 1)
+    assert torch.equal(swizzled_data, ref_data)
+    assert torch.equal(swizzled_params, ref_params)
+
+
+@pytest.mark.inference_ops
+@pytest.mark.parametrize("q_bits", [4, 8])
+def test_quantized_reduction(q_bits):
+    global inference_module
+    if inference_module is None:
+        inference_module = QuantizerBuilder().load()
+
+    torch.manual_seed(0)
+    devices_per_node, in_groups_per_tensor, out_groups = 4, 4, 2
+    elems_per_tensor = 512
+    activations = torch.randn((devices_per_node, elems_per_tensor),
+                              dtype=torch.float16,
+                              device=get_accelerator().device_name())
+
+    in_groups = devices_per_node * in_groups_per_tensor
+    data, params = inference_module.quantize(activations, in_groups, q_bits, inference_module.Symmetric)
+    reduced_data, reduced_params = inference_module.quantized_reduction(data.reshape(-1), params, in_groups,
+                                                                        out_groups, q_bits,
+                                                                        inference_module.Symmetric, devices_per_node)
+    assert reduced_data.numel() == data.numel() // devices_per_node
+
+    expected = inference_module.dequantize_fp32(data, params, in_groups, q_bits, inference_module.Symmetric).sum(0)
+    reduced = inference_module.dequantize_fp32(reduced_data, reduced_params, out_groups, q_bits,
+                                               inference_module.Symmetric)
+    # Within one quantization step of the reduced groups.
+    step = reduced_params.repeat_interleave(elems_per_tensor // out_groups).flatten()
+    assert torch.all((reduced - expected).abs() <= step * 1.01)
@@ -88,3 +88,27 @@ def test_bias_add_bias_add(batch, image_size, channels):
     ds_vals = nhwc_bias_add(activations, bias, other=other, other_bias=other_bias)
 
     assert allclose(ds_vals, ref_vals)
+
+
+@pytest.mark.inference_ops
+@pytest.mark.parametrize("dtype", [torch.float32, torch.bfloat16])
+@pytest.mark.parametrize("channels", [320, 333])
+def test_bias_add_cpu(dtype, channels):
+    if get_accelerator().device_name() != 'cpu':
+        pytest.skip("CPU kernel only")
+    shape = (2, channels, 16, 16)
+    activations = torch.randn(shape, dtype=dtype).to(memory_format=torch.channels_last)
+    other = torch.randn(shape, dtype=dtype).to(memory_format=torch.channels_last)
+    bias = torch.randn((channels), dtype=dtype)
+    other_bias = torch.randn((channels), dtype=dtype)
+
+    # the kernel accumulates in fp32 and rounds once
+    rtol, atol = (1e-5, 1e-5) if dtype == torch.float32 else (1e-2, 1e-2)
+    checks = [(nhwc_bias_add(activations, bias), ref_bias_add(activations.float(), bias.float())),
+              (nhwc_bias_add(activations, bias, other=other),
+               ref_bias_add_add(activations.float(), bias.float(), other.float())),
+              (nhwc_bias_add(activations, bias, other=other, other_bias=other_bias),
+               ref_bias_add_bias_add(activations.float(), bias.float(), other.float(), other_bias.float()))]
+    for ds_vals, ref_vals in checks:
+        assert ds_vals.is_contiguous(memory_format=torch.channels_last)
+        assert torch.allclose(ds_vals.float(), ref_vals, rtol=rtol, atol=atol)
@@ -0,0 +1,98 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import torch
+import pytest
+from torch.utils.cpp_extension import load_inline
+
+import deepspeed
+from deepspeed.ops.op_builder import NativeProfilerBuilder
+from deepspeed.profiling.flops_profiler import NativeFlopsProfiler
+from deepspeed.profiling.flops_profiler.native_profiler import attach_native_profiler
+
+if not deepspeed.ops.__compatible_ops__[NativeProfilerBuilder.NAME]:
+    pytest.skip("native-profiler is not compatible", allow_module_level=True)
+
+
+def test_module_profile():
+    batch, hidden = 4, 16
+    model = torch.nn.Sequential(torch.nn.Linear(hidden, 2 * hidden), torch.nn.ReLU(),
+                                torch.nn.Linear(2 * hidden, hidden))
+    prof = NativeFlopsProfiler(model)
+
+    prof.start_profile()
+    for _ in range(3):
+        model(torch.randn(batch, hidden))
+    prof.stop_profile()
+
+    # not recorded once stopped
+    model(torch.randn(batch, hidden))
+
+    profile = prof.get_module_profile()
+    linear_flops = 2 * batch * hidden * 2 * hidden
+    assert all(entry['calls'] == 3 for entry in profile.values())
+    assert profile['0']['flops'] == 3 * linear_flops
+    assert profile['1']['flops'] == 0
+    assert prof.get_total_flops() == 6 * linear_flops
+    assert prof.get_total_duration() >= profile['0']['duration'] + profile['2']['duration']
+    assert prof.get_dropped_events() == 0
+
+
+def test_restart_resets():
+    model = torch.nn.Linear(8, 8)
+    prof = NativeFlopsProfiler(model)
+
+    prof.start_profile()
+    model(torch.randn(2, 8))
+    prof.stop_profile()
+    prof.start_profile()
+    prof.stop_profile()
+
+    assert prof.get_module_profile()['']['calls'] == 0
+
+
+# A kernel of an extension other than the profiler, recording through the kernel-facing API.
+RECORDING_EXTENSION_SOURCE = """
+#include "ds_profiler.h"
+
+void scaled_kernel(int64_t flops)
+{
+    DS_Profile_Scope profile(0, 42, flops);
+}
+
+void profile_attach(py::capsule recorder)
+{
+    void* table = PyCapsule_GetPointer(recorder.ptr(), DS_PROFILE_RECORDER_CAPSULE);
+    if (table == nullptr) throw py::error_already_set();
+    ds_profile_attach((const DS_Profile_Recorder*)table);
+}
+"""
+
+
+def test_kernel_events_of_other_extension(tmpdir):
+    include_path = NativeProfilerBuilder().deepspeed_src_path('csrc/includes')
+    op = load_inline(name='ds_profiler_recording_test',
+                     cpp_sources=RECORDING_EXTENSION_SOURCE,
+                     functions=['scaled_kernel', 'profile_attach'],
+                     extra_include_paths=[include_path],
+                     extra_cflags=['-std=c++17'],
+                     build_directory=str(tmpdir))
+    prof = NativeFlopsProfiler(torch.nn.Linear(8, 8))
+
+    # Nothing is recorded before the extension is attached.
+    prof.start_profile()
+    op.scaled_kernel(5)
+    attach_native_profiler(op)
+    for _ in range(3):
+        op.scaled_kernel(10)
+    prof.stop_profile()
+
+    # nor once stopped
+    op.scaled_kernel(10)
+
+    profile = prof.get_kernel_profile()
+    assert profile[42]['calls'] == 3
+    assert profile[42]['flops'] == 30
+    assert prof.get_dropped_events() == 0
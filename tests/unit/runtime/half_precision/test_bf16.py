@@ -12,6 +12,8 @@ from deepspeed.ops.op_builder import CPUAdamBuilder
 from unit.simple_model import SimpleModel, SimpleOptimizer, random_dataloader
 from unit.util import bf16_required_version_check
 from deepspeed import comm as dist
+from deepspeed.accelerator import get_accelerator
+from deepspeed.runtime.bf16_optimizer import stochastic_round_to_bf16_
 
 
 class TestAdamBF16ZeroOneCycleCompatibility(DistributedTest):
@@ -340,3 +342,73 @@ class TestZeroDtypeCocktail(DistributedTest):
             model.backward(loss)
             model.step()
         dist.reduce = orig_torch_reduce
+
+
+class TestBF16StochasticRoundingCheckpoint(DistributedTest):
+    world_size = 1
+
+    def test(self, tmpdir):
+        if not bf16_required_version_check():
+            pytest.skip(
+                " DeepSpeed BFloat16 tests need torch >= 1.10, NCCL >= 2.10.3, CUDA > =11.0 and HW support for BFloat16 to run correctly"
+            )
+
+        config_dict = {
+            "train_micro_batch_size_per_gpu": 1,
+            "steps_per_print": 1,
+            "bf16": {
+                "enabled": True,
+                "stochastic_rounding": True
+            },
+            "zero_optimization": {
+                "stage": 0
+            }
+        }
+        hidden_dim = 10
+
+        def create_engine():
+            model = SimpleModel(hidden_dim)
+            optimizer = torch.optim.Adam(model.parameters())
+            model, _, _, _ = deepspeed.initialize(config=config_dict, model=model, optimizer=optimizer)
+            return model
+
+        model = create_engine()
+        data_loader = random_dataloader(model=model,
+                                        total_samples=2,
+                                        hidden_dim=hidden_dim,
+                                        device=model.device,
+                                        dtype=torch.bfloat16)
+        for n, batch in enumerate(data_loader):
+            loss = model(batch[0], batch[1])
+            model.backward(loss)
+            model.step()
+
+        # Every step advances the seed, whether the copy is native or not.
+        assert model.optimizer.rounding_step == 2
+        model.save_checkpoint(tmpdir)
+
+        loaded = create_engine()
+        assert loaded.optimizer.rounding_step == 0
+        loaded.load_checkpoint(tmpdir)
+        assert loaded.optimizer.rounding_step == 2
+
+
+class TestBF16StochasticRound(DistributedTest):
+    world_size = 1
+
+    def test(self):
+        src = torch.randn(4096, device=get_accelerator().current_device_name())
+        dst = [torch.empty_like(src, dtype=torch.bfloat16) for _ in range(2)]
+
+        rng_state = get_accelerator().get_rng_state()
+        for lp in dst:
+            generator = torch.Generator(device=src.device)
+            generator.manual_seed(3)
+            stochastic_round_to_bf16_(lp, src, generator)
+
+        # Rounding draws from its own generator only, so the same seed gives the same result and
+        # the global RNG stream is left alone.
+        assert torch.equal(dst[0], dst[1])
+        assert torch.equal(get_accelerator().get_rng_state(), rng_state)
+        # Every value lands on one of its two neighbouring bf16 values.
+        assert torch.all((dst[0].float() - src).abs() <= src.abs() * 2**-7)
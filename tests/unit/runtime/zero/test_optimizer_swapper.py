@@ -0,0 +1,137 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+from types import SimpleNamespace
+
+import numpy as np
+import pytest
+import torch
+
+import deepspeed
+from deepspeed.ops.adam import DeepSpeedCPUAdam
+from deepspeed.ops.aio import AsyncIOBuilder
+from deepspeed.ops.op_builder import CPUAdamBuilder
+from deepspeed.runtime.swap_tensor.aio_config import get_aio_config
+from deepspeed.runtime.swap_tensor.partitioned_optimizer_swapper import PartitionedOptimizerSwapper
+from deepspeed.runtime.swap_tensor.streaming_optimizer_swapper import StreamingOptimizerSwapper
+from unit.common import DistributedTest
+
+if not deepspeed.ops.__compatible_ops__[AsyncIOBuilder.NAME]:
+    pytest.skip('Skip tests since async-io is not compatible', allow_module_level=True)
+
+# Large enough for every gradient fragment to be swappable
+PARAM_NUMEL = 1 << 20
+BUFFER_COUNT = 2
+
+
+def make_swapper(tmpdir):
+    param = torch.nn.Parameter(torch.zeros(PARAM_NUMEL))
+    param.ds_id = '0'
+    optimizer = torch.optim.Adam([param])
+    swapper = PartitionedOptimizerSwapper(swap_config=SimpleNamespace(buffer_count=BUFFER_COUNT),
+                                          aio_config=get_aio_config({}),
+                                          base_folder=str(tmpdir),
+                                          optimizer=optimizer,
+                                          largest_numel=PARAM_NUMEL,
+                                          device='cpu',
+                                          dtype=torch.float32,
+                                          timers=None)
+    swapper.initialize_parameters(parameters=[param], src_tensors=[param.data])
+    return swapper, param
+
+
+def read_gradient(swapper, param, offset, numel):
+    path = swapper.swap_params_info[param.ds_id].swapped_gradients[offset].path
+    return torch.from_numpy(np.fromfile(path, dtype=np.float32)[:numel])
+
+
+class TestOptimizerGradientSwapOut(DistributedTest):
+    world_size = 1
+
+    def test_direct_and_staged_gradients(self, tmpdir):
+        swapper, param = make_swapper(tmpdir)
+        half = PARAM_NUMEL // 2
+        direct = torch.randn(half)
+        # Not contiguous, so it has to be staged in the pinned swap buffers
+        staged = torch.randn(half * 2)[::2]
+
+        swapper.swap_out_gradients(parameter=param, gradient_offsets=[0, half], gradient_tensors=[direct, staged])
+        gradient_swapper = swapper.gradient_swapper
+        assert gradient_swapper.num_direct_swaps == 1
+        assert gradient_swapper.has_buffers()
+
+        swapper.flush_gradients()
+        assert not gradient_swapper.has_buffers()
+        assert not gradient_swapper.has_pending_swaps()
+        assert len(swapper.swap_buffer_manager.free_buffer_index) == BUFFER_COUNT
+        assert torch.equal(read_gradient(swapper, param, 0, half), direct)
+        assert torch.equal(read_gradient(swapper, param, half, half), staged)
+
+    def test_flush_direct_gradients_without_buffers(self, tmpdir):
+        swapper, param = make_swapper(tmpdir)
+        gradient = torch.randn(PARAM_NUMEL)
+
+        # Host gradients alone never take the pinned buffers, the flush still waits for their writes.
+        swapper.swap_out_gradients(parameter=param, gradient_offsets=[0], gradient_tensors=[gradient])
+        gradient_swapper = swapper.gradient_swapper
+        assert not gradient_swapper.has_buffers()
+        assert gradient_swapper.has_pending_swaps()
+
+        swapper.flush_gradients()
+        assert not gradient_swapper.has_pending_swaps()
+        assert len(swapper.swap_buffer_manager.free_buffer_index) == BUFFER_COUNT
+        assert torch.equal(read_gradient(swapper, param, 0, PARAM_NUMEL), gradient)
+
+
+class TestStreamingOptimizerSwapper(DistributedTest):
+    world_size = 1
+
+    def test_matches_optimizer_step(self, tmpdir):
+        if not deepspeed.ops.__compatible_ops__[CPUAdamBuilder.NAME]:
+            pytest.skip("cpu-adam is not compatible")
+
+        # Not a multiple of the streamed chunks, so the last chunk is partial.
+        numel = PARAM_NUMEL + 5 * 256
+        init = torch.randn(numel)
+        param = torch.nn.Parameter(init.clone())
+        param.ds_id = '0'
+        optimizer = DeepSpeedCPUAdam([param], lr=1e-2, weight_decay=0.01)
+        # Small blocks so that the parameter is streamed in many chunks.
+        aio_config = get_aio_config({"aio": {"block_size": 65536, "queue_depth": 4}})
+        swapper = StreamingOptimizerSwapper(swap_config=SimpleNamespace(buffer_count=BUFFER_COUNT,
+                                                                        pipeline_read=False,
+                                                                        pipeline_write=False),
+                                            aio_config=aio_config,
+                                            base_folder=str(tmpdir),
+                                            optimizer=optimizer,
+                                            largest_numel=numel,
+                                            device='cpu',
+                                            dtype=torch.float32,
+                                            timers=None)
+        swapper.initialize_parameters(parameters=[param], src_tensors=[param.data])
+        swapper._get_param_swap_info(param).release_memory()
+
+        ref_param = torch.nn.Parameter(init.clone())
+        ref_optimizer = DeepSpeedCPUAdam([ref_param], lr=1e-2, weight_decay=0.01)
+
+        for _ in range(3):
+            grad = torch.randn(numel)
+            ref_param.grad = grad.clone()
+            ref_optimizer.step()
+
+            swapper.swap_out_gradients(parameter=param, gradient_offsets=[0], gradient_tensors=[grad])
+            assert swapper.swap_in_gradients(param)
+            swapper.stream_optimizer_step(param, optimizer.param_groups[0])
+            assert torch.allclose(param.data, ref_param.data)
+            swapper.release_streamed_parameter(param)
+
+        # The fp32 parameter and both moments were written back to their swap files.
+        swap_info = swapper._get_param_swap_info(param)
+        ref_state = ref_optimizer.state[ref_param]
+        for path, expected in zip(swap_info.swap_paths,
+                                  [ref_param.data, ref_state['exp_avg'], ref_state['exp_avg_sq']]):
+            streamed = torch.from_numpy(np.fromfile(path, dtype=np.float32)[:numel])
+            assert torch.allclose(streamed, expected)
+        assert optimizer.state[param]['step'] == ref_state['step']
@@ -0,0 +1,137 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import os
+from types import SimpleNamespace
+
+import pytest
+import torch
+
+import deepspeed
+from deepspeed.ops.aio import AsyncIOBuilder
+from deepspeed.runtime.swap_tensor.aio_config import get_aio_config
+from deepspeed.runtime.swap_tensor.partitioned_param_swapper import PartitionedParamStatus
+from deepspeed.runtime.swap_tensor.slab_param_swapper import SlabPartitionedParameterSwapper
+from deepspeed.runtime.zero.offload_config import DeepSpeedZeroOffloadParamConfig
+from unit.common import DistributedTest
+
+if not deepspeed.ops.__compatible_ops__[AsyncIOBuilder.NAME]:
+    pytest.skip('Skip tests since async-io is not compatible', allow_module_level=True)
+
+BUFFER_NUMEL = 1 << 20
+
+
+def make_swapper(tmpdir, buffer_count=2):
+    offload_param = DeepSpeedZeroOffloadParamConfig(device="nvme",
+                                                    nvme_path=os.path.join(tmpdir, "swap"),
+                                                    buffer_count=buffer_count,
+                                                    buffer_size=BUFFER_NUMEL,
+                                                    slab_buffers=True)
+    ds_config = SimpleNamespace(zero_config=SimpleNamespace(offload_param=offload_param),
+                                aio_config=get_aio_config({}))
+    return SlabPartitionedParameterSwapper(ds_config, torch.float16)
+
+
+def make_param(ds_id, numel):
+    ds_tensor = torch.empty(0, dtype=torch.float16)
+    ds_tensor.ds_numel = numel
+    ds_tensor.status = PartitionedParamStatus.NOT_AVAILABLE
+    return SimpleNamespace(ds_id=ds_id, ds_tensor=ds_tensor)
+
+
+def swap_out(swapper, param, value):
+    buffer = swapper.get_buffer(param, param.ds_tensor.ds_numel)
+    buffer.fill_(value)
+    swapper.swap_out_and_release([param])
+
+
+class TestSlabParamSwapper(DistributedTest):
+    world_size = 1
+
+    def test_cached_swap_in(self, tmpdir):
+        swapper = make_swapper(tmpdir)
+        param = make_param(0, 1000)
+
+        swap_out(swapper, param, 1.0)
+        assert param.ds_tensor.status == PartitionedParamStatus.NOT_AVAILABLE
+        assert 0 in swapper.cached_swap_buffers
+
+        # Served from the cached buffer, no read is issued.
+        swapper.swap_in([param], async_op=False)
+        assert swapper.pending_reads == 0
+        assert param.ds_tensor.status == PartitionedParamStatus.AVAILABLE
+        assert param.ds_tensor.numel() == 1000
+        assert torch.all(param.ds_tensor == 1.0)
+        assert 0 not in swapper.cached_swap_buffers
+
+    def test_reallocating_cached_partition(self, tmpdir):
+        swapper = make_swapper(tmpdir)
+        param = make_param(0, 1000)
+        swap_out(swapper, param, 1.0)
+
+        # A new buffer for the same partition replaces the cached one, whose view must not be kept.
+        buffer = swapper.get_buffer(param, 1000)
+        assert 0 not in swapper.cached_swap_buffers
+        buffer.fill_(2.0)
+        swapper.swap_out_and_release([param])
+
+        swapper.swap_in([param], async_op=False)
+        assert torch.all(param.ds_tensor == 2.0)
+
+    def test_evicted_partition_is_read_back(self, tmpdir):
+        swapper = make_swapper(tmpdir)
+        params = [make_param(ds_id, BUFFER_NUMEL) for ds_id in range(3)]
+        for value, param in enumerate(params):
+            swap_out(swapper, param, float(value))
+
+        # The slabs hold two full-size buffers, the partition released first was evicted.
+        assert sorted(swapper.cached_swap_buffers.keys()) == [1, 2]
+
+        swapper.swap_in([params[0]], async_op=False)
+        assert torch.all(params[0].ds_tensor == 0.0)
+        assert sorted(swapper.cached_swap_buffers.keys()) == [2]
+
+    def test_exhausted_slabs_raise(self, tmpdir):
+        swapper = make_swapper(tmpdir)
+        for ds_id in range(2):
+            swapper.get_buffer(make_param(ds_id, BUFFER_NUMEL), BUFFER_NUMEL)
+
+        with pytest.raises(RuntimeError):
+            swapper.get_buffer(make_param(2, BUFFER_NUMEL), BUFFER_NUMEL)
+
+    def test_allocation_waits_for_writes(self, tmpdir):
+        swapper = make_swapper(tmpdir)
+        params = [make_param(ds_id, BUFFER_NUMEL) for ds_id in range(3)]
+        for value, param in enumerate(params[:2]):
+            buffer = swapper.get_buffer(param, BUFFER_NUMEL)
+            buffer.fill_(float(value))
+            swapper.swap_out_and_release([param], async_op=True, force_buffer_release=True)
+        assert swapper.pending_writes == 2
+
+        # Both slabs are held by writes in flight, the allocation waits for them and evicts one.
+        swapper.get_buffer(params[2], BUFFER_NUMEL)
+        assert swapper.pending_writes == 0
+        assert sorted(swapper.cached_swap_buffers.keys()) == [1]
+
+        swapper.swap_in([params[1]], async_op=False)
+        assert torch.all(params[1].ds_tensor == 1.0)
+
+    def test_allocation_waits_for_reads_before_raising(self, tmpdir):
+        swapper = make_swapper(tmpdir)
+        params = [make_param(ds_id, BUFFER_NUMEL) for ds_id in range(3)]
+        for value, param in enumerate(params):
+            swap_out(swapper, param, float(value))
+
+        # One slab is read into, the other is taken by a new partition.
+        swapper.swap_in([params[0]], async_op=True)
+        swapper.get_buffer(make_param(3, BUFFER_NUMEL), BUFFER_NUMEL)
+        assert swapper.pending_reads == 1
+
+        # Nothing frees up once the read completed, the allocation raises with no I/O left in flight.
+        with pytest.raises(RuntimeError):
+            swapper.get_buffer(make_param(4, BUFFER_NUMEL), BUFFER_NUMEL)
+        assert swapper.pending_reads == 0
+        assert params[0].ds_tensor.status == PartitionedParamStatus.AVAILABLE
+        assert torch.all(params[0].ds_tensor == 0.0)
@@ -0,0 +1,47 @@
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: Apache-2.0
+
+# DeepSpeed Team
+
+import json
+
+import torch
+import pytest
+
+import deepspeed
+from deepspeed.ops.adam import DeepSpeedCPUAdam
+from deepspeed.ops.op_builder import CPUAdamBuilder
+from deepspeed.utils import native_trace
+
+if not deepspeed.ops.__compatible_ops__[CPUAdamBuilder.NAME]:
+    pytest.skip("cpu-adam is not compatible", allow_module_level=True)
+
+
+def _step(optimizer, param):
+    param.grad = torch.randn_like(param)
+    optimizer.step()
+
+
+def test_optimizer_step_trace(tmpdir):
+    param = torch.nn.Parameter(torch.randn(1024))
+    optimizer = DeepSpeedCPUAdam([param])
+
+    native_trace.disable()
+    _step(optimizer, param)
+    native_trace.collect_events()
+
+    native_trace.enable()
+    _step(optimizer, param)
+    _step(optimizer, param)
+    native_trace.disable()
+    _step(optimizer, param)
+
+    trace_file = str(tmpdir.join("trace.json"))
+    native_trace.export_chrome_trace(trace_file)
+    with open(trace_file) as fd:
+        events = json.load(fd)["traceEvents"]
+
+    steps = [e for e in events if e["cat"] == "optimizer" and e["name"] == "adam_step"]
+    assert len(steps) == 2
+    assert all(e["ph"] == "X" and e["dur"] >= 0 and e["args"]["bytes"] == param.numel() * 4 for e in steps)
+    assert steps[0]["ts"] + steps[0]["dur"] <= steps[1]["ts"]